@@ -6,37 +6,86 @@
 #include <esp_chip_info.h>
 #include <soc/rtc.h>
 #include <BLEDevice.h>
-#include <EEPROM.h>
 #include <SPIFFS.h>
 #include <WebServer.h>
 #include <WiFiAP.h>
-
-#define EEPROM_SIZE 4096
-#define HISTORY_MAX_LEN 4000
+#include "ESP32-Specs.h"
+#include "web_assets.h"
 
 // Estado del diagnóstico
 bool diagnosticoCompleto = false;
 
-// Buffer para almacenar el historial de resultados
-char historialBuffer[HISTORY_MAX_LEN];
-int historialIdx = 0;
+// Bitácora de resultados (registros tipados sobre el historial circular)
+BitacoraResultados historial;
+// Hasta dónde se ha mostrado la bitácora por Serial
+CursorRender cursorSerial;
+// En modo binario la bitácora sale en tramas en lugar de texto
+Telemetria telemetria;
+
+// Cola entre el callback BLE (tarea host de BLE) y loop()
+ColaSPSC<RegistroEscaneoBLE, BLE_COLA_LEN> colaBLE;
+// Dispositivos BLE únicos con sus estadísticas (la alimenta procesarColaBLE)
+TablaBLE tablaBLE;
+// true mientras dura el escaneo de explorarBluetooth (no el del modo continuo)
+static bool escaneoBLEPuntual = false;
+
+// Planificador cooperativo y diagnóstico en curso (nullptr si ninguno)
+Planificador planificador;
+static PasoTarea diagnosticoActual = nullptr;
+
+// Últimas redes escaneadas, con su vigencia
+CacheWiFi cacheWiFi;
+
+// Motor de micro-benchmarks
+MicroBench microbench;
+
+// Serie temporal del heap (comando F y /heap)
+SerieHeap serieHeap;
+// Muestreo periódico en segundo plano (comando S y /muestras)
+SerieMuestras serieMuestras;
+
+// Línea en curso del Monitor Serie
+static LectorLineas lectorSerial;
+
+// Respaldo de la bitácora en flash (diario de páginas en NVS)
+DiarioRespaldo respaldo;
+
+// Exportaciones numeradas con rotación y su índice de metadatos
+AlmacenExportaciones exportaciones;
+
+// Línea base para detectar regresiones entre ejecuciones (comando base y /veredicto)
+LineaBase lineaBase;
+
+// Índice del directorio para /list (se invalida al escribir o borrar)
+IndiceArchivos indiceArchivos;
 
 // Variables para el servidor web
 WebServer server(80);
+MetricasHTTP metricasHTTP;
+ServidorEventos eventos;
 const char* ap_ssid = "ESP32-FileManager";
 const char* ap_password = "12345678";
 bool servidorWebActivo = false;
 
 void setup() {
-  Serial.begin(115200);
+  Serial.begin(SERIAL_BAUDIOS);
   delay(1000);
   
   disableCore0WDT();
-  EEPROM.begin(EEPROM_SIZE);
+  registrarKernelsBase(microbench);
+  planificador.lanzar("heap", muestrearHeap);
+  planificador.lanzar("muestreo", muestrearTelemetria);
   
   if (!SPIFFS.begin(true)) {
     Serial.println(" Error inicializando ");
   }
+
+  exportaciones.iniciar();
+  lineaBase.iniciar();
+
+  // Resultados de la sesión anterior, si quedó respaldo
+  size_t recuperados = respaldo.recuperar(historial);
+  cursorSerial.pos = historial.fin();
   
   delay(500);
 
@@ -44,139 +93,411 @@ void setup() {
   Serial.println("║   ESP32-C3 MINI - EXPLORADOR TOTAL        ║");
   Serial.println("║                                           ║");
   Serial.println("╚═══════════════════════════════════════════╝");
+  if (recuperados) {
+    imprimirlnf(Serial, "💾 Respaldo recuperado: %u bytes de la sesión anterior (%lu us)", (unsigned)recuperados,
+                (unsigned long)respaldo.recuperadoUs());
+  } else if (respaldo.descartado()) {
+    Serial.println("💾 Respaldo de otro firmware descartado: sus claves no coinciden con estas");
+  }
   
   delay(500);
   mostrarMenu();
+  
+  // Guion de arranque (p. ej. para pruebas de larga duración): arranca en loop()
+  if (SPIFFS.exists(GUION_INICIO)) {
+    ejecutarComando("G " GUION_INICIO);
+  }
 }
 
 void loop() {
-  if (Serial.available()) {
-    String comando = Serial.readStringUntil('\n');
-    comando.trim();
-    
-    if (comando.length() > 0) {
-      ejecutarComando(comando);
-    }
+  // Entrada sin bloquear: una línea completa por vuelta, y el guion pendiente
+  if (lectorSerial.leer(Serial)) {
+    if (lectorSerial.cortada()) Serial.println("\n⚠️ Línea demasiado larga: se ejecuta cortada");
+    interprete.ejecutarLinea(lectorSerial.linea());
   }
+  interprete.avanzar();
+  
+  // Volcar anuncios BLE recibidos por el callback
+  procesarColaBLE();
   
   // Manejar servidor web si está activo
   if (servidorWebActivo) {
     server.handleClient();
   }
   
-  delay(100);
+  // Avanzar los diagnósticos en curso un paso
+  planificador.ejecutar();
+  
+  // Empujar a /eventos lo que se escribió en esta vuelta
+  if (servidorWebActivo) {
+    eventos.atender(historial, indiceArchivos);
+  }
+  
+  // Sin pasos vencidos: ceder 1 ms al resto de tareas (antes se dormían 100 ms fijos)
+  if (planificador.msHastaProximo() > 0) {
+    delay(1);
+  }
 }
 
 void mostrarMenu() {
   Serial.println("\n📋 MENÚ DE OPCIONES:");
-  Serial.println("┌─────────────────────────────────────────┐");
-  Serial.println("│ 1 - Información del Chip                │");
-  Serial.println("│ 2 - Análisis de Memoria                │");
-  Serial.println("│ 3 - Test de WiFi                       │");
-  Serial.println("│ 4 - Test de GPIOs                      │");
-  Serial.println("│ 5 - Estado del Sistema                 │");
-  Serial.println("│ 6 - Sensores Internos                  │");
-  Serial.println("│ 7 - Test de LEDs                       │");
-  Serial.println("│ 8 - Benchmark de Rendimiento           │");
-  Serial.println("│ 9 - DIAGNÓSTICO COMPLETO               │");
-  Serial.println("│ A - Test de Bluetooth                  │"); 
-  Serial.println("│ W - Iniciar Servidor Web               │");
-  Serial.println("│ X - Exportar a archivo TXT            │");
-  Serial.println("│ Y - Mostrar archivos guardados        │");
-  Serial.println("│ C - Limpiar Historial                  │");
-  Serial.println("│                                       │");
-  Serial.println("│ help - Mostrar este menú               │");
-  Serial.println("│ reset - Reiniciar                      │");
-  Serial.println("│ sleep - Deep Sleep                     │");
-  Serial.println("└─────────────────────────────────────────┘");
+  interprete.imprimirMenu(Serial);
   Serial.print("💬 Comando: ");
 }
 
-void ejecutarComando(String cmd) {
-  Serial.println();
-  
-  if (cmd == "1") {
-    explorarChipSeguro();
-  }
-  else if (cmd == "2") {
-    explorarMemoria();
+static void imprimirListo(const char* origen) {
+  eventos.notificarListo(origen);
+  if (telemetria.activa()) {
+    telemetria.enviarListo(Serial, origen);
+    return;
   }
-  else if (cmd == "3") {
-    explorarWiFi();
+  Serial.println("\n\xC4\xC4\xC4 Listo \xC4\xC4\xC4");
+  Serial.print(" Siguiente comando: ");
+}
+
+void ejecutarComando(const char* linea) {
+  interprete.ejecutarLinea(linea);
+}
+
+// === COMANDOS ===
+
+static ResultadoComando diagnostico(const char* nombre, PasoTarea paso) {
+  return lanzarDiagnostico(nombre, paso) ? CMD_EN_CURSO : CMD_HECHO;
+}
+
+// Ejecuta un guion de SPIFFS: sus comandos se añaden a lo que quede pendiente
+static ResultadoComando comandoGuion(const char* arg) {
+  const char* ruta = *arg ? arg : GUION_INICIO;
+  File archivo = SPIFFS.open(ruta, "r");
+  if (!archivo) {
+    imprimirlnf(Serial, "❌ No se pudo abrir el guion %s", ruta);
+    return CMD_HECHO;
   }
-  else if (cmd == "4") {
-    explorarGPIOs();
+  bool entero = interprete.cargarGuion(archivo);
+  archivo.close();
+  imprimirlnf(Serial, "📜 Guion %s: %u bytes de comandos pendientes", ruta, (unsigned)interprete.bytesPendientes());
+  if (!entero) imprimirlnf(Serial, "⚠️ No cabe entero (máx. %d bytes): se ejecuta cortado", INTERPRETE_GUION_MAX);
+  return CMD_HECHO;
+}
+
+// S [ventana_s] | S periodo <ms> | S guardar: muestreo periódico agregado por
+// ventanas (60 s por defecto), su ritmo y su volcado CSV a SPIFFS
+static ResultadoComando comandoMuestreo(const char* arg) {
+  if (!strncasecmp(arg, "periodo", 7)) {
+    long ms = atol(arg + 7);
+    if (ms > 0) serieMuestras.setPeriodo(ms);
+    imprimirlnf(Serial, "📈 Muestreo cada %lu ms", (unsigned long)serieMuestras.periodo());
+    return CMD_HECHO;
   }
-  else if (cmd == "5") {
-    explorarSistema();
+  if (!strncasecmp(arg, "guardar", 7)) {
+    File archivo = SPIFFS.open(MUESTREO_ARCHIVO, "w");
+    if (!archivo) {
+      imprimirlnf(Serial, "❌ No se pudo crear %s", MUESTREO_ARCHIVO);
+      return CMD_HECHO;
+    }
+    serieMuestras.imprimirCSV(archivo, 0);
+    size_t tamano = archivo.size();
+    archivo.close();
+    indiceArchivos.invalidar();
+    imprimirlnf(Serial, "💾 %lu muestras en %s (%u bytes)", (unsigned long)serieMuestras.cantidad(),
+                MUESTREO_ARCHIVO, (unsigned)tamano);
+    return CMD_HECHO;
   }
-  else if (cmd == "6") {
-    explorarSensores();
+  uint32_t ventanaMs = *arg ? strtoul(arg, nullptr, 10) * 1000UL : 60000UL;
+  serieMuestras.imprimirTexto(Serial, ventanaMs);
+  return CMD_HECHO;
+}
+
+// base: muestra la línea base; base guardar | comparar | borrar | tol <prefijo> <valor>
+static ResultadoComando comandoLineaBase(const char* arg) {
+  if (!strncasecmp(arg, "guardar", 7)) {
+    size_t n = lineaBase.guardar(historial);
+    if (n) {
+      indiceArchivos.invalidar();
+      imprimirlnf(Serial, "📏 Línea base guardada: %u métricas en %s", (unsigned)n, LINEA_BASE_ARCHIVO);
+    } else {
+      Serial.println("❌ No hay métricas en el historial: ejecuta el benchmark (8) o el diagnóstico (9)");
+    }
+    return CMD_HECHO;
   }
-  else if (cmd == "7") {
-    testLEDs();
+  if (!strncasecmp(arg, "comparar", 8)) {
+    if (!compararConLineaBase()) lineaBase.imprimirTexto(Serial);
+    return CMD_HECHO;
   }
-  else if (cmd == "8") {
-    benchmark();
+  if (!strncasecmp(arg, "borrar", 6)) {
+    lineaBase.borrar();
+    indiceArchivos.invalidar();
+    Serial.println("🗑️ Línea base y veredicto borrados");
+    return CMD_HECHO;
   }
-  else if (cmd == "9") {
-    diagnosticoTotal();
+  if (!strncasecmp(arg, "tol", 3)) {
+    char prefijo[sizeof(MetricaBase::id)];
+    float valor;
+    if (sscanf(arg + 3, "%31s %f", prefijo, &valor) != 2 || valor < 0) {
+      Serial.println("❌ Uso: base tol <métrica o prefijo> <tolerancia>  (p. ej. base tol bench. 15)");
+      return CMD_HECHO;
+    }
+    size_t n = lineaBase.tolerancia(prefijo, valor);
+    imprimirlnf(Serial, "📏 Tolerancia %g en %u métricas que empiezan por '%s'", valor, (unsigned)n, prefijo);
+    return CMD_HECHO;
   }
-  else if (cmd == "A" || cmd == "a") { 
-    explorarBluetooth();
+  lineaBase.imprimirBase(Serial);
+  return CMD_HECHO;
+}
+
+// bin on [baudios] | bin off: cambia entre tramas binarias y texto. El aviso sale
+// a la velocidad vieja; el puerto cambia después de vaciarlo
+static ResultadoComando comandoBinario(const char* arg) {
+  if (!strncasecmp(arg, "off", 3)) {
+    if (telemetria.activa()) {
+      Serial.flush();
+      Serial.updateBaudRate(SERIAL_BAUDIOS);
+      telemetria.desactivar();
+      // El render de texto empieza limpio desde lo último que salió en tramas
+      uint32_t pos = cursorSerial.pos;
+      cursorSerial = CursorRender();
+      cursorSerial.pos = pos;
+    }
+    imprimirlnf(Serial, "📟 Modo texto a %d baudios", SERIAL_BAUDIOS);
+    return CMD_HECHO;
   }
-  else if (cmd == "W" || cmd == "w") { 
-    comandoWebServer();
+  if (strncasecmp(arg, "on", 2) != 0) {
+    Serial.println("❌ Uso: bin on [baudios] | bin off");
+    return CMD_HECHO;
   }
-  else if (cmd == "X" || cmd == "x") { 
-    exportarDatosArchivo();
+  long baudios = atol(arg + 2);
+  if (baudios <= 0) baudios = TELEMETRIA_BAUDIOS;
+  // Lo pendiente sale aún en texto: las tramas empiezan en el siguiente registro
+  mostrarResultados();
+  imprimirlnf(Serial, "📟 Modo binario a %ld baudios (protocolo v%d)", baudios, TELEMETRIA_VERSION);
+  Serial.flush();
+  Serial.updateBaudRate(baudios);
+  telemetria.activar(Serial, baudios);
+  return CMD_HECHO;
+}
+
+// Nombre, alias, acción y línea del menú, en el orden del menú
+static const DefComando comandos[] = {
+  {"1", nullptr, [](const char*) { return diagnostico("chip", explorarChipSeguro); }, "Información del Chip"},
+  {"2", nullptr, [](const char*) { return diagnostico("memoria", explorarMemoria); }, "Análisis de Memoria"},
+  {"3", nullptr, [](const char*) { return diagnostico("wifi", explorarWiFi); }, "Test de WiFi"},
+  {"4", nullptr, [](const char*) { return diagnostico("gpio", explorarGPIOs); }, "Test de GPIOs"},
+  {"4s", nullptr, [](const char*) { return diagnostico("gpio", explorarGPIOsSecuencial); }, "Test de GPIOs pin a pin"},
+  {"5", nullptr, [](const char*) { return diagnostico("sistema", explorarSistema); }, "Estado del Sistema"},
+  {"6", nullptr, [](const char*) { return diagnostico("sensores", explorarSensores); }, "Sensores Internos"},
+  {"7", nullptr, [](const char*) { return diagnostico("leds", testLEDs); }, "Test de LEDs"},
+  {"8", nullptr, [](const char*) { return diagnostico("benchmark", benchmark); }, "Benchmark de Rendimiento"},
+  {"9", nullptr, [](const char*) { return diagnostico("completo", diagnosticoTotal); }, "DIAGNÓSTICO COMPLETO"},
+  {"A", nullptr, [](const char*) { return diagnostico("bluetooth", explorarBluetooth); }, "Test de Bluetooth"},
+  {"B", nullptr, [](const char*) {
+     comandoEscaneoBLEContinuo();
+     return CMD_HECHO;
+   }, "Escaneo BLE continuo (on/off)"},
+  {"T", nullptr, [](const char*) {
+     procesarColaBLE();
+     tablaBLE.imprimirTexto(Serial);
+     return CMD_HECHO;
+   }, "Tabla de dispositivos BLE"},
+  {"W", nullptr, [](const char*) {
+     comandoWebServer();
+     return CMD_HECHO;
+   }, "Iniciar Servidor Web"},
+  {"X", nullptr, [](const char*) {
+     exportarDatosArchivo();
+     return CMD_HECHO;
+   }, "Exportar a archivo TXT"},
+  {"J", nullptr, [](const char*) {
+     exportarDatosArchivo(FMT_JSON);
+     return CMD_HECHO;
+   }, "Exportar a archivo JSON"},
+  {"V", nullptr, [](const char*) {
+     exportarDatosArchivo(FMT_CSV);
+     return CMD_HECHO;
+   }, "Exportar a archivo CSV"},
+  {"Y", nullptr, [](const char*) {
+     mostrarArchivosGuardados();
+     return CMD_HECHO;
+   }, "Mostrar archivos guardados"},
+  {"C", nullptr, [](const char*) {
+     limpiarHistorial();
+     return CMD_HECHO;
+   }, "Limpiar Historial"},
+  {"M", nullptr, [](const char*) { return diagnostico("heap", perfilarHeap); }, "Perfil de fragmentación del heap"},
+  {"F", nullptr, [](const char*) {
+     serieHeap.imprimirTexto(Serial);
+     return CMD_HECHO;
+   }, "Serie temporal del heap"},
+  {"S", nullptr, comandoMuestreo, "Muestreo (S [s] / periodo / guardar)"},
+  {"G", "guion", comandoGuion, "Ejecutar guion (G /archivo.txt)"},
+  {"base", nullptr, comandoLineaBase, "Línea base (guardar/comparar/tol)"},
+  {"bin", nullptr, comandoBinario, "Telemetría binaria (on [baud] / off)"},
+  {"stop", nullptr, [](const char*) {
+     interprete.cancelarGuion();
+     cancelarDiagnostico();
+     return CMD_HECHO;
+   }, "Cancelar diagnóstico y guion"},
+  {"help", "h", [](const char*) {
+     mostrarMenu();
+     return CMD_SILENCIOSO;
+   }, "Mostrar este menú"},
+  {"reset", nullptr, [](const char*) {
+     Serial.println(" Reiniciando...");
+     delay(1000);
+     ESP.restart();
+     return CMD_HECHO;
+   }, "Reiniciar"},
+  {"sleep", nullptr, [](const char*) {
+     Serial.println("Modo Deep Sleep. Use RESET para despertar.");
+     delay(500);
+     esp_deep_sleep_start();
+     return CMD_HECHO;
+   }, "Deep Sleep"},
+};
+
+// Tras cada comando: muestra del heap y "Listo" (los diagnósticos lo hacen en finDiagnostico)
+static void despuesDeComando(const char* cmd, ResultadoComando r) {
+  if (r == CMD_EN_CURSO || r == CMD_SILENCIOSO) return;
+  serieHeap.muestrear(cmd);
+  imprimirListo(cmd);
+}
+
+Interprete interprete(comandos, sizeof(comandos) / sizeof(comandos[0]), Serial, diagnosticoEnCurso, despuesDeComando);
+
+// === DIAGNÓSTICOS EN SEGUNDO PLANO ===
+
+static void finDiagnostico(Tarea& t) {
+  diagnosticoActual = nullptr;
+  // Antes del "Listo": la web recarga el veredicto al recibirlo
+  if ((t.paso == benchmark || t.paso == diagnosticoTotal) && lineaBase.existe()) {
+    compararConLineaBase();
   }
-  else if (cmd == "Y" || cmd == "y") { 
-    mostrarArchivosGuardados();
+  serieHeap.muestrear(t.nombre);
+  imprimirListo(t.nombre);
+}
+
+bool diagnosticoEnCurso() {
+  return diagnosticoActual && planificador.activa(diagnosticoActual);
+}
+
+bool lanzarDiagnostico(const char* nombre, PasoTarea paso) {
+  if (diagnosticoEnCurso()) {
+    Serial.println("⏳ Ya hay un diagnóstico en curso. Espere o use 'stop'.");
+    return false;
   }
-  else if (cmd == "C" || cmd == "c") {
-    limpiarHistorial();
+  if (!planificador.lanzar(nombre, paso, finDiagnostico)) {
+    Serial.println("❌ No quedan huecos en el planificador");
+    return false;
   }
-  else if (cmd == "help" || cmd == "h") {
-    mostrarMenu();
+  diagnosticoActual = paso;
+  return true;
+}
+
+// Los resultados parciales se conservan en el historial
+void cancelarDiagnostico() {
+  if (!diagnosticoEnCurso()) {
+    Serial.println("ℹ️ No hay ningún diagnóstico en curso");
     return;
   }
-  else if (cmd == "reset") {
-    Serial.println(" Reiniciando...");
-    delay(1000);
-    ESP.restart();
-  }
-  else if (cmd == "sleep") {
-    Serial.println("Modo Deep Sleep. Use RESET para despertar.");
-    delay(500);
-    esp_deep_sleep_start();
+  planificador.cancelar(diagnosticoActual);
+  diagnosticoActual = nullptr;
+  // Un escaneo WiFi a medias se termina igualmente y queda en la caché
+  if (cacheWiFi.escaneando() && !planificador.activa(refrescarWiFi)) {
+    planificador.lanzar("wifi", refrescarWiFi);
   }
-  else {
-    Serial.println(" Comando no reconocido: '" + cmd + "'");
-    Serial.println(" Escriba 'help' para ver opciones");
+  if (escaneoBLEPuntual) {
+    BLEDevice::getScan()->stop();
+    escaneoBLEPuntual = false;
   }
-  
-  Serial.println("\n" + String(char(196)) + String(char(196)) + String(char(196)) + " Listo " + String(char(196)) + String(char(196)) + String(char(196)));
-  Serial.print(" Siguiente comando: ");
+  Serial.println("⏹️ Diagnóstico cancelado");
 }
 
 // === FUNCIONES DEL SERVIDOR WEB ===
 
+// Adaptador Print que agrupa la salida en bloques para una respuesta chunked
+class SalidaHTTP : public Print {
+public:
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* datos, size_t len) override {
+    for (size_t i = 0; i < len; i++) {
+      buf_[n_++] = datos[i];
+      if (n_ == sizeof(buf_)) vaciar();
+    }
+    return len;
+  }
+  void vaciar() {
+    if (n_ == 0) return;
+    server.sendContent((const char*)buf_, n_);
+    n_ = 0;
+  }
+
+private:
+  uint8_t buf_[512];
+  size_t n_ = 0;
+};
+
+static const char* nombreMetodo(HTTPMethod metodo) {
+  switch (metodo) {
+    case HTTP_GET: return "GET";
+    case HTTP_POST: return "POST";
+    case HTTP_PUT: return "PUT";
+    case HTTP_DELETE: return "DELETE";
+    default: return "OTRO";
+  }
+}
+
+// Registra una ruta con su entrada en /metrics (tiempo del handler y de los
+// callbacks de subida) y anota el heap al terminar cada respuesta, con la ruta como origen
+static void registrarRuta(const char* uri, HTTPMethod metodo, void (*fn)(), void (*subida)() = nullptr) {
+  int ruta = metricasHTTP.registrar(uri, nombreMetodo(metodo));
+  auto conMuestra = [uri, fn, ruta]() {
+    uint32_t inicio = micros();
+    fn();
+    metricasHTTP.anotar(ruta, micros() - inicio);
+    serieHeap.muestrear(uri);
+  };
+  if (subida) {
+    server.on(uri, metodo, conMuestra, [subida, ruta]() {
+      uint32_t inicio = micros();
+      subida();
+      metricasHTTP.anotarParcial(ruta, micros() - inicio);
+    });
+  } else {
+    server.on(uri, metodo, conMuestra);
+  }
+}
+
 void iniciarServidorWeb() {
   // Crear punto de acceso WiFi
   WiFi.softAP(ap_ssid, ap_password);
   IPAddress IP = WiFi.softAPIP();
   
   Serial.println("🌐 SERVIDOR WEB INICIADO");
-  Serial.println("📡 Red WiFi: " + String(ap_ssid));
-  Serial.println("🔑 Password: " + String(ap_password));
-  Serial.println("🌍 IP: http://" + IP.toString());
+  imprimirlnf(Serial, "📡 Red WiFi: %s", ap_ssid);
+  imprimirlnf(Serial, "🔑 Password: %s", ap_password);
+  imprimirlnf(Serial, "🌍 IP: http://%u.%u.%u.%u", IP[0], IP[1], IP[2], IP[3]);
   
   // Rutas del servidor
-  server.on("/", HTTP_GET, handleRoot);
-  server.on("/list", HTTP_GET, handleFileList);
-  server.on("/download", HTTP_GET, handleFileDownload);
-  server.on("/delete", HTTP_GET, handleFileDelete);
+  registrarRuta("/", HTTP_GET, handleRoot);
+  registrarRuta("/list", HTTP_GET, handleFileList);
+  registrarRuta("/download", HTTP_GET, handleFileDownload);
+  registrarRuta("/delete", HTTP_GET, handleFileDelete);
+  registrarRuta("/resultados", HTTP_GET, handleResultados);
+  registrarRuta("/wifi", HTTP_GET, handleWiFi);
+  registrarRuta("/ble", HTTP_GET, handleBLE);
+  registrarRuta("/heap", HTTP_GET, handleHeap);
+  registrarRuta("/muestras", HTTP_GET, handleMuestras);
+  registrarRuta("/metrics", HTTP_GET, handleMetrics);
+  registrarRuta("/eventos", HTTP_GET, handleEventos);
+  registrarRuta("/veredicto", HTTP_GET, handleVeredicto);
+  registrarRuta("/upload", HTTP_POST, handleUploadFin, handleUploadMultipart);
+  registrarRuta("/upload", HTTP_PUT, handleUploadFin, handleUploadRaw);
+  
+  // If-None-Match para el 304 de la página principal; Range/If-Range para descargas;
+  // Accept-Encoding para servir las exportaciones .gz tal cual o descomprimidas;
+  // Last-Event-ID para que /eventos siga donde se quedó el navegador
+  const char* cabeceras[] = {"If-None-Match", "Range", "If-Range", "Accept-Encoding", "Last-Event-ID"};
+  server.collectHeaders(cabeceras, sizeof(cabeceras) / sizeof(cabeceras[0]));
   
   server.begin();
   servidorWebActivo = true;
@@ -190,13 +511,85 @@ void comandoWebServer() {
   iniciarServidorWeb();
   
   Serial.println("\n📱 INSTRUCCIONES:");
-  Serial.println("1. Conecta tu teléfono/PC a la red WiFi: " + String(ap_ssid));
-  Serial.println("2. Usa la contraseña: " + String(ap_password));
+  imprimirlnf(Serial, "1. Conecta tu teléfono/PC a la red WiFi: %s", ap_ssid);
+  imprimirlnf(Serial, "2. Usa la contraseña: %s", ap_password);
   Serial.println("3. Abra el navegador y ve a: http://192.168.4.1");
   Serial.println("\n⚠️ El servidor quedará activo. Usa 'reset' para reiniciar.");
 }
 
-// Función para descargar archivos
+// Copia [inicio, inicio+len) del archivo al cliente con un buffer fijo.
+// DESCARGA_BUFFER es múltiplo de la página de SPIFFS (256 B) y cubre varios
+// segmentos TCP por escritura; al ser estático, el heap no crece con el archivo.
+static uint8_t bufferDescarga[DESCARGA_BUFFER];
+
+static size_t copiarAlCliente(File& file, uint32_t inicio, uint32_t len) {
+  uint8_t* buffer = bufferDescarga;
+  if (!file.seek(inicio)) return 0;
+  WiFiClient cliente = server.client();
+  size_t enviados = 0;
+  while (enviados < len) {
+    size_t n = file.read(buffer, min((size_t)(len - enviados), sizeof(bufferDescarga)));
+    if (n == 0) break;
+    size_t escritos = cliente.write(buffer, n);
+    enviados += escritos;
+    if (escritos < n) break;  // el cliente cortó la conexión
+  }
+  return enviados;
+}
+
+// Exportación comprimida para un cliente sin gzip: se descomprime al vuelo
+// por el mismo buffer; el tamaño original está en la cola del .gz
+static size_t descomprimirAlCliente(File& file) {
+  static DescompresorGzip descompresor;
+  if (!descompresor.iniciar(file)) return 0;
+  WiFiClient cliente = server.client();
+  size_t enviados = 0;
+  size_t n;
+  while ((n = descompresor.leer(bufferDescarga, sizeof(bufferDescarga))) > 0) {
+    size_t escritos = cliente.write(bufferDescarga, n);
+    enviados += escritos;
+    if (escritos < n) break;
+  }
+  if (descompresor.error()) Serial.println("⚠️ Exportación .gz dañada: descarga cortada");
+  return enviados;
+}
+
+// "/diagnostico_....txt.gz": las exportaciones que escribe exportarDatosArchivo()
+static bool esExportacionGzip(const char* nombre) {
+  size_t n = strlen(nombre);
+  return strncmp(nombre, "/diagnostico_", 13) == 0 && n > 3 && strcmp(nombre + n - 3, ".gz") == 0;
+}
+
+// Tipo MIME por la extensión que queda al quitar el .gz
+static const char* tipoExportacion(const char* nombre) {
+  size_t n = strlen(nombre) - 3;
+  if (n >= 5 && strncmp(nombre + n - 5, ".json", 5) == 0) return "application/json";
+  if (n >= 4 && strncmp(nombre + n - 4, ".csv", 4) == 0) return "text/csv; charset=utf-8";
+  return "text/plain; charset=utf-8";
+}
+
+// Accept-Encoding incluye gzip (y no con q=0)
+static bool clienteAceptaGzip() {
+  String cabecera = server.header("Accept-Encoding");
+  const char* p = strstr(cabecera.c_str(), "gzip");
+  if (!p) return false;
+  p += 4;
+  while (*p == ' ') p++;
+  if (strncmp(p, ";q=0", 4) != 0) return true;
+  for (p += 4; *p == '0' || *p == '.'; p++) {
+  }
+  return *p != '\0' && *p != ',' && *p != ' ';
+}
+
+// Cabecera de cada parte de una respuesta multipart/byteranges
+static size_t cabeceraParte(char* buf, size_t len, const RangoBytes& r, size_t tamano) {
+  return snprintf(buf, len,
+                  "\r\n--" DESCARGA_SEPARADOR "\r\nContent-Type: application/octet-stream\r\n"
+                  "Content-Range: bytes %u-%u/%u\r\n\r\n",
+                  (unsigned)r.inicio, (unsigned)r.fin, (unsigned)tamano);
+}
+
+// Función para descargar archivos (admite Range/If-Range para reanudar)
 void handleFileDownload() {
   if (!server.hasArg("file")) {
     server.send(400, "text/plain", "Parámetro 'file' requerido");
@@ -210,11 +603,11 @@ void handleFileDownload() {
     filename = "/" + filename;
   }
   
-  Serial.println("📥 Intentando descargar: " + filename);
+  imprimirlnf(Serial, "📥 Intentando descargar: %s", filename.c_str());
   
   // Verificar que el archivo existe
   if (!SPIFFS.exists(filename)) {
-    Serial.println("❌ Archivo no encontrado: " + filename);
+    imprimirlnf(Serial, "❌ Archivo no encontrado: %s", filename.c_str());
     server.send(404, "text/plain", "Archivo no encontrado: " + filename);
     return;
   }
@@ -222,31 +615,147 @@ void handleFileDownload() {
   File file = SPIFFS.open(filename, "r");
   
   if (!file) {
-    Serial.println("❌ Error al abrir archivo: " + filename);
+    imprimirlnf(Serial, "❌ Error al abrir archivo: %s", filename.c_str());
     server.send(500, "text/plain", "Error al abrir archivo");
     return;
   }
   
-  // Obtener tamaño del archivo
   size_t fileSize = file.size();
-  Serial.println("📊 Tamaño del archivo: " + String(fileSize) + " bytes");
+  imprimirlnf(Serial, "📊 Tamaño del archivo: %u bytes", (unsigned)fileSize);
+  
+  // Exportación .gz: tal cual con Content-Encoding si el cliente acepta gzip;
+  // si no, descomprimida al vuelo, completa (los rangos son del .gz)
+  bool gzip = esExportacionGzip(filename.c_str());
+  bool descomprimir = gzip && !clienteAceptaGzip();
+  uint32_t original = 0;
+  if (descomprimir && !DescompresorGzip::tamanoOriginal(file, original)) {
+    // Sin la cola del .gz no hay Content-Length, y el cliente no acepta el .gz tal cual
+    file.close();
+    imprimirlnf(Serial, "❌ Exportación .gz dañada: %s", filename.c_str());
+    server.send(500, "text/plain", "Exportación dañada: no se puede descomprimir");
+    return;
+  }
+  int nombreLen = (int)filename.length() - 1 - (gzip ? 3 : 0);  // sin la "/" ni el .gz
+  TextoFijoN<64> disposicion;
+  disposicion.printf("attachment; filename=\"%.*s\"", nombreLen, filename.c_str() + 1);
+  server.sendHeader("Content-Disposition", disposicion.c_str());
+  const char* tipo = "application/octet-stream";
+  if (gzip) {
+    server.sendHeader("Vary", "Accept-Encoding");
+    tipo = tipoExportacion(filename.c_str());
+    if (descomprimir) {
+      unsigned long inicio = micros();
+      server.setContentLength(original);
+      server.send(200, tipo, "");
+      size_t sent = descomprimirAlCliente(file);
+      file.close();
+      if (sent != original) {
+        // Content-Length prometía original: sin cerrar, el cliente esperaría lo que falta
+        server.client().stop();
+        imprimirlnf(Serial, "❌ Descompresión cortada: %u de %u bytes enviados", (unsigned)sent, (unsigned)original);
+        return;
+      }
+      unsigned long us = max(micros() - inicio, 1UL);
+      imprimirlnf(Serial, "🗜️ Descomprimido al vuelo: %u -> %u bytes, %.1f KB/s", (unsigned)fileSize,
+                  (unsigned)sent, (double)sent * 1000000.0 / 1024.0 / us);
+      return;
+    }
+    server.sendHeader("Content-Encoding", "gzip");
+  }
+  
+  // El ETag identifica la versión del archivo para If-Range
+  char etag[24];
+  snprintf(etag, sizeof(etag), "\"%x-%x\"", (unsigned)fileSize, (unsigned)file.getLastWrite());
+  
+  RangoBytes rangos[RANGOS_MAX];
+  int nRangos = RANGO_IGNORAR;
+  if (server.hasHeader("Range")) {
+    // Con If-Range solo se honra el rango si el archivo no cambió; si no, va completo
+    String ifRange = server.header("If-Range");
+    if (ifRange.length() == 0 || ifRange == etag) {
+      nRangos = parsearRangos(server.header("Range").c_str(), fileSize, rangos, RANGOS_MAX);
+    }
+  }
+  
+  server.sendHeader("Accept-Ranges", "bytes");
+  server.sendHeader("ETag", etag);
   
-  // Configurar headers para descarga - nombre sin la barra inicial
-  String downloadName = filename.substring(1); // Quitar la "/" inicial
-  server.sendHeader("Content-Disposition", "attachment; filename=\"" + downloadName + "\"");
-  server.sendHeader("Content-Type", "application/octet-stream");
-  server.sendHeader("Content-Length", String(fileSize));
+  char contentRange[48];
+  if (nRangos == RANGO_NO_SATISFACIBLE) {
+    snprintf(contentRange, sizeof(contentRange), "bytes */%u", (unsigned)fileSize);
+    server.sendHeader("Content-Range", contentRange);
+    server.send(416, "text/plain", "");
+    file.close();
+    Serial.println("⚠️ Rango fuera del archivo (416)");
+    return;
+  }
   
-  //  usar streamFile
-  size_t sent = server.streamFile(file, "application/octet-stream");
+  unsigned long inicio = micros();
+  size_t esperado = 0;
+  size_t sent = 0;
+  
+  if (nRangos == RANGO_IGNORAR) {
+    esperado = fileSize;
+    server.setContentLength(fileSize);
+    server.send(200, tipo, "");
+    sent = copiarAlCliente(file, 0, fileSize);
+  } else if (nRangos == 1) {
+    esperado = rangos[0].longitud();
+    snprintf(contentRange, sizeof(contentRange), "bytes %u-%u/%u", (unsigned)rangos[0].inicio,
+             (unsigned)rangos[0].fin, (unsigned)fileSize);
+    server.sendHeader("Content-Range", contentRange);
+    server.setContentLength(esperado);
+    server.send(206, tipo, "");
+    sent = copiarAlCliente(file, rangos[0].inicio, esperado);
+    imprimirlnf(Serial, "✂️ Rango %s", contentRange + 6);
+  } else {
+    // multipart/byteranges: la longitud total se conoce antes de enviar
+    static const char cierre[] = "\r\n--" DESCARGA_SEPARADOR "--\r\n";
+    char cabecera[128];
+    size_t total = sizeof(cierre) - 1;
+    for (int i = 0; i < nRangos; i++) {
+      total += cabeceraParte(cabecera, sizeof(cabecera), rangos[i], fileSize) + rangos[i].longitud();
+      esperado += rangos[i].longitud();
+    }
+    server.setContentLength(total);
+    server.send(206, "multipart/byteranges; boundary=" DESCARGA_SEPARADOR, "");
+    WiFiClient cliente = server.client();
+    for (int i = 0; i < nRangos; i++) {
+      size_t n = cabeceraParte(cabecera, sizeof(cabecera), rangos[i], fileSize);
+      cliente.write((const uint8_t*)cabecera, n);
+      sent += copiarAlCliente(file, rangos[i].inicio, rangos[i].longitud());
+    }
+    cliente.write((const uint8_t*)cierre, sizeof(cierre) - 1);
+    imprimirlnf(Serial, "✂️ %d rangos (multipart/byteranges)", nRangos);
+  }
   file.close();
   
-  if (sent == fileSize) {
-    Serial.println("✅ Archivo descargado exitosamente: " + filename);
-    Serial.println("📊 Bytes enviados: " + String(sent));
+  unsigned long us = max(micros() - inicio, 1UL);
+  if (sent == esperado) {
+    imprimirlnf(Serial, "✅ Archivo descargado exitosamente: %s", filename.c_str());
+    imprimirlnf(Serial, "📊 Bytes enviados: %u", (unsigned)sent);
   } else {
-    Serial.println("⚠️ Advertencia: Enviados " + String(sent) + "/" + String(fileSize) + " bytes");
+    imprimirlnf(Serial, "⚠️ Advertencia: Enviados %u/%u bytes", (unsigned)sent, (unsigned)esperado);
   }
+  imprimirlnf(Serial, "⚡ Velocidad: %.1f KB/s", (double)sent * 1000000.0 / 1024.0 / us);
+}
+
+// Página que confirma (o no) el borrado y vuelve a / tras unos segundos
+static void responderBorrado(int codigo, const char* archivo) {
+  bool ok = codigo == 200;
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(codigo, "text/html", "");
+  SalidaHTTP salida;
+  imprimirf(salida,
+            "<!DOCTYPE html><html><head><meta charset='UTF-8'><meta http-equiv='refresh' content='%d; url=/'>"
+            "<title>%s</title><style>body{font-family:Arial;text-align:center;margin-top:50px;%s}</style>"
+            "</head><body>",
+            ok ? 2 : 3, ok ? "Archivo Eliminado" : "Error", ok ? "" : "color:red;");
+  imprimirf(salida, "<h2>%s</h2><p>%s<strong>%s</strong></p>", ok ? "✅ Archivo eliminado exitosamente" : "❌ Error eliminando archivo",
+            ok ? "Archivo: " : "No se pudo eliminar: ", archivo);
+  imprimirf(salida, "<p>Redirigiendo en %d segundos...</p><p><a href='/'>Volver al inicio</a></p></body></html>", ok ? 2 : 3);
+  salida.vaciar();
+  server.sendContent("");
 }
 
 // Función para eliminar archivos
@@ -263,330 +772,584 @@ void handleFileDelete() {
     filename = "/" + filename;
   }
   
-  Serial.println("🗑️ Intentando eliminar: " + filename);
+  imprimirlnf(Serial, "🗑️ Intentando eliminar: %s", filename.c_str());
   
   // Verificar que el archivo existe antes de intentar eliminarlo
   if (!SPIFFS.exists(filename)) {
-    Serial.println("❌ Archivo no encontrado: " + filename);
+    imprimirlnf(Serial, "❌ Archivo no encontrado: %s", filename.c_str());
     server.send(404, "text/plain", "Archivo no encontrado: " + filename);
     return;
   }
   
   // Intentar eliminar el archivo
   if (SPIFFS.remove(filename)) {
-    Serial.println("✅ Archivo eliminado exitosamente: " + filename);
-    
+    indiceArchivos.invalidar();
+    exportaciones.olvidar(filename.c_str());
+    imprimirlnf(Serial, "✅ Archivo eliminado exitosamente: %s", filename.c_str());
     // Respuesta HTML  que redirije de vuelta
-    String html = "<!DOCTYPE html><html><head>";
-    html += "<meta charset='UTF-8'>";
-    html += "<meta http-equiv='refresh' content='2; url=/'>";
-    html += "<title>Archivo Eliminado</title>";
-    html += "<style>body{font-family:Arial;text-align:center;margin-top:50px;}</style>";
-    html += "</head><body>";
-    html += "<h2>✅ Archivo eliminado exitosamente</h2>";
-    html += "<p>Archivo: <strong>" + filename + "</strong></p>";
-    html += "<p>Redirigiendo en 2 segundos...</p>";
-    html += "<p><a href='/'>Volver al inicio</a></p>";
-    html += "</body></html>";
-    
-    server.send(200, "text/html", html);
+    responderBorrado(200, filename.c_str());
   } else {
-    Serial.println("❌ Error eliminando archivo: " + filename);
-    
-    String html = "<!DOCTYPE html><html><head>";
-    html += "<meta charset='UTF-8'>";
-    html += "<meta http-equiv='refresh' content='3; url=/'>";
-    html += "<title>Error</title>";
-    html += "<style>body{font-family:Arial;text-align:center;margin-top:50px;color:red;}</style>";
-    html += "</head><body>";
-    html += "<h2>❌ Error eliminando archivo</h2>";
-    html += "<p>No se pudo eliminar: <strong>" + filename + "</strong></p>";
-    html += "<p>Redirigiendo en 3 segundos...</p>";
-    html += "<p><a href='/'>Volver al inicio</a></p>";
-    html += "</body></html>";
-    
-    server.send(500, "text/html", html);
+    imprimirlnf(Serial, "❌ Error eliminando archivo: %s", filename.c_str());
+    responderBorrado(500, filename.c_str());
+  }
+}
+
+// === SUBIDA DE ARCHIVOS ===
+// POST /upload (multipart, formulario web) o PUT /upload?file=/nombre (cuerpo crudo).
+// Los bloques del servidor se acumulan en un buffer fijo y se escriben a SPIFFS
+// cuando se llena, así el heap no depende del tamaño del archivo. Se escribe en
+// SUBIDA_TEMPORAL: una subida fallida no se lleva por delante la copia anterior.
+
+struct EstadoSubida {
+  File archivo;
+  char ruta[32];
+  size_t bytes;
+  size_t pendientes;     // bytes en bufferSubida aún sin escribir
+  unsigned long inicio;
+  unsigned long duracion;
+  bool activa;
+  int codigo;            // respuesta final de handleUploadFin
+  const char* error;
+};
+static EstadoSubida subida;
+static uint8_t bufferSubida[SUBIDA_BUFFER];
+
+// Nombre base con "/" delante; false si está vacío o no cabe en SPIFFS
+static bool rutaSubida(const String& nombre, char* ruta, size_t len) {
+  int barra = max(nombre.lastIndexOf('/'), nombre.lastIndexOf('\\'));
+  String base = nombre.substring(barra + 1);
+  if (base.length() == 0 || base == "." || base == ".." || base.length() + 2 > len) return false;
+  snprintf(ruta, len, "/%s", base.c_str());
+  return true;
+}
+
+static void fallarSubida(int codigo, const char* error) {
+  if (subida.archivo) subida.archivo.close();
+  if (SPIFFS.exists(SUBIDA_TEMPORAL)) {
+    SPIFFS.remove(SUBIDA_TEMPORAL);
+    indiceArchivos.invalidar();
+  }
+  subida.codigo = codigo;
+  subida.error = error;
+  imprimirlnf(Serial, "❌ Subida cancelada: %s", error);
+}
+
+static void iniciarSubida(const String& nombre, size_t longitud) {
+  subida.bytes = 0;
+  subida.pendientes = 0;
+  subida.activa = true;
+  subida.codigo = 200;
+  subida.error = nullptr;
+
+  if (!rutaSubida(nombre, subida.ruta, sizeof(subida.ruta))) {
+    fallarSubida(400, "Nombre de archivo no válido");
+    return;
+  }
+  // El índice y las exportaciones que lleva son del almacén: pisarlos lo dejaría desfasado
+  if (strcmp(subida.ruta, EXPORTAR_INDICE) == 0 || exportaciones.buscar(subida.ruta)) {
+    fallarSubida(409, "Archivo reservado para las exportaciones");
+    return;
+  }
+  if (strcmp(subida.ruta, SUBIDA_TEMPORAL) == 0) {
+    fallarSubida(409, "Archivo reservado para las subidas");
+    return;
+  }
+
+  // Espacio libre antes de escribir nada. La copia anterior sigue ocupando
+  // hasta el final; un temporal que dejó un corte de corriente se reutiliza
+  size_t libre = SPIFFS.totalBytes() - SPIFFS.usedBytes();
+  if (SPIFFS.exists(SUBIDA_TEMPORAL)) {
+    File resto = SPIFFS.open(SUBIDA_TEMPORAL, "r");
+    libre += resto.size();
+    resto.close();
+  }
+  if (longitud > libre) {
+    fallarSubida(507, "Espacio insuficiente en SPIFFS");
+    return;
+  }
+
+  subida.archivo = SPIFFS.open(SUBIDA_TEMPORAL, "w");
+  if (!subida.archivo) {
+    fallarSubida(500, "No se pudo crear el archivo");
+    return;
   }
+  imprimirlnf(Serial, "📤 Subiendo: %s (%u bytes)", subida.ruta, (unsigned)longitud);
+  subida.inicio = micros();
 }
 
-// Función para listar archivos 
+static void vaciarSubida() {
+  if (subida.pendientes == 0 || subida.error) return;
+  size_t escritos = subida.archivo.write(bufferSubida, subida.pendientes);
+  if (escritos < subida.pendientes) {
+    fallarSubida(507, "SPIFFS lleno durante la escritura");
+    return;
+  }
+  subida.bytes += escritos;
+  subida.pendientes = 0;
+}
+
+static void escribirSubida(const uint8_t* datos, size_t len) {
+  while (len > 0 && !subida.error) {
+    size_t n = min(len, sizeof(bufferSubida) - subida.pendientes);
+    memcpy(bufferSubida + subida.pendientes, datos, n);
+    subida.pendientes += n;
+    datos += n;
+    len -= n;
+    if (subida.pendientes == sizeof(bufferSubida)) vaciarSubida();
+  }
+}
+
+static void terminarSubida(bool abortada) {
+  if (subida.error) return;
+  if (abortada) {
+    fallarSubida(400, "Conexión interrumpida");
+    return;
+  }
+  vaciarSubida();
+  if (subida.error) return;
+  subida.archivo.close();
+  // SPIFFS no renombra sobre un archivo existente: la copia anterior se borra justo antes
+  if (SPIFFS.exists(subida.ruta) && !SPIFFS.remove(subida.ruta)) {
+    fallarSubida(500, "No se pudo reemplazar el archivo");
+    return;
+  }
+  if (!SPIFFS.rename(SUBIDA_TEMPORAL, subida.ruta)) {
+    fallarSubida(500, "No se pudo renombrar el archivo subido");
+    return;
+  }
+  subida.duracion = max(micros() - subida.inicio, 1UL);
+  indiceArchivos.invalidar();
+  imprimirlnf(Serial, "✅ Subida completa: %s (%u bytes, %.1f KB/s)", subida.ruta, (unsigned)subida.bytes,
+              (double)subida.bytes * 1000000.0 / 1024.0 / subida.duracion);
+}
+
+void handleUploadMultipart() {
+  HTTPUpload& upload = server.upload();
+  if (upload.status == UPLOAD_FILE_START) {
+    // El Content-Length incluye las cabeceras multipart: cota superior del archivo
+    iniciarSubida(upload.filename, server.clientContentLength());
+  } else if (upload.status == UPLOAD_FILE_WRITE) {
+    escribirSubida(upload.buf, upload.currentSize);
+  } else {
+    terminarSubida(upload.status == UPLOAD_FILE_ABORTED);
+  }
+}
+
+void handleUploadRaw() {
+  HTTPRaw& raw = server.raw();
+  if (raw.status == RAW_START) {
+    iniciarSubida(server.arg("file"), server.clientContentLength());
+  } else if (raw.status == RAW_WRITE) {
+    escribirSubida(raw.buf, raw.currentSize);
+  } else {
+    terminarSubida(raw.status == RAW_ABORTED);
+  }
+}
+
+// Respuesta final, cuando el cuerpo ya se consumió
+void handleUploadFin() {
+  char json[160];
+  if (!subida.activa) {
+    server.send(400, "application/json", "{\"error\":\"No se recibió ningún archivo\"}");
+  } else if (subida.error) {
+    snprintf(json, sizeof(json), "{\"error\":\"%s\"}", subida.error);
+    server.send(subida.codigo, "application/json", json);
+  } else {
+    snprintf(json, sizeof(json), "{\"file\":\"%s\",\"size\":%u,\"kbps\":%.1f}", subida.ruta,
+             (unsigned)subida.bytes, (double)subida.bytes * 1000000.0 / 1024.0 / subida.duracion);
+    server.send(200, "application/json", json);
+  }
+  subida.activa = false;
+}
+
+// Metadatos de una exportación para /list, del índice del almacén
+static void detallesExportacion(Print& out, const EntradaArchivo& archivo) {
+  const EntradaExportacion* e = exportaciones.buscar(archivo.nombre);
+  if (!e) return;
+  imprimirf(out, ",\"export\":{\"seq\":%lu,\"format\":\"%s\",\"gzip\":%s,\"original\":%lu,\"uptime\":%lu,\"records\":%u,"
+                 "\"sections\":\"", (unsigned long)e->seq, AlmacenExportaciones::nombreFormato(e->formato),
+            e->gzip ? "true" : "false", (unsigned long)e->original, (unsigned long)e->uptime, e->registros);
+  AlmacenExportaciones::imprimirSecciones(out, e->secciones, ",");
+  out.print("\"}");
+}
+
+// Función para listar archivos: página del índice en RAM como JSON chunked
+//   /list?offset=0&limit=50&sort=name|size|mtime&order=asc|desc
 void handleFileList() {
-  String json = "{\"files\":[";
-  
-  File root = SPIFFS.open("/");
-  if (!root) {
+  if (!indiceArchivos.actualizar()) {
     server.send(500, "application/json", "{\"error\":\"Cannot open root directory\"}");
     return;
   }
   
-  File file = root.openNextFile();
-  bool first = true;
-  int fileCount = 0;
-  
-  while (file) {
-    if (!file.isDirectory()) {
-      if (!first) json += ",";
-      
-      String fileName = String(file.name());
-      size_t fileSize = file.size();
-      
-      json += "{";
-      json += "\"name\":\"" + fileName + "\",";
-      json += "\"size\":" + String(fileSize);
-      json += "}";
-      
-      first = false;
-      fileCount++;
-    }
-    file = root.openNextFile();
+  size_t offset = server.hasArg("offset") ? (size_t)max(0L, server.arg("offset").toInt()) : 0;
+  size_t limit = server.hasArg("limit") ? (size_t)max(0L, server.arg("limit").toInt()) : LIST_LIMITE_DEFECTO;
+  if (limit == 0 || limit > LIST_LIMITE_MAX) limit = LIST_LIMITE_MAX;
+  
+  OrdenIndice orden = ORDEN_NOMBRE;
+  String sort = server.arg("sort");
+  if (sort == "size") orden = ORDEN_TAMANO;
+  else if (sort == "mtime") orden = ORDEN_FECHA;
+  bool descendente = server.arg("order") == "desc";
+  
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  SalidaHTTP salida;
+  indiceArchivos.imprimirJSON(salida, offset, limit, orden, descendente, detallesExportacion);
+  salida.vaciar();
+  server.sendContent("");
+}
+
+// Resultados generados al vuelo desde la bitácora: /resultados?formato=txt|json|csv
+void handleResultados() {
+  FormatoSalida formato = FMT_TXT;
+  const char* tipo = "text/plain; charset=utf-8";
+  String f = server.arg("formato");
+  if (f == "json") {
+    formato = FMT_JSON;
+    tipo = "application/json";
+  } else if (f == "csv") {
+    formato = FMT_CSV;
+    tipo = "text/csv; charset=utf-8";
+  }
+
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, tipo, "");
+  SalidaHTTP salida;
+  historial.exportar(salida, formato);
+  salida.vaciar();
+  server.sendContent("");
+}
+
+// Redes de la caché al instante. Si caducó se devuelve igualmente (con su edad)
+// y se lanza un refresco en segundo plano; ?refrescar=1 lo fuerza
+void handleWiFi() {
+  bool refrescar = !cacheWiFi.vigente() || server.arg("refrescar") == "1";
+  if (refrescar) cacheWiFi.iniciarEscaneo();
+  if (cacheWiFi.escaneando() && !planificador.activa(refrescarWiFi)) {
+    planificador.lanzar("wifi", refrescarWiFi);
   }
   
-  json += "],";
-  json += "\"count\":" + String(fileCount) + ",";
-  json += "\"used\":" + String(SPIFFS.usedBytes()) + ",";
-  json += "\"total\":" + String(SPIFFS.totalBytes());
-  json += "}";
-  
-  Serial.println("📋 Listando " + String(fileCount) + " archivos");
-  server.send(200, "application/json", json);
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  SalidaHTTP salida;
+  cacheWiFi.imprimirJSON(salida);
+  salida.vaciar();
+  server.sendContent("");
+}
+
+// Tabla de dispositivos BLE (la del modo continuo o la del último escaneo)
+void handleBLE() {
+  procesarColaBLE();
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  SalidaHTTP salida;
+  tablaBLE.imprimirJSON(salida);
+  salida.vaciar();
+  server.sendContent("");
+}
+
+// Serie temporal del heap en JSON (o CSV con ?formato=csv)
+void handleHeap() {
+  bool csv = server.arg("formato") == "csv";
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, csv ? "text/csv; charset=utf-8" : "application/json", "");
+  SalidaHTTP salida;
+  if (csv) serieHeap.imprimirCSV(salida);
+  else serieHeap.imprimirJSON(salida);
+  salida.vaciar();
+  server.sendContent("");
 }
 
-// Página principal mejorada con mejor manejo de errores
+// Muestreo periódico agregado por ventanas: ?ventana=<s> (por defecto 60, 0 = sin
+// agregar) y ?formato=csv
+void handleMuestras() {
+  bool csv = server.arg("formato") == "csv";
+  uint32_t ventanaMs = server.hasArg("ventana") ? server.arg("ventana").toInt() * 1000UL : 60000UL;
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, csv ? "text/csv; charset=utf-8" : "application/json", "");
+  SalidaHTTP salida;
+  if (csv) serieMuestras.imprimirCSV(salida, ventanaMs);
+  else serieMuestras.imprimirJSON(salida, ventanaMs);
+  salida.vaciar();
+  server.sendContent("");
+}
+
+// Métricas para Prometheus, escritas por el buffer fijo de SalidaHTTP
+void handleMetrics() {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/plain; version=0.0.4; charset=utf-8", "");
+  SalidaHTTP salida;
+
+  FotoHeap f;
+  fotoHeap(MALLOC_CAP_DEFAULT, f);
+  metrica(salida, "esp32_heap_total_bytes", "gauge", "Tamaño del heap por defecto", f.total);
+  metrica(salida, "esp32_heap_libre_bytes", "gauge", "Bytes libres del heap", f.libre);
+  metrica(salida, "esp32_heap_mayor_bloque_bytes", "gauge", "Mayor bloque libre del heap", f.mayorBloque);
+  metrica(salida, "esp32_heap_minimo_libre_bytes", "gauge", "Mínimo de bytes libres desde el arranque", f.minimoLibre);
+  metrica(salida, "esp32_heap_bloques_libres", "gauge", "Bloques libres del heap", f.bloquesLibres);
+  metricaCabecera(salida, "esp32_heap_fragmentacion_ratio", "gauge", "1 - mayor bloque libre / bytes libres");
+  metricaValor(salida, "esp32_heap_fragmentacion_ratio", f.fragmentacion() / 100.0f, 2);
+
+  metrica(salida, "esp32_uptime_segundos", "counter", "Segundos desde el arranque", millis() / 1000);
+  esp_reset_reason_t razon = esp_reset_reason();
+  metricaCabecera(salida, "esp32_reset_razon", "gauge", "Razón del último reinicio (siempre 1)");
+  imprimirf(salida, "esp32_reset_razon{codigo=\"%d\",razon=", (int)razon);
+  metricaEtiqueta(salida, textoRazonReset(razon));
+  salida.print("} 1\n");
+  metricaCabecera(salida, "esp32_temperatura_celsius", "gauge", "Temperatura interna del chip");
+  metricaValor(salida, "esp32_temperatura_celsius", temperatureRead(), 1);
+
+  metrica(salida, "esp32_spiffs_total_bytes", "gauge", "Capacidad de SPIFFS", SPIFFS.totalBytes());
+  metrica(salida, "esp32_spiffs_usado_bytes", "gauge", "Bytes ocupados en SPIFFS", SPIFFS.usedBytes());
+
+  metricasHTTP.imprimir(salida);
+
+  metrica(salida, "esp32_eventos_clientes", "gauge", "Clientes conectados a /eventos", eventos.clientes());
+  metrica(salida, "esp32_eventos_total", "counter", "Eventos enviados a /eventos", eventos.eventos());
+  metrica(salida, "esp32_eventos_bytes_total", "counter", "Bytes aceptados por los sockets de /eventos",
+          eventos.bytesEnviados());
+  metrica(salida, "esp32_eventos_desfases_total", "counter", "Clientes que perdieron historial por ir lentos",
+          eventos.desfases());
+  metrica(salida, "esp32_eventos_atascados_total", "counter", "Clientes desconectados por no leer",
+          eventos.atascados());
+
+  metrica(salida, "esp32_exportaciones", "gauge", "Exportaciones guardadas en SPIFFS", exportaciones.cantidad());
+  metrica(salida, "esp32_exportaciones_bytes", "gauge", "Bytes que ocupan las exportaciones", exportaciones.bytes());
+  metrica(salida, "esp32_exportaciones_expulsadas_total", "counter", "Exportaciones borradas por la rotación",
+          exportaciones.expulsadas());
+  metrica(salida, "esp32_respaldo_guardados_total", "counter", "Respaldos de la bitácora con datos nuevos",
+          respaldo.guardados());
+  metrica(salida, "esp32_respaldo_paginas_total", "counter", "Páginas del diario reescritas en NVS",
+          respaldo.paginasEscritas());
+  metrica(salida, "esp32_respaldo_ultimo_us", "gauge", "Duración del último respaldo", respaldo.ultimoUs());
+  metrica(salida, "esp32_linea_base_metricas", "gauge", "Métricas en la línea base", lineaBase.cantidad());
+  metrica(salida, "esp32_linea_base_regresiones", "gauge", "Regresiones en la última comparación",
+          lineaBase.regresiones());
+  metrica(salida, "esp32_linea_base_comparaciones_total", "counter", "Comparaciones con la línea base",
+          lineaBase.comparaciones());
+  metrica(salida, "esp32_linea_base_con_regresion_total", "counter", "Comparaciones con alguna regresión",
+          lineaBase.conRegresion());
+  metrica(salida, "esp32_wifi_escaneos_total", "counter", "Escaneos WiFi completados", cacheWiFi.escaneos());
+  metrica(salida, "esp32_wifi_redes", "gauge", "Redes encontradas en el último escaneo", cacheWiFi.encontradas());
+  metrica(salida, "esp32_wifi_cache_edad_segundos", "gauge", "Antigüedad del último escaneo",
+          cacheWiFi.tieneDatos() ? cacheWiFi.edadMs() / 1000 : 0);
+  metrica(salida, "esp32_ble_anuncios_total", "counter", "Anuncios BLE recibidos", tablaBLE.paquetes());
+  metrica(salida, "esp32_ble_dispositivos", "gauge", "Dispositivos BLE en la tabla", tablaBLE.cantidad());
+  metrica(salida, "esp32_ble_altas_total", "counter", "Altas en la tabla BLE", tablaBLE.altas());
+  metrica(salida, "esp32_ble_expulsados_total", "counter", "Dispositivos BLE expulsados por LRU", tablaBLE.expulsados());
+  metrica(salida, "esp32_ble_escaneo_continuo", "gauge", "1 si el escaneo BLE continuo está activo",
+          escaneoBLEContinuoActivo() ? 1 : 0);
+
+  salida.vaciar();
+  server.sendContent("");
+}
+
+// Eventos en vivo: la conexión se queda abierta y la atiende eventos.atender() desde loop()
+void handleEventos() {
+  if (!eventos.aceptar(server.client(), server.header("Last-Event-ID"), historial, indiceArchivos)) {
+    server.send(503, "text/plain", "Demasiados clientes de eventos");
+  }
+}
+
+// Veredicto de la última comparación con la línea base (el mismo JSON que LINEA_BASE_VEREDICTO)
+void handleVeredicto() {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  SalidaHTTP salida;
+  lineaBase.imprimirJSON(salida);
+  salida.vaciar();
+  server.sendContent("");
+}
+
+// Página principal: HTML/CSS/JS de web/ minificados y comprimidos en flash
+// (web_assets.h, generado por tools/generar_web.py). Sin heap por petición.
 void handleRoot() {
-  String html = "<!DOCTYPE html><html><head>";
-  html += "<title>ESP32 File Manager</title>";
-  html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-  html += "<meta charset='UTF-8'>";
-  html += "<style>";
-  html += "body { font-family: Arial; margin: 20px; background: #f0f0f0; }";
-  html += ".container { background: white; padding: 20px; border-radius: 10px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }";
-  html += ".file-item { background: #f8f9fa; margin: 10px 0; padding: 15px; border-radius: 5px; border-left: 4px solid #007bff; display: flex; justify-content: space-between; align-items: center; }";
-  html += ".file-info { flex-grow: 1; }";
-  html += ".file-name { font-weight: bold; color: #333; word-break: break-all; }";
-  html += ".file-size { color: #666; font-size: 0.9em; }";
-  html += ".btn { padding: 8px 15px; margin: 0 5px; text-decoration: none; border-radius: 4px; font-size: 0.9em; display: inline-block; }";
-  html += ".btn-download { background: #28a745; color: white; }";
-  html += ".btn-delete { background: #dc3545; color: white; }";
-  html += ".btn:hover { opacity: 0.8; }";
-  html += ".header { text-align: center; margin-bottom: 30px; }";
-  html += ".header h1 { color: #333; }";
-  html += ".stats { background: #e3f2fd; padding: 15px; border-radius: 5px; margin-bottom: 20px; }";
-  html += ".error { background: #f8d7da; color: #721c24; padding: 10px; border-radius: 5px; margin: 10px 0; }";
-  html += ".loading { text-align: center; padding: 20px; color: #666; }";
-  html += "</style></head><body>";
-  
-  html += "<div class='container'>";
-  html += "<div class='header'>";
-  html += "<h1>🗂️ ESP32 File Manager</h1>";
-  html += "<p>Administra archivos del sistema SPIFFS</p>";
-  html += "</div>";
-  html += "<div id='stats' class='stats'>Cargando estadísticas...</div>";
-  html += "<div id='files' class='loading'>Cargando archivos...</div>";
-  html += "</div>";
-  
-  html += "<script>";
-  html += "let errorCount = 0;";
-  html += "function showError(msg) {";
-  html += "  document.getElementById('files').innerHTML = '<div class=\"error\">❌ Error: ' + msg + '</div>';";
-  html += "}";
-  html += "function loadFiles() {";
-  html += "  fetch('/list')";
-  html += "    .then(response => {";
-  html += "      if (!response.ok) throw new Error('HTTP ' + response.status);";
-  html += "      return response.json();";
-  html += "    })";
-  html += "    .then(data => {";
-  html += "      errorCount = 0;"; 
-  html += "      let statsHtml = 'Archivos: ' + data.count + ' | ';";
-  html += "      statsHtml += 'Usado: ' + (data.used/1024).toFixed(1) + ' KB | ';";
-  html += "      statsHtml += 'Total: ' + (data.total/1024).toFixed(1) + ' KB';";
-  html += "      document.getElementById('stats').innerHTML = statsHtml;";
-  html += "      let html = '';";
-  html += "      if (data.files && data.files.length > 0) {";
-  html += "        data.files.forEach(file => {";
-  html += "          let fileName = file.name.startsWith('/') ? file.name.substring(1) : file.name;";
-  html += "          html += '<div class=\"file-item\">';";
-  html += "          html += '<div class=\"file-info\">';";
-  html += "          html += '<div class=\"file-name\">' + file.name + '</div>';";
-  html += "          html += '<div class=\"file-size\">' + (file.size/1024).toFixed(2) + ' KB (' + file.size + ' bytes)</div>';";
-  html += "          html += '</div>';";
-  html += "          html += '<div>';";
-  html += "          html += '<a href=\"/download?file=' + encodeURIComponent(file.name) + '\" class=\"btn btn-download\" target=\"_blank\">📥 Descargar</a>';";
-  html += "          html += '<a href=\"/delete?file=' + encodeURIComponent(file.name) + '\" class=\"btn btn-delete\" onclick=\"return confirm(\\'¿Eliminar ' + file.name + '?\\')\">🗑️ Eliminar</a>';";
-  html += "          html += '</div>';";
-  html += "          html += '</div>';";
-  html += "        });";
-  html += "      } else {";
-  html += "        html = '<div class=\"file-item\"><div class=\"file-info\">📂 No hay archivos guardados</div></div>';";
-  html += "      }";
-  html += "      document.getElementById('files').innerHTML = html;";
-  html += "    })";
-  html += "    .catch(err => {";
-  html += "      errorCount++;";
-  html += "      console.error('Error loading files:', err);";
-  html += "      if (errorCount < 3) {";
-  html += "        setTimeout(loadFiles, 2000);"; // Reintentar en 2 segundos
-  html += "      } else {";
-  html += "        showError('No se pueden cargar los archivos. Error: ' + err.message);";
-  html += "      }";
-  html += "    });";
-  html += "}";
-  html += "loadFiles();";
-  html += "setInterval(function() { if (errorCount < 3) loadFiles(); }, 5000);";
-  html += "</script>";
-  html += "</body></html>";
-  
-  server.send(200, "text/html", html);
+  server.sendHeader("ETag", WEB_INDEX_ETAG);
+  server.sendHeader("Cache-Control", "no-cache");
+  
+  // El navegador ya tiene esta versión: solo revalidar
+  if (server.header("If-None-Match") == WEB_INDEX_ETAG) {
+    server.send(304);
+    return;
+  }
+  
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, "text/html", (const char*)WEB_INDEX_GZ, WEB_INDEX_GZ_LEN);
 }
 // === FUNCIONES PARA OBTENCION DE DATOS ===
 
-void addToHistory(const String& text) {
-  int len = text.length();
-  if (historialIdx + len >= HISTORY_MAX_LEN) {
-    Serial.println("⚠️ Historial de RAM casi lleno. No se puede añadir todo el texto.");
-    len = HISTORY_MAX_LEN - 1 - historialIdx;
-    if (len <= 0) {
-      Serial.println("⚠️ No hay espacio en el historial de RAM. Considera limpiarlo con 'C'.");
-      return;
-    }
+void addToHistory(const char* texto) {
+  historial.nota(texto, strlen(texto));
+}
+
+// Muestra por Serial los registros nuevos desde la última llamada
+void mostrarResultados() {
+  if (telemetria.activa()) {
+    telemetria.enviarRegistros(Serial, historial, cursorSerial.pos);
+    return;
   }
-  
-  memcpy(historialBuffer + historialIdx, text.c_str(), len);
-  historialIdx += len;
-  historialBuffer[historialIdx] = '\0';
+  historial.mostrar(Serial, cursorSerial);
+}
+
+bool compararConLineaBase() {
+  if (!lineaBase.comparar(historial)) return false;
+  lineaBase.escribirVeredicto();
+  indiceArchivos.invalidar();
+  // En modo binario solo queda el veredicto en SPIFFS y /veredicto
+  if (!telemetria.activa()) {
+    Serial.println();
+    lineaBase.imprimirTexto(Serial);
+  }
+  return true;
 }
 
 void limpiarHistorial() {
-  historialIdx = 0;
-  memset(historialBuffer, 0, HISTORY_MAX_LEN);
+  historial.limpiar();
+  cursorSerial.pos = historial.fin();
   Serial.println("🗑️ Historial de comandos en RAM limpiado.");
   addToHistory("--- Historial limpiado manualmente ---\n");
 }
 
+// Añade al respaldo lo nuevo de la bitácora e informa del coste
+void guardarRespaldo() {
+  size_t nuevos = respaldo.guardar(historial);
+  if (nuevos == 0) {
+    Serial.println("✅ Respaldo al día: nada nuevo que escribir");
+    return;
+  }
+  imprimirlnf(Serial, "✅ Respaldo guardado: %u bytes nuevos, %u páginas de %u B en %lu.%03lu ms", (unsigned)nuevos,
+              respaldo.ultimasPaginas(), RESPALDO_PAGINA, (unsigned long)(respaldo.ultimoUs() / 1000),
+              (unsigned long)(respaldo.ultimoUs() % 1000));
+}
+
 // === 1. EXPLORACIÓN DEL CHIP  ===
-void explorarChipSeguro() {
-  String output = "\n🔍 ANÁLISIS DEL CHIP ESP32-C3 \n";
-  output += "============================================\n";
+int32_t explorarChipSeguro(Tarea& t) {
+  historial.seccion(SEC_CHIP);
   
   esp_chip_info_t chip_info;
   esp_chip_info(&chip_info);
   
-  output += "📋 IDENTIFICACIÓN BÁSICA:\n";
-  output += "• Familia: ESP32-C3\n";
-  output += "• Arquitectura: RISC-V 32-bit\n";
-  output += "• Núcleos: " + String(chip_info.cores) + "\n";
-  
-  output += "• WiFi: " + String(chip_info.features & CHIP_FEATURE_WIFI_BGN ? "✅ SÍ" : "❌ NO") + "\n";
-  output += "• Bluetooth: " + String(chip_info.features & CHIP_FEATURE_BT ? "✅ SÍ" : "❌ NO") + "\n";
-  
-  uint8_t revision = chip_info.revision;
-  output += "• Revisión: " + String(revision) + "\n";
+  historial.texto(K_CHIP_FAMILIA, "ESP32-C3");
+  historial.texto(K_CHIP_ARQUITECTURA, "RISC-V 32-bit");
+  historial.u32(K_CHIP_NUCLEOS, chip_info.cores);
+  historial.booleano(K_CHIP_WIFI, chip_info.features & CHIP_FEATURE_WIFI_BGN);
+  historial.booleano(K_CHIP_BT, chip_info.features & CHIP_FEATURE_BT);
+  historial.u32(K_CHIP_REVISION, chip_info.revision);
   
   // Método más seguro para ID del chip usando MAC
   uint64_t chipId = ESP.getEfuseMac();
-  char chipIdStr[20];
-  sprintf(chipIdStr, "%04X%08X", (uint16_t)(chipId>>32), (uint32_t)chipId);
-  output += "• Chip ID: " + String(chipIdStr) + "\n";
+  TextoFijoN<20> chipIdStr;
+  chipIdStr.printf("%04X%08X", (uint16_t)(chipId>>32), (uint32_t)chipId);
+  historial.texto(K_CHIP_ID, chipIdStr.c_str());
   
-  output += "\n💾 INFORMACIÓN DE FLASH:\n";
   uint32_t flashSize = ESP.getFlashChipSize();
+  historial.u32(K_FLASH_TAMANO, flashSize);
   if (flashSize > 0) {
-    output += "• Tamaño: " + String(flashSize/(1024*1024)) + " MB\n";
-    output += "• Velocidad: " + String(ESP.getFlashChipSpeed()/1000000) + " MHz\n";
-  } else {
-    output += "• Tamaño: No determinado\n";
+    historial.u32(K_FLASH_VELOCIDAD, ESP.getFlashChipSpeed());
   }
   
-  size_t sketchSize = ESP.getSketchSize();
-  size_t freeSpace = ESP.getFreeSketchSpace();
-  
-  output += "• Tamaño sketch: " + String(sketchSize/1024) + " KB\n";
-  output += "• Espacio libre: " + String(freeSpace/1024) + " KB\n";
-  
-  output += "• SDK Version: " + String(esp_get_idf_version()) + "\n";
+  historial.u32(K_SKETCH_TAMANO, ESP.getSketchSize());
+  historial.u32(K_SKETCH_LIBRE, ESP.getFreeSketchSpace());
+  historial.texto(K_SDK_VERSION, esp_get_idf_version());
   
-  output += "\n✅ Análisis del chip completado (modo seguro)\n";
-
-  Serial.print(output);
-  addToHistory(output);
+  historial.finSeccion(SEC_CHIP);
+  mostrarResultados();
+  return TAREA_FIN;
 }
 
 // === X. EXPORTAR DATOS ===
-void exportarDatosArchivo() {
+void exportarDatosArchivo(FormatoSalida formato) {
   Serial.println("\n📤 EXPORTACIÓN DE DATOS");
   Serial.println("=================================");
   
-  if (historialIdx == 0) {
+  if (historial.vacio()) {
     Serial.println("❌ No hay datos en el historial para exportar.");
     Serial.println("💡 Ejecuta algún comando o el 'DIAGNÓSTICO COMPLETO' (9) primero.");
     return;
   }
 
-  String timestamp = String(millis());
-  String nombreArchivo = "/diagnostico_" + timestamp + ".txt";
+  // Nombre con la secuencia del almacén, tras hacer sitio si hace falta
+  char nombreArchivo[32];
+  exportaciones.preparar(formato, EXPORTAR_GZIP, historial.bytesUsados() * (EXPORTAR_GZIP ? 1 : 3), nombreArchivo,
+                         sizeof(nombreArchivo));
   
-  Serial.println("💾 Creando archivo: " + nombreArchivo);
+  imprimirlnf(Serial, "💾 Creando archivo: %s", nombreArchivo);
   
   File archivo = SPIFFS.open(nombreArchivo, "w");
   
   if (archivo) {
-    archivo.println("ESP32-C3 MINI - DIAGNOSTICO COMPLETO");
-    archivo.println("====================================");
-    archivo.println("Generado: " + String(millis()/1000) + " segundos desde inicio");
-    archivo.println("Archivo: " + nombreArchivo);
-    archivo.println("");
+    uint32_t inicio = micros();
+    // Con EXPORTAR_GZIP todo pasa por el compresor camino del archivo
+    static CompresorGzip compresor;
+    if (EXPORTAR_GZIP) compresor.iniciar(archivo);
+    Print& salida = EXPORTAR_GZIP ? (Print&)compresor : (Print&)archivo;
+    
+    if (formato == FMT_TXT) {
+      salida.println("ESP32-C3 MINI - DIAGNOSTICO COMPLETO");
+      salida.println("====================================");
+      imprimirlnf(salida, "Generado: %lu segundos desde inicio", (unsigned long)(millis() / 1000));
+      imprimirlnf(salida, "Archivo: %s", nombreArchivo);
+      if (historial.descartados() > 0) {
+        imprimirlnf(salida, "Historial: %lu bytes antiguos descartados", (unsigned long)historial.descartados());
+      }
+      salida.println("");
+    }
     
-    archivo.write((uint8_t*)historialBuffer, historialIdx);
+    // El texto/JSON/CSV se genera aquí desde los registros, directo al archivo
+    historial.exportar(salida, formato);
     
-    archivo.println("");
-    archivo.println("====================================");
-    archivo.println("Fin del diagnóstico - ESP32-C3 MINI");
+    if (formato == FMT_TXT) {
+      salida.println("");
+      salida.println("====================================");
+      salida.println("Fin del diagnóstico - ESP32-C3 MINI");
+    }
     
+    if (EXPORTAR_GZIP) compresor.terminar();
     archivo.close();
+    uint32_t us = micros() - inicio;
+    indiceArchivos.invalidar();
     
     File archivoVerif = SPIFFS.open(nombreArchivo, "r");
     size_t tamano = archivoVerif.size();
     archivoVerif.close();
     
     Serial.println("✅ Archivo creado exitosamente!");
-    Serial.println("📄 Nombre: " + nombreArchivo);
-    Serial.println("📊 Tamaño: " + String(tamano) + " bytes");
+    imprimirlnf(Serial, "📄 Nombre: %s", nombreArchivo);
+    imprimirlnf(Serial, "📊 Tamaño: %u bytes", (unsigned)tamano);
+    if (EXPORTAR_GZIP) {
+      imprimirlnf(Serial, "🗜️ Comprimido: %lu -> %u bytes (%.1f:1)", (unsigned long)compresor.entrada(),
+                  (unsigned)tamano, tamano ? (double)compresor.entrada() / tamano : 0.0);
+    }
+    uint32_t expulsadas = exportaciones.expulsadas();
+    exportaciones.registrar(tamano, EXPORTAR_GZIP ? compresor.entrada() : tamano, historial);
+    imprimirlnf(Serial, "🔁 Exportaciones guardadas: %u de %u, %lu de %lu KB", (unsigned)exportaciones.cantidad(),
+                EXPORTAR_MAX_ARCHIVOS, (unsigned long)(exportaciones.bytes() / 1024),
+                (unsigned long)(EXPORTAR_MAX_BYTES / 1024));
+    if (exportaciones.expulsadas() != expulsadas) {
+      imprimirlnf(Serial, "🧹 Borradas las %lu más antiguas", (unsigned long)(exportaciones.expulsadas() - expulsadas));
+    }
+    imprimirlnf(Serial, "⏱️ Exportado en %lu.%03lu ms", (unsigned long)(us / 1000), (unsigned long)(us % 1000));
     Serial.println("");
     Serial.println("🎯 OPCIONES DE ACCESO:");
     Serial.println("1. Usar comando 'W' para servidor web");
     Serial.println("2. Usar comando 'Y' para ver contenido");
     Serial.println("3. Conectar ESP32 como dispositivo USB");
     
-    Serial.println("💾 Guardando respaldo en EEPROM...");
-    int bytesToSave = min(historialIdx, EEPROM_SIZE - 1);
-    for (int i = 0; i < bytesToSave; i++) {
-      EEPROM.write(i, historialBuffer[i]);
-    }
-    EEPROM.write(bytesToSave, '\0');
-    EEPROM.commit();
-    Serial.println("✅ Respaldo en EEPROM guardado (" + String(bytesToSave) + " bytes)");
+    Serial.println("💾 Guardando respaldo en flash...");
+    guardarRespaldo();
     
   } else {
     Serial.println("❌ Error al crear archivo en SPIFFS");
-    Serial.println("🔄 Usando método de respaldo (EEPROM + copy/paste):");
+    Serial.println("🔄 Usando método de respaldo (flash + copy/paste):");
     
-    Serial.println("💾 Guardando historial en EEPROM...");
-    int bytesToSave = min(historialIdx, EEPROM_SIZE - 1);
-    for (int i = 0; i < bytesToSave; i++) {
-      EEPROM.write(i, historialBuffer[i]);
-    }
-    EEPROM.write(bytesToSave, '\0');
-    EEPROM.commit();
+    Serial.println("💾 Guardando historial en flash...");
+    guardarRespaldo();
 
-    Serial.println("✅ Historial guardado en EEPROM. (" + String(bytesToSave) + " bytes)");
     Serial.println("⬇️ Copia el siguiente texto para exportar:");
-    Serial.println("```text");
-    
-    for (int i = 0; i < bytesToSave; i++) {
-      Serial.print((char)EEPROM.read(i));
-    }
+    Serial.println(formato == FMT_JSON ? "```json" : formato == FMT_CSV ? "```csv" : "```text");
+    historial.exportar(Serial, formato);
     Serial.println("\n```");
-    Serial.println("\n💡 Puedes pegar este texto en un archivo .txt");
+    Serial.println("\n💡 Puedes pegar este texto en un archivo");
   }
 }
 
@@ -594,6 +1357,28 @@ void mostrarArchivosGuardados() {
   Serial.println("\n📁 ARCHIVOS GUARDADOS EN SPIFFS");
   Serial.println("================================");
   
+  // Las exportaciones salen del índice, sin abrir cada archivo
+  char nombre[32];
+  if (exportaciones.cantidad()) {
+    imprimirlnf(Serial, "📤 Exportaciones: %u de %u, %lu de %lu KB (siguiente #%lu)", (unsigned)exportaciones.cantidad(),
+                EXPORTAR_MAX_ARCHIVOS, (unsigned long)(exportaciones.bytes() / 1024),
+                (unsigned long)(EXPORTAR_MAX_BYTES / 1024), (unsigned long)exportaciones.siguiente());
+    for (size_t i = exportaciones.cantidad(); i-- > 0;) {
+      const EntradaExportacion& e = exportaciones.entrada(i);
+      AlmacenExportaciones::nombre(e, nombre, sizeof(nombre));
+      imprimirf(Serial, "📄 %s (%lu bytes", nombre, (unsigned long)e.tamano);
+      if (e.gzip && e.original) imprimirf(Serial, ", %lu sin comprimir", (unsigned long)e.original);
+      imprimirlnf(Serial, ") %s, a los %lu s de encender", AlmacenExportaciones::nombreFormato(e.formato),
+                  (unsigned long)e.uptime);
+      if (e.secciones) {
+        imprimirf(Serial, "   📋 %u registros: ", e.registros);
+        AlmacenExportaciones::imprimirSecciones(Serial, e.secciones, ", ");
+        Serial.println();
+      }
+    }
+    Serial.println("");
+  }
+  
   File root = SPIFFS.open("/");
   if (!root) {
     Serial.println("❌ Error al acceder al sistema de archivos");
@@ -605,526 +1390,663 @@ void mostrarArchivosGuardados() {
     return;
   }
   
-  File file = root.openNextFile();
   int contador = 0;
-  
-  while (file) {
-    if (!file.isDirectory()) {
-      contador++;
-      Serial.println("📄 " + String(file.name()) + " (" + String(file.size()) + " bytes)");
-      
-      String nombre = String(file.name());
-      if (nombre.startsWith("/diagnostico_") && nombre.endsWith(".txt")) {
-        Serial.println("   📋 Contenido (primeras líneas):");
-        file.seek(0);
-        String linea;
-        int lineas = 0;
-        while (file.available() && lineas < 5) {
-          linea = file.readStringUntil('\n');
-          Serial.println("   " + linea);
-          lineas++;
-        }
-        if (file.available()) {
-          Serial.println("   ... (archivo continúa)");
-        }
-        Serial.println("");
-      }
-    }
-    file = root.openNextFile();
+  for (File file = root.openNextFile(); file; file = root.openNextFile()) {
+    if (file.isDirectory() || exportaciones.buscar(file.path())) continue;
+    if (contador++ == 0) Serial.println("📂 Otros archivos:");
+    imprimirlnf(Serial, "📄 %s (%u bytes)", file.name(), (unsigned)file.size());
   }
+  contador += exportaciones.cantidad();
   
   if (contador == 0) {
     Serial.println("🔭 No hay archivos guardados");
     Serial.println("💡 Usa el comando 'X' después de hacer un diagnóstico");
   } else {
-    Serial.println("📊 Total de archivos: " + String(contador));
-    Serial.println("💾 Espacio usado: " + String(SPIFFS.usedBytes()) + " bytes");
-    Serial.println("💾 Espacio total: " + String(SPIFFS.totalBytes()) + " bytes");
+    imprimirlnf(Serial, "📊 Total de archivos: %d", contador);
+    imprimirlnf(Serial, "💾 Espacio usado: %u bytes", (unsigned)SPIFFS.usedBytes());
+    imprimirlnf(Serial, "💾 Espacio total: %u bytes", (unsigned)SPIFFS.totalBytes());
     if (!servidorWebActivo) {
       Serial.println("💡 Usa el comando 'W' para acceso web a los archivos");
     }
   }
 }
 
-void explorarMemoria() {
-  String output = "\n🧠 ANÁLISIS DE MEMORIA\n";
-  output += "=======================\n";
+int32_t explorarMemoria(Tarea& t) {
+  historial.seccion(SEC_MEMORIA);
   
-  output += "📊 HEAP PRINCIPAL:\n";
   uint32_t heapTotal = ESP.getHeapSize();
   uint32_t heapLibre = ESP.getFreeHeap();
   uint32_t heapUsado = heapTotal - heapLibre;
   
-  output += "• Total: " + String(heapTotal/1024) + " KB\n";
-  output += "• Libre: " + String(heapLibre/1024) + " KB\n";
-  output += "• Usado: " + String(heapUsado/1024) + " KB\n";
-  output += "• Utilización: " + String((heapUsado*100)/heapTotal) + "%\n";
+  historial.u32(K_HEAP_TOTAL, heapTotal);
+  historial.u32(K_HEAP_LIBRE, heapLibre);
+  historial.u32(K_HEAP_USADO, heapUsado);
+  historial.u32(K_HEAP_UTILIZACION, (heapUsado*100)/heapTotal);
   
   multi_heap_info_t info;
   heap_caps_get_info(&info, MALLOC_CAP_DEFAULT);
   
-  output += "\n🔍 DETALLES DEL HEAP:\n";
-  output += "• Bloques totales: " + String(info.total_blocks) + "\n";
-  output += "• Bloques libres: " + String(info.free_blocks) + "\n";
-  output += "• Bloque más grande: " + String(info.largest_free_block) + " bytes\n";
-  output += "• Bytes libres: " + String(info.total_free_bytes) + "\n";
+  historial.u32(K_HEAP_BLOQUES, info.total_blocks);
+  historial.u32(K_HEAP_BLOQUES_LIBRES, info.free_blocks);
+  historial.u32(K_HEAP_MAYOR_BLOQUE, info.largest_free_block);
+  historial.u32(K_HEAP_BYTES_LIBRES, info.total_free_bytes);
+  historial.u32(K_HEAP_FRAGMENTACION,
+                info.total_free_bytes ? 100 - (uint64_t)info.largest_free_block * 100 / info.total_free_bytes : 0);
   
-  output += "\n🧪 TEST DE FRAGMENTACIÓN:\n";
   void* testPtr = malloc(1024);
   if (testPtr) {
-    output += "• Asignación de 1KB: ✅ Exitosa\n";
+    historial.booleano(K_HEAP_TEST_ASIGNACION, true);
     free(testPtr);
-    output += "• Liberación: ✅ Exitosa\n";
+    historial.booleano(K_HEAP_TEST_LIBERACION, true);
   } else {
-    output += "• Asignación de 1KB: ❌ Falló\n";
+    historial.booleano(K_HEAP_TEST_ASIGNACION, false);
   }
   
-  output += "\n✅ Análisis de memoria completado\n";
+  historial.finSeccion(SEC_MEMORIA);
+  mostrarResultados();
+  return TAREA_FIN;
+}
 
-  Serial.print(output);
-  addToHistory(output);
+static void ponerU32LE(uint8_t* p, uint32_t v) {
+  for (int b = 0; b < 4; b++) p[b] = (uint8_t)(v >> (8 * b));
 }
 
-void explorarWiFi() {
-  String output = "\n📶 ANÁLISIS DE WIFI\n";
-  output += "====================\n";
-  
-  WiFi.mode(WIFI_OFF);
-  delay(100);
-  WiFi.mode(WIFI_STA);
-  delay(200);
-  
-  output += "📡 INFORMACIÓN BÁSICA:\n";
-  output += "• MAC Address: " + WiFi.macAddress() + "\n";
-  output += "• Modo: Station (STA)\n";
-  
-  output += "\n🔍 ESCANEANDO REDES...\n";
-  Serial.print(output);
-  addToHistory(output);
+// Un paso por clase de tamaño (16 B, 32 B, ... hasta el mayor bloque libre) para
+// no retener loop() mientras se llena el heap; t.i es el exponente de la clase
+int32_t perfilarHeap(Tarea& t) {
+  switch (t.estado) {
+  case 0:
+    historial.seccion(SEC_HEAP);
+    for (size_t i = 0; i < N_CAPACIDADES_HEAP; i++) {
+      FotoHeap f;
+      fotoHeap(CAPACIDADES_HEAP[i].caps, f);
+      if (f.total == 0) continue;
+      uint8_t reg[HEAP_CAPACIDAD_CABECERA + 8];
+      ponerU32LE(reg, f.total);
+      ponerU32LE(reg + 4, f.libre);
+      ponerU32LE(reg + 8, f.mayorBloque);
+      ponerU32LE(reg + 12, f.minimoLibre);
+      ponerU32LE(reg + 16, f.bloquesLibres);
+      reg[20] = f.fragmentacion();
+      size_t n = strlen(CAPACIDADES_HEAP[i].nombre);
+      if (n > 8) n = 8;
+      memcpy(reg + HEAP_CAPACIDAD_CABECERA, CAPACIDADES_HEAP[i].nombre, n);
+      historial.bytes(K_HEAP_CAPACIDAD, reg, HEAP_CAPACIDAD_CABECERA + n);
+    }
+    historial.u32(K_HEAP_RESERVA, HEAP_RESERVA_BARRIDO);
+    mostrarResultados();
+    t.i = 4;
+    return t.siguiente(1);
 
-  Serial.print("⏳ ");
-  
-  int redes = WiFi.scanNetworks(false, true, false, 300);
-  Serial.println("¡Completado!");
+  case 1: {
+    uint32_t tam = 1UL << t.i;
+    if (t.i > 20 || tam + HEAP_RESERVA_BARRIDO > heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT)) {
+      return t.siguiente(2);
+    }
+    ClaseHeap c;
+    barrerClase(tam, c);
+    uint8_t reg[HEAP_CLASE_CABECERA];
+    ponerU32LE(reg, c.tam);
+    ponerU32LE(reg + 4, c.bloques);
+    ponerU32LE(reg + 8, c.libreAntes);
+    reg[12] = c.motivo;
+    historial.bytes(K_HEAP_CLASE, reg, sizeof(reg));
+    mostrarResultados();
+    t.i++;
+    return 0;
+  }
+
+  default:
+    historial.u32(K_HEAP_MAX_ASIGNABLE, mayorAsignable());
+    historial.finSeccion(SEC_HEAP);
+    mostrarResultados();
+    return TAREA_FIN;
+  }
+}
+
+// Tarea permanente: la serie también recoge lo que cambia sin que nadie lo pida
+int32_t muestrearHeap(Tarea& t) {
+  serieHeap.muestrear("periodo");
+  return HEAP_MUESTREO_MS;
+}
+
+// Tarea permanente: una muestra por periodo, con su propio coste medido
+int32_t muestrearTelemetria(Tarea& t) {
+  uint32_t inicio = micros();
+  Muestra m;
+  m.ms = millis();
+  m.valor[CM_HEAP_LIBRE] = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+  m.valor[CM_MAYOR_BLOQUE] = heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT);
+  m.valor[CM_TEMPERATURA] = lroundf(temperatureRead() * 10);
+  m.valor[CM_RSSI] = WiFi.RSSI();  // 0 sin enlace de estación
+  serieMuestras.agregar(m);
+  serieMuestras.anotarCoste(micros() - inicio);
+  return serieMuestras.periodo();
+}
+
+// MAC de la estación en el formato de WiFi.macAddress(), sin pasar por String
+static void emitirMacWiFi() {
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  TextoFijoN<18> texto;
+  texto.printf("%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  historial.texto(K_WIFI_MAC, texto.c_str());
+}
+
+// Vuelca a la bitácora las redes de la caché
+static void emitirRedesWiFi() {
+  historial.u32(K_WIFI_REDES, cacheWiFi.encontradas());
+  for (size_t i = 0; i < min(cacheWiFi.cantidad(), (size_t)8); i++) {
+    const RedWiFi& red = cacheWiFi.red(i);
+    historial.texto(K_RED_SSID, red.ssid);
+    historial.u32(K_RED_SEGURIDAD, red.seguridad);
+    historial.i32(K_RED_RSSI, red.rssi);
+    historial.u32(K_RED_CANAL, red.canal);
+  }
   
-  output = "";
-  if (redes > 0) {
-    output += "\n📋 REDES ENCONTRADAS (" + String(redes) + "):\n";
+  if (cacheWiFi.encontradas() > 8) {
+    historial.u32(K_WIFI_REDES_EXTRA, cacheWiFi.encontradas() - 8);
+  }
+}
+
+// Responde desde la caché si sigue vigente; si no, escanea en segundo plano
+// (AP+STA cuando el File Manager está activo) y sondea cada 50 ms
+int32_t explorarWiFi(Tarea& t) {
+  switch (t.estado) {
+  case 0:
+    historial.seccion(SEC_WIFI);
+    emitirMacWiFi();
     
-    for (int i = 0; i < min(redes, 8); i++) {
-      String seguridad = getSecurityType(WiFi.encryptionType(i));
-      String intensidad = getRSSIQuality(WiFi.RSSI(i));
-      
-      output += "  " + String(i+1) + ". " + WiFi.SSID(i) + "\n";
-      output += "     🔒 " + seguridad + " | 📶 " + intensidad + 
-                    " (" + String(WiFi.RSSI(i)) + "dBm) | 📺 Ch" + String(WiFi.channel(i)) + "\n";
-      
-      delay(10);
+    if (cacheWiFi.vigente()) {
+      historial.texto(K_WIFI_MODO, cacheWiFi.conAP() ? "AP + Station (AP+STA)" : "Station (STA)");
+      historial.u32(K_WIFI_CACHE_EDAD, cacheWiFi.edadMs() / 1000);
+      return t.siguiente(2);
     }
     
-    if (redes > 8) {
-      output += "  ... y " + String(redes - 8) + " redes más\n";
+    if (!cacheWiFi.iniciarEscaneo()) {
+      historial.texto(K_WIFI_MODO, "Sin radio disponible");
+      historial.u32(K_WIFI_REDES, 0);
+      historial.finSeccion(SEC_WIFI);
+      mostrarResultados();
+      return TAREA_FIN;
     }
-  } else {
-    output += "\n❌ No se encontraron redes WiFi\n";
+    historial.texto(K_WIFI_MODO, cacheWiFi.conAP() ? "AP + Station (AP+STA)" : "Station (STA)");
+    mostrarResultados();
+    
+    Serial.println("\n🔍 ESCANEANDO REDES...");
+    Serial.print("⏳ ");
+    return t.siguiente(1, 50);
+  
+  case 1:
+    if (!cacheWiFi.sondear()) return 50;
+    Serial.println("¡Completado!");
+    return t.siguiente(2);
+  
+  default:
+    emitirRedesWiFi();
+    historial.finSeccion(SEC_WIFI);
+    mostrarResultados();
+    return TAREA_FIN;
   }
-  
-  WiFi.scanDelete();
-  WiFi.mode(WIFI_OFF);
-  output += "\n✅ Análisis WiFi completado\n";
+}
 
-  Serial.print(output);
-  addToHistory(output);
+// Sondea en segundo plano un escaneo ya lanzado hasta volcarlo a la caché
+int32_t refrescarWiFi(Tarea& t) {
+  return cacheWiFi.sondear() ? TAREA_FIN : 50;
 }
 
-void explorarGPIOs() {
-  String output = "\n🔌 ANÁLISIS DE GPIOS\n";
-  output += "=====================\n";
-  
-  int gpios[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 10};
-  int total = sizeof(gpios)/sizeof(gpios[0]);
-  
-  output += "🔍 PINES DISPONIBLES:\n";
-  output += "• Testeando: ";
-  for(int i = 0; i < total; i++) {
-    output += String(gpios[i]);
-    if(i < total-1) output += ", ";
+// Autotest por máscaras (autotest_gpio.h): todos los pines del perfil a la vez,
+// con cortos y entradas flotantes, en un solo paso de menos de un milisegundo
+int32_t explorarGPIOs(Tarea& t) {
+  historial.seccion(SEC_GPIO);
+  historial.texto(K_GPIO_PERFIL, PERFIL_PLACA.nombre);
+  historial.u32(K_GPIO_PINES, mascaraPerfil(PERFIL_PLACA));
+  historial.texto(K_GPIO_RESERVADOS, PERFIL_PLACA.reservados);
+
+  ResultadoAutotestGPIO r;
+  autotestGPIO(PERFIL_PLACA, r);
+
+  for (uint8_t i = 0; i < PERFIL_PLACA.n; i++) {
+    uint8_t pin = PERFIL_PLACA.pines[i];
+    uint8_t resultado[2] = {pin, (uint8_t)((r.funcionales() >> pin) & 1)};
+    historial.bytes(K_GPIO_PIN, resultado, sizeof(resultado));
   }
-  output += "\n• Reservados: 9(BOOT), 18-21(USB/UART)\n";
-  
-  output += "\n🧪 EJECUTANDO TESTS:\n";
-  String funcionales = "";
-  String problemáticos = "";
-  int ok = 0;
-  
-  for (int i = 0; i < total; i++) {
-    int pin = gpios[i];
-    String currentPinOutput = "  GPIO " + String(pin) + ": ";
-    
+  for (uint8_t i = 0; i < r.nCortos; i++) {
+    uint8_t corto[3] = {r.cortos[i].a, r.cortos[i].b, r.cortos[i].adyacentes};
+    historial.bytes(K_GPIO_CORTO, corto, sizeof(corto));
+  }
+  if (r.flotantes) historial.u32(K_GPIO_FLOTANTES, r.flotantes);
+  if (r.fijosAlto) historial.u32(K_GPIO_FIJOS_ALTO, r.fijosAlto);
+  if (r.fijosBajo) historial.u32(K_GPIO_FIJOS_BAJO, r.fijosBajo);
+  historial.u32(K_GPIO_FUNCIONALES, r.funcionales());
+  if (r.problematicos()) {
+    historial.u32(K_GPIO_PROBLEMATICOS, r.problematicos());
+  }
+  historial.u32(K_GPIO_DURACION_US, r.duracionUs);
+
+  historial.finSeccion(SEC_GPIO);
+  mostrarResultados();
+  return TAREA_FIN;
+}
+
+// Modo secuencial (comando 4s): un pin por vuelta con la HAL y esperas del
+// planificador. t.i es el índice, t.j acumula las tres lecturas y t.a / t.b
+// las máscaras de pines funcionales / problemáticos
+int32_t explorarGPIOsSecuencial(Tarea& t) {
+  const uint8_t* gpios = PERFIL_PLACA.pines;
+  const int total = PERFIL_PLACA.n;
+  int pin = gpios[t.i < total ? t.i : 0];
+
+  switch (t.estado) {
+  case 0: {
+    historial.seccion(SEC_GPIO);
+    historial.texto(K_GPIO_PERFIL, PERFIL_PLACA.nombre);
+    historial.u32(K_GPIO_PINES, mascaraPerfil(PERFIL_PLACA));
+    historial.texto(K_GPIO_RESERVADOS, PERFIL_PLACA.reservados);
+    mostrarResultados();
+    return t.siguiente(1);
+  }
+
+  case 1:
+    if (t.i == total) return t.siguiente(5);
     pinMode(pin, OUTPUT);
     digitalWrite(pin, HIGH);
-    delay(2);
-    bool testHigh = digitalRead(pin);
-    
+    return t.siguiente(2, 2);
+
+  case 2:
+    t.j = digitalRead(pin) ? 1 : 0;  // testHigh
     digitalWrite(pin, LOW);
-    delay(2);
-    bool testLow = digitalRead(pin);
-    
+    return t.siguiente(3, 2);
+
+  case 3:
+    t.j |= digitalRead(pin) ? 2 : 0;  // testLow
     pinMode(pin, INPUT_PULLUP);
-    delay(2);
-    bool testPullup = digitalRead(pin);
-    
+    return t.siguiente(4, 2);
+
+  case 4: {
+    t.j |= digitalRead(pin) ? 4 : 0;  // testPullup
     pinMode(pin, INPUT);
-    
-    if (testHigh && !testLow && testPullup) {
-      currentPinOutput += "✅ Funcional\n";
-      funcionales += String(pin) + " ";
-      ok++;
+
+    bool ok = t.j == (1 | 4);
+    if (ok) {
+      t.a |= 1UL << pin;
     } else {
-      currentPinOutput += "⚠️ Problemático\n";
-      problemáticos += String(pin) + " ";
+      t.b |= 1UL << pin;
     }
-    output += currentPinOutput;
-    Serial.print(currentPinOutput);
-    delay(50);
+    uint8_t resultado[2] = {(uint8_t)pin, ok};
+    historial.bytes(K_GPIO_PIN, resultado, sizeof(resultado));
+    mostrarResultados();
+    t.i++;
+    return t.siguiente(1, 50);
   }
-  
-  output += "\n📊 RESUMEN:\n";
-  output += "• Funcionales (" + String(ok) + "): " + funcionales + "\n";
-  if (problemáticos.length() > 0) {
-    output += "• Problemáticos: " + problemáticos + "\n";
-  }
-  
-  output += "\n✅ Análisis de GPIOs completado\n";
 
-  Serial.print(output.substring(output.indexOf("📊 RESUMEN:")));
-  addToHistory(output);
+  default:
+    historial.u32(K_GPIO_FUNCIONALES, t.a);
+    if (t.b) {
+      historial.u32(K_GPIO_PROBLEMATICOS, t.b);
+    }
+
+    historial.finSeccion(SEC_GPIO);
+    mostrarResultados();
+    return TAREA_FIN;
+  }
 }
 
-void explorarSistema() {
-  String output = "\n⚙️ ANÁLISIS DEL SISTEMA\n";
-  output += "========================\n";
+int32_t explorarSistema(Tarea& t) {
+  historial.seccion(SEC_SISTEMA);
   
-  output += "🔄 INFORMACIÓN DE ARRANQUE:\n";
-  output += "• Razón del reset: " + getResetReason() + "\n";
-  output += "• Tiempo activo: " + String(millis()/1000) + " segundos\n";
-  output += "• Núcleo actual: " + String(xPortGetCoreID()) + "\n";
+  historial.u32(K_RESET_RAZON, esp_reset_reason());
+  historial.u32(K_UPTIME, millis()/1000);
+  historial.u32(K_NUCLEO_ACTUAL, xPortGetCoreID());
   
-  output += "\n🕐 FRECUENCIAS DE RELOJ:\n";
-  output += "• CPU: " + String(ESP.getCpuFreqMHz()) + " MHz\n";
-  output += "• APB: " + String(rtc_clk_apb_freq_get()/1000000) + " MHz\n";
-  output += "• XTAL: " + String(rtc_clk_xtal_freq_get()) + " MHz\n";
+  historial.u32(K_CPU_FREQ, ESP.getCpuFreqMHz());
+  historial.u32(K_APB_FREQ, rtc_clk_apb_freq_get());
+  historial.u32(K_XTAL_FREQ, rtc_clk_xtal_freq_get());
   
-  output += "\n🔋 GESTIÓN DE ENERGÍA:\n";
-  output += "• Wake-up causa: " + String(esp_sleep_get_wakeup_cause()) + "\n";
-  output += "• Modo actual: Rendimiento normal\n";
+  historial.u32(K_WAKEUP_CAUSA, esp_sleep_get_wakeup_cause());
+  historial.texto(K_MODO_ENERGIA, "Rendimiento normal");
   
   if (servidorWebActivo) {
-    output += "\n🌐 SERVIDOR WEB:\n";
-    output += "• Estado: ✅ Activo\n";
-    output += "• Red: " + String(ap_ssid) + "\n";
-    output += "• IP: http://192.168.4.1\n";
+    historial.booleano(K_WEB_ACTIVO, true);
+    historial.texto(K_WEB_RED, ap_ssid);
+    historial.texto(K_WEB_IP, "http://192.168.4.1");
   }
   
-  output += "\n✅ Análisis del sistema completado\n";
-
-  Serial.print(output);
-  addToHistory(output);
+  historial.finSeccion(SEC_SISTEMA);
+  mostrarResultados();
+  return TAREA_FIN;
 }
 
-void explorarSensores() {
-  String output = "\n🌡️ ANÁLISIS DE SENSORES\n";
-  output += "=========================\n";
-  
-  output += "🌡️ SENSOR DE TEMPERATURA:\n";
-  float temp = temperatureRead();
-  Serial.print("• Temperatura del chip: " + String(temp, 1) + "°C");
-  output += "• Temperatura del chip: " + String(temp, 1) + "°C\n";
-  
-  if (temp > 80) {
-    Serial.println(" 🔥 ADVERTENCIA: Temperatura muy alta!");
-    output += " 🔥 ADVERTENCIA: Temperatura muy alta!\n";
-  } else if (temp > 60) {
-    Serial.println(" ⚠️ Temperatura elevada");
-    output += " ⚠️ Temperatura elevada\n";
-  } else {
-    Serial.println(" ✅ Temperatura normal");
-    output += " ✅ Temperatura normal\n";
-  }
-  
-  output += "\n⏱️ SISTEMA DE TIMING:\n";
-  output += "• Millis(): " + String(millis()) + " ms\n";
-  output += "• Micros(): " + String(micros()) + " μs\n";
-  
-  output += "🎯 Test de precisión delay(100ms): ";
-  unsigned long inicio = millis();
-  delay(100);
-  unsigned long fin = millis();
-  unsigned long precision = fin - inicio;
-  output += String(precision) + "ms\n";
-  Serial.print("🎯 Test de precisión delay(100ms): ");
-  Serial.println(String(precision) + "ms");
-  
-  if (precision >= 98 && precision <= 102) {
-    output += "✅ Excelente precisión\n";
-    Serial.println("✅ Excelente precisión");
-  } else {
-    output += "⚠️ Desviación: " + String(abs((int)(precision-100))) + "ms\n";
-    Serial.println("⚠️ Desviación: " + String(abs((int)(precision-100))) + "ms");
+// La espera de 100 ms la cumple el planificador: K_DELAY_100MS mide su precisión
+int32_t explorarSensores(Tarea& t) {
+  if (t.estado == 0) {
+    historial.seccion(SEC_SENSORES);
+
+    historial.f32(K_TEMPERATURA, temperatureRead());
+    historial.u32(K_MILLIS, millis());
+    historial.u32(K_MICROS, micros());
+    mostrarResultados();
+
+    t.marca = millis();
+    return t.siguiente(1, 100);
   }
-  
-  output += "\n✅ Análisis de sensores completado\n";
 
-  addToHistory(output);
+  historial.u32(K_DELAY_100MS, millis() - t.marca);
+
+  historial.finSeccion(SEC_SENSORES);
+  mostrarResultados();
+  return TAREA_FIN;
 }
 
-void testLEDs() {
-  String output = "\n💡 TEST DE LEDS\n";
-  output += "================";
-  
-  int candidatos[] = {2, 3, 7, 8, 10};
-  String nombres[] = {"GPIO2", "GPIO3", "GPIO7", "GPIO8", "GPIO10"};
-  int total = sizeof(candidatos)/sizeof(candidatos[0]);
-  
-  output += "\n🔍 Probando " + String(total) + " posibles ubicaciones de LEDs\n";
-  output += "👀 Observa la placa durante cada test...\n\n";
+// t.i es el LED candidato y t.j el flanco dentro de sus parpadeos (uno cada 200 ms)
+int32_t testLEDs(Tarea& t) {
+  static const int candidatos[] = {2, 3, 7, 8, 10};
+  const int total = sizeof(candidatos)/sizeof(candidatos[0]);
+  const int parpadeos = 6;
 
-  Serial.print(output);
-  addToHistory(output);
-  output = "";
+  switch (t.estado) {
+  case 0:
+    historial.seccion(SEC_LEDS);
+    historial.u32(K_LEDS_CANDIDATOS, total);
+    mostrarResultados();
+    return t.siguiente(1);
 
-  for (int i = 0; i < total; i++) {
-    int pin = candidatos[i];
-    Serial.println("🧪 Testeando " + nombres[i] + ":");
-    output += "🧪 Testeando " + nombres[i] + ":\n";
-    
-    pinMode(pin, OUTPUT);
-    Serial.print("   Parpadeando: ");
-    output += "   Parpadeando: ";
-    
-    for (int j = 0; j < 6; j++) {
-      digitalWrite(pin, HIGH);
-      delay(200);
-      digitalWrite(pin, LOW);
-      delay(200);
-      Serial.print("●");
-      output += "●";
+  case 1:
+    if (t.i == total) return t.siguiente(3);
+    historial.u32(K_LED_PIN, candidatos[t.i]);
+    mostrarResultados();
+    pinMode(candidatos[t.i], OUTPUT);
+    t.j = 0;
+    return t.siguiente(2);
+
+  case 2: {
+    int pin = candidatos[t.i];
+    if (t.j < 2 * parpadeos) {
+      digitalWrite(pin, t.j % 2 == 0 ? HIGH : LOW);
+      t.j++;
+      return 200;
     }
-    
     pinMode(pin, INPUT);
-    Serial.println(" [Completado]");
-    output += " [Completado]\n";
-    
-    delay(500);
+
+    historial.u32(K_LED_PARPADEOS, parpadeos);
+    mostrarResultados();
+    t.i++;
+    return t.siguiente(1, 500);
   }
-  
-  output += "\n💡 Test de LEDs completado\n";
-  output += "ℹ️ Si no viste LEDs, pueden estar en otros pines o no existir\n";
 
-  Serial.print(output);
-  addToHistory(output);
+  default:
+    historial.finSeccion(SEC_LEDS);
+    mostrarResultados();
+    return TAREA_FIN;
+  }
 }
 
-void benchmark() {
-  String output = "\n🏃 BENCHMARK DE RENDIMIENTO\n";
-  output += "============================\n";
-  
-  output += "🧮 Test matemático de 10k operaciones ";
-  Serial.print(output);
-  addToHistory(output);
-  output = "";
+// Un kernel por paso: sus muestras van seguidas (unos ms) y entre kernel y
+// kernel loop() vuelve a atender la web y Serial. Después, t.j recorre los
+// métodos de conmutación de un pin (frecuencia alcanzable y jitter)
+int32_t benchmark(Tarea& t) {
+  uint8_t datos[255];
 
-  unsigned long inicio = micros();
-  volatile float resultado = 0;
-  for (int i = 0; i < 10000; i++) {
-    resultado += sqrt(i) * 3.14159;
+  if (t.estado == 0) {
+    historial.seccion(SEC_BENCHMARK);
+    microbench.calibrar();
+    historial.u32(K_BENCH_CPU_MHZ, ESP.getCpuFreqMHz());
+    historial.u32(K_BENCH_MUESTRAS, microbench.muestras());
+    historial.booleano(K_BENCH_SIN_IRQ, microbench.sinInterrupciones());
+    historial.u32(K_BENCH_SOBRECOSTE, microbench.sobrecoste());
+    mostrarResultados();
+    return t.siguiente(1);
   }
-  unsigned long tiempoMath = micros() - inicio;
-  output += String(tiempoMath) + " μs\n";
-  Serial.println(String(tiempoMath) + " μs");
-  
-  output += "⚡ Test GPIO (5k toggles)... ";
-  Serial.print(output);
-  addToHistory(output);
-  output = "";
 
-  pinMode(2, OUTPUT);
-  inicio = micros();
-  for (int i = 0; i < 5000; i++) {
-    digitalWrite(2, i % 2);
+  if (t.i < microbench.cantidad()) {
+    EstadisticaBench e;
+    if (microbench.medir(t.i, e)) {
+      const char* nombre = microbench.kernel(t.i).nombre;
+      size_t longNombre = min(strlen(nombre), (size_t)(sizeof(datos) - BENCH_KERNEL_CABECERA));
+      const uint32_t campos[] = {e.min, e.mediana, e.p95, e.max, e.desviacion, e.ops};
+      for (int i = 0; i < 6; i++) ponerU32LE(datos + 4 * i, campos[i]);
+      datos[24] = e.sinIRQ ? 1 : 0;
+      memcpy(datos + BENCH_KERNEL_CABECERA, nombre, longNombre);
+      historial.bytes(K_BENCH_KERNEL, datos, BENCH_KERNEL_CABECERA + longNombre);
+      mostrarResultados();
+    }
+    t.i++;
+    return 0;
   }
-  unsigned long tiempoGPIO = micros() - inicio;
-  pinMode(2, INPUT);
-  output += String(tiempoGPIO) + " μs\n";
-  Serial.println(String(tiempoGPIO) + " μs");
-  
-  output += "💾 Test memoria ... ";
-  Serial.print(output);
-  addToHistory(output);
-  output = "";
 
-  inicio = micros();
-  String testStr = "";
-  for (int i = 0; i < 500; i++) {
-    testStr += String(i);
+  if (t.j < TOGGLE_TOTAL) {
+    MedidaToggle m;
+    microbench.medirToggle((MetodoToggle)t.j, m);
+    const char* nombre = nombreMetodoToggle((MetodoToggle)t.j);
+    size_t longNombre = strlen(nombre);
+    ponerU32LE(datos, m.frecuenciaHz(ESP.getCpuFreqMHz()));
+    ponerU32LE(datos + 4, m.min);
+    ponerU32LE(datos + 8, m.max);
+    ponerU32LE(datos + 12, (uint32_t)(m.media * 100 + 0.5f));
+    ponerU32LE(datos + 16, (uint32_t)(m.desviacion * 100 + 0.5f));
+    memcpy(datos + BENCH_TOGGLE_CABECERA, nombre, longNombre);
+    historial.bytes(K_BENCH_TOGGLE, datos, BENCH_TOGGLE_CABECERA + longNombre);
+    mostrarResultados();
+    t.j++;
+    return 0;
   }
-  unsigned long tiempoMem = micros() - inicio;
-  output += String(tiempoMem) + " μs\n";
-  Serial.println(String(tiempoMem) + " μs");
-  
-  output += "\n📊 PUNTUACIÓN FINAL:\n";
-  output += "• Matemáticas: " + String(10000000.0/tiempoMath, 1) + " ops/seg\n";
-  output += "• GPIO: " + String(5000000.0/tiempoGPIO, 1) + " ops/seg\n";
-  output += "• Memoria: " + String(500000.0/tiempoMem, 1) + " ops/seg\n";
-  
-  output += "\n✅ Benchmark completado\n";
 
-  Serial.print(output);
-  addToHistory(output);
+  historial.finSeccion(SEC_BENCHMARK);
+  mostrarResultados();
+  return TAREA_FIN;
 }
 
 // Clase de callback para Bluetooth
+// Corre en la tarea host de BLE: solo empaqueta el anuncio y lo encola.
+// Serial y el historial se tocan únicamente desde loop() (procesarColaBLE).
 class MyAdvertisedDeviceCallbacks: public BLEAdvertisedDeviceCallbacks {
     void onResult(BLEAdvertisedDevice advertisedDevice) {
-      String msg = "  BLE Device found: ";
-      if (advertisedDevice.getName().length() > 0) {
-        msg += advertisedDevice.getName().c_str();
-      } else {
-        msg += "[Unnamed]";
+      RegistroEscaneoBLE reg;
+      reg.ms = millis();
+      memcpy(reg.mac, *advertisedDevice.getAddress().getNative(), sizeof(reg.mac));
+      reg.rssi = (int8_t)advertisedDevice.getRSSI();
+      reg.longNombre = 0;
+      if (advertisedDevice.haveName()) {
+        auto nombre = advertisedDevice.getName();
+        reg.longNombre = (uint8_t)min((size_t)nombre.length(), sizeof(reg.nombre));
+        memcpy(reg.nombre, nombre.c_str(), reg.longNombre);
       }
-      msg += " Address: ";
-      msg += advertisedDevice.getAddress().toString().c_str();
-      msg += " RSSI: ";
-      msg += String(advertisedDevice.getRSSI());
-      msg += "\n";
-      Serial.print(msg);
-      addToHistory(msg);
+      colaBLE.push(reg);
     }
 };
 
-void explorarBluetooth() {
-  String output = "\n📡 ANÁLISIS DE BLUETOOTH\n";
-  output += "=========================\n";
-  Serial.print(output);
-  addToHistory(output);
+// Vacía la cola BLE hacia la tabla de dispositivos. Devuelve los anuncios procesados
+size_t procesarColaBLE() {
+  RegistroEscaneoBLE reg;
+  size_t procesados = 0;
+  while (colaBLE.pop(reg)) {
+    tablaBLE.registrar(reg);
+    procesados++;
+  }
+  return procesados;
+}
+
+// Fin de escaneo: lo avisa la tarea host de BLE; las tareas BLE lo sondean
+static std::atomic<bool> escaneoBLETerminado{false};
 
+static void finEscaneoBLE(BLEScanResults resultados) {
+  escaneoBLETerminado.store(true);
+}
+
+// Inicia el stack si hace falta y configura el escaneo. Se piden los duplicados:
+// cada anuncio cuenta para los paquetes y el RSSI de su dispositivo en la tabla
+static BLEScan* prepararEscaneoBLE() {
   if (!BLEDevice::getInitialized()) {
     BLEDevice::init("");
     BLEDevice::setPower(ESP_PWR_LVL_P9);
-    output = "• BLE Initialized: ✅\n";
-  } else {
-    output = "• BLE Already Initialized: ✅\n";
   }
-
-  output += "• MAC Address: " + String(BLEDevice::getAddress().toString().c_str()) + "\n";
-  Serial.print(output);
-  addToHistory(output);
-
+  static MyAdvertisedDeviceCallbacks callbacks;
   BLEScan* pBLEScan = BLEDevice::getScan();
-  pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks());
+  pBLEScan->setAdvertisedDeviceCallbacks(&callbacks, true);
   pBLEScan->setActiveScan(true);
   pBLEScan->setInterval(100);
   pBLEScan->setWindow(99);
+  return pBLEScan;
+}
+
+// Inicio del modo continuo y anuncios contados hasta entonces (para su tasa)
+static uint32_t inicioContinuoMs = 0;
+static uint32_t paquetesInicioContinuo = 0;
+
+// Escaneo continuo en ciclos de BLE_CICLO_S; la tabla acumula entre ciclos.
+// Tras cada ciclo se vacían los resultados propios del stack para acotar su memoria
+int32_t escaneoBLEContinuo(Tarea& t) {
+  BLEScan* pBLEScan = prepararEscaneoBLE();
+  if (t.estado == 1 && !escaneoBLETerminado.load()) return 200;
+  pBLEScan->clearResults();
+  escaneoBLETerminado.store(false);
+  pBLEScan->start(BLE_CICLO_S, finEscaneoBLE, false);
+  return t.siguiente(1, BLE_CICLO_S * 1000);
+}
 
-  Serial.println("\n🔍 ESCANEANDO DISPOSITIVOS BLE por 10 segundos (en 5 ciclos de 2s)...");
-  addToHistory("\n🔍 ESCANEANDO DISPOSITIVOS BLE por 10 segundos (en 5 ciclos de 2s)...\n");
+bool escaneoBLEContinuoActivo() {
+  return planificador.activa(escaneoBLEContinuo);
+}
 
-  int scanCycles = 5;
-  for (int i = 0; i < scanCycles; i++) {
-    Serial.print("   Ciclo de escaneo " + String(i + 1) + "/" + String(scanCycles) + "...");
-    pBLEScan->start(2, false); 
-    Serial.println(" completado.");
-    delay(50); 
+void comandoEscaneoBLEContinuo() {
+  if (escaneoBLEContinuoActivo()) {
+    planificador.cancelar(escaneoBLEContinuo);
+    BLEDevice::getScan()->stop();
+    procesarColaBLE();
+    Serial.println("⏹️ Escaneo BLE continuo detenido");
+    tablaBLE.imprimirTexto(Serial);
+    return;
   }
-  
-  BLEScanResults* foundDevices = pBLEScan->getResults();
-  
-  String summary = "\n📊 RESUMEN DE ESCANEO BLE:\n";
-  summary += "• Dispositivos encontrados: " + String(foundDevices->getCount()) + "\n";
-  
-  if (foundDevices->getCount() == 0) {
-    summary += "• No se encontraron dispositivos BLE.\n";
+  if (escaneoBLEPuntual) {
+    Serial.println("⏳ Hay un escaneo BLE en curso. Espere o use 'stop'.");
+    return;
+  }
+  if (!planificador.lanzar("ble", escaneoBLEContinuo)) {
+    Serial.println("❌ No quedan huecos en el planificador");
+    return;
   }
+  inicioContinuoMs = millis();
+  paquetesInicioContinuo = tablaBLE.paquetes();
+  Serial.println("📡 Escaneo BLE continuo iniciado (B para detener, T para ver la tabla)");
+}
 
-  summary += "\n✅ Análisis de Bluetooth completado\n";
-  Serial.print(summary);
-  addToHistory(summary);
+// Resumen de la tabla: un registro por dispositivo visto desde inicioMs (los
+// BLE_RESUMEN_MAX más recientes) más totales y tasa, en vez de cada anuncio
+static void resumirTablaBLE(uint32_t inicioMs, uint32_t paquetesInicio) {
+  procesarColaBLE();
+  uint8_t datos[BLE_DISPOSITIVO_CABECERA + sizeof(DispositivoBLE::nombre)];
+  uint32_t vistos = 0;
+  for (const DispositivoBLE* d = tablaBLE.masReciente(); d; d = tablaBLE.masAntiguoQue(d)) {
+    if ((int32_t)(d->ultimoMs - inicioMs) < 0) break;  // orden LRU: el resto es anterior
+    if (vistos++ >= BLE_RESUMEN_MAX) continue;
+    uint16_t paquetes = (uint16_t)min(d->paquetes, (uint32_t)UINT16_MAX);
+    memcpy(datos, d->mac, 6);
+    datos[6] = (uint8_t)d->rssiMedia();
+    datos[7] = (uint8_t)d->rssiMin;
+    datos[8] = (uint8_t)d->rssiMax;
+    datos[9] = paquetes & 0xFF;
+    datos[10] = paquetes >> 8;
+    memcpy(datos + BLE_DISPOSITIVO_CABECERA, d->nombre, d->longNombre);
+    historial.bytes(K_BLE_DISPOSITIVO, datos, BLE_DISPOSITIVO_CABECERA + d->longNombre);
+  }
 
-  pBLEScan->clearResults(); 
+  uint32_t paquetes = tablaBLE.paquetes() - paquetesInicio;
+  uint32_t lapso = millis() - inicioMs;
+  historial.u32(K_BLE_ENCONTRADOS, vistos);
+  historial.u32(K_BLE_PAQUETES, paquetes);
+  historial.f32(K_BLE_TASA, lapso ? paquetes * 1000.0f / lapso : 0.0f);
+  if (tablaBLE.expulsados() > 0) {
+    historial.u32(K_BLE_EXPULSADOS, tablaBLE.expulsados());
+  }
+  if (colaBLE.descartados() > 0) {
+    historial.u32(K_BLE_DESCARTADOS, colaBLE.descartados());
+  }
+  historial.u32(K_BLE_COLA_MAX, colaBLE.maxOcupacion());
 }
 
-void diagnosticoTotal() {
-  Serial.println("\n🔬 DIAGNÓSTICO COMPLETO");
-  Serial.println("========================");
-  Serial.println("⏳ Ejecutando todos los análisis...\n");
-  
-  limpiarHistorial();
-  addToHistory("--- INICIO DIAGNÓSTICO COMPLETO ---\n\n");
+// Un escaneo asíncrono de BLE_ESCANEO_S; con el modo continuo activo no escanea
+// y resume lo acumulado desde que empezó
+int32_t explorarBluetooth(Tarea& t) {
+  switch (t.estado) {
+  case 0: {
+    historial.seccion(SEC_BLE);
 
-  explorarChipSeguro();
-  delay(1000);
-  
-  explorarMemoria();
-  delay(1000);
-  
-  explorarWiFi();
-  delay(1000);
-  
-  explorarGPIOs();
-  delay(1000);
-  
-  explorarSistema();
-  delay(1000);
-  
-  explorarSensores();
-  delay(1000);
-  
-  benchmark();
-  delay(1000);
+    bool yaIniciado = BLEDevice::getInitialized();
+    BLEScan* pBLEScan = prepararEscaneoBLE();
+    historial.booleano(K_BLE_INICIADO, !yaIniciado);
+    TextoFijoN<18> mac;
+    imprimirMac(mac, *BLEDevice::getAddress().getNative());
+    historial.texto(K_BLE_MAC, mac.c_str());
+    mostrarResultados();
 
-  explorarBluetooth(); 
-  
-  Serial.println("\n🎉 DIAGNÓSTICO COMPLETO TERMINADO");
-  Serial.println("📊 Todos los sistemas han sido analizados exitosamente");
-  Serial.println("ℹ️ Usa el comando 'X' para exportar los resultados a un archivo TXT.");
-  Serial.println("🌐 Usa el comando 'W' para acceso web a los archivos.");
-  diagnosticoCompleto = true;
-  addToHistory("\n--- FIN DIAGNÓSTICO COMPLETO ---\n");
-}
-
-// === FUNCIONES AUXILIARES ===
-String getResetReason() {
-  switch(esp_reset_reason()) {
-    case ESP_RST_POWERON: return "Power-On";
-    case ESP_RST_EXT: return "Reset externo";
-    case ESP_RST_SW: return "Software";
-    case ESP_RST_PANIC: return "Excepción/Pánico";
-    case ESP_RST_INT_WDT: return "Interrupt WDT";
-    case ESP_RST_TASK_WDT: return "Task WDT";
-    case ESP_RST_WDT: return "Other WDT";
-    case ESP_RST_DEEPSLEEP: return "Deep Sleep";
-    case ESP_RST_BROWNOUT: return "Brownout";
-    default: return "Desconocido";
-  }
-}
-
-String getSecurityType(wifi_auth_mode_t tipo) {
-  switch(tipo) {
-    case WIFI_AUTH_OPEN: return "Abierta";
-    case WIFI_AUTH_WEP: return "WEP";
-    case WIFI_AUTH_WPA_PSK: return "WPA-PSK";
-    case WIFI_AUTH_WPA2_PSK: return "WPA2-PSK";
-    case WIFI_AUTH_WPA_WPA2_PSK: return "WPA/WPA2";
-    case WIFI_AUTH_WPA2_ENTERPRISE: return "WPA2-Enterprise";
-    case WIFI_AUTH_WPA3_PSK: return "WPA3-PSK";
-    default: return "Desconocida";
-  }
-}
-
-String getRSSIQuality(int rssi) {
-  if (rssi > -30) return "Excelente";
-  else if (rssi > -50) return "Muy buena";
-  else if (rssi > -60) return "Buena";
-  else if (rssi > -70) return "Regular";
-  else return "Débil";
-}
\ No newline at end of file
+    if (escaneoBLEContinuoActivo()) {
+      t.marca = inicioContinuoMs;
+      t.a = paquetesInicioContinuo;
+      return t.siguiente(2);
+    }
+
+    imprimirlnf(Serial, "\n🔍 ESCANEANDO DISPOSITIVOS BLE por %d segundos...", BLE_ESCANEO_S);
+    t.marca = millis();
+    t.a = tablaBLE.paquetes();
+    escaneoBLETerminado.store(false);
+    escaneoBLEPuntual = true;
+    pBLEScan->start(BLE_ESCANEO_S, finEscaneoBLE, false);
+    return t.siguiente(1, BLE_ESCANEO_S * 1000);
+  }
+
+  case 1:
+    if (!escaneoBLETerminado.load()) return 100;
+    escaneoBLEPuntual = false;
+    BLEDevice::getScan()->clearResults();
+    return t.siguiente(2);
+
+  default:
+    resumirTablaBLE(t.marca, t.a);
+    historial.finSeccion(SEC_BLE);
+    mostrarResultados();
+    return TAREA_FIN;
+  }
+}
+
+// Encadena los diagnósticos con 1 s entre uno y otro. Cada uno avanza sobre
+// su propia Tarea (subtarea); t.i es el índice del diagnóstico actual
+int32_t diagnosticoTotal(Tarea& t) {
+  static const PasoTarea pasos[] = {
+    explorarChipSeguro, explorarMemoria, explorarWiFi, explorarGPIOs,
+    explorarSistema, explorarSensores, benchmark, explorarBluetooth,
+  };
+  const int total = sizeof(pasos)/sizeof(pasos[0]);
+  static Tarea subtarea;
+
+  switch (t.estado) {
+  case 0:
+    Serial.println("\n🔬 DIAGNÓSTICO COMPLETO");
+    Serial.println("========================");
+    Serial.println("⏳ Ejecutando todos los análisis...\n");
+
+    limpiarHistorial();
+    addToHistory("--- INICIO DIAGNÓSTICO COMPLETO ---\n\n");
+    return t.siguiente(1);
+
+  case 1:
+    subtarea.reiniciar();
+    subtarea.nombre = t.nombre;
+    subtarea.paso = pasos[t.i];
+    return t.siguiente(2);
+
+  case 2: {
+    int32_t espera = subtarea.paso(subtarea);
+    if (espera != TAREA_FIN) return espera;
+    if (++t.i < total) return t.siguiente(1, 1000);
+
+    Serial.println("\n🎉 DIAGNÓSTICO COMPLETO TERMINADO");
+    Serial.println("📊 Todos los sistemas han sido analizados exitosamente");
+    Serial.println("ℹ️ Usa el comando 'X' para exportar los resultados a un archivo TXT.");
+    Serial.println("🌐 Usa el comando 'W' para acceso web a los archivos.");
+    diagnosticoCompleto = true;
+    addToHistory("\n--- FIN DIAGNÓSTICO COMPLETO ---\n");
+    return TAREA_FIN;
+  }
+  }
+  return TAREA_FIN;
+}
@@ -0,0 +1,173 @@
+// ESP32-C3 MINI - EXPLORADOR TOTAL
+// Declaraciones compartidas entre el sketch y los módulos auxiliares
+// (un .cpp no recibe los prototipos automáticos que el IDE genera para un .ino).
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WebServer.h>
+#include "resultados.h"
+#include "formato.h"
+#include "interprete.h"
+#include "ble_cola.h"
+#include "indice_archivos.h"
+#include "rangos_http.h"
+#include "planificador.h"
+#include "cache_wifi.h"
+#include "tabla_ble.h"
+#include "microbench.h"
+#include "autotest_gpio.h"
+#include "monitor_heap.h"
+#include "telemetria.h"
+#include "muestreo.h"
+#include "metricas.h"
+#include "eventos.h"
+#include "compresion.h"
+#include "respaldo.h"
+#include "exportaciones.h"
+#include "linea_base.h"
+
+extern bool diagnosticoCompleto;
+// Tareas cooperativas que loop() avanza entre petición y petición
+extern Planificador planificador;
+// Bitácora de registros tipados; el texto se genera desde aquí al mostrar/exportar
+extern BitacoraResultados historial;
+// Copia de la bitácora que sobrevive a un reinicio
+extern DiarioRespaldo respaldo;
+// Exportaciones en SPIFFS (rotación e índice)
+extern AlmacenExportaciones exportaciones;
+// Métricas de referencia con las que se comparan el benchmark y el diagnóstico completo
+extern LineaBase lineaBase;
+
+// Anuncios BLE pendientes de volcar a Serial/historial desde loop()
+#ifndef BLE_COLA_LEN
+#define BLE_COLA_LEN 64
+#endif
+extern ColaSPSC<RegistroEscaneoBLE, BLE_COLA_LEN> colaBLE;
+extern TablaBLE tablaBLE;
+// Duración del escaneo del comando A y de cada ciclo del modo continuo (s)
+#ifndef BLE_ESCANEO_S
+#define BLE_ESCANEO_S 10
+#endif
+#ifndef BLE_CICLO_S
+#define BLE_CICLO_S 30
+#endif
+// Dispositivos que el resumen guarda en el historial (el resto solo se cuenta)
+#ifndef BLE_RESUMEN_MAX
+#define BLE_RESUMEN_MAX 16
+#endif
+
+// Evolución del heap: muestras periódicas y tras cada comando y handler HTTP
+extern SerieHeap serieHeap;
+// Heap, temperatura y RSSI cada periodo(), comprimidos (comando S y /muestras)
+extern SerieMuestras serieMuestras;
+#define MUESTREO_ARCHIVO "/muestras.csv"
+
+// Tabla de comandos y guion pendiente; GUION_INICIO se ejecuta al arrancar si existe
+extern Interprete interprete;
+#ifndef GUION_INICIO
+#define GUION_INICIO "/inicio.txt"
+#endif
+
+// Modo binario del puerto serie (comando bin) y velocidad del modo texto
+extern Telemetria telemetria;
+#ifndef SERIAL_BAUDIOS
+#define SERIAL_BAUDIOS 115200
+#endif
+
+// Kernels del comando 8 (los de fábrica se registran en setup)
+extern MicroBench microbench;
+
+// Paginación de /list
+#define LIST_LIMITE_DEFECTO 50
+#define LIST_LIMITE_MAX 200
+extern IndiceArchivos indiceArchivos;
+
+// Redes del último escaneo WiFi (vigencia WIFI_CACHE_TTL_MS)
+extern CacheWiFi cacheWiFi;
+
+// Descargas: buffer de copia SPIFFS -> socket y separador multipart
+#ifndef DESCARGA_BUFFER
+#define DESCARGA_BUFFER 4096
+#endif
+#define DESCARGA_SEPARADOR "ESP32_RANGOS"
+
+// Exportaciones (X/J/V) guardadas como .gz; 0 = texto plano como antes
+#ifndef EXPORTAR_GZIP
+#define EXPORTAR_GZIP 1
+#endif
+
+// Subidas: buffer fijo entre los bloques HTTP y las escrituras a SPIFFS
+#ifndef SUBIDA_BUFFER
+#define SUBIDA_BUFFER 4096
+#endif
+// La subida se escribe aquí y solo al terminar bien sustituye al destino
+#define SUBIDA_TEMPORAL "/subida.tmp"
+
+extern WebServer server;
+// Peticiones y latencias por ruta, para /metrics
+extern MetricasHTTP metricasHTTP;
+// Clientes de /eventos (la página web recibe los cambios sin sondear)
+extern ServidorEventos eventos;
+extern const char* ap_ssid;
+extern const char* ap_password;
+extern bool servidorWebActivo;
+
+void setup();
+void loop();
+void mostrarMenu();
+// Ejecuta una línea del Monitor Serie (admite guiones: "1;2;5", "8*20")
+void ejecutarComando(const char* linea);
+
+// Servidor web
+void iniciarServidorWeb();
+void comandoWebServer();
+void handleFileDownload();
+void handleFileDelete();
+void handleFileList();
+void handleUploadMultipart();
+void handleUploadRaw();
+void handleUploadFin();
+void handleRoot();
+void handleResultados();
+void handleWiFi();
+void handleBLE();
+void handleHeap();
+void handleMuestras();
+void handleMetrics();
+void handleEventos();
+void handleVeredicto();
+
+// Historial y exportación
+void addToHistory(const char* texto);
+void mostrarResultados();
+void limpiarHistorial();
+void exportarDatosArchivo(FormatoSalida formato = FMT_TXT);
+void guardarRespaldo();
+void mostrarArchivosGuardados();
+// Compara la bitácora con la línea base y escribe el veredicto; false si no había con qué
+bool compararConLineaBase();
+
+// Diagnósticos: máquinas de estados que avanza el planificador (ver planificador.h)
+int32_t explorarChipSeguro(Tarea& t);
+int32_t explorarMemoria(Tarea& t);
+int32_t explorarWiFi(Tarea& t);
+int32_t refrescarWiFi(Tarea& t);
+int32_t explorarGPIOs(Tarea& t);
+int32_t explorarGPIOsSecuencial(Tarea& t);
+int32_t explorarSistema(Tarea& t);
+int32_t explorarSensores(Tarea& t);
+int32_t testLEDs(Tarea& t);
+int32_t benchmark(Tarea& t);
+int32_t explorarBluetooth(Tarea& t);
+size_t procesarColaBLE();
+int32_t escaneoBLEContinuo(Tarea& t);
+bool escaneoBLEContinuoActivo();
+void comandoEscaneoBLEContinuo();
+int32_t diagnosticoTotal(Tarea& t);
+int32_t perfilarHeap(Tarea& t);
+int32_t muestrearHeap(Tarea& t);
+int32_t muestrearTelemetria(Tarea& t);
+// Lanza un diagnóstico en segundo plano; false si ya hay otro en curso
+bool lanzarDiagnostico(const char* nombre, PasoTarea paso);
+bool diagnosticoEnCurso();
+void cancelarDiagnostico();
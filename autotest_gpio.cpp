@@ -0,0 +1,82 @@
+#include "autotest_gpio.h"
+#include "gpio_rapido.h"
+
+static int posicionEnPerfil(const PerfilPlaca& p, uint8_t pin) {
+  for (uint8_t i = 0; i < p.n; i++) {
+    if (p.pines[i] == pin) return i;
+  }
+  return -1;
+}
+
+// 'seguidores' son los pines que copiaron el nivel del pin i; cada par se anota una vez
+static void anotarCortos(const PerfilPlaca& p, uint8_t i, uint32_t seguidores, ResultadoAutotestGPIO& r) {
+  uint8_t pin = p.pines[i];
+  if (seguidores) r.enCorto |= seguidores | 1UL << pin;
+  while (seguidores) {
+    uint8_t otro = __builtin_ctz(seguidores);
+    seguidores &= seguidores - 1;
+    uint8_t a = min(pin, otro), b = max(pin, otro);
+    bool repetido = false;
+    for (uint8_t k = 0; k < r.nCortos; k++) repetido |= r.cortos[k].a == a && r.cortos[k].b == b;
+    if (repetido || r.nCortos == GPIO_MAX_CORTOS) continue;
+    int j = posicionEnPerfil(p, otro);
+    r.cortos[r.nCortos++] = {a, b, j == i - 1 || j == i + 1};
+  }
+}
+
+void autotestGPIO(const PerfilPlaca& p, ResultadoAutotestGPIO& r) {
+  uint32_t inicio = micros();
+  const uint32_t m = mascaraPerfil(p);
+  r = ResultadoAutotestGPIO();
+  r.pines = m;
+
+  // La HAL solo para llevar el IO MUX a función GPIO; lo demás va por registros
+  for (uint8_t i = 0; i < p.n; i++) pinMode(p.pines[i], INPUT);
+
+  // 1. Salidas
+  gpioPulls(m, false, false);
+  gpioAlto(m);
+  gpioSalidas(m);
+  delayMicroseconds(GPIO_ASENTAMIENTO_US);
+  r.siguenAlto = gpioLeer() & m;
+  gpioBajo(m);
+  delayMicroseconds(GPIO_ASENTAMIENTO_US);
+  r.siguenBajo = ~gpioLeer() & m;
+  gpioEntradas(m);
+
+  // 2 y 3a. Pull-up: lectura en reposo y walking-zeros. Un pin que ya leía 0
+  // sin que nadie lo condujera no cuenta como seguidor
+  gpioPulls(m, true, false);
+  delayMicroseconds(GPIO_ASENTAMIENTO_PULL_US);
+  uint32_t conPullup = gpioLeer() & m;
+  for (uint8_t i = 0; i < p.n; i++) {
+    uint32_t bit = 1UL << p.pines[i];
+    gpioBajo(bit);
+    gpioSalidas(bit);
+    delayMicroseconds(GPIO_ASENTAMIENTO_US);
+    uint32_t caen = ~gpioLeer() & conPullup & ~bit;
+    gpioEntradas(bit);
+    anotarCortos(p, i, caen, r);
+  }
+
+  // 2 y 3b. Pull-down: lectura en reposo y walking-ones
+  gpioPulls(m, false, true);
+  delayMicroseconds(GPIO_ASENTAMIENTO_PULL_US);
+  uint32_t conPulldown = gpioLeer() & m;
+  for (uint8_t i = 0; i < p.n; i++) {
+    uint32_t bit = 1UL << p.pines[i];
+    gpioAlto(bit);
+    gpioSalidas(bit);
+    delayMicroseconds(GPIO_ASENTAMIENTO_US);
+    uint32_t suben = gpioLeer() & m & ~conPulldown & ~bit;
+    gpioEntradas(bit);
+    gpioBajo(bit);
+    anotarCortos(p, i, suben, r);
+  }
+
+  gpioPulls(m, false, false);
+  r.flotantes = conPullup & ~conPulldown;
+  r.fijosAlto = conPullup & conPulldown;
+  r.fijosBajo = m & ~conPullup & ~conPulldown;
+  r.duracionUs = micros() - inicio;
+}
@@ -0,0 +1,75 @@
+// Autotest de GPIOs por máscaras
+// En lugar de probar los pines de uno en uno con la HAL y delay(), se mueven y
+// se leen todos a la vez con los registros de gpio_rapido.h:
+//   1. Todos como salida a 1 y luego a 0: ¿sigue cada pin a su driver?
+//   2. Todos como entrada con pull-up y luego con pull-down: un pin que sigue a
+//      los dos pulls flota (nada conectado); uno que no, tiene algo externo.
+//   3. Walking-zeros (resto con pull-up) y walking-ones (resto con pull-down):
+//      un solo pin conduce y cualquier otro que lo siga está en corto con él.
+// Los pines candidatos vienen de un perfil de placa fijado en compilación, en
+// el orden del conector, para señalar los cortos entre pines vecinos.
+// Todo el test dura unos cientos de microsegundos.
+#pragma once
+#include <Arduino.h>
+
+struct PerfilPlaca {
+  const char* nombre;
+  uint8_t pines[16];       // candidatos en el orden del conector
+  uint8_t n;
+  const char* reservados;  // pines que no se tocan y por qué
+};
+
+constexpr PerfilPlaca PERFILES_PLACA[] = {
+  {"ESP32-C3 Super Mini", {0, 1, 2, 3, 4, 5, 6, 7, 8, 10}, 10, "9(BOOT), 18-21(USB/UART)"},
+  {"ESP32-C3-DevKitM-1", {0, 1, 2, 3, 4, 5, 6, 7, 10}, 9, "8(LED RGB), 9(BOOT), 18-21(USB/UART)"},
+  {"Seeed XIAO ESP32C3", {2, 3, 4, 5, 6, 7, 8, 10}, 8, "9(BOOT), 20-21(UART), 18-19(USB)"},
+};
+
+// Perfil activo: -DPERFIL_GPIO=n (índice en PERFILES_PLACA)
+#ifndef PERFIL_GPIO
+#define PERFIL_GPIO 0
+#endif
+static_assert(PERFIL_GPIO < sizeof(PERFILES_PLACA) / sizeof(PERFILES_PLACA[0]), "PERFIL_GPIO fuera de la tabla");
+static constexpr const PerfilPlaca& PERFIL_PLACA = PERFILES_PLACA[PERFIL_GPIO];
+
+constexpr uint32_t mascaraPerfil(const PerfilPlaca& p) {
+  uint32_t m = 0;
+  for (uint8_t i = 0; i < p.n; i++) m |= 1UL << p.pines[i];
+  return m;
+}
+
+// Esperas tras cambiar un driver o un pull antes de leer (µs)
+#ifndef GPIO_ASENTAMIENTO_US
+#define GPIO_ASENTAMIENTO_US 5
+#endif
+#ifndef GPIO_ASENTAMIENTO_PULL_US
+#define GPIO_ASENTAMIENTO_PULL_US 20
+#endif
+#ifndef GPIO_MAX_CORTOS
+#define GPIO_MAX_CORTOS 8
+#endif
+
+struct CortoGPIO {
+  uint8_t a;
+  uint8_t b;
+  bool adyacentes;  // vecinos en el conector
+};
+
+struct ResultadoAutotestGPIO {
+  uint32_t pines = 0;       // máscaras de GPIO
+  uint32_t siguenAlto = 0;  // como salida a 1 se leen a 1
+  uint32_t siguenBajo = 0;
+  uint32_t flotantes = 0;   // siguen al pull-up y al pull-down: nada conectado
+  uint32_t fijosAlto = 0;   // leen 1 incluso con pull-down: pull o driver externo a VCC
+  uint32_t fijosBajo = 0;   // leen 0 incluso con pull-up: a GND
+  uint32_t enCorto = 0;
+  CortoGPIO cortos[GPIO_MAX_CORTOS];
+  uint8_t nCortos = 0;
+  uint32_t duracionUs = 0;
+
+  uint32_t funcionales() const { return siguenAlto & siguenBajo & ~enCorto; }
+  uint32_t problematicos() const { return pines & ~funcionales(); }
+};
+
+// Deja todos los pines del perfil como entradas sin pull al terminar
+void autotestGPIO(const PerfilPlaca& perfil, ResultadoAutotestGPIO& r);
@@ -0,0 +1,61 @@
+// Cola SPSC sin bloqueo entre el callback de escaneo BLE y loop()
+// El productor es la tarea host de BLE (onResult) y el consumidor el hilo de
+// loop(); solo se usan índices atómicos, sin secciones críticas ni heap.
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+// Registro compacto de un anuncio BLE (32 bytes)
+struct RegistroEscaneoBLE {
+  uint32_t ms;        // millis() al recibirlo
+  uint8_t mac[6];
+  int8_t rssi;
+  uint8_t longNombre; // 0 = sin nombre
+  char nombre[20];    // truncado, sin terminador
+};
+
+template <typename T, size_t N>
+class ColaSPSC {
+public:
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "La capacidad debe ser potencia de 2");
+
+  // Solo productor. false si la cola está llena (el registro se descarta)
+  bool push(const T& item) {
+    uint32_t cabeza = cabeza_.load(std::memory_order_relaxed);
+    uint32_t cola = cola_.load(std::memory_order_acquire);
+    if (cabeza - cola >= N) {
+      descartados_.store(descartados_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    items_[cabeza & (N - 1)] = item;
+    cabeza_.store(cabeza + 1, std::memory_order_release);
+    uint32_t ocupacion = cabeza + 1 - cola;
+    if (ocupacion > maxOcupacion_.load(std::memory_order_relaxed)) {
+      maxOcupacion_.store(ocupacion, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  // Solo consumidor
+  bool pop(T& item) {
+    uint32_t cola = cola_.load(std::memory_order_relaxed);
+    if (cola == cabeza_.load(std::memory_order_acquire)) return false;
+    item = items_[cola & (N - 1)];
+    cola_.store(cola + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t pendientes() const {
+    return cabeza_.load(std::memory_order_acquire) - cola_.load(std::memory_order_acquire);
+  }
+  uint32_t descartados() const { return descartados_.load(std::memory_order_relaxed); }
+  uint32_t maxOcupacion() const { return maxOcupacion_.load(std::memory_order_relaxed); }
+  static constexpr size_t capacidad() { return N; }
+
+private:
+  T items_[N];
+  std::atomic<uint32_t> cabeza_{0};  // escrito por el productor
+  std::atomic<uint32_t> cola_{0};    // escrito por el consumidor
+  std::atomic<uint32_t> descartados_{0};
+  std::atomic<uint32_t> maxOcupacion_{0};
+};
@@ -0,0 +1,90 @@
+#include "cache_wifi.h"
+#include "resultados.h"
+
+bool CacheWiFi::iniciarEscaneo() {
+  if (escaneando_) return true;
+
+  // Apagar la radio para escanear cortaba el AP; ahora solo se añade STA
+  modoPrevio_ = WiFi.getMode();
+  if (modoPrevio_ == WIFI_OFF) {
+    WiFi.mode(WIFI_STA);
+  } else if (modoPrevio_ == WIFI_AP) {
+    WiFi.mode(WIFI_AP_STA);
+  }
+  conAP_ = WiFi.getMode() == WIFI_AP_STA;
+
+  if (WiFi.scanNetworks(true, true, false, 300) == WIFI_SCAN_FAILED) {
+    restaurarModo();
+    return false;
+  }
+  escaneando_ = true;
+  return true;
+}
+
+bool CacheWiFi::sondear() {
+  if (!escaneando_) return true;
+  int16_t redes = WiFi.scanComplete();
+  if (redes == WIFI_SCAN_RUNNING) return false;
+
+  escaneando_ = false;
+  if (redes < 0) redes = 0;
+  encontradas_ = redes;
+  n_ = min((size_t)redes, (size_t)WIFI_CACHE_MAX);
+  // Registros crudos del driver: WiFi.SSID(i) crearía un String por red
+  size_t copiadas = 0;
+  for (size_t i = 0; i < n_; i++) {
+    const wifi_ap_record_t* ap = (const wifi_ap_record_t*)WiFi.getScanInfoByIndex(i);
+    if (!ap) break;
+    RedWiFi& r = redes_[copiadas++];
+    strlcpy(r.ssid, (const char*)ap->ssid, sizeof(r.ssid));
+    r.rssi = ap->rssi;
+    r.canal = ap->primary;
+    r.seguridad = (uint8_t)ap->authmode;
+  }
+  n_ = copiadas;
+  WiFi.scanDelete();
+  restaurarModo();
+
+  marca_ = millis();
+  escaneos_++;
+  valido_ = true;
+  return true;
+}
+
+// Solo deshace lo que puso iniciarEscaneo(): si entretanto se levantó el AP, se respeta
+void CacheWiFi::restaurarModo() {
+  wifi_mode_t actual = WiFi.getMode();
+  if (modoPrevio_ == WIFI_OFF && actual == WIFI_STA) {
+    WiFi.mode(WIFI_OFF);
+  } else if (modoPrevio_ == WIFI_AP && actual == WIFI_AP_STA) {
+    WiFi.mode(WIFI_AP);
+  }
+}
+
+void CacheWiFi::imprimirJSON(Print& out) const {
+  out.print("{\"edad_ms\":");
+  out.print((unsigned long)(tieneDatos() ? edadMs() : 0));
+  out.print(",\"ttl_ms\":");
+  out.print((unsigned long)ttl_);
+  out.print(",\"vigente\":");
+  out.print(vigente() ? "true" : "false");
+  out.print(",\"actualizando\":");
+  out.print(escaneando_ ? "true" : "false");
+  out.print(",\"encontradas\":");
+  out.print((unsigned)(tieneDatos() ? encontradas_ : 0));
+  out.print(",\"redes\":[");
+  for (size_t i = 0; tieneDatos() && i < n_; i++) {
+    const RedWiFi& r = redes_[i];
+    if (i) out.print(',');
+    out.print("{\"ssid\":");
+    imprimirTextoJSON(out, (const uint8_t*)r.ssid, strlen(r.ssid));
+    out.print(",\"rssi\":");
+    out.print((int)r.rssi);
+    out.print(",\"canal\":");
+    out.print((unsigned)r.canal);
+    out.print(",\"seguridad\":\"");
+    out.print(textoSeguridad(r.seguridad));
+    out.print("\"}");
+  }
+  out.print("]}");
+}
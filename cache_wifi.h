@@ -0,0 +1,66 @@
+// Caché de redes WiFi
+// El escaneo corre en modo asíncrono y en STA o AP+STA, así no tumba el punto de
+// acceso del File Manager. Los resultados quedan en registros compactos con una
+// vigencia (TTL): mientras no caduque, el comando '3' y /wifi responden desde aquí
+// sin tocar la radio; solo al caducar se vuelve a escanear.
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+
+#ifndef WIFI_CACHE_MAX
+#define WIFI_CACHE_MAX 24
+#endif
+// Vigencia de un escaneo; se puede cambiar con -DWIFI_CACHE_TTL_MS=... o setTTL()
+#ifndef WIFI_CACHE_TTL_MS
+#define WIFI_CACHE_TTL_MS 30000
+#endif
+
+struct RedWiFi {
+  char ssid[33];      // 32 + '\0'
+  int8_t rssi;
+  uint8_t canal;
+  uint8_t seguridad;  // wifi_auth_mode_t
+};
+
+class CacheWiFi {
+public:
+  // Lanza un escaneo asíncrono (añade STA al modo actual si hace falta).
+  // false si la radio lo rechaza; true también si ya había uno en curso
+  bool iniciarEscaneo();
+  // Sondea el escaneo en curso y, al terminar, vuelca los resultados y restaura
+  // el modo de la radio. true si no queda escaneo pendiente
+  bool sondear();
+  bool escaneando() const { return escaneando_; }
+
+  bool tieneDatos() const { return valido_; }
+  bool vigente() const { return tieneDatos() && edadMs() < ttl_; }
+  uint32_t edadMs() const { return millis() - marca_; }
+  void invalidar() { valido_ = false; }
+
+  void setTTL(uint32_t ms) { ttl_ = ms; }
+  uint32_t ttl() const { return ttl_; }
+
+  // Redes retenidas (las WIFI_CACHE_MAX primeras) y encontradas en total
+  size_t cantidad() const { return n_; }
+  uint16_t encontradas() const { return encontradas_; }
+  const RedWiFi& red(size_t i) const { return redes_[i]; }
+  // true si el último escaneo se hizo con el punto de acceso activo (AP+STA)
+  bool conAP() const { return conAP_; }
+  uint32_t escaneos() const { return escaneos_; }
+
+  void imprimirJSON(Print& out) const;
+
+private:
+  void restaurarModo();
+
+  RedWiFi redes_[WIFI_CACHE_MAX];
+  size_t n_ = 0;
+  uint16_t encontradas_ = 0;
+  uint32_t marca_ = 0;  // millis() al terminar el último escaneo
+  uint32_t ttl_ = WIFI_CACHE_TTL_MS;
+  uint32_t escaneos_ = 0;
+  wifi_mode_t modoPrevio_ = WIFI_OFF;
+  bool escaneando_ = false;
+  bool valido_ = false;
+  bool conAP_ = false;
+};
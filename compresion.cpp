@@ -0,0 +1,376 @@
+#include "compresion.h"
+#include "crc32.h"
+
+// Longitudes (símbolos 257..285) y distancias (códigos 0..29) de RFC 1951 3.2.5
+static const uint16_t BASE_LONGITUD[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                           31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t EXTRA_LONGITUD[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                           2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t BASE_DISTANCIA[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+                                            33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+                                            1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t EXTRA_DISTANCIA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                            6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+#define MASCARA_VENTANA (COMPRESION_VENTANA - 1)
+#define GZIP_FEXTRA 0x04
+#define GZIP_FNAME 0x08
+#define GZIP_FCOMMENT 0x10
+#define GZIP_FHCRC 0x02
+
+// === COMPRESOR ===
+
+void CompresorGzip::iniciar(Print& out) {
+  out_ = &out;
+  memset(cabeza_, 0xFF, sizeof(cabeza_));
+  memset(previo_, 0xFF, sizeof(previo_));
+  pos_ = fin_ = 0;
+  bits_ = 0;
+  nBits_ = nSalida_ = 0;
+  crc_ = entrada_ = salida_ = 0;
+  // ID1 ID2, deflate, sin flags ni fecha, XFL 0, SO desconocido
+  static const uint8_t cabecera[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+  for (uint8_t b : cabecera) byte(b);
+  // Un bloque fijo abierto hasta terminar(): BFINAL=0, BTYPE=01
+  bits(0, 1);
+  bits(1, 2);
+}
+
+size_t CompresorGzip::write(const uint8_t* datos, size_t len) {
+  size_t total = len;
+  crc_ = crc32(datos, len, crc_);
+  entrada_ += len;
+  while (len) {
+    if (fin_ == sizeof(ventana_)) deslizar();
+    size_t n = min(len, sizeof(ventana_) - fin_);
+    memcpy(ventana_ + fin_, datos, n);
+    fin_ += n;
+    datos += n;
+    len -= n;
+    codificar(false);
+  }
+  return total;
+}
+
+void CompresorGzip::terminar() {
+  codificar(true);
+  simbolo(256);
+  // Bloque final vacío: BFINAL=1, BTYPE=01, fin de bloque
+  bits(1, 1);
+  bits(1, 2);
+  simbolo(256);
+  if (nBits_) bits(0, 8 - nBits_);
+  for (uint8_t i = 0; i < 32; i += 8) byte((uint8_t)(crc_ >> i));
+  for (uint8_t i = 0; i < 32; i += 8) byte((uint8_t)(entrada_ >> i));
+  vaciarSalida();
+}
+
+uint16_t CompresorGzip::hash(const uint8_t* p) {
+  uint32_t v = (uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2];
+  return (uint16_t)((v * 2654435761u) >> (32 - HASH_BITS));
+}
+
+void CompresorGzip::insertar(uint16_t p) {
+  if (fin_ - p < MIN_COINCIDENCIA) return;
+  uint16_t h = hash(ventana_ + p);
+  previo_[p & MASCARA_VENTANA] = cabeza_[h];
+  cabeza_[h] = p;
+}
+
+// La mitad antigua sale del buffer; las posiciones guardadas bajan una ventana
+void CompresorGzip::deslizar() {
+  memmove(ventana_, ventana_ + COMPRESION_VENTANA, COMPRESION_VENTANA);
+  fin_ -= COMPRESION_VENTANA;
+  pos_ -= COMPRESION_VENTANA;
+  for (uint16_t& p : cabeza_) p = p == NADA || p < COMPRESION_VENTANA ? NADA : p - COMPRESION_VENTANA;
+  for (uint16_t& p : previo_) p = p == NADA || p < COMPRESION_VENTANA ? NADA : p - COMPRESION_VENTANA;
+}
+
+// LZ77 voraz: se espera a tener MAX_COINCIDENCIA bytes por delante salvo al final
+void CompresorGzip::codificar(bool final) {
+  while (fin_ - pos_ >= (final ? 1 : MAX_COINCIDENCIA)) {
+    uint16_t maxLen = min((uint16_t)(fin_ - pos_), MAX_COINCIDENCIA);
+    uint16_t mejorLen = 0, mejorDist = 0;
+    if (maxLen >= MIN_COINCIDENCIA) {
+      uint16_t cand = cabeza_[hash(ventana_ + pos_)];
+      for (uint8_t i = 0; cand != NADA && i < COMPRESION_CADENA; i++) {
+        uint16_t dist = pos_ - cand;
+        if (cand >= pos_ || dist > COMPRESION_VENTANA) break;
+        if (ventana_[cand + mejorLen] == ventana_[pos_ + mejorLen]) {
+          uint16_t l = 0;
+          while (l < maxLen && ventana_[cand + l] == ventana_[pos_ + l]) l++;
+          if (l > mejorLen) {
+            mejorLen = l;
+            mejorDist = dist;
+            if (l == maxLen) break;
+          }
+        }
+        cand = previo_[cand & MASCARA_VENTANA];
+      }
+    }
+
+    if (mejorLen < MIN_COINCIDENCIA) {
+      simbolo(ventana_[pos_]);
+      insertar(pos_++);
+      continue;
+    }
+    uint8_t i = 28;
+    while (BASE_LONGITUD[i] > mejorLen) i--;
+    simbolo(257 + i);
+    bits(mejorLen - BASE_LONGITUD[i], EXTRA_LONGITUD[i]);
+    uint8_t d = 29;
+    while (BASE_DISTANCIA[d] > mejorDist) d--;
+    // Código de distancia fijo de 5 bits, el más significativo primero
+    uint8_t invertido = 0;
+    for (uint8_t b = 0; b < 5; b++) invertido |= ((d >> b) & 1) << (4 - b);
+    bits(invertido, 5);
+    bits(mejorDist - BASE_DISTANCIA[d], EXTRA_DISTANCIA[d]);
+    for (uint16_t k = 0; k < mejorLen; k++) insertar(pos_++);
+  }
+}
+
+// Código Huffman fijo de un literal/longitud (RFC 1951 3.2.6), invertido para el flujo LSB
+void CompresorGzip::simbolo(uint16_t s) {
+  uint16_t codigo;
+  uint8_t n;
+  if (s < 144) {
+    codigo = 0x30 + s;
+    n = 8;
+  } else if (s < 256) {
+    codigo = 0x190 + s - 144;
+    n = 9;
+  } else if (s < 280) {
+    codigo = s - 256;
+    n = 7;
+  } else {
+    codigo = 0xC0 + s - 280;
+    n = 8;
+  }
+  uint16_t invertido = 0;
+  for (uint8_t b = 0; b < n; b++) invertido |= ((codigo >> b) & 1) << (n - 1 - b);
+  bits(invertido, n);
+}
+
+void CompresorGzip::bits(uint32_t v, uint8_t n) {
+  bits_ |= v << nBits_;
+  nBits_ += n;
+  while (nBits_ >= 8) {
+    byte((uint8_t)bits_);
+    bits_ >>= 8;
+    nBits_ -= 8;
+  }
+}
+
+void CompresorGzip::byte(uint8_t b) {
+  salidaBuf_[nSalida_++] = b;
+  if (nSalida_ == sizeof(salidaBuf_)) vaciarSalida();
+}
+
+void CompresorGzip::vaciarSalida() {
+  if (!nSalida_) return;
+  out_->write(salidaBuf_, nSalida_);
+  salida_ += nSalida_;
+  nSalida_ = 0;
+}
+
+// === DESCOMPRESOR ===
+
+bool DescompresorGzip::tamanoOriginal(File& f, uint32_t& tam) {
+  uint8_t cola[4];
+  size_t total = f.size();
+  bool ok = total >= 18 && f.seek(total - 4) && f.read(cola, 4) == 4;
+  f.seek(0);
+  if (ok) tam = (uint32_t)cola[0] | (uint32_t)cola[1] << 8 | (uint32_t)cola[2] << 16 | (uint32_t)cola[3] << 24;
+  return ok;
+}
+
+int DescompresorGzip::leerByte() {
+  if (posEntrada_ == nEntrada_) {
+    nEntrada_ = (uint8_t)in_->read(entradaBuf_, sizeof(entradaBuf_));
+    posEntrada_ = 0;
+    if (nEntrada_ == 0) return -1;
+  }
+  return entradaBuf_[posEntrada_++];
+}
+
+// Bits extra y cabeceras de bloque: el menos significativo primero
+int32_t DescompresorGzip::leerBits(uint8_t n) {
+  while (nBits_ < n) {
+    int b = leerByte();
+    if (b < 0) return -1;
+    bits_ |= (uint32_t)b << nBits_;
+    nBits_ += 8;
+  }
+  int32_t v = (int32_t)(bits_ & ((1u << n) - 1));
+  bits_ >>= n;
+  nBits_ -= n;
+  return v;
+}
+
+// Los códigos Huffman van con el bit más significativo primero: se leen de uno en uno
+int DescompresorGzip::simboloFijo() {
+  int codigo = 0;
+  for (uint8_t n = 1; n <= 9; n++) {
+    int32_t b = leerBits(1);
+    if (b < 0) return -1;
+    codigo = codigo << 1 | b;
+    if (n == 7 && codigo <= 23) return 256 + codigo;
+    if (n == 8 && codigo >= 0x30 && codigo <= 0xBF) return codigo - 0x30;
+    if (n == 8 && codigo >= 0xC0 && codigo <= 0xC7) return 280 + codigo - 0xC0;
+    if (n == 9 && codigo >= 0x190) return 144 + codigo - 0x190;
+  }
+  return -1;
+}
+
+bool DescompresorGzip::iniciar(File& in) {
+  in_ = &in;
+  nEntrada_ = posEntrada_ = 0;
+  bits_ = 0;
+  nBits_ = 0;
+  producidos_ = crc_ = 0;
+  ultimo_ = false;
+  estado_ = D_ERROR;
+
+  uint8_t cab[10];
+  for (uint8_t& b : cab) {
+    int c = leerByte();
+    if (c < 0) return false;
+    b = (uint8_t)c;
+  }
+  if (cab[0] != 0x1f || cab[1] != 0x8b || cab[2] != 8) return false;
+  uint8_t flags = cab[3];
+  if (flags & GZIP_FEXTRA) {
+    int32_t xlen = leerBits(16);
+    while (xlen-- > 0) leerByte();
+  }
+  for (uint8_t f : {GZIP_FNAME, GZIP_FCOMMENT}) {
+    if (!(flags & f)) continue;
+    int c;
+    while ((c = leerByte()) > 0) {
+    }
+  }
+  if (flags & GZIP_FHCRC) leerBits(16);
+  estado_ = D_BLOQUE;
+  return true;
+}
+
+// Tras el bloque final: CRC-32 y tamaño, alineados a byte
+void DescompresorGzip::cola(uint32_t crc) {
+  bits_ = 0;
+  nBits_ = 0;
+  uint32_t crcArchivo = 0, tam = 0;
+  for (uint8_t i = 0; i < 32; i += 8) {
+    int c = leerByte();
+    if (c < 0) {
+      estado_ = D_ERROR;
+      return;
+    }
+    crcArchivo |= (uint32_t)c << i;
+  }
+  for (uint8_t i = 0; i < 32; i += 8) {
+    int c = leerByte();
+    if (c < 0) {
+      estado_ = D_ERROR;
+      return;
+    }
+    tam |= (uint32_t)c << i;
+  }
+  estado_ = crcArchivo == crc && tam == producidos_ ? D_FIN : D_ERROR;
+}
+
+size_t DescompresorGzip::leer(uint8_t* buf, size_t len) {
+  size_t n = 0;
+  auto emitir = [&](uint8_t c) {
+    ventana_[producidos_++ & MASCARA_VENTANA] = c;
+    buf[n++] = c;
+  };
+
+  while (n < len) {
+    switch (estado_) {
+      case D_BLOQUE: {
+        if (ultimo_) {
+          crc_ = crc32(buf, n, crc_);
+          cola(crc_);
+          return n;
+        }
+        int32_t cab = leerBits(3);
+        if (cab < 0) {
+          estado_ = D_ERROR;
+          break;
+        }
+        ultimo_ = cab & 1;
+        if (cab >> 1 == 1) {
+          estado_ = D_FIJO;
+        } else if (cab >> 1 == 0) {
+          // Almacenado: LEN y NLEN alineados a byte
+          bits_ >>= nBits_ % 8;
+          nBits_ -= nBits_ % 8;
+          int32_t l = leerBits(16), nl = leerBits(16);
+          if (l < 0 || nl < 0 || (l ^ nl) != 0xFFFF) {
+            estado_ = D_ERROR;
+            break;
+          }
+          almacenado_ = (uint16_t)l;
+          estado_ = D_ALMACENADO;
+        } else {
+          estado_ = D_ERROR;  // Huffman dinámico: no lo produce CompresorGzip
+        }
+        break;
+      }
+      case D_ALMACENADO: {
+        if (almacenado_ == 0) {
+          estado_ = D_BLOQUE;
+          break;
+        }
+        int32_t c = leerBits(8);
+        if (c < 0) {
+          estado_ = D_ERROR;
+          break;
+        }
+        emitir((uint8_t)c);
+        almacenado_--;
+        break;
+      }
+      case D_FIJO: {
+        int s = simboloFijo();
+        if (s < 0 || s > 285) {
+          estado_ = D_ERROR;
+        } else if (s < 256) {
+          emitir((uint8_t)s);
+        } else if (s == 256) {
+          estado_ = D_BLOQUE;
+        } else {
+          int32_t extra = leerBits(EXTRA_LONGITUD[s - 257]);
+          int32_t d = 0;
+          for (uint8_t b = 0; b < 5 && d >= 0; b++) {
+            int32_t bit = leerBits(1);
+            d = bit < 0 ? -1 : d << 1 | bit;
+          }
+          int32_t extraDist = d >= 0 && d < 30 ? leerBits(EXTRA_DISTANCIA[d]) : -1;
+          if (extra < 0 || extraDist < 0) {
+            estado_ = D_ERROR;
+            break;
+          }
+          copiaLen_ = BASE_LONGITUD[s - 257] + extra;
+          copiaDist_ = BASE_DISTANCIA[d] + extraDist;
+          if (copiaDist_ > COMPRESION_VENTANA || copiaDist_ > producidos_) {
+            estado_ = D_ERROR;
+            break;
+          }
+          estado_ = D_COPIA;
+        }
+        break;
+      }
+      case D_COPIA:
+        emitir(ventana_[(producidos_ - copiaDist_) & MASCARA_VENTANA]);
+        if (--copiaLen_ == 0) estado_ = D_FIJO;
+        break;
+      case D_FIN:
+      case D_ERROR:
+        crc_ = crc32(buf, n, crc_);
+        return n;
+    }
+  }
+  crc_ = crc32(buf, n, crc_);
+  return n;
+}
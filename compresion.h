@@ -0,0 +1,104 @@
+// Compresión gzip por flujo para las exportaciones
+// Deflate (RFC 1951) con los códigos Huffman fijos del bloque tipo 1 y LZ77
+// sobre una ventana de COMPRESION_VENTANA bytes: sin tablas dinámicas ni los
+// 32 KB de ventana de zlib, cabe en unos KB de RAM estática y el resultado es
+// un .gz estándar que el navegador descomprime solo (Content-Encoding: gzip).
+//
+// El descompresor entiende lo que produce el compresor (bloques fijos y
+// almacenados, distancias dentro de la ventana), no cualquier gzip: basta para
+// leer las exportaciones propias y servirlas a quien no acepta gzip.
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+
+// Ventana de LZ77; la RAM del compresor es ~3x esto y la del descompresor 1x
+#ifndef COMPRESION_VENTANA
+#define COMPRESION_VENTANA 2048
+#endif
+static_assert((COMPRESION_VENTANA & (COMPRESION_VENTANA - 1)) == 0 && COMPRESION_VENTANA >= 512 &&
+                  COMPRESION_VENTANA <= 16384,
+              "COMPRESION_VENTANA debe ser potencia de 2 entre 512 y 16384");
+// Candidatos que se prueban por posición: más da mejor ratio y más CPU
+#ifndef COMPRESION_CADENA
+#define COMPRESION_CADENA 16
+#endif
+
+class CompresorGzip : public Print {
+public:
+  // Escribe la cabecera gzip en out; lo que se escriba después sale comprimido
+  void iniciar(Print& out);
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* datos, size_t len) override;
+  using Print::write;
+  // Codifica lo pendiente y cierra con el bloque final, el CRC-32 y el tamaño
+  void terminar();
+
+  uint32_t entrada() const { return entrada_; }
+  uint32_t salida() const { return salida_; }
+
+private:
+  static constexpr uint16_t MIN_COINCIDENCIA = 3;
+  static constexpr uint16_t MAX_COINCIDENCIA = 258;
+  static constexpr uint8_t HASH_BITS = 10;
+  static constexpr uint16_t NADA = 0xFFFF;
+
+  void codificar(bool final);
+  void insertar(uint16_t p);
+  void deslizar();
+  void simbolo(uint16_t s);
+  void bits(uint32_t v, uint8_t n);
+  void byte(uint8_t b);
+  void vaciarSalida();
+  static uint16_t hash(const uint8_t* p);
+
+  Print* out_ = nullptr;
+  uint8_t ventana_[2 * COMPRESION_VENTANA];
+  uint16_t cabeza_[1 << HASH_BITS];       // última posición de cada hash
+  uint16_t previo_[COMPRESION_VENTANA];   // posición anterior con el mismo hash
+  uint16_t pos_ = 0;                      // siguiente byte por codificar
+  uint16_t fin_ = 0;                      // bytes válidos en ventana_
+  uint32_t bits_ = 0;
+  uint8_t nBits_ = 0;
+  uint8_t salidaBuf_[128];
+  uint8_t nSalida_ = 0;
+  uint32_t crc_ = 0;
+  uint32_t entrada_ = 0;
+  uint32_t salida_ = 0;
+};
+
+class DescompresorGzip {
+public:
+  // Valida la cabecera gzip de in; false si no lo es
+  bool iniciar(File& in);
+  // Hasta len bytes descomprimidos; 0 al terminar o ante un error
+  size_t leer(uint8_t* buf, size_t len);
+  bool terminado() const { return estado_ == D_FIN; }
+  bool error() const { return estado_ == D_ERROR; }
+  uint32_t producidos() const { return producidos_; }
+
+  // Tamaño original que guarda la cola del gzip, sin descomprimir; deja f al principio
+  static bool tamanoOriginal(File& f, uint32_t& tam);
+
+private:
+  enum Estado : uint8_t { D_BLOQUE, D_ALMACENADO, D_FIJO, D_COPIA, D_FIN, D_ERROR };
+
+  int leerByte();
+  int32_t leerBits(uint8_t n);
+  int simboloFijo();
+  void cola(uint32_t crc);
+
+  File* in_ = nullptr;
+  uint8_t entradaBuf_[64];
+  uint8_t nEntrada_ = 0;
+  uint8_t posEntrada_ = 0;
+  uint32_t bits_ = 0;
+  uint8_t nBits_ = 0;
+  uint8_t ventana_[COMPRESION_VENTANA];
+  uint32_t producidos_ = 0;
+  uint32_t crc_ = 0;
+  uint16_t copiaLen_ = 0;
+  uint16_t copiaDist_ = 0;
+  uint16_t almacenado_ = 0;
+  bool ultimo_ = false;
+  Estado estado_ = D_FIN;
+};
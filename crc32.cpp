@@ -0,0 +1,25 @@
+#include "crc32.h"
+
+namespace {
+
+struct TablaCRC32 {
+  uint32_t v[256];
+  constexpr TablaCRC32() : v() {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      v[i] = c;
+    }
+  }
+};
+
+constexpr TablaCRC32 tabla;
+
+}  // namespace
+
+uint32_t crc32(const void* datos, size_t len, uint32_t crc) {
+  const uint8_t* p = (const uint8_t*)datos;
+  crc = ~crc;
+  while (len--) crc = tabla.v[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
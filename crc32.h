@@ -0,0 +1,8 @@
+// CRC-32 (IEEE 802.3, polinomio reflejado 0xEDB88320), el mismo que zlib
+// La tabla de 256 entradas se genera en compilación y queda en flash.
+// Para calcularlo por trozos se encadena el resultado: crc = crc32(b, n, crc).
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+uint32_t crc32(const void* datos, size_t len, uint32_t crc = 0);
@@ -0,0 +1,201 @@
+#include "eventos.h"
+#include <lwip/sockets.h>
+#include <errno.h>
+
+// Cola de un evento "historial": "\nid: 4294967295\n\n"
+#define RESERVA_COLA 24
+
+static const char CABECERA_SSE[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream; charset=utf-8\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n"
+    "retry: 2000\n\n";
+
+// Escribe en el buffer de un cliente hasta un límite, partiendo el texto en
+// líneas "data: " (los \r de println sobran: SSE separa con \n)
+class EscritorDatos : public Print {
+public:
+  EscritorDatos(uint8_t* buf, uint16_t& fin, uint16_t limite) : buf_(buf), fin_(fin), limite_(limite) {}
+
+  size_t write(uint8_t c) override {
+    if (c == '\r') return 1;
+    if (c == '\n') return poner((const uint8_t*)"\ndata: ", 7) ? 1 : 0;
+    return poner(&c, 1) ? 1 : 0;
+  }
+  size_t write(const uint8_t* datos, size_t len) override {
+    size_t n = 0;
+    while (n < len && write(datos[n])) n++;
+    return n;
+  }
+  using Print::write;
+
+private:
+  bool poner(const uint8_t* p, uint16_t n) {
+    if (fin_ + n > limite_) return false;
+    memcpy(buf_ + fin_, p, n);
+    fin_ += n;
+    return true;
+  }
+
+  uint8_t* buf_;
+  uint16_t& fin_;
+  uint16_t limite_;
+};
+
+static uint16_t libre(uint16_t fin) { return EVENTOS_BUFFER - fin; }
+
+static void anexar(uint8_t* buf, uint16_t& fin, const char* texto, size_t len) {
+  if (len > libre(fin)) len = libre(fin);
+  memcpy(buf + fin, texto, len);
+  fin += len;
+}
+
+static void anexarEvento(uint8_t* buf, uint16_t& fin, const char* evento, const char* datos) {
+  char linea[80];
+  int n = snprintf(linea, sizeof(linea), "event: %s\ndata: %s\n\n", evento, datos);
+  anexar(buf, fin, linea, n < (int)sizeof(linea) ? n : sizeof(linea) - 1);
+}
+
+bool ServidorEventos::aceptar(WiFiClient cliente, const String& ultimoId, const BitacoraResultados& b,
+                              const IndiceArchivos& indice) {
+  if (n_ == EVENTOS_CLIENTES_MAX) {
+    rechazados_++;
+    return false;
+  }
+  Cliente& c = clientes_[n_++];
+  c.conexion = cliente;
+  c.conexion.setNoDelay(true);
+  c.cursor = CursorRender();
+  c.cursor.pos = b.fin();
+  if (ultimoId.length()) {
+    uint32_t id = strtoul(ultimoId.c_str(), nullptr, 10);
+    if ((int32_t)(id - b.fin()) > 0) {
+      // Id de antes de un reinicio: todo lo retenido es nuevo para la página
+      c.cursor.pos = b.primero();
+    } else if ((int32_t)(id - b.primero()) < 0) {
+      c.cursor.pos = id;  // rellenar() avisa del desfase
+    } else {
+      // Se sigue desde el primer registro completo a partir del id
+      BitacoraResultados::Registro r;
+      c.cursor.pos = b.primero();
+      while ((int32_t)(id - c.cursor.pos) > 0 && b.leer(c.cursor.pos, r)) {}
+    }
+  }
+  c.listosVistos = listos_;
+  c.generacionVista = indice.generacion();
+  c.ultimoEnvioMs = c.ultimoSondeoMs = millis();
+  c.ini = c.fin = 0;
+  anexar(c.buf, c.fin, CABECERA_SSE, sizeof(CABECERA_SSE) - 1);
+  conexiones_++;
+  return true;
+}
+
+void ServidorEventos::notificarListo(const char* origen) {
+  strncpy(listo_, origen, sizeof(listo_) - 1);
+  listo_[sizeof(listo_) - 1] = '\0';
+  listos_++;
+}
+
+void ServidorEventos::rellenar(Cliente& c, const BitacoraResultados& b, const IndiceArchivos& indice,
+                               uint32_t ahora) {
+  if (c.ini) {
+    memmove(c.buf, c.buf + c.ini, c.fin - c.ini);
+    c.fin -= c.ini;
+    c.ini = 0;
+  }
+  char num[12];
+
+  if (c.generacionVista != indice.generacion() && libre(c.fin) >= 64) {
+    c.generacionVista = indice.generacion();
+    snprintf(num, sizeof(num), "%lu", (unsigned long)c.generacionVista);
+    anexarEvento(c.buf, c.fin, "archivos", num);
+    eventos_++;
+  }
+
+  // Un registro por evento, mientras quepa el peor caso
+  while (c.cursor.pos != b.fin() && libre(c.fin) >= EVENTOS_REGISTRO_MAX) {
+    if ((int32_t)(c.cursor.pos - b.primero()) < 0) {
+      snprintf(num, sizeof(num), "%lu", (unsigned long)(b.primero() - c.cursor.pos));
+      anexarEvento(c.buf, c.fin, "desfase", num);
+      c.cursor = CursorRender();
+      c.cursor.pos = b.primero();
+      desfases_++;
+      eventos_++;
+      continue;
+    }
+    uint16_t inicio = c.fin;
+    anexar(c.buf, c.fin, "event: historial\ndata: ", 23);
+    uint16_t cuerpo = c.fin;
+    EscritorDatos datos(c.buf, c.fin, EVENTOS_BUFFER - RESERVA_COLA);
+    b.mostrarSiguiente(datos, c.cursor);
+    if (c.fin == cuerpo) {
+      c.fin = inicio;  // nota o registro sin texto propio
+      continue;
+    }
+    char cola[RESERVA_COLA];
+    int n = snprintf(cola, sizeof(cola), "\nid: %lu\n\n", (unsigned long)c.cursor.pos);
+    anexar(c.buf, c.fin, cola, n);
+    eventos_++;
+  }
+
+  // "listo" después de todo lo que escribió el comando
+  if (c.listosVistos != listos_ && c.cursor.pos == b.fin() && libre(c.fin) >= 64) {
+    c.listosVistos = listos_;
+    anexarEvento(c.buf, c.fin, "listo", listo_);
+    eventos_++;
+  }
+
+  if (c.fin == 0 && ahora - c.ultimoEnvioMs >= EVENTOS_LATIDO_MS) anexar(c.buf, c.fin, ":\n\n", 3);
+}
+
+bool ServidorEventos::vaciar(Cliente& c, uint32_t ahora) {
+  if (c.ini == c.fin) return true;
+  ssize_t n = send(c.conexion.fd(), c.buf + c.ini, c.fin - c.ini, MSG_DONTWAIT | MSG_NOSIGNAL);
+  if (n > 0) {
+    c.ini += n;
+    bytes_ += n;
+    c.ultimoEnvioMs = ahora;
+    if (c.ini == c.fin) c.ini = c.fin = 0;
+    return true;
+  }
+  if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+    // Ventana TCP llena: el cliente no lee. Se espera sin bloquear, con un límite
+    if (ahora - c.ultimoEnvioMs < EVENTOS_ATASCO_MS) return true;
+    atascados_++;
+  }
+  return false;
+}
+
+void ServidorEventos::cerrar(uint8_t i) {
+  clientes_[i].conexion.stop();
+  if (i != n_ - 1) clientes_[i] = clientes_[n_ - 1];
+  clientes_[n_ - 1].conexion = WiFiClient();
+  n_--;
+}
+
+void ServidorEventos::atender(const BitacoraResultados& b, const IndiceArchivos& indice) {
+  if (n_ == 0) return;
+  uint32_t ahora = millis();
+  for (uint8_t i = 0; i < n_;) {
+    Cliente& c = clientes_[i];
+    // Varias rondas mientras el socket se lo lleve todo: una salida larga no
+    // espera a la siguiente vuelta de loop() por el tamaño del buffer
+    bool vivo = true;
+    for (uint8_t ronda = 0; vivo && ronda < EVENTOS_RONDAS; ronda++) {
+      uint16_t antes = c.fin;
+      rellenar(c, b, indice, ahora);
+      if (c.fin == antes && ronda) break;
+      vivo = vaciar(c, ahora);
+      if (c.fin) break;  // ventana llena
+    }
+    // Un cliente que no recibe nada no se entera de un cierre al escribir
+    if (vivo && c.ini == c.fin && ahora - c.ultimoSondeoMs >= EVENTOS_SONDEO_MS) {
+      c.ultimoSondeoMs = ahora;
+      vivo = c.conexion.connected();
+    }
+    if (vivo) i++;
+    else cerrar(i);
+  }
+}
@@ -0,0 +1,94 @@
+// Eventos en vivo para la página web (Server-Sent Events en /eventos)
+// El navegador deja abierta una conexión y el ESP32 empuja solo lo que cambió,
+// en lugar de que la página sondee /list cada pocos segundos:
+//   event: historial  id: <posición>  data: texto de un registro nuevo de la bitácora
+//   event: listo      data: comando o diagnóstico que terminó
+//   event: archivos   data: generación del índice de SPIFFS (hubo escritura o borrado)
+//   event: desfase    data: bytes de historial que el cliente se perdió por ir lento
+//
+// Sin colas de eventos: cada cliente lee el historial con su propio cursor y
+// "listo"/"archivos" son estados que se comparan con lo último enviado. Un
+// cliente lento solo se retrasa (los avisos se funden en uno) y la memoria no
+// crece: el buffer de envío de cada cliente es fijo y se rellena cuando el
+// socket acepta datos. Si el historial gira por delante del cursor el cliente
+// recibe "desfase"; si no acepta nada en EVENTOS_ATASCO_MS se le desconecta.
+// El id de cada registro es su posición en el historial: al reconectar, el
+// navegador la devuelve en Last-Event-ID y se sigue desde ahí sin repetir nada.
+#pragma once
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include "resultados.h"
+#include "indice_archivos.h"
+
+#ifndef EVENTOS_CLIENTES_MAX
+#define EVENTOS_CLIENTES_MAX 3
+#endif
+// Buffer de envío por cliente; solo se renderiza un registro si quedan
+// EVENTOS_REGISTRO_MAX bytes libres
+#ifndef EVENTOS_BUFFER
+#define EVENTOS_BUFFER 1536
+#endif
+#define EVENTOS_REGISTRO_MAX 640
+static_assert(EVENTOS_BUFFER >= 2 * EVENTOS_REGISTRO_MAX, "EVENTOS_BUFFER no admite dos registros");
+// Rondas de rellenar y enviar por cliente en cada atender()
+#define EVENTOS_RONDAS 4
+// Sin aceptar datos durante este tiempo, el cliente se da por muerto
+#ifndef EVENTOS_ATASCO_MS
+#define EVENTOS_ATASCO_MS 30000
+#endif
+// Comentario vacío para mantener viva una conexión sin eventos
+#define EVENTOS_LATIDO_MS 15000
+// Cada cuánto se mira si un cliente sin nada que enviar sigue conectado
+#define EVENTOS_SONDEO_MS 1000
+
+class ServidorEventos {
+public:
+  // Adopta la conexión de la petición en curso y le responde con la cabecera
+  // SSE (sin esperar al socket). ultimoId: cabecera Last-Event-ID, vacía si no
+  // hay. false si no queda hueco.
+  bool aceptar(WiFiClient cliente, const String& ultimoId, const BitacoraResultados& b,
+               const IndiceArchivos& indice);
+
+  // Un comando o diagnóstico terminó: se avisa cuando el cliente tenga todo su historial
+  void notificarListo(const char* origen);
+
+  // Rellena los buffers y envía lo que cada socket acepte, sin bloquear.
+  // Barato sin clientes; llamar en cada vuelta de loop()
+  void atender(const BitacoraResultados& b, const IndiceArchivos& indice);
+
+  size_t clientes() const { return n_; }
+  uint32_t conexiones() const { return conexiones_; }
+  uint32_t eventos() const { return eventos_; }
+  uint32_t bytesEnviados() const { return bytes_; }
+  uint32_t desfases() const { return desfases_; }
+  uint32_t atascados() const { return atascados_; }
+  uint32_t rechazados() const { return rechazados_; }
+
+private:
+  struct Cliente {
+    WiFiClient conexion;
+    CursorRender cursor;
+    uint32_t listosVistos;
+    uint32_t generacionVista;
+    uint32_t ultimoEnvioMs;    // último byte aceptado por el socket
+    uint32_t ultimoSondeoMs;
+    uint16_t ini;              // pendiente de enviar: buf[ini, fin)
+    uint16_t fin;
+    uint8_t buf[EVENTOS_BUFFER];
+  };
+
+  void rellenar(Cliente& c, const BitacoraResultados& b, const IndiceArchivos& indice, uint32_t ahora);
+  bool vaciar(Cliente& c, uint32_t ahora);
+  void cerrar(uint8_t i);
+
+  Cliente clientes_[EVENTOS_CLIENTES_MAX];
+  uint8_t n_ = 0;
+  char listo_[32] = "";
+  uint32_t listos_ = 0;
+  uint32_t conexiones_ = 0;
+  uint32_t eventos_ = 0;
+  uint32_t bytes_ = 0;
+  uint32_t desfases_ = 0;
+  uint32_t atascados_ = 0;
+  uint32_t rechazados_ = 0;
+};
@@ -0,0 +1,244 @@
+#include "exportaciones.h"
+#include <SPIFFS.h>
+#include <time.h>
+#include "crc32.h"
+
+#define INDICE_MAGIA 0x49505845u  // "EXPI"
+#define INDICE_VERSION 1
+
+struct CabeceraIndice {
+  uint32_t magia;
+  uint8_t version;
+  uint8_t n;
+  uint16_t tamEntrada;
+  uint32_t siguiente;
+  uint32_t crc;  // de la cabecera (con crc = 0) y las entradas
+};
+
+static const char* const extensiones[] = {".txt", ".json", ".csv"};
+
+const char* AlmacenExportaciones::nombreFormato(uint8_t formato) {
+  switch (formato) {
+    case FMT_JSON: return "JSON";
+    case FMT_CSV: return "CSV";
+    default: return "TXT";
+  }
+}
+
+void AlmacenExportaciones::nombre(const EntradaExportacion& e, char* out, size_t len) {
+  snprintf(out, len, EXPORTAR_PREFIJO "%06lu%s%s", (unsigned long)e.seq, extensiones[e.formato < 3 ? e.formato : 0],
+           e.gzip ? ".gz" : "");
+}
+
+void AlmacenExportaciones::imprimirSecciones(Print& out, uint16_t secciones, const char* separador) {
+  bool primera = true;
+  for (uint8_t s = 0; s < SEC_TOTAL; s++) {
+    if (!(secciones & (1u << s))) continue;
+    if (!primera) out.print(separador);
+    out.print(nombreSeccion(s));
+    primera = false;
+  }
+}
+
+bool AlmacenExportaciones::cargar() {
+  File f = SPIFFS.open(EXPORTAR_INDICE, "r");
+  if (!f) return false;
+  CabeceraIndice c;
+  bool ok = f.read((uint8_t*)&c, sizeof(c)) == sizeof(c) && c.magia == INDICE_MAGIA && c.version == INDICE_VERSION &&
+            c.tamEntrada == sizeof(EntradaExportacion) && c.n <= EXPORTAR_MAX_ARCHIVOS &&
+            f.read((uint8_t*)entradas_, c.n * sizeof(EntradaExportacion)) == c.n * sizeof(EntradaExportacion);
+  f.close();
+  if (!ok) return false;
+  uint32_t crc = c.crc;
+  c.crc = 0;
+  if (crc32(entradas_, c.n * sizeof(EntradaExportacion), crc32(&c, sizeof(c))) != crc) return false;
+  n_ = c.n;
+  siguiente_ = c.siguiente;
+  return true;
+}
+
+void AlmacenExportaciones::guardar() {
+  CabeceraIndice c = {INDICE_MAGIA, INDICE_VERSION, (uint8_t)n_, sizeof(EntradaExportacion), siguiente_, 0};
+  c.crc = crc32(entradas_, n_ * sizeof(EntradaExportacion), crc32(&c, sizeof(c)));
+  File f = SPIFFS.open(EXPORTAR_INDICE, "w");
+  if (!f) return;
+  f.write((const uint8_t*)&c, sizeof(c));
+  f.write((const uint8_t*)entradas_, n_ * sizeof(EntradaExportacion));
+  f.close();
+}
+
+// Entrada de un nombre con la forma que da nombre(); false para cualquier otro
+// archivo (también los /diagnostico_<millis> de antes, que se dejan como están)
+static bool entradaDesdeNombre(const char* nombreArchivo, EntradaExportacion& e) {
+  size_t prefijo = strlen(EXPORTAR_PREFIJO);
+  if (strncmp(nombreArchivo, EXPORTAR_PREFIJO, prefijo) != 0) return false;
+  char* fin;
+  e = {};
+  e.seq = strtoul(nombreArchivo + prefijo, &fin, 10);
+  if (fin == nombreArchivo + prefijo) return false;
+  e.formato = strncmp(fin, ".json", 5) == 0 ? FMT_JSON : strncmp(fin, ".csv", 4) == 0 ? FMT_CSV : FMT_TXT;
+  size_t len = strlen(nombreArchivo);
+  e.gzip = len > 3 && strcmp(nombreArchivo + len - 3, ".gz") == 0;
+  char canonico[32];
+  AlmacenExportaciones::nombre(e, canonico, sizeof(canonico));
+  return strcmp(canonico, nombreArchivo) == 0;
+}
+
+// Sin índice: las exportaciones se reconocen por el nombre. Se quedan las
+// EXPORTAR_MAX_ARCHIVOS más recientes y el resto se borra. Se compara path():
+// desde el core 2.x name() es el nombre sin la "/" de EXPORTAR_PREFIJO
+void AlmacenExportaciones::reconstruir() {
+  n_ = 0;
+  siguiente_ = 1;
+  File root = SPIFFS.open("/");
+  for (File f = root.openNextFile(); f; f = root.openNextFile()) {
+    EntradaExportacion e;
+    if (f.isDirectory() || !entradaDesdeNombre(f.path(), e)) continue;
+    e.tamano = f.size();
+    e.fecha = (uint32_t)f.getLastWrite();
+    if (e.seq + 1 > siguiente_) siguiente_ = e.seq + 1;
+    // Inserción ordenada por fecha (y secuencia); si no cabe se cae la más antigua
+    size_t i = n_;
+    while (i > 0 && (entradas_[i - 1].fecha > e.fecha ||
+                     (entradas_[i - 1].fecha == e.fecha && entradas_[i - 1].seq > e.seq))) {
+      i--;
+    }
+    if (n_ == EXPORTAR_MAX_ARCHIVOS) {
+      if (i == 0) continue;
+      memmove(entradas_, entradas_ + 1, (i - 1) * sizeof(EntradaExportacion));
+      i--;
+    } else {
+      memmove(entradas_ + i + 1, entradas_ + i, (n_ - i) * sizeof(EntradaExportacion));
+      n_++;
+    }
+    entradas_[i] = e;
+  }
+  root.close();
+
+  // Lo que no entró en el índice, fuera (sin borrar mientras se recorre). Si
+  // una pasada no consigue borrar nada, las siguientes verían lo mismo: se deja
+  char sobran[8][32];
+  size_t nSobran, borradas;
+  do {
+    nSobran = 0;
+    borradas = 0;
+    root = SPIFFS.open("/");
+    for (File f = root.openNextFile(); f && nSobran < 8; f = root.openNextFile()) {
+      EntradaExportacion e;
+      if (!f.isDirectory() && entradaDesdeNombre(f.path(), e) && !buscar(f.path())) {
+        strlcpy(sobran[nSobran++], f.path(), sizeof(sobran[0]));
+      }
+    }
+    root.close();
+    for (size_t i = 0; i < nSobran; i++) {
+      if (SPIFFS.remove(sobran[i])) {
+        expulsadas_++;
+        borradas++;
+      }
+    }
+  } while (nSobran == 8 && borradas > 0);
+  reconstruido_ = true;
+}
+
+void AlmacenExportaciones::iniciar() {
+  reconstruido_ = false;
+  if (!cargar()) {
+    reconstruir();
+    guardar();
+  } else {
+    // Lo borrado con el índice sin actualizar (p. ej. un corte de corriente)
+    char nombreArchivo[32];
+    size_t antes = n_;
+    for (size_t i = n_; i-- > 0;) {
+      nombre(entradas_[i], nombreArchivo, sizeof(nombreArchivo));
+      if (!SPIFFS.exists(nombreArchivo)) quitar(i);
+    }
+    if (n_ != antes) guardar();
+  }
+  bytes_ = 0;
+  for (size_t i = 0; i < n_; i++) bytes_ += entradas_[i].tamano;
+}
+
+void AlmacenExportaciones::quitar(size_t i) {
+  bytes_ -= entradas_[i].tamano;
+  memmove(entradas_ + i, entradas_ + i + 1, (n_ - i - 1) * sizeof(EntradaExportacion));
+  n_--;
+}
+
+void AlmacenExportaciones::expulsarMasAntigua() {
+  char nombreArchivo[32];
+  nombre(entradas_[0], nombreArchivo, sizeof(nombreArchivo));
+  SPIFFS.remove(nombreArchivo);
+  quitar(0);
+  expulsadas_++;
+}
+
+void AlmacenExportaciones::preparar(FormatoSalida formato, bool gzip, size_t estimado, char* nombreArchivo,
+                                    size_t len) {
+  // Mejor que la estimación: lo que ocupó la última del mismo formato
+  for (size_t i = n_; i-- > 0;) {
+    if (entradas_[i].formato == formato && entradas_[i].gzip == gzip) {
+      estimado = entradas_[i].tamano;
+      break;
+    }
+  }
+  bool cambio = false;
+  while (n_ >= EXPORTAR_MAX_ARCHIVOS) {
+    expulsarMasAntigua();
+    cambio = true;
+  }
+  while (n_ > 0 && (bytes_ + estimado > EXPORTAR_MAX_BYTES ||
+                    SPIFFS.totalBytes() - SPIFFS.usedBytes() < estimado + EXPORTAR_RESERVA)) {
+    expulsarMasAntigua();
+    cambio = true;
+  }
+  if (cambio) guardar();
+  formatoPendiente_ = formato;
+  gzipPendiente_ = gzip;
+  EntradaExportacion e = {};
+  e.seq = siguiente_;
+  e.formato = formato;
+  e.gzip = gzip;
+  nombre(e, nombreArchivo, len);
+}
+
+void AlmacenExportaciones::registrar(uint32_t tamano, uint32_t original, const BitacoraResultados& b) {
+  EntradaExportacion e = {};
+  e.seq = siguiente_++;
+  e.tamano = tamano;
+  e.original = original;
+  e.fecha = (uint32_t)time(nullptr);
+  e.uptime = millis() / 1000;
+  e.formato = formatoPendiente_;
+  e.gzip = gzipPendiente_;
+  BitacoraResultados::Registro r;
+  uint32_t registros = 0;
+  for (uint32_t pos = b.primero(); b.leer(pos, r); registros++) {
+    if (r.clave == K_SECCION && r.u32() < SEC_TOTAL) e.secciones |= 1u << r.u32();
+  }
+  e.registros = registros > 0xFFFF ? 0xFFFF : registros;
+  if (n_ == EXPORTAR_MAX_ARCHIVOS) expulsarMasAntigua();
+  entradas_[n_++] = e;
+  bytes_ += tamano;
+  // La nueva se queda aunque sola pase del presupuesto
+  while (bytes_ > EXPORTAR_MAX_BYTES && n_ > 1) expulsarMasAntigua();
+  guardar();
+}
+
+bool AlmacenExportaciones::olvidar(const char* nombreArchivo) {
+  const EntradaExportacion* e = buscar(nombreArchivo);
+  if (!e) return false;
+  quitar(e - entradas_);
+  guardar();
+  return true;
+}
+
+const EntradaExportacion* AlmacenExportaciones::buscar(const char* nombreArchivo) const {
+  EntradaExportacion e;
+  if (!entradaDesdeNombre(nombreArchivo, e)) return nullptr;
+  for (size_t i = 0; i < n_; i++) {
+    const EntradaExportacion& x = entradas_[i];
+    if (x.seq == e.seq && x.formato == e.formato && x.gzip == e.gzip) return &x;
+  }
+  return nullptr;
+}
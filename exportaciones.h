@@ -0,0 +1,90 @@
+// Almacén de exportaciones en SPIFFS con rotación
+// Las exportaciones se llaman /diagnostico_<secuencia><ext>: la secuencia se
+// guarda en el índice y sigue creciendo tras un reinicio (antes el nombre salía
+// de millis() y se repetía). Se conservan como mucho EXPORTAR_MAX_ARCHIVOS
+// archivos y EXPORTAR_MAX_BYTES bytes; al pasarse, o si SPIFFS no tiene sitio
+// para la siguiente, se borra la más antigua.
+//
+// El índice (EXPORTAR_INDICE) guarda de cada exportación su tamaño, el original
+// sin comprimir, la hora, el formato y qué secciones contiene, así el listado
+// por Serial y /list no abren ni leen cada archivo. Se carga una vez al
+// arrancar y se reescribe entero (unos cientos de bytes) con cada cambio:
+//   [cabecera][EntradaExportacion x n], con CRC-32 de todo en la cabecera
+// Si falta o está dañado se reconstruye desde los nombres del directorio (sin
+// resumen de secciones).
+#pragma once
+#include <Arduino.h>
+#include "resultados.h"
+
+#ifndef EXPORTAR_MAX_ARCHIVOS
+#define EXPORTAR_MAX_ARCHIVOS 16
+#endif
+#ifndef EXPORTAR_MAX_BYTES
+#define EXPORTAR_MAX_BYTES (128 * 1024)
+#endif
+// Espacio que se deja libre en SPIFFS además de lo que ocupará la exportación
+#ifndef EXPORTAR_RESERVA
+#define EXPORTAR_RESERVA 8192
+#endif
+#define EXPORTAR_INDICE "/exportaciones.idx"
+#define EXPORTAR_PREFIJO "/diagnostico_"
+
+struct EntradaExportacion {
+  uint32_t seq;
+  uint32_t tamano;     // en SPIFFS
+  uint32_t original;   // sin comprimir; 0 si no se sabe
+  uint32_t fecha;      // time(), segundos (lo mismo que getLastWrite())
+  uint32_t uptime;     // segundos desde el arranque al exportar
+  uint16_t registros;  // registros de la bitácora exportados
+  uint16_t secciones;  // bit s: la sección s tiene registros
+  uint8_t formato;     // FormatoSalida
+  uint8_t gzip;
+  uint16_t reservado;
+};
+static_assert(sizeof(EntradaExportacion) == 28, "EntradaExportacion cambia el formato del índice");
+
+class AlmacenExportaciones {
+public:
+  // Carga el índice (o lo reconstruye); llamar tras SPIFFS.begin()
+  void iniciar();
+
+  // Hace sitio para la siguiente exportación y da su nombre. Se cuenta con que
+  // ocupe lo que la última del mismo formato, o estimado si no hay ninguna
+  void preparar(FormatoSalida formato, bool gzip, size_t estimado, char* nombre, size_t len);
+  // Anota la exportación preparada, ya escrita, y aplica el presupuesto de bytes
+  void registrar(uint32_t tamano, uint32_t original, const BitacoraResultados& b);
+  // Un archivo que se borró por otro camino (web): sale del índice
+  bool olvidar(const char* nombre);
+
+  // Entrada de un archivo del almacén, o nullptr
+  const EntradaExportacion* buscar(const char* nombre) const;
+  // i = 0 es la más antigua
+  const EntradaExportacion& entrada(size_t i) const { return entradas_[i]; }
+  size_t cantidad() const { return n_; }
+  uint32_t bytes() const { return bytes_; }
+  uint32_t siguiente() const { return siguiente_; }
+  uint32_t expulsadas() const { return expulsadas_; }
+  bool reconstruido() const { return reconstruido_; }
+
+  static void nombre(const EntradaExportacion& e, char* out, size_t len);
+  // "chip, memoria, ..." a partir de la máscara de secciones
+  static void imprimirSecciones(Print& out, uint16_t secciones, const char* separador);
+  static const char* nombreFormato(uint8_t formato);
+
+private:
+  bool cargar();
+  void reconstruir();
+  void guardar();
+  void expulsarMasAntigua();
+  void quitar(size_t i);
+
+  EntradaExportacion entradas_[EXPORTAR_MAX_ARCHIVOS];
+  size_t n_ = 0;
+  uint32_t bytes_ = 0;
+  uint32_t siguiente_ = 1;
+  uint32_t expulsadas_ = 0;
+  bool reconstruido_ = false;
+  // Lo que dio preparar() a la espera de registrar()
+  uint8_t formatoPendiente_ = FMT_TXT;
+  bool gzipPendiente_ = false;
+};
@@ -0,0 +1,54 @@
+#include "formato.h"
+
+size_t TextoFijo::write(const uint8_t* datos, size_t len) {
+  size_t libre = cap_ - 1 - n_;
+  if (len > libre) {
+    len = libre;
+    truncado_ = true;
+  }
+  memcpy(buf_ + n_, datos, len);
+  n_ += len;
+  buf_[n_] = '\0';
+  return len;
+}
+
+size_t TextoFijo::vprintf(const char* formato, va_list args) {
+  size_t libre = cap_ - n_;
+  int len = vsnprintf(buf_ + n_, libre, formato, args);
+  if (len < 0) {
+    buf_[n_] = '\0';
+    return 0;
+  }
+  if ((size_t)len >= libre) {
+    len = (int)libre - 1;
+    truncado_ = true;
+  }
+  n_ += len;
+  return len;
+}
+
+size_t TextoFijo::printf(const char* formato, ...) {
+  va_list args;
+  va_start(args, formato);
+  size_t n = vprintf(formato, args);
+  va_end(args);
+  return n;
+}
+
+size_t imprimirf(Print& out, const char* formato, ...) {
+  TextoFijoN<FORMATO_LINEA_MAX> linea;
+  va_list args;
+  va_start(args, formato);
+  linea.vprintf(formato, args);
+  va_end(args);
+  return out.write((const uint8_t*)linea.c_str(), linea.length());
+}
+
+size_t imprimirlnf(Print& out, const char* formato, ...) {
+  TextoFijoN<FORMATO_LINEA_MAX> linea;
+  va_list args;
+  va_start(args, formato);
+  linea.vprintf(formato, args);
+  va_end(args);
+  return out.write((const uint8_t*)linea.c_str(), linea.length()) + out.println();
+}
@@ -0,0 +1,61 @@
+// Formateo de texto sin heap
+// TextoFijo es un Print que escribe en un buffer de quien llama (normalmente en
+// la pila): print()/println() tipados heredados de Print y printf() con vsnprintf
+// directo sobre el buffer. Lo que no cabe se descarta y queda marcado en
+// truncado(), en lugar de crecer como String.
+// imprimirf() formatea hacia cualquier Print (Serial, SalidaHTTP, un File) a
+// través de una línea en la pila: Print::printf pide memoria al heap cuando el
+// resultado pasa de 64 bytes.
+#pragma once
+#include <Arduino.h>
+#include <stdarg.h>
+
+// Línea más larga que imprimirf() escribe de una vez (el resto se trunca)
+#ifndef FORMATO_LINEA_MAX
+#define FORMATO_LINEA_MAX 192
+#endif
+
+class TextoFijo : public Print {
+public:
+  // capacidad incluye el '\0' final
+  TextoFijo(char* buf, size_t capacidad) : buf_(buf), cap_(capacidad) { limpiar(); }
+
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* datos, size_t len) override;
+  size_t printf(const char* formato, ...) __attribute__((format(printf, 2, 3)));
+  size_t vprintf(const char* formato, va_list args);
+
+  const char* c_str() const { return buf_; }
+  size_t length() const { return n_; }
+  size_t capacidad() const { return cap_ - 1; }
+  bool truncado() const { return truncado_; }
+  void limpiar() {
+    n_ = 0;
+    buf_[0] = '\0';
+    truncado_ = false;
+  }
+
+private:
+  char* buf_;
+  size_t cap_;
+  size_t n_ = 0;
+  bool truncado_ = false;
+};
+
+// TextoFijo con su propio buffer de N bytes (terminador incluido)
+template <size_t N>
+class TextoFijoN : public TextoFijo {
+public:
+  static_assert(N >= 2, "TextoFijoN necesita sitio para un carácter y el terminador");
+  TextoFijoN() : TextoFijo(almacen_, N) {}
+  TextoFijoN(const TextoFijoN&) = delete;
+  TextoFijoN& operator=(const TextoFijoN&) = delete;
+
+private:
+  char almacen_[N];
+};
+
+size_t imprimirf(Print& out, const char* formato, ...) __attribute__((format(printf, 2, 3)));
+// Igual que imprimirf() con salto de línea al final
+size_t imprimirlnf(Print& out, const char* formato, ...) __attribute__((format(printf, 2, 3)));
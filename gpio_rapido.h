@@ -0,0 +1,57 @@
+// GPIO rápido por registros
+// Escribe directamente los registros de set/clear (GPIO_OUT_W1TS / W1TC) en vez
+// de pasar por digitalWrite: un flanco es una sola escritura atómica, sin
+// comprobaciones de pin ni llamadas a la HAL, y una máscara mueve varios pines
+// a la vez. PinRapido<N> fija el pin en compilación para que su máscara sea una
+// constante. El pin tiene que haberse configurado antes con pinMode() (que deja
+// el IO MUX en función GPIO); aquí solo se tocan la salida y el enable.
+#pragma once
+#include <Arduino.h>
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+#include <soc/gpio_periph.h>
+#include <soc/io_mux_reg.h>
+
+inline void gpioAlto(uint32_t mascara) { REG_WRITE(GPIO_OUT_W1TS_REG, mascara); }
+inline void gpioBajo(uint32_t mascara) { REG_WRITE(GPIO_OUT_W1TC_REG, mascara); }
+inline uint32_t gpioLeer() { return REG_READ(GPIO_IN_REG); }
+
+// Deja los pines de 'mascara' al nivel de su bit en 'valor' (dos escrituras atómicas)
+inline void gpioEscribir(uint32_t mascara, uint32_t valor) {
+  gpioAlto(valor & mascara);
+  gpioBajo(~valor & mascara);
+}
+
+// Lectura-modificación-escritura de GPIO_OUT: una interrupción que toque otro pin
+// entre la lectura y la escritura pierde su cambio. Solo para comparar con W1TS/W1TC
+inline void gpioEscribirRMW(uint32_t mascara, uint32_t valor) {
+  REG_WRITE(GPIO_OUT_REG, (REG_READ(GPIO_OUT_REG) & ~mascara) | (valor & mascara));
+}
+
+// Habilita / deshabilita el driver de salida de los pines de 'mascara'
+inline void gpioSalidas(uint32_t mascara) { REG_WRITE(GPIO_ENABLE_W1TS_REG, mascara); }
+inline void gpioEntradas(uint32_t mascara) { REG_WRITE(GPIO_ENABLE_W1TC_REG, mascara); }
+
+// Pull-up / pull-down internos de los pines de 'mascara' (FUN_PU / FUN_PD de su
+// registro IO MUX): una lectura y una escritura por pin, sin pasar por la HAL
+inline void gpioPulls(uint32_t mascara, bool arriba, bool abajo) {
+  while (mascara) {
+    uint32_t reg = GPIO_PIN_MUX_REG[__builtin_ctz(mascara)];
+    uint32_t v = REG_READ(reg) & ~(FUN_PU | FUN_PD);
+    if (arriba) v |= FUN_PU;
+    if (abajo) v |= FUN_PD;
+    REG_WRITE(reg, v);
+    mascara &= mascara - 1;
+  }
+}
+
+template <uint8_t PIN>
+struct PinRapido {
+  static_assert(PIN < SOC_GPIO_PIN_COUNT, "PinRapido: pin fuera de rango");
+  static constexpr uint32_t MASCARA = 1UL << PIN;
+
+  static void alto() { gpioAlto(MASCARA); }
+  static void bajo() { gpioBajo(MASCARA); }
+  static void escribir(bool nivel) { nivel ? alto() : bajo(); }
+  static bool leer() { return gpioLeer() & MASCARA; }
+};
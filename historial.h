@@ -0,0 +1,102 @@
+// Historial circular de resultados
+// Conserva los N bytes más recientes con append O(1). Los lectores toman una
+// instantánea (dos tramos contiguos, sin copiar) y la validan al terminar:
+// si un escritor la pisó mientras se leía, valida() devuelve false.
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+template <size_t N>
+class HistorialCircular {
+public:
+  static_assert(N >= 64, "Historial demasiado pequeño");
+
+  struct Instantanea {
+    const char* tramo1;
+    size_t len1;
+    const char* tramo2;
+    size_t len2;
+    uint32_t inicio;  // posición lógica del primer byte (bytes escritos desde el origen)
+    uint32_t fin;
+
+    size_t longitud() const { return len1 + len2; }
+  };
+
+  void append(const char* datos, size_t len) {
+    if (len == 0) return;
+    portENTER_CRITICAL(&mux_);
+    uint32_t escritos = escritos_.load(std::memory_order_relaxed);
+    // Un bloque mayor que el buffer solo aporta su cola
+    if (len > N) {
+      datos += len - N;
+      escritos += len - N;
+      len = N;
+    }
+    size_t pos = escritos % N;
+    size_t primero = min(len, N - pos);
+    memcpy(buf_ + pos, datos, primero);
+    if (len > primero) memcpy(buf_, datos + primero, len - primero);
+    escritos_.store(escritos + len, std::memory_order_release);
+    portEXIT_CRITICAL(&mux_);
+  }
+
+  void append(const String& texto) { append(texto.c_str(), texto.length()); }
+
+  Instantanea instantanea() const {
+    uint32_t fin = escritos_.load(std::memory_order_acquire);
+    uint32_t inicio = fin - base_ > N ? fin - N : base_;
+    Instantanea s;
+    s.inicio = inicio;
+    s.fin = fin;
+    size_t len = fin - inicio;
+    size_t pos = inicio % N;
+    s.tramo1 = buf_ + pos;
+    s.len1 = min(len, N - pos);
+    s.tramo2 = buf_;
+    s.len2 = len - s.len1;
+    return s;
+  }
+
+  // true si ningún byte de la instantánea fue sobrescrito desde que se tomó
+  bool valida(const Instantanea& s) const {
+    return escritos_.load(std::memory_order_acquire) - s.inicio <= N;
+  }
+
+  size_t longitud() const {
+    uint32_t len = escritos_.load(std::memory_order_acquire) - base_;
+    return len > N ? N : len;
+  }
+
+  // Bytes perdidos por el giro del buffer desde el último limpiar()
+  uint32_t descartados() const {
+    uint32_t len = escritos_.load(std::memory_order_acquire) - base_;
+    return len > N ? len - N : 0;
+  }
+
+  bool vacio() const { return longitud() == 0; }
+
+  // Posiciones lógicas: [origen(), fin()) es lo escrito desde el último limpiar()
+  uint32_t fin() const { return escritos_.load(std::memory_order_acquire); }
+  uint32_t origen() const { return base_; }
+
+  // Copia len bytes a partir de la posición lógica pos (debe seguir en el buffer)
+  void leer(uint32_t pos, void* destino, size_t len) const {
+    size_t p = pos % N;
+    size_t primero = min(len, N - p);
+    memcpy(destino, buf_ + p, primero);
+    if (len > primero) memcpy((char*)destino + primero, buf_, len - primero);
+  }
+  static constexpr size_t capacidad() { return N; }
+
+  void limpiar() {
+    portENTER_CRITICAL(&mux_);
+    base_ = escritos_.load(std::memory_order_relaxed);
+    portEXIT_CRITICAL(&mux_);
+  }
+
+private:
+  char buf_[N];
+  std::atomic<uint32_t> escritos_{0};
+  uint32_t base_ = 0;
+  portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+};
@@ -0,0 +1,1668 @@
+// Benchmark de host del explorador
+// Ejecuta cada handler HTTP y cada explorar* en un bucle cronometrado y reporta
+// throughput, asignaciones de heap por operación y tiempo de delay() simulado.
+//
+//   ./bench                 todos los casos, iteraciones completas
+//   ./bench --quick         iteraciones reducidas (CI)
+//   ./bench --filter http   solo los casos cuyo nombre contiene "http"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <BLEDevice.h>
+#include <EEPROM.h>
+#include <SPIFFS.h>
+
+#include "ESP32-Specs.h"
+#include "web_assets.h"
+#include "host_alloc.h"
+#include "decodificador_telemetria.h"
+
+// --- Entorno programado ---
+
+static const WiFiClass::HostNetwork redesSimuladas[] = {
+    {"Oficina-5G", -42, 36, WIFI_AUTH_WPA2_PSK},   {"Oficina", -48, 6, WIFI_AUTH_WPA2_PSK},
+    {"Invitados", -55, 11, WIFI_AUTH_OPEN},         {"Lab-IoT", -61, 1, WIFI_AUTH_WPA_WPA2_PSK},
+    {"DIRECT-7F-Printer", -66, 6, WIFI_AUTH_WPA2_PSK}, {"Vecino_2.4", -71, 3, WIFI_AUTH_WPA2_PSK},
+    {"eduroam", -73, 1, WIFI_AUTH_WPA2_ENTERPRISE}, {"Cafeteria", -77, 9, WIFI_AUTH_OPEN},
+    {"MiCasa", -80, 11, WIFI_AUTH_WPA3_PSK},        {"AndroidAP", -84, 6, WIFI_AUTH_WPA2_PSK},
+    {"Legacy", -88, 2, WIFI_AUTH_WEP},              {"Sensor-Net", -90, 13, WIFI_AUTH_WPA_PSK},
+};
+
+static BLEDevice::HostAdvertiser anunciantes[48];
+
+static void prepararEntorno() {
+  WiFi.hostSetScanResults(redesSimuladas, sizeof(redesSimuladas) / sizeof(redesSimuladas[0]));
+  static const char* nombres[] = {"Mi Band 7", "JBL Flip 5", "Tile", nullptr, "LE-Bose", nullptr};
+  for (size_t i = 0; i < sizeof(anunciantes) / sizeof(anunciantes[0]); i++) {
+    BLEDevice::HostAdvertiser& a = anunciantes[i];
+    a.name = nombres[i % 6];
+    uint8_t addr[6] = {0xc0, 0xff, 0xee, (uint8_t)(i >> 8), (uint8_t)i, (uint8_t)(i * 7)};
+    memcpy(a.addr, addr, 6);
+    a.rssi = -45 - (int)(i % 50);
+    a.advIntervalMs = i % 4 == 0 ? 20 : 100 + (uint16_t)(i * 10);
+  }
+  BLEDevice::hostSetAdvertisers(anunciantes, sizeof(anunciantes) / sizeof(anunciantes[0]));
+}
+
+// --- Cliente HTTP en un hilo aparte (sin heap en el bucle de medición) ---
+
+static char respuesta[1 << 20];
+static std::atomic<int> clienteEstado{0};  // 0 libre, 1 pedido, 2 listo, 3 salir
+static char peticion[512];
+static const char* cuerpoPeticion = nullptr;
+static size_t cuerpoPeticionLen = 0;
+static size_t respuestaLen = 0;
+static int puertoHttp = 0;
+// true: mientras espera la respuesta corre loop() completo (Serial, BLE, planificador)
+static bool atenderConLoop = false;
+// true: cierra el envío tras el cuerpo, aunque sea más corto que su Content-Length
+static bool cortarCuerpo = false;
+
+static void hiloCliente() {
+  for (;;) {
+    int st;
+    while ((st = clienteEstado.load()) != 1) {
+      if (st == 3) return;
+      sched_yield();
+    }
+    respuestaLen = 0;
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(puertoHttp);
+    if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0) {
+      ::send(fd, peticion, strlen(peticion), MSG_NOSIGNAL);
+      for (size_t enviado = 0; enviado < cuerpoPeticionLen;) {
+        ssize_t n = ::send(fd, cuerpoPeticion + enviado, cuerpoPeticionLen - enviado, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        enviado += n;
+      }
+      if (cortarCuerpo) ::shutdown(fd, SHUT_WR);
+      ssize_t n;
+      while ((n = ::recv(fd, respuesta + respuestaLen, sizeof(respuesta) - 1 - respuestaLen, 0)) > 0) {
+        respuestaLen += n;
+      }
+    }
+    ::close(fd);
+    respuesta[respuestaLen] = '\0';
+    clienteEstado.store(2);
+  }
+}
+
+// Devuelve el código HTTP; el cuerpo queda en respuesta[]
+static int peticionHttp(const char* metodo, const char* ruta, const char* cabeceras = "",
+                        const char* cuerpo = nullptr, size_t cuerpoLen = 0) {
+  snprintf(peticion, sizeof(peticion), "%s %s HTTP/1.1\r\nHost: 192.168.4.1\r\n%s\r\n", metodo, ruta,
+           cabeceras);
+  cuerpoPeticion = cuerpo;
+  cuerpoPeticionLen = cuerpoLen;
+  clienteEstado.store(1);
+  while (clienteEstado.load() != 2) {
+    if (atenderConLoop) loop();
+    else server.handleClient();
+    sched_yield();
+  }
+  clienteEstado.store(0);
+  return respuestaLen > 12 ? atoi(respuesta + 9) : -1;
+}
+
+static size_t cuerpoHttp() {
+  const char* fin = strstr(respuesta, "\r\n\r\n");
+  return fin ? respuestaLen - (fin + 4 - respuesta) : 0;
+}
+
+// Cuerpo de una respuesta chunked ya recibida, sin las líneas de tamaño
+static size_t desfragmentarChunked(char* destino, size_t capacidad) {
+  const char* p = respuesta + respuestaLen - cuerpoHttp();
+  const char* fin = respuesta + respuestaLen;
+  size_t n = 0;
+  while (p < fin) {
+    char* resto;
+    size_t trozo = strtoul(p, &resto, 16);
+    if (resto == p || trozo == 0) break;
+    p = resto + 2;  // "\r\n" tras el tamaño
+    if (p + trozo > fin || n + trozo > capacidad) break;
+    memcpy(destino + n, p, trozo);
+    n += trozo;
+    p += trozo + 2;
+  }
+  return n;
+}
+
+// --- Casos ---
+
+// Corre una tarea del planificador hasta el final, saltando sus esperas con delay()
+// en tramos de 10 ms y vaciando la cola BLE entre tramos, como haría loop()
+static void correrTarea(const char* nombre, PasoTarea paso) {
+  planificador.lanzar(nombre, paso);
+  while (planificador.activa(paso)) {
+    planificador.ejecutar();
+    procesarColaBLE();
+    uint32_t espera = planificador.msHastaProximo();
+    if (espera > 0 && espera != UINT32_MAX) delay(espera < 10 ? espera : 10);
+  }
+}
+
+template <PasoTarea P>
+static void diagnostico() {
+  correrTarea("bench", P);
+}
+
+struct Caso {
+  const char* nombre;
+  void (*fn)();
+  int iteraciones;
+  void (*prep)();  // fuera de la medición, antes de cada iteración
+};
+
+static size_t bytesHttp = 0;
+static int ultimoCodigo = 0;
+
+static void crearArchivo(const char* ruta, size_t bytes) {
+  File f = SPIFFS.open(ruta, "w");
+  static uint8_t bloque[1024];
+  for (size_t i = 0; i < sizeof(bloque); i++) bloque[i] = 'a' + i % 26;
+  while (bytes) {
+    size_t n = bytes < sizeof(bloque) ? bytes : sizeof(bloque);
+    f.write(bloque, n);
+    bytes -= n;
+  }
+  f.close();
+  indiceArchivos.invalidar();
+}
+
+static void httpRoot() {
+  ultimoCodigo = peticionHttp("GET", "/");
+  bytesHttp += cuerpoHttp();
+}
+static void httpRoot304() {
+  char cabecera[64];
+  snprintf(cabecera, sizeof(cabecera), "If-None-Match: %s\r\n", WEB_INDEX_ETAG);
+  ultimoCodigo = peticionHttp("GET", "/", cabecera);
+  bytesHttp += cuerpoHttp();
+}
+static void httpList() {
+  ultimoCodigo = peticionHttp("GET", "/list");
+  bytesHttp += cuerpoHttp();
+}
+static void httpListPagina() {
+  ultimoCodigo = peticionHttp("GET", "/list?offset=20&limit=10&sort=mtime&order=desc");
+  bytesHttp += cuerpoHttp();
+}
+static void prepListFrio() { indiceArchivos.invalidar(); }
+static void httpDownload() {
+  ultimoCodigo = peticionHttp("GET", "/download?file=/bench_64k.bin");
+  bytesHttp += cuerpoHttp();
+}
+static void httpDownloadRango() {
+  ultimoCodigo = peticionHttp("GET", "/download?file=/bench_64k.bin", "Range: bytes=32768-\r\n");
+  bytesHttp += cuerpoHttp();
+}
+static void httpDownloadMultirango() {
+  ultimoCodigo =
+      peticionHttp("GET", "/download?file=/bench_64k.bin", "Range: bytes=0-1023,16384-20479,-4096\r\n");
+  bytesHttp += cuerpoHttp();
+}
+// Cuerpos de subida preparados fuera de la medición
+static char cuerpoSubida[300 * 1024];
+static size_t cuerpoSubidaLen = 0;
+static char cabeceraSubida[160];
+
+static void httpUploadMultipart() {
+  ultimoCodigo = peticionHttp("POST", "/upload", cabeceraSubida, cuerpoSubida, cuerpoSubidaLen);
+}
+static void prepUploadMultipart() {
+  static const char sep[] = "bench-sep";
+  size_t datos = 64 * 1024;
+  int n = snprintf(cuerpoSubida, sizeof(cuerpoSubida),
+                   "--%s\r\nContent-Disposition: form-data; name=\"file\"; filename=\"bench_subida.bin\"\r\n"
+                   "Content-Type: application/octet-stream\r\n\r\n",
+                   sep);
+  for (size_t i = 0; i < datos; i++) cuerpoSubida[n + i] = (char)('a' + i % 26);
+  n += datos;
+  n += snprintf(cuerpoSubida + n, sizeof(cuerpoSubida) - n, "\r\n--%s--\r\n", sep);
+  cuerpoSubidaLen = n;
+  snprintf(cabeceraSubida, sizeof(cabeceraSubida),
+           "Content-Type: multipart/form-data; boundary=%s\r\nContent-Length: %zu\r\n", sep, cuerpoSubidaLen);
+}
+static void httpUploadRaw() {
+  ultimoCodigo = peticionHttp("PUT", "/upload?file=/bench_raw.bin", cabeceraSubida, cuerpoSubida, cuerpoSubidaLen);
+}
+static void prepUploadRaw() {
+  cuerpoSubidaLen = 256 * 1024;
+  for (size_t i = 0; i < cuerpoSubidaLen; i++) cuerpoSubida[i] = (char)i;
+  snprintf(cabeceraSubida, sizeof(cabeceraSubida),
+           "Content-Type: application/octet-stream\r\nContent-Length: %zu\r\n", cuerpoSubidaLen);
+}
+static void httpDelete() {
+  ultimoCodigo = peticionHttp("GET", "/delete?file=/bench_borrar.txt");
+  bytesHttp += cuerpoHttp();
+}
+static void prepDelete() { crearArchivo("/bench_borrar.txt", 512); }
+static void httpResultadosJson() {
+  ultimoCodigo = peticionHttp("GET", "/resultados?formato=json");
+  bytesHttp += cuerpoHttp();
+}
+
+static void httpWiFi() {
+  ultimoCodigo = peticionHttp("GET", "/wifi");
+  bytesHttp += cuerpoHttp();
+}
+static void prepWiFiFrio() { cacheWiFi.invalidar(); }
+static void httpBLE() {
+  ultimoCodigo = peticionHttp("GET", "/ble");
+  bytesHttp += cuerpoHttp();
+}
+static void httpHeap() {
+  ultimoCodigo = peticionHttp("GET", "/heap");
+  bytesHttp += cuerpoHttp();
+}
+
+// 256 direcciones rotando sobre una tabla de BLE_TABLA_MAX: altas, repeticiones y expulsiones LRU
+static void httpMuestras() {
+  ultimoCodigo = peticionHttp("GET", "/muestras?ventana=60");
+  bytesHttp += cuerpoHttp();
+}
+
+static void httpMetrics() {
+  ultimoCodigo = peticionHttp("GET", "/metrics");
+  bytesHttp += cuerpoHttp();
+}
+
+static void muestraPeriodica() {
+  Tarea t = {};
+  muestrearTelemetria(t);
+}
+
+static TablaBLE tablaBench;
+static void tablaBLERegistrar() {
+  static uint32_t n = 0;
+  RegistroEscaneoBLE reg = {};
+  for (int i = 0; i < 100; i++, n++) {
+    uint32_t d = (n * 7) % 256;
+    uint8_t mac[6] = {0xd0, 0x0d, 0x00, 0x00, (uint8_t)(d >> 8), (uint8_t)d};
+    memcpy(reg.mac, mac, 6);
+    reg.ms = n;
+    reg.rssi = (int8_t)(-40 - (int)(n % 50));
+    tablaBench.registrar(reg);
+  }
+}
+
+static void historialLinea() {
+  addToHistory("• Linea de prueba del historial con algo de texto: 1234567890 ABCDEF\n");
+}
+static void comandoAyuda() { ejecutarComando("help"); }
+static void comandoDesconocido() { ejecutarComando("zz"); }
+// 20 comandos de un guion, hasta vaciarlo
+static void comandoGuion() {
+  ejecutarComando("F*10;T*10");
+  while (interprete.guionPendiente()) interprete.avanzar();
+}
+static void prepHistorial() {
+  if (historial.vacio()) addToHistory("--- datos para exportar ---\n");
+}
+static void exportarTxt() { exportarDatosArchivo(FMT_TXT); }
+static void exportarJson() { exportarDatosArchivo(FMT_JSON); }
+// El almacén rota solo: sin borrar nada a mano, cada iteración paga su rotación
+static void prepExport() { prepHistorial(); }
+
+static Caso casos[] = {
+    {"loop() en reposo", loop, 2000, nullptr},
+    {"addToHistory (64 B)", historialLinea, 20000, nullptr},
+    {"cmd help", comandoAyuda, 2000, nullptr},
+    {"cmd desconocido", comandoDesconocido, 2000, nullptr},
+    {"cmd guion F*10;T*10", comandoGuion, 200, nullptr},
+    {"explorarChipSeguro", diagnostico<explorarChipSeguro>, 500, nullptr},
+    {"explorarMemoria", diagnostico<explorarMemoria>, 500, nullptr},
+    {"explorarWiFi", diagnostico<explorarWiFi>, 200, prepWiFiFrio},
+    {"explorarWiFi (caché)", diagnostico<explorarWiFi>, 200, nullptr},
+    {"explorarGPIOs", diagnostico<explorarGPIOs>, 500, nullptr},
+    {"explorarGPIOs (pin a pin)", diagnostico<explorarGPIOsSecuencial>, 100, nullptr},
+    {"explorarSistema", diagnostico<explorarSistema>, 500, nullptr},
+    {"explorarSensores", diagnostico<explorarSensores>, 500, nullptr},
+    {"testLEDs", diagnostico<testLEDs>, 200, nullptr},
+    {"benchmark", diagnostico<benchmark>, 50, nullptr},
+    {"perfilarHeap", diagnostico<perfilarHeap>, 20, nullptr},
+    {"explorarBluetooth", diagnostico<explorarBluetooth>, 50, nullptr},
+    {"muestrearTelemetria", muestraPeriodica, 20000, nullptr},
+    {"tablaBLE x100 anuncios", tablaBLERegistrar, 5000, nullptr},
+    {"diagnosticoTotal", diagnostico<diagnosticoTotal>, 20, nullptr},
+    {"exportarDatosArchivo", exportarTxt, 50, prepExport},
+    {"exportarDatosArchivo JSON", exportarJson, 50, prepExport},
+    {"mostrarArchivosGuardados", mostrarArchivosGuardados, 200, nullptr},
+    {"http GET /", httpRoot, 500, nullptr},
+    {"http GET / (304)", httpRoot304, 500, nullptr},
+    {"http GET /list", httpList, 500, nullptr},
+    {"http GET /list (10 de 40)", httpListPagina, 500, nullptr},
+    {"http GET /list (reindexa)", httpList, 200, prepListFrio},
+    {"http GET /download 64K", httpDownload, 200, nullptr},
+    {"http GET /download Range 32K", httpDownloadRango, 200, nullptr},
+    {"http GET /download 3 rangos", httpDownloadMultirango, 200, nullptr},
+    {"http GET /delete", httpDelete, 300, prepDelete},
+    {"http GET /resultados json", httpResultadosJson, 100, nullptr},
+    {"http GET /wifi", httpWiFi, 500, nullptr},
+    {"http GET /ble", httpBLE, 500, nullptr},
+    {"http GET /heap", httpHeap, 500, nullptr},
+    {"http GET /muestras", httpMuestras, 500, nullptr},
+    {"http GET /metrics", httpMetrics, 500, nullptr},
+    {"http POST /upload 64K", httpUploadMultipart, 100, prepUploadMultipart},
+    {"http PUT /upload 256K", httpUploadRaw, 100, prepUploadRaw},
+};
+
+// Cuenta los bytes que produciría un render sin guardarlos
+class ContadorBytes : public Print {
+public:
+  using Print::write;
+  size_t write(uint8_t) override { return ++n, 1; }
+  size_t write(const uint8_t*, size_t len) override { return n += len, len; }
+  size_t n = 0;
+};
+
+// Bytes retenidos por un diagnóstico completo frente a su texto renderizado
+static void resumenHistorial() {
+  correrTarea("bench", diagnosticoTotal);
+  ContadorBytes txt, json, csv;
+  historial.exportar(txt, FMT_TXT);
+  historial.exportar(json, FMT_JSON);
+  historial.exportar(csv, FMT_CSV);
+  printf("\nhistorial tras diagnosticoTotal: %zu B en registros (capacidad %zu, %u B descartados)\n",
+         historial.bytesUsados(), historial.capacidad(), historial.descartados());
+  printf("  render TXT %zu B (%.1fx), JSON %zu B, CSV %zu B\n", txt.n,
+         (double)txt.n / historial.bytesUsados(), json.n, csv.n);
+}
+
+// Lo que el benchmark asigna a propósito: los buffers de trabajo que preparan
+// los kernels de memoria mientras se miden, y las llamadas de los kernels que
+// usan el asignador (malloc.*, string.concat) por las de calentamiento y
+// muestras. El resto del benchmark no debe asignar nada
+static uint64_t asignacionesKernels() {
+  uint64_t total = 0;
+  for (size_t i = 0; i < microbench.cantidad(); i++) {
+    const DefKernel& k = microbench.kernel(i);
+    HostAllocStats a = hostAllocSnapshot();
+    if (k.preparar && k.preparar(k.ctx, true)) k.preparar(k.ctx, false);
+    total += hostAllocSnapshot().allocs - a.allocs;
+    if (!k.conIRQ) continue;
+    a = hostAllocSnapshot();
+    k.fn(k.ctx);
+    total += (hostAllocSnapshot().allocs - a.allocs) * (microbench.calentamiento() + microbench.muestras());
+  }
+  return total;
+}
+
+// Asignaciones de heap de cada diagnóstico, con su salida por Serial incluida, y
+// de los renders del historial. Se espera cero salvo lo que el propio diagnóstico
+// prueba o la librería impone: el malloc de 1 KB de explorarMemoria, la copia de
+// BLEScanResults que el callback de fin de escaneo recibe por valor y lo que
+// asignan los kernels del benchmark; diagnosticoTotal suma las tres. false si
+// alguno se pasa
+static bool comprobarSinHeap() {
+  struct Esperado {
+    const char* nombre;
+    PasoTarea paso;
+    void (*prep)();
+    uint64_t maxAllocs;
+    bool conKernels;  // más asignacionesKernels()
+  };
+  static const Esperado diagnosticos[] = {
+      {"explorarChipSeguro", explorarChipSeguro, nullptr, 0, false},
+      {"explorarMemoria", explorarMemoria, nullptr, 1, false},
+      {"explorarWiFi (escaneo)", explorarWiFi, prepWiFiFrio, 0, false},
+      {"explorarWiFi (caché)", explorarWiFi, nullptr, 0, false},
+      {"explorarGPIOs", explorarGPIOs, nullptr, 0, false},
+      {"explorarGPIOs (pin a pin)", explorarGPIOsSecuencial, nullptr, 0, false},
+      {"explorarSistema", explorarSistema, nullptr, 0, false},
+      {"explorarSensores", explorarSensores, nullptr, 0, false},
+      {"testLEDs", testLEDs, nullptr, 0, false},
+      {"explorarBluetooth", explorarBluetooth, nullptr, 1, false},
+      {"benchmark", benchmark, nullptr, 0, true},
+      {"diagnosticoTotal", diagnosticoTotal, nullptr, 2, true},
+  };
+  uint64_t kernels = asignacionesKernels();
+  bool ok = true;
+  printf("\nasignaciones de heap por diagnóstico (segunda ejecución):\n");
+  for (const Esperado& d : diagnosticos) {
+    if (d.prep) d.prep();
+    correrTarea("bench", d.paso);  // la primera calienta cachés y estáticos
+    if (d.prep) d.prep();
+    HostAllocStats a = hostAllocSnapshot();
+    correrTarea("bench", d.paso);
+    uint64_t n = hostAllocSnapshot().allocs - a.allocs;
+    uint64_t max = d.maxAllocs + (d.conKernels ? kernels : 0);
+    bool bien = n <= max;
+    ok = ok && bien;
+    printf("  %-26s %3llu (máx. %llu) %s\n", d.nombre, (unsigned long long)n, (unsigned long long)max,
+           bien ? "ok" : "FALLO");
+  }
+  static const char* const formatos[] = {"TXT", "JSON", "CSV"};
+  for (int f = FMT_TXT; f <= FMT_CSV; f++) {
+    ContadorBytes salida;
+    HostAllocStats a = hostAllocSnapshot();
+    historial.exportar(salida, (FormatoSalida)f);
+    uint64_t n = hostAllocSnapshot().allocs - a.allocs;
+    ok = ok && n == 0;
+    printf("  render %-19s %3llu (máx. 0) %s\n", formatos[f], (unsigned long long)n, n == 0 ? "ok" : "FALLO");
+  }
+  return ok;
+}
+
+// Latencia de GET / mientras corre el diagnóstico completo en segundo plano,
+// en ms de reloj del dispositivo (incluye las esperas que antes eran delay())
+static void latenciaDuranteDiagnostico() {
+  planificador.reiniciarEstadisticas();
+  ejecutarComando("9");
+  atenderConLoop = true;
+  uint32_t peticiones = 0, maxMs = 0;
+  uint64_t sumaMs = 0;
+  uint32_t inicio = millis();
+  while (diagnosticoEnCurso()) {
+    uint32_t t0 = millis();
+    peticionHttp("GET", "/");
+    uint32_t ms = millis() - t0;
+    peticiones++;
+    sumaMs += ms;
+    if (ms > maxMs) maxMs = ms;
+  }
+  atenderConLoop = false;
+  printf("\nGET / durante diagnosticoTotal (%.1f s): %u peticiones, media %.2f ms, máx %u ms\n",
+         (millis() - inicio) / 1000.0, peticiones, (double)sumaMs / (peticiones ? peticiones : 1), maxMs);
+  printf("  paso más largo del planificador: %u us (%s), %u pasos\n", planificador.pasoMaxUs(),
+         planificador.pasoMaxNombre(), planificador.pasosEjecutados());
+  printf("  escaneos WiFi reales: %u; punto de acceso %s\n", WiFi.hostScans(),
+         WiFi.hostApActive() ? "activo" : "CAÍDO");
+}
+
+// 'stop' tecleado con un 9 en marcha (sin guion pendiente) cancela al momento;
+// otro comando que lanzaría un diagnóstico se rechaza en lugar de quedarse en cola
+static bool stopDuranteDiagnostico() {
+  ejecutarComando("9");
+  for (int i = 0; i < 20 && diagnosticoEnCurso(); i++) loop();
+  bool enCurso = diagnosticoEnCurso();
+  ejecutarComando("5");
+  bool sinCola = !interprete.guionPendiente();
+  ejecutarComando("stop");
+  bool ok = enCurso && sinCola && !diagnosticoEnCurso() && !interprete.guionPendiente();
+  printf("\nstop durante el diagnóstico completo: %s, '5' %s %s\n",
+         enCurso && !diagnosticoEnCurso() ? "cancelado" : "NO cancelado", sinCola ? "rechazado" : "EN COLA",
+         ok ? "ok" : "FALLO");
+  return ok;
+}
+
+// "x*N" con N de muchas cifras satura en INTERPRETE_REPETICIONES_MAX: no da la
+// vuelta a 0 (comando perdido) ni a 1
+static uint32_t vecesContadas = 0;
+static ResultadoComando contarVez(const char*) {
+  vecesContadas++;
+  return CMD_HECHO;
+}
+static uint32_t repetir(const char* linea) {
+  static const DefComando tabla[] = {{"x", nullptr, contarVez, nullptr}};
+  static struct : Print {
+    size_t write(uint8_t) override { return 1; }
+    using Print::write;
+  } salida;
+  Interprete i(tabla, 1, salida, nullptr, nullptr);
+  vecesContadas = 0;
+  i.ejecutarLinea(linea);
+  for (int n = 0; n < 2 * INTERPRETE_REPETICIONES_MAX && i.guionPendiente(); n++) i.avanzar();
+  return vecesContadas;
+}
+static bool repeticionesSaturadas() {
+  uint32_t v20 = repetir("x*20"), vMax = repetir("x*9999"), v2e32 = repetir("x*4294967296"),
+           v2e32mas1 = repetir("x*4294967297"), vLarga = repetir("x*000000000000000000000003");
+  bool ok = v20 == 20 && vMax == INTERPRETE_REPETICIONES_MAX && v2e32 == INTERPRETE_REPETICIONES_MAX &&
+            v2e32mas1 == INTERPRETE_REPETICIONES_MAX && vLarga == 3;
+  printf("\nrepeticiones: *20 -> %u, *9999 -> %u, *4294967296 -> %u, *4294967297 -> %u, *0..03 -> %u %s\n",
+         (unsigned)v20, (unsigned)vMax, (unsigned)v2e32, (unsigned)v2e32mas1, (unsigned)vLarga, ok ? "ok" : "FALLO");
+  return ok;
+}
+
+// Salida de Serial retenida para decodificarla después
+class CapturaSerial : public Print {
+public:
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* datos, size_t len) override {
+    size_t n = len < sizeof(buf) - this->len ? len : sizeof(buf) - this->len;
+    memcpy(buf + this->len, datos, n);
+    this->len += n;
+    return len;
+  }
+  uint8_t buf[256 * 1024];
+  size_t len = 0;
+};
+static CapturaSerial captura;
+
+// Cargas de todos los tamaños hasta TELEMETRIA_CARGA_MAX, con y sin ceros y con
+// rachas de 254 bytes sin cero (el caso límite de COBS), ida y vuelta
+static bool tramasSinteticas() {
+  static uint8_t carga[TELEMETRIA_CARGA_MAX];
+  DecodificadorTelemetria d;
+  uint32_t fallos = 0, n = 0;
+  for (size_t len = 0; len <= TELEMETRIA_CARGA_MAX; len++) {
+    for (int patron = 0; patron < 3; patron++) {
+      for (size_t i = 0; i < len; i++) {
+        carga[i] = patron == 0 ? (uint8_t)(i * 37) : patron == 1 ? (uint8_t)(1 + i % 255) : (i % 254 ? 0xA5 : 0);
+      }
+      captura.len = 0;
+      EmisorTrama t(captura);
+      t.abrir(TRAMA_LISTO, (uint8_t)n++);
+      t.escribir(carga, len);
+      t.cerrar();
+      bool ok = false;
+      for (size_t i = 0; i < captura.len; i++) {
+        if (d.alimentar(captura.buf[i])) ok = d.trama().len == len && !memcmp(d.trama().carga, carga, len);
+      }
+      if (!ok) fallos++;
+    }
+  }
+  printf("  tramas sintéticas: %u, %u fallos, %u perdidas\n", n, fallos, d.perdidas());
+  return fallos == 0 && d.perdidas() == 0;
+}
+
+// Bytes por Serial de cada diagnóstico en texto y en tramas binarias. La salida
+// binaria se decodifica y cada registro se compara con el de la bitácora en su
+// posición; las tramas tienen que llegar hasta el último registro que no sea nota.
+// false si algo no cuadra
+static bool telemetriaFrenteATexto() {
+  struct Diag {
+    const char* nombre;
+    PasoTarea paso;
+  };
+  static const Diag diagnosticos[] = {
+      {"explorarChipSeguro", explorarChipSeguro}, {"explorarMemoria", explorarMemoria},
+      {"explorarWiFi", explorarWiFi},             {"explorarGPIOs", explorarGPIOs},
+      {"explorarSistema", explorarSistema},       {"explorarSensores", explorarSensores},
+      {"diagnosticoTotal", diagnosticoTotal},
+  };
+  bool ok = true;
+  printf("\ntelemetría: bytes por Serial por diagnóstico, texto frente a tramas (v%d)\n", TELEMETRIA_VERSION);
+  printf("  %-20s %9s %9s %6s %11s %11s %8s %s\n", "diagnóstico", "texto B", "binario B", "ratio",
+         "ms@115200", "ms@921600", "tramas", "registros");
+  for (const Diag& d : diagnosticos) {
+    size_t s0 = Serial.hostBytesWritten();
+    correrTarea("bench", d.paso);
+    size_t texto = Serial.hostBytesWritten() - s0;
+
+    ejecutarComando("bin on");
+    DecodificadorTelemetria dec;
+    captura.len = 0;
+    Serial.hostSetCopia(&captura);
+    s0 = Serial.hostBytesWritten();
+    correrTarea("bench", d.paso);
+    size_t binario = Serial.hostBytesWritten() - s0;
+    Serial.hostSetCopia(nullptr);
+    ejecutarComando("bin off");
+
+    uint32_t registros = 0, distintos = 0, finTramas = 0;
+    BitacoraResultados::Registro r, esperado;
+    for (size_t i = 0; i < captura.len; i++) {
+      if (!dec.alimentar(captura.buf[i]) || dec.trama().tipo != TRAMA_REGISTROS) continue;
+      uint32_t pos = dec.posicion();
+      for (size_t off = 0; dec.siguienteRegistro(off, r);) {
+        registros++;
+        uint32_t p = pos;
+        bool retenido = (int32_t)(p - historial.primero()) >= 0;
+        if (retenido && (!historial.leer(p, esperado) || esperado.clave != r.clave || esperado.tipo != r.tipo ||
+                         esperado.len != r.len || memcmp(esperado.datos, r.datos, r.len))) {
+          distintos++;
+        }
+        pos += 3 + r.len;
+        finTramas = pos;
+      }
+    }
+    // Tras la última trama solo pueden quedar notas, que tampoco salen en texto
+    bool completo = registros > 0;
+    for (uint32_t p = finTramas; historial.leer(p, r);) completo = completo && r.clave == K_NOTA;
+    bool bien = completo && distintos == 0 && dec.perdidas() == 0;
+    ok = ok && bien;
+    printf("  %-20s %9zu %9zu %5.1fx %11.1f %11.1f %8u %u%s\n", d.nombre, texto, binario,
+           (double)texto / (binario ? binario : 1), texto * 10000.0 / 115200, binario * 10000.0 / TELEMETRIA_BAUDIOS,
+           dec.tramas(), registros, bien ? "" : " FALLO");
+  }
+  return tramasSinteticas() && ok;
+}
+
+// Serie sintética con el ritmo por defecto: heap que sube y baja a saltos, la
+// temperatura y el RSSI oscilando en una unidad y el periodo con 0-2 ms de
+// retraso del planificador. Cuánta historia cabe y que se decodifica sin pérdidas
+static bool muestreoComprimido() {
+  static SerieMuestras serie;
+  static Muestra enviadas[8192];
+  const uint32_t total = sizeof(enviadas) / sizeof(enviadas[0]);
+  uint32_t semilla = 12345;
+  auto azar = [&semilla](uint32_t n) {
+    semilla = semilla * 1103515245u + 12345u;
+    return (semilla >> 16) % n;
+  };
+  Muestra m = {1000, {180000, 110000, 415, -60}};
+  for (uint32_t i = 0; i < total; i++) {
+    m.ms += MUESTREO_PERIODO_MS + azar(3);
+    if (azar(4) == 0) m.valor[CM_HEAP_LIBRE] += (int32_t)azar(2049) - 1024;
+    if (azar(8) == 0) m.valor[CM_MAYOR_BLOQUE] = m.valor[CM_HEAP_LIBRE] - (int32_t)azar(40000);
+    if (azar(3) == 0) m.valor[CM_TEMPERATURA] += (int32_t)azar(3) - 1;
+    if (azar(6) == 0) m.valor[CM_RSSI] += (int32_t)azar(3) - 1;
+    enviadas[i] = m;
+    serie.agregar(m);
+  }
+
+  uint32_t retenidas = serie.cantidad(), distintas = 0, leidas = 0;
+  SerieMuestras::Lector lector(serie);
+  Muestra r;
+  while (lector.siguiente(r)) {
+    const Muestra& e = enviadas[total - retenidas + leidas++];
+    if (e.ms != r.ms || memcmp(e.valor, r.valor, sizeof(e.valor))) distintas++;
+  }
+  struct Cuenta {
+    uint32_t ventanas, muestras;
+  } cuenta = {0, 0};
+  serie.reducir(60000, 0, [](const VentanaMuestras& v, void* p) {
+    ((Cuenta*)p)->ventanas++;
+    ((Cuenta*)p)->muestras += v.n;
+  }, &cuenta);
+
+  uint32_t horasMs = r.ms - enviadas[total - retenidas].ms;
+  printf("\nmuestreo cada %u ms (serie sintética): %u de %u muestras en %zu B (%.2f B/muestra)\n",
+         MUESTREO_PERIODO_MS, retenidas, total, serie.bytesUsados(), (double)serie.bytesUsados() / retenidas);
+  printf("  historia retenida %.1f h en %zu B de anillo; %u ventanas de 60 s\n", horasMs / 3.6e6,
+         serie.capacidad(), cuenta.ventanas);
+  printf("  coste real de muestrearTelemetria: %u us por muestra, %.4f%% de CPU a su periodo\n",
+         serieMuestras.costeMedioUs(), serieMuestras.usoCPU());
+  bool ok = leidas == retenidas && distintas == 0 && cuenta.muestras == retenidas;
+  if (!ok) printf("  FALLO: %u leídas, %u distintas, %u en ventanas\n", leidas, distintas, cuenta.muestras);
+  return ok;
+}
+
+// /metrics tras el resto de casos (todas las rutas con peticiones): formato de
+// texto válido (solo '\n', cada muestra "nombre valor"), heap libre igual antes y
+// después de raspar y coste de raspar a 1 Hz
+static bool metricasPrometheus() {
+  ultimoCodigo = peticionHttp("GET", "/metrics");
+  static char cuerpo[64 * 1024];
+  size_t len = desfragmentarChunked(cuerpo, sizeof(cuerpo));
+  uint32_t lineas = 0, muestras = 0, malas = 0;
+  for (const char* p = cuerpo; p < cuerpo + len;) {
+    const char* fin = (const char*)memchr(p, '\n', cuerpo + len - p);
+    if (!fin) {
+      malas++;
+      break;
+    }
+    lineas++;
+    if (*p != '#') {
+      muestras++;
+      const char* espacio = (const char*)memrchr(p, ' ', fin - p);
+      if (!espacio || memchr(p, '\r', fin - p) || espacio + 1 == fin) malas++;
+    }
+    p = fin + 1;
+  }
+
+  uint32_t libreAntes = ESP.getFreeHeap();
+  auto t0 = std::chrono::steady_clock::now();
+  const int raspados = 100;
+  for (int i = 0; i < raspados; i++) peticionHttp("GET", "/metrics");
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / raspados;
+  uint32_t libreDespues = ESP.getFreeHeap();
+
+  printf("\n/metrics: HTTP %d, %zu B, %u líneas, %u muestras, %u mal formadas\n", ultimoCodigo, len, lineas, muestras,
+         malas);
+  printf("  %.0f us por raspado (%.3f%% de CPU a 1 Hz); heap libre %u -> %u tras %d raspados\n", us, us / 1e4,
+         libreAntes, libreDespues, raspados);
+  return ultimoCodigo == 200 && malas == 0 && libreAntes == libreDespues;
+}
+
+// --- /eventos ---
+
+// Conecta un navegador de mentira a /eventos y deja que el servidor lo adopte.
+// ventana != 0: buffers de socket pequeños en los dos extremos (en el ESP32 el
+// de envío es el TCP_SND_BUF de lwIP, unos KB) para que un cliente que no lee
+// llene pronto la ventana en lugar de los MB del loopback de Linux
+static int abrirEventos(int ventana) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (ventana) setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &ventana, sizeof(ventana));
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(puertoHttp);
+  if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  const char pedido[] = "GET /eventos HTTP/1.1\r\nHost: 192.168.4.1\r\nAccept: text/event-stream\r\n\r\n";
+  ::send(fd, pedido, sizeof(pedido) - 1, MSG_NOSIGNAL);
+  server.handleClient();
+  if (ventana) {
+    // El socket que adoptó el servidor es el que tiene a este como par
+    sockaddr_in local = {}, par = {};
+    socklen_t len = sizeof(local);
+    getsockname(fd, (sockaddr*)&local, &len);
+    for (int s = 3; s < 1024; s++) {
+      len = sizeof(par);
+      if (s == fd || getpeername(s, (sockaddr*)&par, &len) != 0 || par.sin_port != local.sin_port) continue;
+      setsockopt(s, SOL_SOCKET, SO_SNDBUF, &ventana, sizeof(ventana));
+      break;
+    }
+  }
+  return fd;
+}
+
+// Lo que haya llegado, sin esperar; -1 si el servidor cerró
+struct FlujoEventos {
+  int fd;
+  std::string datos;
+
+  ssize_t leer() {
+    char buf[4096];
+    ssize_t total = 0, n;
+    while ((n = ::recv(fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+      datos.append(buf, n);
+      total += n;
+    }
+    return n == 0 ? -1 : total;
+  }
+  size_t cuenta(const char* evento) const {
+    std::string marca = std::string("event: ") + evento + "\n";
+    size_t n = 0;
+    for (size_t p = datos.find(marca); p != std::string::npos; p = datos.find(marca, p + 1)) n++;
+    return n;
+  }
+  // Texto de los eventos "historial" tal como lo junta EventSource
+  std::string historial() const {
+    std::string texto;
+    for (size_t p = datos.find("\r\n\r\n"); p != std::string::npos;) {
+      size_t fin = datos.find("\n\n", p + 1);
+      if (fin == std::string::npos) break;
+      std::string ev = datos.substr(p, fin - p);
+      if (ev.find("event: historial\n") != std::string::npos) {
+        bool primera = true;
+        for (size_t l = ev.find("data: "); l != std::string::npos; l = ev.find("\ndata: ", l + 1)) {
+          if (ev[l] == '\n') l++;
+          size_t finLinea = ev.find('\n', l);
+          if (!primera) texto += '\n';
+          texto += ev.substr(l + 6, (finLinea == std::string::npos ? ev.size() : finLinea) - l - 6);
+          primera = false;
+        }
+      }
+      p = fin + 1;
+    }
+    return texto;
+  }
+};
+
+// Impresora a std::string sin \r, para comparar con lo que llega por /eventos
+struct TextoSinCR : public Print {
+  std::string s;
+  size_t write(uint8_t c) override {
+    if (c != '\r') s += (char)c;
+    return 1;
+  }
+  using Print::write;
+};
+
+// Un navegador que lee y otro que no: el diagnóstico 5 llega entero y sin
+// repeticiones, "listo" en la misma vuelta de loop() que termina el comando;
+// con una ráfaga de historial el lento se queda en su buffer fijo (sin heap
+// nuevo, atender() sin bloquear), recibe "desfase" al ponerse al día y, si deja
+// de leer, se le desconecta a los EVENTOS_ATASCO_MS
+static bool eventosEnVivo() {
+  uint32_t atascados0 = eventos.atascados();
+  FlujoEventos rapido = {abrirEventos(0)}, lento = {abrirEventos(4096)};
+  rapido.datos.reserve(4 << 20);  // que el heap del propio bench no cuente
+  lento.datos.reserve(1 << 20);
+  size_t clientes = eventos.clientes();
+  eventos.atender(historial, indiceArchivos);
+  rapido.leer();
+  lento.leer();
+  bool cabecera = rapido.datos.find("Content-Type: text/event-stream") != std::string::npos;
+
+  // Latencia de un comando real por loop()
+  uint32_t desde = historial.fin();
+  size_t base = rapido.datos.size();
+  auto t0 = std::chrono::steady_clock::now();
+  double usPrimero = -1, usListo = -1;
+  int vueltas = 0, vueltasTrasFin = -1;
+  ejecutarComando("5");
+  while (vueltas < 100000) {
+    loop();
+    vueltas++;
+    rapido.leer();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    if (usPrimero < 0 && rapido.datos.find("event: historial", base) != std::string::npos) usPrimero = us;
+    if (vueltasTrasFin >= 0) vueltasTrasFin++;
+    else if (!diagnosticoEnCurso()) vueltasTrasFin = 0;
+    if (rapido.datos.find("event: listo\ndata: sistema", base) != std::string::npos) {
+      usListo = us;
+      break;
+    }
+  }
+  TextoSinCR esperado;
+  CursorRender c;
+  c.pos = desde;
+  historial.mostrar(esperado, c);
+  std::string llegado = FlujoEventos{-1, "\r\n\r\n" + rapido.datos.substr(base)}.historial();
+  bool igual = llegado == esperado.s;
+
+  // Sin cambios no sale nada (salvo el latido a los 15 s)
+  size_t antes = rapido.datos.size();
+  for (int i = 0; i < 1000; i++) loop();
+  rapido.leer();
+  size_t repetidos = rapido.datos.size() - antes;
+
+  // Ráfaga: 4000 secciones cortas; el rápido lee entre escrituras, el lento no
+  uint64_t vivos0 = hostAllocSnapshot().liveBytes;
+  double maxAtender = 0;
+  size_t lentoRafaga = lento.datos.size();
+  for (int i = 0; i < 4000; i++) {
+    historial.seccion(SEC_SISTEMA);
+    historial.u32(K_UPTIME, (uint32_t)i);
+    historial.u32(K_CPU_FREQ, 160);
+    historial.finSeccion(SEC_SISTEMA);
+    for (int j = 0; j < 4; j++) {
+      auto a = std::chrono::steady_clock::now();
+      eventos.atender(historial, indiceArchivos);
+      double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - a).count();
+      if (us > maxAtender) maxAtender = us;
+      rapido.leer();
+    }
+  }
+  uint64_t vivos1 = hostAllocSnapshot().liveBytes;
+  size_t desfasesRapido = rapido.cuenta("desfase");
+  lento.leer();
+  size_t lentoAntesDeLeer = lento.datos.size() - lentoRafaga;
+  // El lento se pone al día
+  for (int i = 0; i < 200; i++) {
+    eventos.atender(historial, indiceArchivos);
+    lento.leer();
+  }
+  size_t desfasesLento = lento.cuenta("desfase");
+
+  // El lento deja de leer con datos pendientes: fuera tras EVENTOS_ATASCO_MS
+  for (int i = 0; i < 400; i++) {
+    historial.seccion(SEC_SISTEMA);
+    historial.u32(K_UPTIME, (uint32_t)i);
+    historial.finSeccion(SEC_SISTEMA);
+    eventos.atender(historial, indiceArchivos);
+    rapido.leer();
+  }
+  size_t clientesAntes = eventos.clientes();
+  delay(EVENTOS_ATASCO_MS + 1);
+  eventos.atender(historial, indiceArchivos);
+  rapido.leer();
+  size_t clientesDespues = eventos.clientes();
+
+  ::close(rapido.fd);
+  ::close(lento.fd);
+  delay(EVENTOS_SONDEO_MS);
+  eventos.atender(historial, indiceArchivos);
+
+  printf("\n/eventos: %zu clientes aceptados, diagnóstico 5 -> primer evento en %.0f us, listo en %.0f us "
+         "(%d vueltas de loop(), %d tras terminar)\n",
+         clientes, usPrimero, usListo, vueltas, vueltasTrasFin);
+  printf("  texto recibido %s al del Monitor Serie (%zu B); %zu B repetidos en 1000 vueltas sin cambios\n",
+         igual ? "idéntico" : "DISTINTO", llegado.size(), repetidos);
+  printf("  ráfaga de 4000 secciones: rápido %zu desfases; lento %zu B hasta llenar su ventana, %zu desfase(s) al "
+         "leer; atender() máx %.0f us; heap vivo %+lld B\n",
+         desfasesRapido, lentoAntesDeLeer, desfasesLento, maxAtender, (long long)(vivos1 - vivos0));
+  printf("  lento sin leer %u ms: clientes %zu -> %zu (atascados %u); tras cerrar ambos quedan %zu\n",
+         EVENTOS_ATASCO_MS, clientesAntes, clientesDespues, eventos.atascados() - atascados0, eventos.clientes());
+  return cabecera && clientes == 2 && usListo >= 0 && vueltasTrasFin == 0 && igual && repetidos == 0 &&
+         desfasesRapido == 0 && desfasesLento >= 1 && vivos1 == vivos0 && clientesAntes == 2 &&
+         clientesDespues == 1 && eventos.atascados() - atascados0 == 1 && eventos.clientes() == 0;
+}
+
+// --- Exportaciones .gz ---
+
+// Ruta en el disco del host de un archivo de SPIFFS
+static std::string rutaHost(const char* nombre) {
+  return std::string(getenv("ESP32_HOST_DATA")) + "/spiffs" + nombre;
+}
+
+// Comprime con CompresorGzip lo que escriba fn y comprueba la ida y vuelta con
+// DescompresorGzip y con el gzip del sistema; devuelve el tamaño comprimido
+static size_t idaYVuelta(const char* nombre, void (*fn)(Print&), double& usComprimir, bool& ok) {
+  static CompresorGzip compresor;
+  std::string plano = std::string(nombre) + ".plano", gz = std::string(nombre) + ".gz";
+  File f = SPIFFS.open(plano.c_str(), "w");
+  fn(f);
+  f.close();
+  auto t0 = std::chrono::steady_clock::now();
+  f = SPIFFS.open(gz.c_str(), "w");
+  compresor.iniciar(f);
+  fn(compresor);
+  compresor.terminar();
+  f.close();
+  usComprimir = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+  static DescompresorGzip descompresor;
+  static uint8_t a[4096], b[4096];
+  File fg = SPIFFS.open(gz.c_str(), "r"), fp = SPIFFS.open(plano.c_str(), "r");
+  bool igual = descompresor.iniciar(fg);
+  size_t n;
+  while (igual && (n = descompresor.leer(a, sizeof(a))) > 0) igual = fp.read(b, n) == n && memcmp(a, b, n) == 0;
+  igual = igual && descompresor.terminado() && !fp.available();
+  size_t tam = fg.size();
+  fg.close();
+  fp.close();
+  std::string orden = "gzip -dc '" + rutaHost(gz.c_str()) + "' | cmp -s - '" + rutaHost(plano.c_str()) + "'";
+  bool sistema = system(orden.c_str()) == 0;
+  if (!igual || !sistema) printf("  FALLO %s: DescompresorGzip %s, gzip -dc %s\n", nombre, igual ? "ok" : "distinto",
+                                 sistema ? "ok" : "distinto");
+  ok = ok && igual && sistema;
+  SPIFFS.remove(plano.c_str());
+  SPIFFS.remove(gz.c_str());
+  return tam;
+}
+
+static void exportacionTXT(Print& out) { historial.exportar(out, FMT_TXT); }
+static void exportacionJSON(Print& out) { historial.exportar(out, FMT_JSON); }
+static void exportacionCSV(Print& out) { historial.exportar(out, FMT_CSV); }
+// 40 exportaciones seguidas: la ventana se desliza muchas veces
+static void exportacionLarga(Print& out) {
+  for (int i = 0; i < 40; i++) historial.exportar(out, (FormatoSalida)(i % 3));
+}
+// Bytes al azar: casi todo literales de 9 bits, sin coincidencias
+static void bytesAlAzar(Print& out) {
+  uint32_t x = 2463534242u;
+  for (int i = 0; i < 64 * 1024; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    out.write((uint8_t)x);
+  }
+}
+
+// Ratio y coste de comprimir las exportaciones, ida y vuelta contra gzip -dc,
+// y /download de un .gz con y sin Accept-Encoding: gzip
+static bool exportacionComprimida() {
+  correrTarea("bench", diagnosticoTotal);
+  printf("\nexportaciones .gz (ventana %u B, cadena %u; RAM compresor %zu B, descompresor %zu B)\n",
+         COMPRESION_VENTANA, COMPRESION_CADENA, sizeof(CompresorGzip), sizeof(DescompresorGzip));
+  printf("  %-10s %9s %9s %6s %11s %11s\n", "contenido", "texto B", "gzip B", "ratio", "us texto", "us gzip");
+  struct {
+    const char* nombre;
+    void (*fn)(Print&);
+  } contenidos[] = {{"TXT", exportacionTXT}, {"JSON", exportacionJSON}, {"CSV", exportacionCSV},
+                    {"40 seguidas", exportacionLarga}, {"al azar", bytesAlAzar}};
+  bool ok = true;
+  for (auto& c : contenidos) {
+    ContadorBytes contador;
+    c.fn(contador);
+    size_t texto = contador.n;
+    File f = SPIFFS.open("/bench_texto", "w");
+    auto t0 = std::chrono::steady_clock::now();
+    c.fn(f);
+    f.close();
+    double usTexto = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    SPIFFS.remove("/bench_texto");
+    double usGzip;
+    size_t gz = idaYVuelta("/bench_gz", c.fn, usGzip, ok);
+    printf("  %-10s %9zu %9zu %5.1fx %11.0f %11.0f\n", c.nombre, texto, gz, (double)texto / gz, usTexto, usGzip);
+  }
+
+  // La exportación real (X) y su descarga en las dos variantes
+  prepExport();
+  char nombre[40];
+  exportarDatosArchivo(FMT_TXT);
+  AlmacenExportaciones::nombre(exportaciones.entrada(exportaciones.cantidad() - 1), nombre, sizeof(nombre));
+  File f = SPIFFS.open(nombre, "r");
+  size_t gz = f ? f.size() : 0;
+  uint32_t original = 0;
+  bool tam = f && DescompresorGzip::tamanoOriginal(f, original);
+  f.close();
+  char ruta[64];
+  snprintf(ruta, sizeof(ruta), "/download?file=%s", nombre + 1);
+  int codigoGzip = peticionHttp("GET", ruta, "Accept-Encoding: gzip, deflate\r\n");
+  bool conEncoding = strstr(respuesta, "Content-Encoding: gzip") != nullptr && cuerpoHttp() == gz;
+  int codigoPlano = peticionHttp("GET", ruta, "Accept-Encoding: identity\r\n");
+  bool sinEncoding = strstr(respuesta, "Content-Encoding") == nullptr && cuerpoHttp() == original &&
+                     strstr(respuesta + respuestaLen - cuerpoHttp(), "ESP32-C3 MINI - DIAGNOSTICO COMPLETO") != nullptr;
+  printf("  X: %s %zu B (%u B sin comprimir); /download con gzip HTTP %d %s, sin gzip HTTP %d %s\n", nombre, gz,
+         original, codigoGzip, conEncoding ? "Content-Encoding: gzip" : "FALLO", codigoPlano,
+         sinEncoding ? "descomprimido al vuelo" : "FALLO");
+  printf("  exportaciones TXT en %u KB de SPIFFS: ~%zu en texto, ~%zu en .gz\n", (unsigned)(SPIFFS.totalBytes() / 1024),
+         SPIFFS.totalBytes() / (original ? original : 1), SPIFFS.totalBytes() / (gz ? gz : 1));
+
+  // .gz dañados para un cliente sin gzip: truncado sin cola, un 500 y no el .gz
+  // tal cual; con los datos corruptos, conexión cerrada y error en el Serial
+  static const char truncado[] = "/diagnostico_999998.txt.gz";
+  File t = SPIFFS.open(truncado, "w");
+  t.write((const uint8_t*)"\x1f\x8b\x08", 3);
+  t.close();
+  snprintf(ruta, sizeof(ruta), "/download?file=%s", truncado + 1);
+  int codigoTruncado = peticionHttp("GET", ruta, "Accept-Encoding: identity\r\n");
+  bool truncadoOk = codigoTruncado == 500 && strstr(respuesta, "Content-Encoding") == nullptr;
+  SPIFFS.remove(truncado);
+
+  static const char corrupto[] = "/diagnostico_999999.txt.gz";
+  static uint8_t datos[64 * 1024];
+  f = SPIFFS.open(nombre, "r");
+  size_t n = f.read(datos, sizeof(datos));
+  f.close();
+  for (size_t i = 20; i + 8 < n; i += 7) datos[i] ^= 0x5A;  // deja cabecera y cola
+  f = SPIFFS.open(corrupto, "w");
+  f.write(datos, n);
+  f.close();
+  snprintf(ruta, sizeof(ruta), "/download?file=%s", corrupto + 1);
+  captura.len = 0;
+  Serial.hostSetCopia(&captura);
+  int codigoCorrupto = peticionHttp("GET", ruta, "Accept-Encoding: identity\r\n");
+  Serial.hostSetCopia(nullptr);
+  std::string log((const char*)captura.buf, captura.len);
+  bool corruptoOk = cuerpoHttp() < original && log.find("Descompresión cortada") != std::string::npos &&
+                    log.find("Descomprimido al vuelo") == std::string::npos;
+  SPIFFS.remove(corrupto);
+  indiceArchivos.invalidar();
+  printf("  .gz truncado sin gzip: HTTP %d sin Content-Encoding %s; corrupto: HTTP %d, %zu de %u B y cortado %s\n",
+         codigoTruncado, truncadoOk ? "ok" : "FALLO", codigoCorrupto, cuerpoHttp(), original,
+         corruptoOk ? "ok" : "FALLO");
+  return ok && tam && conEncoding && sinEncoding && codigoGzip == 200 && codigoPlano == 200 && truncadoOk &&
+         corruptoOk;
+}
+
+// --- Respaldo en diario ---
+
+// El respaldo de antes: [u16 longitud][registros] byte a byte en la EEPROM de
+// 4 KB y commit(), que en el core reescribe el blob entero
+static size_t respaldoEEPROMCompleto() {
+  static bool iniciada = false;
+  if (!iniciada) iniciada = EEPROM.begin(4096);
+  uint32_t inicio = historial.primero(), fin = historial.fin();
+  BitacoraResultados::Registro r;
+  while (fin - inicio > 4096 - sizeof(uint16_t)) {
+    if (!historial.leer(inicio, r)) break;
+  }
+  uint16_t n = (uint16_t)(fin - inicio);
+  EEPROM.put(0, n);
+  uint8_t bloque[64];
+  size_t pos = sizeof(uint16_t);
+  for (uint32_t p = inicio; p != fin;) {
+    size_t k = std::min((size_t)(fin - p), sizeof(bloque));
+    historial.almacen().leer(p, bloque, k);
+    for (size_t i = 0; i < k; i++) EEPROM.write(pos++, bloque[i]);
+    p += k;
+  }
+  EEPROM.commit();
+  return n;
+}
+
+// true si los bytes retenidos por copia son la cola de historial que acaba en fin
+static bool colaIgual(const BitacoraResultados& copia, uint32_t fin) {
+  size_t n = copia.bytesUsados();
+  if (n == 0 || n > fin - historial.primero()) return false;
+  static uint8_t a[HISTORY_MAX_LEN], b[HISTORY_MAX_LEN];
+  copia.almacen().leer(copia.primero(), a, n);
+  historial.almacen().leer(fin - n, b, n);
+  return memcmp(a, b, n) == 0;
+}
+
+// Una sesión de diagnósticos con una exportación tras cada uno: coste del
+// respaldo completo de antes frente al diario, recuperación al arrancar y
+// recuperación con la página más nueva corrompida
+static bool respaldoEnDiario() {
+  static PasoTarea const pasos[] = {explorarChipSeguro, explorarMemoria, explorarSistema, explorarSensores,
+                                    explorarWiFi, benchmark, explorarGPIOs, testLEDs};
+  printf("\nrespaldo en diario (%u páginas de %u B en NVS; antes blob EEPROM de 4096 B)\n", RESPALDO_PAGINAS,
+         RESPALDO_PAGINA);
+  printf("  %-4s %9s %11s %11s %9s %11s %11s\n", "exp", "nuevos B", "us antes", "us diario", "páginas", "entr. antes",
+         "entr. diario");
+  respaldo.borrar();
+  uint32_t entradasAntes = 0, entradasDiario = 0, guardadosAntes = respaldo.guardados();
+  double usAntes = 0, usDiario = 0;
+  uint32_t maxDiarioUs = 0;
+  const int exportaciones = 24;
+  for (int i = 0; i < exportaciones; i++) {
+    correrTarea("bench", pasos[i % (sizeof(pasos) / sizeof(pasos[0]))]);
+    auto t0 = std::chrono::steady_clock::now();
+    uint32_t escritoAntes = EEPROM.hostCommits();
+    respaldoEEPROMCompleto();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    uint32_t eAntes = (EEPROM.hostCommits() - escritoAntes) * entradasNVS(4096);
+    uint32_t e0 = respaldo.entradasEscritas();
+    size_t nuevos = respaldo.guardar(historial);
+    uint32_t eDiario = respaldo.entradasEscritas() - e0;
+    entradasAntes += eAntes;
+    entradasDiario += eDiario;
+    usAntes += us;
+    usDiario += respaldo.ultimoUs();
+    if (respaldo.ultimoUs() > maxDiarioUs) maxDiarioUs = respaldo.ultimoUs();
+    if (i < 8 || i == exportaciones - 1) {
+      printf("  %-4d %9zu %11.0f %11lu %9u %11lu %11lu\n", i + 1, nuevos, us, (unsigned long)respaldo.ultimoUs(),
+             respaldo.ultimasPaginas(), (unsigned long)eAntes, (unsigned long)eDiario);
+    }
+  }
+  double borradosAntes = (double)entradasAntes / NVS_ENTRADAS_SECTOR;
+  double borradosDiario = (double)entradasDiario / NVS_ENTRADAS_SECTOR;
+  printf("  media por exportación: %.0f us antes, %.0f us diario (máx %lu us)\n", usAntes / exportaciones,
+         usDiario / exportaciones, (unsigned long)maxDiarioUs);
+  printf("  borrados de sector estimados: %.2f antes, %.2f diario por exportación (%.2f ahorrados)\n",
+         borradosAntes / exportaciones, borradosDiario / exportaciones,
+         (borradosAntes - borradosDiario) / exportaciones);
+  bool contados = respaldo.guardados() - guardadosAntes == (uint32_t)exportaciones;
+
+  // Sin nada nuevo no se toca la flash
+  uint32_t escrituras = Preferences::hostWrites();
+  bool sinCambios = respaldo.guardar(historial) == 0 && Preferences::hostWrites() == escrituras;
+
+  // Arranque: otro diario lee las páginas y rehace la bitácora
+  static DiarioRespaldo otro;
+  static BitacoraResultados copia;
+  copia.limpiar();
+  size_t recuperados = otro.recuperar(copia);
+  bool recuperadoOk = recuperados > 0 && colaIgual(copia, historial.fin());
+  printf("  recuperación: %zu de %zu bytes de bitácora en %lu us (%s)\n", recuperados, historial.bytesUsados(),
+         (unsigned long)otro.recuperadoUs(), recuperadoOk ? "cola idéntica" : "FALLO");
+
+  // Un registro más y su página corrompida: vuelve la copia anterior, entera
+  uint32_t finAnterior = historial.fin();
+  addToHistory("--- nota tras el último respaldo ---\n");
+  respaldo.guardar(historial);
+  std::string dir = std::string(getenv("ESP32_HOST_DATA")) + "/nvs/" RESPALDO_ESPACIO;
+  std::string nueva;
+  struct timespec masNueva = {0, 0};
+  for (int n = 0; n < RESPALDO_PAGINAS; n++) {
+    std::string ruta = dir + "/p" + std::to_string(n);
+    struct stat st;
+    if (stat(ruta.c_str(), &st) == 0 && (st.st_mtim.tv_sec > masNueva.tv_sec ||
+                                         (st.st_mtim.tv_sec == masNueva.tv_sec && st.st_mtim.tv_nsec > masNueva.tv_nsec))) {
+      masNueva = st.st_mtim;
+      nueva = ruta;
+    }
+  }
+  bool corruptoOk = false;
+  if (FILE* f = fopen(nueva.c_str(), "r+b")) {
+    fseek(f, -1, SEEK_END);
+    int c = fgetc(f);
+    fseek(f, -1, SEEK_END);
+    fputc(c ^ 0x5A, f);
+    fclose(f);
+    static DiarioRespaldo tercero;
+    copia.limpiar();
+    size_t n = tercero.recuperar(copia);
+    corruptoOk = n > 0 && colaIgual(copia, finAnterior);
+    printf("  página más nueva corrompida: %zu bytes recuperados hasta el respaldo anterior (%s)\n", n,
+           corruptoOk ? "ok" : "FALLO");
+  }
+  // El diario en uso reescribe la página en el siguiente guardar()
+  addToHistory("--- otra nota ---\n");
+  respaldo.guardar(historial);
+
+  // Un firmware con otras claves no recupera nada y deja el diario vacío
+  bool esquemaOk = false;
+  if (FILE* f = fopen((dir + "/esquema").c_str(), "r+b")) {
+    int c = fgetc(f);
+    fseek(f, 0, SEEK_SET);
+    fputc(c ^ 0x01, f);
+    fclose(f);
+    static DiarioRespaldo cuarto;
+    copia.limpiar();
+    size_t n = cuarto.recuperar(copia);
+    struct stat st;
+    esquemaOk = n == 0 && cuarto.descartado() && copia.bytesUsados() == 0 && stat((dir + "/p0").c_str(), &st) != 0;
+    printf("  esquema distinto (%08lx en este firmware): %zu bytes recuperados, diario borrado %s\n",
+           (unsigned long)DiarioRespaldo::esquema(), n, esquemaOk ? "ok" : "FALLO");
+  }
+  return contados && sinCambios && recuperadoOk && corruptoOk && esquemaOk && borradosDiario < borradosAntes;
+}
+
+// --- Almacén de exportaciones ---
+
+// Exportaciones con nombre canónico que hay de verdad en SPIFFS
+static size_t exportacionesEnDisco(size_t& fueraDelIndice) {
+  size_t n = 0;
+  fueraDelIndice = 0;
+  File root = SPIFFS.open("/");
+  for (File f = root.openNextFile(); f; f = root.openNextFile()) {
+    if (exportaciones.buscar(f.path())) n++;
+    else if (strncmp(f.path(), EXPORTAR_PREFIJO "0", strlen(EXPORTAR_PREFIJO) + 1) == 0) fueraDelIndice++;
+  }
+  return n;
+}
+
+// Rotación por cuenta y bytes, secuencia que sobrevive a un reinicio, índice
+// dañado, borrado desde la web, y el listado desde el índice frente a abrir
+// cada archivo como antes
+static bool almacenRotativo() {
+  printf("\nalmacén de exportaciones (máx %u archivos, %u KB; índice %zu B por entrada)\n", EXPORTAR_MAX_ARCHIVOS,
+         EXPORTAR_MAX_BYTES / 1024, sizeof(EntradaExportacion));
+  prepHistorial();
+  uint32_t expulsadasAntes = exportaciones.expulsadas();
+  uint32_t primera = exportaciones.siguiente();
+  const int n = 3 * EXPORTAR_MAX_ARCHIVOS;
+  bool secuenciaOk = true;
+  for (int i = 0; i < n; i++) {
+    exportarDatosArchivo((FormatoSalida)(i % 3));
+    secuenciaOk = secuenciaOk && exportaciones.entrada(exportaciones.cantidad() - 1).seq == primera + i;
+  }
+  size_t fuera;
+  size_t enDisco = exportacionesEnDisco(fuera);
+  bool rotaOk = exportaciones.cantidad() <= EXPORTAR_MAX_ARCHIVOS && exportaciones.bytes() <= EXPORTAR_MAX_BYTES &&
+                enDisco == exportaciones.cantidad() && fuera == 0 &&
+                exportaciones.entrada(0).seq == primera + n - exportaciones.cantidad();
+  printf("  %d exportaciones: quedan %zu (%lu B), %lu borradas, en disco %zu sin huérfanas %s\n", n,
+         exportaciones.cantidad(), (unsigned long)exportaciones.bytes(),
+         (unsigned long)(exportaciones.expulsadas() - expulsadasAntes), enDisco, rotaOk ? "ok" : "FALLO");
+
+  // "Reinicio": otro almacén lee el índice y sigue la misma secuencia
+  static AlmacenExportaciones otro;
+  auto t0 = std::chrono::steady_clock::now();
+  otro.iniciar();
+  double usCargar = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  bool reinicioOk = !otro.reconstruido() && otro.siguiente() == exportaciones.siguiente() &&
+                    otro.cantidad() == exportaciones.cantidad() &&
+                    memcmp(&otro.entrada(0), &exportaciones.entrada(0), sizeof(EntradaExportacion)) == 0;
+  printf("  arranque con índice: %.0f us, siguiente #%lu %s\n", usCargar, (unsigned long)otro.siguiente(),
+         reinicioOk ? "ok" : "FALLO");
+
+  // Índice dañado: se rehace desde los nombres sin repetir secuencia
+  if (FILE* f = fopen(rutaHost(EXPORTAR_INDICE).c_str(), "r+b")) {
+    fseek(f, 20, SEEK_SET);
+    fputc(0xA5, f);
+    fclose(f);
+  }
+  t0 = std::chrono::steady_clock::now();
+  otro.iniciar();
+  double usRehacer = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  bool rehechoOk = otro.reconstruido() && otro.siguiente() == exportaciones.siguiente() &&
+                   otro.cantidad() == exportaciones.cantidad();
+  printf("  índice dañado: reconstruido en %.0f us con %zu exportaciones, siguiente #%lu %s\n", usRehacer,
+         otro.cantidad(), (unsigned long)otro.siguiente(), rehechoOk ? "ok" : "FALLO");
+  exportaciones.iniciar();  // vuelve a escribir el índice con los resúmenes
+
+  // Listado: del índice frente a abrir y descomprimir el principio de cada una
+  t0 = std::chrono::steady_clock::now();
+  mostrarArchivosGuardados();
+  double usIndice = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  t0 = std::chrono::steady_clock::now();
+  static DescompresorGzip descompresor;
+  static uint8_t texto[480];
+  char nombre[32];
+  for (size_t i = 0; i < exportaciones.cantidad(); i++) {
+    AlmacenExportaciones::nombre(exportaciones.entrada(i), nombre, sizeof(nombre));
+    File f = SPIFFS.open(nombre, "r");
+    uint32_t original;
+    if (DescompresorGzip::tamanoOriginal(f, original) && descompresor.iniciar(f)) descompresor.leer(texto, sizeof(texto));
+    f.close();
+  }
+  double usAbrir = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  printf("  Y con %zu exportaciones: %.0f us desde el índice; abrir y leer el principio de cada una, como antes, "
+         "sumaba otros %.0f us\n",
+         exportaciones.cantidad(), usIndice, usAbrir);
+
+  // /list lleva los metadatos; /delete saca la exportación del índice
+  peticionHttp("GET", "/list?limit=100&sort=mtime&order=desc");
+  static char cuerpo[1 << 16];
+  size_t len = desfragmentarChunked(cuerpo, sizeof(cuerpo) - 1);
+  cuerpo[len] = '\0';
+  size_t conMetadatos = 0;
+  for (const char* p = cuerpo; (p = strstr(p, "\"export\":{\"seq\":")) != nullptr; p++) conMetadatos++;
+  AlmacenExportaciones::nombre(exportaciones.entrada(0), nombre, sizeof(nombre));
+  char ruta[64];
+  snprintf(ruta, sizeof(ruta), "/delete?file=%s", nombre + 1);
+  size_t antes = exportaciones.cantidad();
+  peticionHttp("GET", ruta);
+  bool webOk = conMetadatos == antes && exportaciones.cantidad() == antes - 1 && !SPIFFS.exists(nombre);
+  printf("  /list: %zu de %zu con metadatos; /delete %s %s\n", conMetadatos, antes, nombre, webOk ? "ok" : "FALLO");
+
+  // /upload no puede pisar el índice ni una exportación del almacén
+  AlmacenExportaciones::nombre(exportaciones.entrada(0), nombre, sizeof(nombre));
+  File f = SPIFFS.open(nombre, "r");
+  size_t tamano = f.size();
+  f.close();
+  File idx = SPIFFS.open(EXPORTAR_INDICE, "r");
+  size_t tamanoIndice = idx.size();
+  idx.close();
+  static const char basura[] = "no es una exportación";
+  snprintf(cabeceraSubida, sizeof(cabeceraSubida), "Content-Length: %zu\r\n", sizeof(basura) - 1);
+  snprintf(ruta, sizeof(ruta), "/upload?file=%s", nombre);
+  int codigoExport = peticionHttp("PUT", ruta, cabeceraSubida, basura, sizeof(basura) - 1);
+  int codigoIndice = peticionHttp("PUT", "/upload?file=" EXPORTAR_INDICE, cabeceraSubida, basura, sizeof(basura) - 1);
+  f = SPIFFS.open(nombre, "r");
+  idx = SPIFFS.open(EXPORTAR_INDICE, "r");
+  bool subidaOk = codigoExport == 409 && codigoIndice == 409 && f.size() == tamano && idx.size() == tamanoIndice &&
+                  exportaciones.buscar(nombre) != nullptr;
+  f.close();
+  idx.close();
+  printf("  /upload sobre %s y el índice: %d y %d, intactos %s\n", nombre, codigoExport, codigoIndice,
+         subidaOk ? "ok" : "FALLO");
+
+  // Sin índice, con exportaciones de más y SPIFFS sin poder borrar: el arranque
+  // las deja estar en vez de repasar la raíz para siempre
+  for (int i = 1; i <= 12; i++) {
+    snprintf(nombre, sizeof(nombre), EXPORTAR_PREFIJO "%06d.txt", i);
+    if (FILE* h = fopen(rutaHost(nombre).c_str(), "wb")) {
+      fputs("antigua", h);
+      fclose(h);
+    }
+    struct utimbuf vieja = {1000, 1000};
+    utime(rutaHost(nombre).c_str(), &vieja);
+  }
+  SPIFFS.hostRescan();
+  SPIFFS.remove(EXPORTAR_INDICE);
+  SPIFFS.hostFallarBorrados(true);
+  otro.iniciar();
+  SPIFFS.hostFallarBorrados(false);
+  bool sinBorrarOk = otro.reconstruido() && otro.cantidad() == EXPORTAR_MAX_ARCHIVOS &&
+                     !otro.buscar(EXPORTAR_PREFIJO "000001.txt") && SPIFFS.exists(EXPORTAR_PREFIJO "000001.txt");
+  SPIFFS.remove(EXPORTAR_INDICE);
+  exportaciones.iniciar();  // ahora sí se borran las que sobran
+  exportacionesEnDisco(fuera);
+  sinBorrarOk = sinBorrarOk && fuera == 0;
+  printf("  índice perdido y remove() fallando: arranca con %zu; al volver, sin huérfanas %s\n", otro.cantidad(),
+         sinBorrarOk ? "ok" : "FALLO");
+  return secuenciaOk && rotaOk && reinicioOk && rehechoOk && webOk && subidaOk && sinBorrarOk;
+}
+
+static bool contenidoArchivo(const char* ruta, const char* esperado) {
+  char leido[64] = {};
+  File f = SPIFFS.open(ruta, "r");
+  size_t n = f ? f.read((uint8_t*)leido, sizeof(leido) - 1) : 0;
+  f.close();
+  return n == strlen(esperado) && memcmp(leido, esperado, n) == 0;
+}
+
+// Volver a subir un archivo que ya existe: si la subida se corta, la copia
+// anterior sigue ahí y no queda el temporal; si llega completa, la sustituye
+static bool subidaSinPerdidas() {
+  printf("\nsubida sobre un archivo existente (temporal %s)\n", SUBIDA_TEMPORAL);
+  static const char original[] = "copia buena";
+  File f = SPIFFS.open("/bench_conservar.txt", "w");
+  f.print(original);
+  f.close();
+
+  static const char nuevo[] = "copia nueva, más larga";
+  snprintf(cabeceraSubida, sizeof(cabeceraSubida), "Content-Length: %zu\r\n", sizeof(nuevo) - 1 + 100);
+  cortarCuerpo = true;
+  int codigoCortada = peticionHttp("PUT", "/upload?file=/bench_conservar.txt", cabeceraSubida, nuevo, sizeof(nuevo) - 1);
+  cortarCuerpo = false;
+  bool cortadaOk = codigoCortada != 200 && contenidoArchivo("/bench_conservar.txt", original) &&
+                   !SPIFFS.exists(SUBIDA_TEMPORAL);
+  printf("  cortada a mitad (%d), copia anterior intacta y sin temporal %s\n", codigoCortada, cortadaOk ? "ok" : "FALLO");
+
+  snprintf(cabeceraSubida, sizeof(cabeceraSubida), "Content-Length: %zu\r\n", sizeof(nuevo) - 1);
+  int codigoCompleta = peticionHttp("PUT", "/upload?file=/bench_conservar.txt", cabeceraSubida, nuevo, sizeof(nuevo) - 1);
+  int codigoTemporal = peticionHttp("PUT", "/upload?file=" SUBIDA_TEMPORAL, cabeceraSubida, nuevo, sizeof(nuevo) - 1);
+  bool completaOk = codigoCompleta == 200 && contenidoArchivo("/bench_conservar.txt", nuevo) &&
+                    !SPIFFS.exists(SUBIDA_TEMPORAL) && codigoTemporal == 409;
+  printf("  completa: %d, sustituida sin temporal; subir %s: %d %s\n", codigoCompleta, SUBIDA_TEMPORAL,
+         codigoTemporal, completaOk ? "ok" : "FALLO");
+  SPIFFS.remove("/bench_conservar.txt");
+  indiceArchivos.invalidar();
+  return cortadaOk && completaOk;
+}
+
+// Copia en el historial el último registro de bytes de clave k y nombre con el
+// u32 LE en offset multiplicado por factor: una ejecución posterior simulada
+static bool degradarRegistro(Clave k, const char* nombre, size_t cabecera, size_t offset, double factor) {
+  BitacoraResultados::Registro r, ultimo;
+  bool hay = false;
+  for (uint32_t pos = historial.primero(); historial.leer(pos, r);) {
+    if (r.clave != k) continue;
+    if (r.len - cabecera != strlen(nombre) || memcmp(r.datos + cabecera, nombre, strlen(nombre))) continue;
+    ultimo = r;
+    hay = true;
+  }
+  if (!hay) return false;
+  uint8_t* p = ultimo.datos + offset;
+  uint32_t v = (uint32_t)(((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24) * factor);
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+  historial.bytes(k, ultimo.datos, ultimo.len);
+  return true;
+}
+
+static bool estadoEnVeredicto(const char* veredicto, const char* id, const char* estado) {
+  char buscado[96];
+  snprintf(buscado, sizeof(buscado), "{\"id\":\"%s\"", id);
+  const char* p = strstr(veredicto, buscado);
+  const char* fin = p ? strchr(p, '}') : nullptr;
+  snprintf(buscado, sizeof(buscado), "\"estado\":\"%s\"", estado);
+  const char* e = p ? strstr(p, buscado) : nullptr;
+  return e && e < fin;
+}
+
+static bool lineaBaseRegresiones() {
+  printf("\nlínea base (%zu B por métrica, máx %d)\n", sizeof(MetricaBase), LINEA_BASE_MAX);
+  historial.limpiar();
+  correrTarea("bench", explorarMemoria);
+  correrTarea("bench", explorarGPIOs);
+  correrTarea("bench", explorarSensores);
+  correrTarea("bench", benchmark);
+  auto t0 = std::chrono::steady_clock::now();
+  ejecutarComando("base guardar");
+  double usGuardar = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  struct stat st = {};
+  stat(rutaHost(LINEA_BASE_ARCHIVO).c_str(), &st);
+  size_t esperadas = microbench.cantidad() + TOGGLE_TOTAL + 5;  // + heap libre, bloque, frag., temp., GPIO
+  bool guardadaOk = lineaBase.cantidad() == esperadas;
+  printf("  guardada: %zu métricas de %zu B de historial en %.0f us, %ld B en SPIFFS %s\n", lineaBase.cantidad(),
+         historial.bytesUsados(), usGuardar, (long)st.st_size, guardadaOk ? "ok" : "FALLO");
+
+  // Los mismos datos: todo dentro de tolerancia
+  t0 = std::chrono::steady_clock::now();
+  bool comparada = lineaBase.comparar(historial);
+  double usComparar = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  bool igualOk = comparada && lineaBase.regresiones() == 0 && lineaBase.sinDato() == 0 && lineaBase.mejoras() == 0;
+  printf("  misma ejecución: %zu regresiones en %.0f us %s\n", lineaBase.regresiones(), usComparar,
+         igualOk ? "ok" : "FALLO");
+
+  // Ejecución degradada: un kernel un 50% más lento, un método de conmutación
+  // a 2/3, un 20% menos de heap libre y un pin perdido; y un kernel un 5% más
+  // lento, dentro de su tolerancia
+  const char* kernel = microbench.kernel(0).nombre;
+  const char* lento = microbench.kernel(1).nombre;
+  const char* metodo = nombreMetodoToggle(TOGGLE_REGISTRO);
+  bool inyectado = degradarRegistro(K_BENCH_KERNEL, kernel, BENCH_KERNEL_CABECERA, 4, 1.5) &&
+                   degradarRegistro(K_BENCH_KERNEL, lento, BENCH_KERNEL_CABECERA, 4, 1.05) &&
+                   degradarRegistro(K_BENCH_TOGGLE, metodo, BENCH_TOGGLE_CABECERA, 0, 2.0 / 3);
+  uint32_t funcionales = 0, libre = 0;
+  BitacoraResultados::Registro r;
+  for (uint32_t pos = historial.primero(); historial.leer(pos, r);) {
+    if (r.clave == K_GPIO_FUNCIONALES) funcionales = r.u32();
+    if (r.clave == K_HEAP_LIBRE) libre = r.u32();
+  }
+  historial.u32(K_GPIO_FUNCIONALES, funcionales & (funcionales - 1));
+  historial.u32(K_HEAP_LIBRE, libre * 4 / 5);
+  size_t serial0 = Serial.hostBytesWritten();
+  bool degradadaOk = inyectado && funcionales && compararConLineaBase() && lineaBase.regresiones() == 4;
+  size_t bytesInforme = Serial.hostBytesWritten() - serial0;
+  static char veredicto[16 * 1024];
+  FILE* f = fopen(rutaHost(LINEA_BASE_VEREDICTO).c_str(), "rb");
+  size_t len = f ? fread(veredicto, 1, sizeof(veredicto) - 1, f) : 0;
+  if (f) fclose(f);
+  veredicto[len] = '\0';
+  char id[64];
+  bool archivoOk = strstr(veredicto, "{\"estado\":\"regresion\"") && strstr(veredicto, "\"regresiones\":4,") &&
+                   estadoEnVeredicto(veredicto, "heap.libre", "regresion") &&
+                   estadoEnVeredicto(veredicto, "gpio.funcionales", "regresion") &&
+                   estadoEnVeredicto(veredicto, "heap.fragmentacion", "ok");
+  snprintf(id, sizeof(id), "bench.%s", kernel);
+  archivoOk = archivoOk && estadoEnVeredicto(veredicto, id, "regresion");
+  snprintf(id, sizeof(id), "bench.%s", lento);
+  archivoOk = archivoOk && estadoEnVeredicto(veredicto, id, "ok");
+  snprintf(id, sizeof(id), "toggle.%s", metodo);
+  archivoOk = archivoOk && estadoEnVeredicto(veredicto, id, "regresion");
+  printf("  ejecución degradada: %zu regresiones, informe de %zu B por Serial %s; %s: %zu B %s\n",
+         lineaBase.regresiones(), bytesInforme, degradadaOk ? "ok" : "FALLO", LINEA_BASE_VEREDICTO, len,
+         archivoOk ? "ok" : "FALLO");
+
+  // Tolerancia por métrica: con 60% el kernel lento deja de ser regresión
+  snprintf(id, sizeof(id), "bench.%s", kernel);
+  lineaBase.tolerancia(id, 60);
+  bool tolOk = lineaBase.comparar(historial) && lineaBase.regresiones() == 3;
+  printf("  base tol %s 60: %zu regresiones %s\n", id, lineaBase.regresiones(), tolOk ? "ok" : "FALLO");
+
+  // La base sobrevive a un reinicio; dañada no se carga
+  static LineaBase otra;
+  bool recargaOk = otra.iniciar() && otra.cantidad() == lineaBase.cantidad() &&
+                   memcmp(&otra.metrica(0), &lineaBase.metrica(0), lineaBase.cantidad() * sizeof(MetricaBase)) == 0;
+  if (FILE* g = fopen(rutaHost(LINEA_BASE_ARCHIVO).c_str(), "r+b")) {
+    fseek(g, 40, SEEK_SET);
+    fputc(0x5A, g);
+    fclose(g);
+  }
+  recargaOk = recargaOk && !otra.iniciar() && !otra.existe();
+  printf("  reinicio: %zu métricas recargadas; archivo dañado descartado %s\n", lineaBase.cantidad(),
+         recargaOk ? "ok" : "FALLO");
+
+  // /veredicto sirve lo mismo que el archivo
+  int codigo = peticionHttp("GET", "/veredicto");
+  static char cuerpo[16 * 1024];
+  size_t n = desfragmentarChunked(cuerpo, sizeof(cuerpo) - 1);
+  cuerpo[n] = '\0';
+  bool webOk = codigo == 200 && strstr(cuerpo, "{\"estado\":\"regresion\"") && strstr(cuerpo, "\"regresiones\":3,");
+  printf("  /veredicto: HTTP %d, %zu B %s\n", codigo, n, webOk ? "ok" : "FALLO");
+
+  // El benchmark lanzado como comando compara solo al terminar
+  lineaBase.guardar(historial);
+  uint32_t antes = lineaBase.comparaciones();
+  ejecutarComando("8");
+  while (diagnosticoEnCurso()) loop();
+  bool autoOk = lineaBase.comparaciones() == antes + 1;
+  printf("  comando 8: comparado al terminar (%zu regresiones por el ruido del host) %s\n", lineaBase.regresiones(),
+         autoOk ? "ok" : "FALLO");
+
+  ejecutarComando("base borrar");
+  return guardadaOk && igualOk && degradadaOk && archivoOk && tolOk && recargaOk && webOk && autoOk;
+}
+
+// El autotest de GPIOs con un puente simulado entre dos pines vecinos del perfil
+static void autotestConCorto() {
+  uint8_t a = PERFIL_PLACA.pines[3], b = PERFIL_PLACA.pines[4];
+  hostCortoGPIO(a, b);
+  ResultadoAutotestGPIO r;
+  autotestGPIO(PERFIL_PLACA, r);
+  hostQuitarCortosGPIO();
+  printf("\nautotest GPIO con corto simulado %u-%u: %u cortos detectados", a, b, r.nCortos);
+  for (uint8_t i = 0; i < r.nCortos; i++) {
+    printf(" [%u-%u%s]", r.cortos[i].a, r.cortos[i].b, r.cortos[i].adyacentes ? " vecinos" : "");
+  }
+  printf(", %d funcionales de %d, %u us\n", __builtin_popcount(r.funcionales()), PERFIL_PLACA.n, r.duracionUs);
+}
+
+static void ejecutarCaso(const Caso& c, int iteraciones) {
+  using clock = std::chrono::steady_clock;
+  std::chrono::nanoseconds total{0};
+  uint64_t allocs = 0, bytes = 0, delayUs = 0;
+  size_t serial0 = Serial.hostBytesWritten();
+  bytesHttp = 0;
+  hostAllocResetPeak();
+  uint64_t live0 = hostAllocSnapshot().liveBytes;
+
+  for (int i = 0; i < iteraciones; i++) {
+    if (c.prep) c.prep();
+    HostAllocStats a = hostAllocSnapshot();
+    auto t0 = clock::now();
+    c.fn();
+    auto t1 = clock::now();
+    HostAllocStats b = hostAllocSnapshot();
+    total += t1 - t0;
+    allocs += b.allocs - a.allocs;
+    bytes += b.bytes - a.bytes;
+    delayUs += b.delayUs - a.delayUs;
+  }
+
+  double usOp = total.count() / 1000.0 / iteraciones;
+  double serialOp = (double)(Serial.hostBytesWritten() - serial0) / iteraciones;
+  uint64_t pico = hostAllocSnapshot().peakLive - live0;
+  printf("%-26s %7d %11.2f %12.0f %10.1f %10.1f %9.1f %9.0f %8.1f", c.nombre, iteraciones, usOp,
+         1e6 / usOp, (double)allocs / iteraciones, (double)bytes / iteraciones / 1024.0, pico / 1024.0,
+         serialOp, delayUs / 1000.0 / iteraciones);
+  if (bytesHttp) {
+    double segundos = total.count() / 1e9;
+    printf("  HTTP %d, %.0f KB/s", ultimoCodigo, bytesHttp / 1024.0 / segundos);
+  }
+  printf("\n");
+}
+
+int main(int argc, char** argv) {
+  bool quick = false;
+  const char* filtro = nullptr;
+  int iterFijas = 0;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--quick")) quick = true;
+    else if (!strcmp(argv[i], "--filter") && i + 1 < argc) filtro = argv[++i];
+    else if (!strcmp(argv[i], "--iters") && i + 1 < argc) iterFijas = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "uso: %s [--quick] [--filter texto] [--iters N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  char plantilla[] = "/tmp/esp32-bench-XXXXXX";
+  const char* datos = mkdtemp(plantilla);
+  setenv("ESP32_HOST_DATA", datos, 1);
+
+  Serial.hostSetEcho(false);
+  prepararEntorno();
+  setup();
+  iniciarServidorWeb();
+  puertoHttp = server.hostPort();
+
+  for (int i = 0; i < 40; i++) {
+    char ruta[40];
+    snprintf(ruta, sizeof(ruta), "/registro_%d.txt", 100000 + i * 977);
+    crearArchivo(ruta, 2048 + i * 37);
+  }
+  crearArchivo("/bench_64k.bin", 64 * 1024);
+
+  std::thread cliente(hiloCliente);
+
+  printf("%-26s %7s %11s %12s %10s %10s %9s %9s %8s\n", "caso", "iter", "us/op", "ops/s", "allocs/op",
+         "KB/op", "pico KB", "serial B", "delay ms");
+  for (const Caso& c : casos) {
+    if (filtro && !strstr(c.nombre, filtro)) continue;
+    int n = iterFijas ? iterFijas : quick ? (c.iteraciones / 20 > 0 ? c.iteraciones / 20 : 1) : c.iteraciones;
+    ejecutarCaso(c, n);
+  }
+
+  if (!filtro || strstr("historial", filtro)) resumenHistorial();
+  if (!filtro || strstr("latencia", filtro)) latenciaDuranteDiagnostico();
+  bool stopOk = true;
+  if (!filtro || strstr("stop", filtro)) stopOk = stopDuranteDiagnostico();
+  bool repeticionesOk = true;
+  if (!filtro || strstr("repeticiones", filtro)) repeticionesOk = repeticionesSaturadas();
+  if (!filtro || strstr("gpio", filtro)) autotestConCorto();
+  bool sinHeap = true;
+  if (!filtro || strstr("asignaciones", filtro)) sinHeap = comprobarSinHeap();
+  bool metricasOk = true;
+  if (!filtro || strstr("metricas", filtro)) metricasOk = metricasPrometheus();
+  bool muestreoOk = true;
+  if (!filtro || strstr("muestreo", filtro)) muestreoOk = muestreoComprimido();
+  bool telemetriaOk = true;
+  if (!filtro || strstr("telemetria", filtro)) telemetriaOk = telemetriaFrenteATexto();
+  bool exportacionOk = true;
+  if (!filtro || strstr("exportacion", filtro)) exportacionOk = exportacionComprimida();
+  bool respaldoOk = true;
+  if (!filtro || strstr("respaldo", filtro)) respaldoOk = respaldoEnDiario();
+  bool almacenOk = true;
+  if (!filtro || strstr("almacen", filtro)) almacenOk = almacenRotativo();
+  bool subidaOk = true;
+  if (!filtro || strstr("subida", filtro)) subidaOk = subidaSinPerdidas();
+  bool lineaBaseOk = true;
+  if (!filtro || strstr("base", filtro)) lineaBaseOk = lineaBaseRegresiones();
+  // Al final: las ráfagas escriben en el historial sin pasar por mostrarResultados()
+  bool eventosOk = true;
+  if (!filtro || strstr("eventos", filtro)) eventosOk = eventosEnVivo();
+
+  clienteEstado.store(3);
+  cliente.join();
+  server.close();
+  std::string limpiar = std::string("rm -rf ") + datos;
+  int rc = system(limpiar.c_str());
+  (void)rc;
+  return sinHeap && stopOk && repeticionesOk && telemetriaOk && muestreoOk && metricasOk && eventosOk && exportacionOk && respaldoOk && almacenOk &&
+                 subidaOk && lineaBaseOk
+             ? 0
+             : 1;
+}
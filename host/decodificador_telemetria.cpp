@@ -0,0 +1,112 @@
+#include "decodificador_telemetria.h"
+#include "crc32.h"
+
+static uint32_t leerU32LE(const uint8_t* p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+void DecodificadorTelemetria::reiniciar() {
+  *this = DecodificadorTelemetria();
+}
+
+bool DecodificadorTelemetria::alimentar(uint8_t b) {
+  if (b != 0) {
+    if (n_ < sizeof(crudo_)) {
+      crudo_[n_++] = b;
+    } else {
+      desbordada_ = true;
+      descartados_++;
+    }
+    return false;
+  }
+  bool valida = !desbordada_ && n_ > 0 && cerrarTrama();
+  if (!valida && n_ > 0) {
+    invalidas_++;
+    descartados_ += n_;
+  }
+  n_ = 0;
+  desbordada_ = false;
+  return valida;
+}
+
+void DecodificadorTelemetria::alimentar(const uint8_t* datos, size_t len,
+                                        void (*alTerminar)(const Trama&, void*), void* ctx) {
+  for (size_t i = 0; i < len; i++) {
+    if (alimentar(datos[i]) && alTerminar) alTerminar(trama_, ctx);
+  }
+}
+
+// Deshace el COBS de crudo_ en plano_ y valida CRC y tamaño
+bool DecodificadorTelemetria::cerrarTrama() {
+  size_t len = 0;
+  for (size_t i = 0; i < n_;) {
+    uint8_t codigo = crudo_[i++];
+    size_t bloque = codigo - 1;
+    if (i + bloque > n_ || len + bloque > sizeof(plano_)) return false;
+    memcpy(plano_ + len, crudo_ + i, bloque);
+    len += bloque;
+    i += bloque;
+    // El cero implícito no se añade tras un bloque lleno ni al final de la trama
+    if (codigo != 0xFF && i < n_) {
+      if (len == sizeof(plano_)) return false;
+      plano_[len++] = 0;
+    }
+  }
+  if (len < 2 + 4) return false;
+  if (crc32(plano_, len - 4) != leerU32LE(plano_ + len - 4)) return false;
+  trama_.tipo = plano_[0];
+  trama_.secuencia = plano_[1];
+  trama_.carga = plano_ + 2;
+  trama_.len = len - 2 - 4;
+  if (haySecuencia_) perdidas_ += (uint8_t)(trama_.secuencia - secuencia_ - 1);
+  haySecuencia_ = true;
+  secuencia_ = trama_.secuencia;
+  tramas_++;
+  return true;
+}
+
+uint32_t DecodificadorTelemetria::posicion() const {
+  return trama_.tipo == TRAMA_REGISTROS && trama_.len >= 4 ? leerU32LE(trama_.carga) : 0;
+}
+
+uint32_t DecodificadorTelemetria::baudios() const {
+  return trama_.tipo == TRAMA_HOLA && trama_.len >= 7 ? leerU32LE(trama_.carga + 3) : 0;
+}
+
+bool DecodificadorTelemetria::siguienteRegistro(size_t& off, BitacoraResultados::Registro& r) const {
+  if (trama_.tipo != TRAMA_REGISTROS) return false;
+  if (off < 4) off = 4;
+  if (off + 3 > trama_.len) return false;
+  const uint8_t* p = trama_.carga + off;
+  if (off + 3 + p[2] > trama_.len) return false;
+  r.clave = p[0];
+  r.tipo = p[1];
+  r.len = p[2];
+  memcpy(r.datos, p + 3, r.len);
+  off += 3 + r.len;
+  return true;
+}
+
+void DecodificadorTelemetria::imprimirRegistro(FILE* f, const BitacoraResultados::Registro& r) {
+  fprintf(f, "%s=", nombreClave(r.clave));
+  switch (r.tipo) {
+  case TV_U32:
+    fprintf(f, "%lu\n", (unsigned long)r.u32());
+    break;
+  case TV_I32:
+    fprintf(f, "%ld\n", (long)r.i32());
+    break;
+  case TV_F32:
+    fprintf(f, "%g\n", (double)r.f32());
+    break;
+  case TV_BOOL:
+    fprintf(f, "%s\n", r.booleano() ? "true" : "false");
+    break;
+  case TV_TEXTO:
+    fprintf(f, "%.*s\n", (int)r.len, (const char*)r.datos);
+    break;
+  default:
+    for (uint8_t i = 0; i < r.len; i++) fprintf(f, "%02x", r.datos[i]);
+    fprintf(f, "\n");
+  }
+}
@@ -0,0 +1,60 @@
+// Decodificador de la telemetría binaria (telemetria.h), para el lado del PC
+// Se alimenta con lo que llega del puerto, byte a byte o por bloques. Cada vez
+// que se completa una trama válida (COBS correcto y CRC bien) alimentar() la
+// deja en trama() y devuelve true. El texto intercalado y las tramas dañadas no se
+// distinguen: ambos cuentan como bloques inválidos y se descartan. Lo que delata
+// una trama dañada es el salto de secuencia, que cuenta como trama perdida.
+//
+//   DecodificadorTelemetria d;
+//   while (leer(puerto, &b)) if (d.alimentar(b) && d.trama().tipo == TRAMA_REGISTROS)
+//     for (size_t off = 0; d.siguienteRegistro(off, r);) ...
+#pragma once
+#include <stdio.h>
+#include "telemetria.h"
+
+class DecodificadorTelemetria {
+public:
+  struct Trama {
+    uint8_t tipo;
+    uint8_t secuencia;
+    const uint8_t* carga;
+    size_t len;
+  };
+
+  bool alimentar(uint8_t b);
+  // Alimenta un bloque; llama a alTerminar(trama, ctx) por cada trama válida
+  void alimentar(const uint8_t* datos, size_t len, void (*alTerminar)(const Trama&, void*), void* ctx);
+  const Trama& trama() const { return trama_; }
+
+  // Registros de la última trama TRAMA_REGISTROS: off empieza en 0
+  bool siguienteRegistro(size_t& off, BitacoraResultados::Registro& r) const;
+  // Posición en el historial del primer registro de la trama
+  uint32_t posicion() const;
+  // TRAMA_HOLA: versión del protocolo y baudios anunciados
+  uint8_t version() const { return trama_.len >= 1 ? trama_.carga[0] : 0; }
+  uint32_t baudios() const;
+
+  uint32_t tramas() const { return tramas_; }
+  uint32_t invalidas() const { return invalidas_; }
+  uint32_t perdidas() const { return perdidas_; }
+  uint32_t bytesDescartados() const { return descartados_; }
+  void reiniciar();
+
+  // "clave=valor" con los nombres del catálogo (resultados.cpp)
+  static void imprimirRegistro(FILE* f, const BitacoraResultados::Registro& r);
+
+private:
+  bool cerrarTrama();
+
+  uint8_t crudo_[TELEMETRIA_COBS_MAX];
+  uint8_t plano_[TELEMETRIA_TRAMA_MAX];
+  size_t n_ = 0;
+  bool desbordada_ = false;  // lo acumulado no cabe: texto, se ignora hasta el próximo 0x00
+  Trama trama_ = {};
+  bool haySecuencia_ = false;
+  uint8_t secuencia_ = 0;
+  uint32_t tramas_ = 0;
+  uint32_t invalidas_ = 0;
+  uint32_t perdidas_ = 0;
+  uint32_t descartados_ = 0;
+};
@@ -0,0 +1,415 @@
+#include "Arduino.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "esp_chip_info.h"
+#include "esp_cpu.h"
+#include "esp_sleep.h"
+#include "esp_system.h"
+#include "host_alloc.h"
+#include "soc/gpio_periph.h"
+#include "soc/gpio_reg.h"
+#include "soc/io_mux_reg.h"
+#include "soc/rtc.h"
+#include "soc/soc.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// --- Print / Stream ---
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char loc[64];
+  va_list arg;
+  va_start(arg, format);
+  va_list copy;
+  va_copy(copy, arg);
+  int len = vsnprintf(loc, sizeof(loc), format, copy);
+  va_end(copy);
+  if (len < 0) {
+    va_end(arg);
+    return 0;
+  }
+  char* temp = loc;
+  if (len >= (int)sizeof(loc)) {
+    temp = (char*)malloc(len + 1);
+    if (!temp) {
+      va_end(arg);
+      return 0;
+    }
+    vsnprintf(temp, len + 1, format, arg);
+  }
+  va_end(arg);
+  size_t n = write((const uint8_t*)temp, len);
+  if (temp != loc) free(temp);
+  return n;
+}
+
+size_t Print::printNumber(unsigned long long n, int base) {
+  char buf[8 * sizeof(n) + 1];
+  char* str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) base = 10;
+  do {
+    char c = (char)(n % base);
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+size_t Print::print(double n, int digits) {
+  char buf[48];
+  if (digits < 0) digits = 2;
+  int len = snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  if (len < 0) return 0;
+  return write((const uint8_t*)buf, min((size_t)len, sizeof(buf) - 1));
+}
+
+int Stream::timedRead() {
+  unsigned long start = millis();
+  auto realStart = std::chrono::steady_clock::now();
+  do {
+    int c = read();
+    if (c >= 0) return c;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  } while (millis() - start < timeout_ &&
+           std::chrono::steady_clock::now() - realStart < std::chrono::milliseconds(timeout_));
+  return -1;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+  size_t count = 0;
+  while (count < length) {
+    int c = timedRead();
+    if (c < 0) break;
+    *buffer++ = (char)c;
+    count++;
+  }
+  return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char* buffer, size_t length) {
+  size_t count = 0;
+  while (count < length) {
+    int c = timedRead();
+    if (c < 0 || c == terminator) break;
+    *buffer++ = (char)c;
+    count++;
+  }
+  return count;
+}
+
+String Stream::readString() {
+  String ret;
+  int c = timedRead();
+  while (c >= 0) {
+    ret += (char)c;
+    c = timedRead();
+  }
+  return ret;
+}
+
+String Stream::readStringUntil(char terminator) {
+  String ret;
+  int c = timedRead();
+  while (c >= 0 && c != terminator) {
+    ret += (char)c;
+    c = timedRead();
+  }
+  return ret;
+}
+
+// --- Serial ---
+
+void HardwareSerial::begin(unsigned long baud) { baud_ = baud; }
+
+void HardwareSerial::pollStdin() {
+  if (!stdin_) return;
+  pollfd p = {0, POLLIN, 0};
+  while (::poll(&p, 1, 0) > 0 && (p.revents & POLLIN)) {
+    char buf[256];
+    ssize_t n = ::read(0, buf, sizeof(buf));
+    if (n <= 0) {
+      stdin_ = false;
+      return;
+    }
+    for (ssize_t i = 0; i < n; i++) {
+      size_t next = (rxHead_ + 1) % sizeof(rx_);
+      if (next == rxTail_) break;
+      rx_[rxHead_] = buf[i];
+      rxHead_ = next;
+    }
+  }
+}
+
+void HardwareSerial::hostInject(const char* text) {
+  for (; *text; text++) {
+    size_t next = (rxHead_ + 1) % sizeof(rx_);
+    if (next == rxTail_) break;
+    rx_[rxHead_] = *text;
+    rxHead_ = next;
+  }
+}
+
+int HardwareSerial::available() {
+  pollStdin();
+  return (int)((rxHead_ + sizeof(rx_) - rxTail_) % sizeof(rx_));
+}
+
+int HardwareSerial::read() {
+  if (!available()) return -1;
+  char c = rx_[rxTail_];
+  rxTail_ = (rxTail_ + 1) % sizeof(rx_);
+  return (uint8_t)c;
+}
+
+int HardwareSerial::peek() { return available() ? (uint8_t)rx_[rxTail_] : -1; }
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  written_ += size;
+  if (echo_) fwrite(buffer, 1, size, stdout);
+  if (copia_) copia_->write(buffer, size);
+  return size;
+}
+
+// --- Tiempo: reloj real + avance virtual de delay() ---
+
+static const auto bootTime = std::chrono::steady_clock::now();
+static std::atomic<uint64_t> virtualUs{0};
+
+static bool realtimeDelays() {
+  static int cached = -1;
+  if (cached < 0) {
+    const char* env = getenv("ESP32_HOST_REALTIME");
+    cached = env && env[0] == '1';
+  }
+  return cached == 1;
+}
+
+unsigned long micros() {
+  auto real = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime);
+  return (unsigned long)(uint32_t)(real.count() + virtualUs.load(std::memory_order_relaxed));
+}
+
+unsigned long millis() {
+  auto real = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime);
+  return (unsigned long)(uint32_t)((real.count() + virtualUs.load(std::memory_order_relaxed)) / 1000);
+}
+
+struct Programado {
+  unsigned long cuando;
+  void (*fn)(void*);
+  void* arg;
+};
+static std::mutex programadosMutex;
+static std::vector<Programado> programados;
+
+void hostProgramar(unsigned long cuandoMs, void (*fn)(void*), void* arg) {
+  std::lock_guard<std::mutex> lock(programadosMutex);
+  programados.push_back({cuandoMs, fn, arg});
+}
+
+void hostCancelar(void* arg) {
+  std::lock_guard<std::mutex> lock(programadosMutex);
+  for (size_t i = 0; i < programados.size();) {
+    if (programados[i].arg == arg) programados.erase(programados.begin() + i);
+    else i++;
+  }
+}
+
+static void dispararProgramados() {
+  for (;;) {
+    Programado p;
+    {
+      std::lock_guard<std::mutex> lock(programadosMutex);
+      size_t i = 0;
+      while (i < programados.size() && (long)(millis() - programados[i].cuando) < 0) i++;
+      if (i == programados.size()) return;
+      p = programados[i];
+      programados.erase(programados.begin() + i);
+    }
+    p.fn(p.arg);
+  }
+}
+
+void delay(uint32_t ms) {
+  hostDelayAccount((uint64_t)ms * 1000);
+  if (realtimeDelays()) std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  else virtualUs.fetch_add((uint64_t)ms * 1000, std::memory_order_relaxed);
+  dispararProgramados();
+}
+
+void delayMicroseconds(uint32_t us) {
+  hostDelayAccount(us);
+  if (realtimeDelays()) std::this_thread::sleep_for(std::chrono::microseconds(us));
+  else virtualUs.fetch_add(us, std::memory_order_relaxed);
+}
+
+void yield() {}
+
+int xPortGetCoreID() { return 0; }
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+  int libre = 0;
+  while (!mux->owner.compare_exchange_weak(libre, 1, std::memory_order_acquire)) {
+    libre = 0;
+    std::this_thread::yield();
+  }
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) { mux->owner.store(0, std::memory_order_release); }
+
+// --- GPIO simulado ---
+// El estado son los propios registros (salida, enable, pulls del IO MUX); un pin
+// como entrada lee su pull (0 si flota) salvo que esté en corto con una salida.
+
+static uint32_t gpioOut;
+static uint32_t gpioEnable;
+static uint32_t ioMux[SOC_GPIO_PIN_COUNT];
+static std::vector<std::pair<uint8_t, uint8_t>> cortosGPIO;
+
+static uint32_t mascaraPull(uint32_t bit) {
+  uint32_t m = 0;
+  for (uint8_t pin = 0; pin < SOC_GPIO_PIN_COUNT; pin++) {
+    if (ioMux[pin] & bit) m |= 1UL << pin;
+  }
+  return m;
+}
+
+static uint32_t nivelesGPIO() {
+  uint32_t arriba = mascaraPull(FUN_PU);
+  uint32_t abajo = mascaraPull(FUN_PD);
+  uint32_t in = (gpioOut & gpioEnable) | (arriba & ~abajo & ~gpioEnable);
+  // Un corto iguala los dos pines: manda la salida, o entre dos entradas el pull-up
+  for (const auto& c : cortosGPIO) {
+    uint32_t a = 1UL << c.first, b = 1UL << c.second;
+    bool nivel;
+    if (gpioEnable & a) nivel = gpioOut & a;
+    else if (gpioEnable & b) nivel = gpioOut & b;
+    else nivel = ((arriba & (a | b)) != 0) && !((abajo & (a | b)) != 0);
+    in = nivel ? in | a | b : in & ~(a | b);
+  }
+  return in;
+}
+
+void hostCortoGPIO(uint8_t a, uint8_t b) { cortosGPIO.push_back({a, b}); }
+void hostQuitarCortosGPIO() { cortosGPIO.clear(); }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= SOC_GPIO_PIN_COUNT) return;
+  uint32_t bit = 1UL << pin;
+  if (mode == OUTPUT) gpioEnable |= bit;
+  else gpioEnable &= ~bit;
+  ioMux[pin] &= ~(FUN_PU | FUN_PD);
+  if (mode == INPUT_PULLUP) ioMux[pin] |= FUN_PU;
+  if (mode == INPUT_PULLDOWN) ioMux[pin] |= FUN_PD;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= SOC_GPIO_PIN_COUNT) return;
+  if (val) gpioOut |= 1UL << pin;
+  else gpioOut &= ~(1UL << pin);
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= SOC_GPIO_PIN_COUNT) return 0;
+  return (nivelesGPIO() >> pin) & 1;
+}
+
+const uint32_t GPIO_PIN_MUX_REG[SOC_GPIO_PIN_COUNT] = {
+#define MUX(n) DR_REG_IO_MUX_BASE + 0x04 + 4 * (n)
+  MUX(0), MUX(1), MUX(2), MUX(3), MUX(4), MUX(5), MUX(6), MUX(7), MUX(8), MUX(9), MUX(10),
+  MUX(11), MUX(12), MUX(13), MUX(14), MUX(15), MUX(16), MUX(17), MUX(18), MUX(19), MUX(20), MUX(21),
+#undef MUX
+};
+
+static int pinDeMux(uint32_t reg) {
+  if (reg < GPIO_PIN_MUX_REG[0] || reg > GPIO_PIN_MUX_REG[SOC_GPIO_PIN_COUNT - 1] || (reg & 3)) return -1;
+  return (int)((reg - GPIO_PIN_MUX_REG[0]) / 4);
+}
+
+uint32_t hostLeerRegistro(uint32_t reg) {
+  switch (reg) {
+    case GPIO_OUT_REG: return gpioOut;
+    case GPIO_ENABLE_REG: return gpioEnable;
+    case GPIO_IN_REG: return nivelesGPIO();
+    default: {
+      int pin = pinDeMux(reg);
+      return pin < 0 ? 0 : ioMux[pin];
+    }
+  }
+}
+
+void hostEscribirRegistro(uint32_t reg, uint32_t valor) {
+  const uint32_t pines = (1UL << SOC_GPIO_PIN_COUNT) - 1;
+  switch (reg) {
+    case GPIO_OUT_REG: gpioOut = valor & pines; break;
+    case GPIO_OUT_W1TS_REG: gpioOut |= valor & pines; break;
+    case GPIO_OUT_W1TC_REG: gpioOut &= ~valor; break;
+    case GPIO_ENABLE_REG: gpioEnable = valor & pines; break;
+    case GPIO_ENABLE_W1TS_REG: gpioEnable |= valor & pines; break;
+    case GPIO_ENABLE_W1TC_REG: gpioEnable &= ~valor; break;
+    default: {
+      int pin = pinDeMux(reg);
+      if (pin >= 0) ioMux[pin] = valor;
+    }
+  }
+}
+
+float temperatureRead() { return 41.5f + (float)(millis() % 1000) / 1000.0f; }
+void disableCore0WDT() {}
+
+// --- ESP / ESP-IDF ---
+
+static const uint32_t HOST_HEAP_SIZE = 320 * 1024;
+
+uint32_t EspClass::getHeapSize() { return HOST_HEAP_SIZE; }
+uint32_t EspClass::getFreeHeap() { return heap_caps_get_free_size(MALLOC_CAP_DEFAULT); }
+uint32_t EspClass::getMinFreeHeap() { return heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT); }
+uint32_t EspClass::getMaxAllocHeap() { return heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT); }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(micros() * 160ULL); }
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count() {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - bootTime);
+  return (esp_cpu_cycle_count_t)((uint64_t)ns.count() * 160 / 1000);
+}
+
+void EspClass::restart() { esp_restart(); }
+
+void esp_restart() { throw std::runtime_error("ESP.restart()"); }
+void esp_deep_sleep_start() { throw std::runtime_error("esp_deep_sleep_start()"); }
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return ESP_SLEEP_WAKEUP_UNDEFINED; }
+esp_reset_reason_t esp_reset_reason() { return ESP_RST_POWERON; }
+const char* esp_get_idf_version() { return "v5.1-host"; }
+uint32_t esp_get_free_heap_size() { return ESP.getFreeHeap(); }
+uint32_t esp_get_minimum_free_heap_size() { return ESP.getMinFreeHeap(); }
+
+void esp_chip_info(esp_chip_info_t* out_info) {
+  out_info->model = CHIP_ESP32C3;
+  out_info->features = CHIP_FEATURE_WIFI_BGN | CHIP_FEATURE_BLE;
+  out_info->revision = 4;
+  out_info->cores = 1;
+}
+
+uint32_t rtc_clk_apb_freq_get() { return 80000000; }
+uint32_t rtc_clk_xtal_freq_get() { return 40; }
+
+uint32_t hostHeapSize() { return HOST_HEAP_SIZE; }
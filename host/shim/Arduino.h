@@ -0,0 +1,128 @@
+// Shim de host: subconjunto de Arduino-ESP32 para compilar el explorador en Linux
+// Los delay() avanzan un reloj virtual (no duermen) salvo ESP32_HOST_REALTIME=1.
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <math.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Print.h"
+#include "WString.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+
+using std::max;
+using std::min;
+
+// newlib la trae; glibc solo desde 2.38
+#if !defined(__GLIBC__) || __GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t len = strlen(src);
+  if (size) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+#endif
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define SOC_GPIO_PIN_COUNT 22
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// --- Solo host ---
+// Llama a fn(arg) desde el primer delay() posterior a millis() == cuandoMs. Así los
+// avisos asíncronos del core (fin de escaneo BLE) siguen al reloj virtual sin carreras.
+void hostProgramar(unsigned long cuandoMs, void (*fn)(void*), void* arg);
+void hostCancelar(void* arg);
+// Une dos pines como si hubiera un puente de estaño entre ellos (para probar el autotest)
+void hostCortoGPIO(uint8_t a, uint8_t b);
+void hostQuitarCortosGPIO();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+float temperatureRead();
+void disableCore0WDT();
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud);
+  void updateBaudRate(unsigned long baud) { baud_ = baud; }
+  void end() {}
+  int available() override;
+  int read() override;
+  int peek() override;
+  void flush() override { fflush(stdout); }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  operator bool() const { return true; }
+
+  // --- Solo host ---
+  // Encola texto como si llegara por el puerto serie
+  void hostInject(const char* text);
+  // echo=false descarta la salida (benchmarks); los bytes se siguen contando
+  void hostSetEcho(bool echo) { echo_ = echo; }
+  // Lee stdin de forma no bloqueante (simulador interactivo)
+  void hostSetStdin(bool enabled) { stdin_ = enabled; }
+  size_t hostBytesWritten() const { return written_; }
+  // Copia de la salida hacia otro Print (nullptr = ninguna), con o sin echo
+  void hostSetCopia(Print* copia) { copia_ = copia; }
+  unsigned long hostBaud() const { return baud_; }
+
+private:
+  void pollStdin();
+
+  char rx_[4096];
+  size_t rxHead_ = 0, rxTail_ = 0;
+  bool echo_ = true;
+  bool stdin_ = false;
+  size_t written_ = 0;
+  Print* copia_ = nullptr;
+  unsigned long baud_ = 0;
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+  uint32_t getHeapSize();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint64_t getEfuseMac() { return 0x0000A1B2C3D4E5F6ULL; }
+  uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+  uint32_t getFlashChipSpeed() { return 80000000; }
+  uint32_t getSketchSize() { return 912 * 1024; }
+  uint32_t getFreeSketchSpace() { return 1280 * 1024; }
+  uint32_t getCpuFreqMHz() { return 160; }
+  uint32_t getCycleCount();
+  void restart();
+};
+
+extern EspClass ESP;
@@ -0,0 +1,109 @@
+#include "BLEDevice.h"
+
+#include <thread>
+
+static bool bleInitialized = false;
+static BLEScan bleScan;
+static const BLEDevice::HostAdvertiser* hostList = nullptr;
+static size_t hostCount = 0;
+
+std::string BLEAddress::toString() const {
+  char buf[18];
+  snprintf(buf, sizeof(buf), "%02x:%02x:%02x:%02x:%02x:%02x", addr_[0], addr_[1], addr_[2], addr_[3],
+           addr_[4], addr_[5]);
+  return buf;
+}
+
+void BLEDevice::init(const std::string& deviceName) {
+  (void)deviceName;
+  bleInitialized = true;
+}
+bool BLEDevice::getInitialized() { return bleInitialized; }
+void BLEDevice::setPower(esp_power_level_t powerLevel) { (void)powerLevel; }
+BLEAddress BLEDevice::getAddress() {
+  static const uint8_t own[6] = {0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf8};
+  return BLEAddress(own);
+}
+BLEScan* BLEDevice::getScan() { return &bleScan; }
+
+void BLEDevice::hostSetAdvertisers(const HostAdvertiser* list, size_t count) {
+  hostList = list;
+  hostCount = count;
+}
+const BLEDevice::HostAdvertiser* BLEDevice::hostAdvertisers(size_t* count) {
+  *count = hostCount;
+  return hostList;
+}
+
+void BLEScan::setAdvertisedDeviceCallbacks(BLEAdvertisedDeviceCallbacks* cb, bool wantDuplicates,
+                                           bool shouldParse) {
+  (void)shouldParse;
+  cb_ = cb;
+  wantDuplicates_ = wantDuplicates;
+}
+
+// Cada anunciante emite un paquete cada advIntervalMs durante el escaneo; sin
+// wantDuplicates el stack solo reporta el primero de cada dirección por escaneo.
+// emitirHasta() entrega los paquetes con instante <= transcurridoMs aún pendientes.
+void BLEScan::emitirHasta(uint32_t transcurridoMs) {
+  if (emitidos_.size() != hostCount) emitidos_.assign(hostCount, 0);
+  for (size_t i = 0; i < hostCount; i++) {
+    const BLEDevice::HostAdvertiser& a = hostList[i];
+    uint32_t packets = a.advIntervalMs ? duracionMs_ / a.advIntervalMs : 1;
+    if (!wantDuplicates_ && packets > 1) packets = 1;
+    uint32_t hasta = a.advIntervalMs ? transcurridoMs / a.advIntervalMs + 1 : 1;
+    if (hasta > packets) hasta = packets;
+    BLEAdvertisedDevice dev;
+    if (a.name) dev.name_ = a.name;
+    dev.address_ = BLEAddress(a.addr);
+    for (; emitidos_[i] < hasta; emitidos_[i]++) {
+      seed_ = seed_ * 1103515245 + 12345;
+      dev.rssi_ = a.rssi + (int)((seed_ >> 16) % 7) - 3;
+      bool known = false;
+      for (auto& d : results_.devices_) known |= d.getAddress().equals(dev.address_);
+      if (!known) results_.devices_.push_back(dev);
+      if (cb_) cb_->onResult(dev);
+    }
+  }
+}
+
+void BLEScan::empezar(uint32_t duration, bool is_continue) {
+  stop();
+  if (!is_continue) results_.devices_.clear();
+  emitidos_.assign(hostCount, 0);
+  duracionMs_ = duration * 1000;
+  inicioMs_ = millis();
+}
+
+// Síncrono: todos los anuncios de golpe desde un hilo aparte y luego la espera
+BLEScanResults* BLEScan::start(uint32_t duration, bool is_continue) {
+  empezar(duration, is_continue);
+  std::thread host([this]() { emitirHasta(duracionMs_); });
+  host.join();
+  delay(duration * 1000);
+  return &results_;
+}
+
+// Asíncrono: los anuncios llegan repartidos en el tiempo (un tick cada
+// BLE_HOST_TICK_MS desde delay()) y el aviso de fin al cumplirse la duración
+bool BLEScan::start(uint32_t duration, void (*scanCompleteCB)(BLEScanResults), bool is_continue) {
+  empezar(duration, is_continue);
+  completo_ = scanCompleteCB;
+  emitirHasta(0);
+  hostProgramar(inicioMs_ + BLE_HOST_TICK_MS, tick, this);
+  return true;
+}
+
+void BLEScan::tick(void* scan) {
+  BLEScan* s = (BLEScan*)scan;
+  uint32_t transcurrido = millis() - s->inicioMs_;
+  if (transcurrido < s->duracionMs_) {
+    s->emitirHasta(transcurrido);
+    hostProgramar(millis() + BLE_HOST_TICK_MS, tick, s);
+    return;
+  }
+  s->emitirHasta(s->duracionMs_);
+  if (s->completo_) s->completo_(s->results_);
+}
+
+void BLEScan::stop() { hostCancelar(this); }
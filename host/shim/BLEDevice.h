@@ -0,0 +1,106 @@
+// Shim de host: BLE de Arduino-ESP32 (3.x) con anunciantes programables
+// start() entrega los callbacks desde un hilo aparte, como la tarea host de BLE.
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+
+// Granularidad con la que el escaneo asíncrono reparte los anuncios
+#define BLE_HOST_TICK_MS 10
+
+typedef enum { ESP_PWR_LVL_N12 = 0, ESP_PWR_LVL_N9, ESP_PWR_LVL_N6, ESP_PWR_LVL_N3, ESP_PWR_LVL_N0,
+               ESP_PWR_LVL_P3, ESP_PWR_LVL_P6, ESP_PWR_LVL_P9 } esp_power_level_t;
+
+typedef uint8_t esp_bd_addr_t[6];
+
+class BLEAddress {
+public:
+  BLEAddress() : addr_{0, 0, 0, 0, 0, 0} {}
+  explicit BLEAddress(const uint8_t* addr) { memcpy(addr_, addr, 6); }
+  std::string toString() const;
+  esp_bd_addr_t* getNative() { return &addr_; }
+  bool equals(const BLEAddress& o) const { return memcmp(addr_, o.addr_, 6) == 0; }
+
+private:
+  esp_bd_addr_t addr_;
+};
+
+class BLEAdvertisedDevice {
+public:
+  std::string getName() const { return name_; }
+  bool haveName() const { return !name_.empty(); }
+  BLEAddress getAddress() const { return address_; }
+  int getRSSI() const { return rssi_; }
+  bool haveRSSI() const { return true; }
+
+  std::string name_;
+  BLEAddress address_;
+  int rssi_ = 0;
+};
+
+class BLEAdvertisedDeviceCallbacks {
+public:
+  virtual ~BLEAdvertisedDeviceCallbacks() {}
+  virtual void onResult(BLEAdvertisedDevice advertisedDevice) = 0;
+};
+
+class BLEScanResults {
+public:
+  int getCount() const { return (int)devices_.size(); }
+  BLEAdvertisedDevice getDevice(uint32_t i) const { return devices_[i]; }
+
+  std::vector<BLEAdvertisedDevice> devices_;
+};
+
+class BLEScan {
+public:
+  void setAdvertisedDeviceCallbacks(BLEAdvertisedDeviceCallbacks* cb, bool wantDuplicates = false,
+                                    bool shouldParse = true);
+  void setActiveScan(bool active) { active_ = active; }
+  void setInterval(uint16_t intervalMSecs) { interval_ = intervalMSecs; }
+  void setWindow(uint16_t windowMSecs) { window_ = windowMSecs; }
+  BLEScanResults* start(uint32_t duration, bool is_continue = false);
+  // Asíncrono: vuelve enseguida; scanCompleteCB llega con el primer delay() tras duration (s)
+  bool start(uint32_t duration, void (*scanCompleteCB)(BLEScanResults), bool is_continue = false);
+  void stop();
+  void clearResults() { results_.devices_.clear(); }
+  BLEScanResults* getResults() { return &results_; }
+
+private:
+  void empezar(uint32_t duration, bool is_continue);
+  void emitirHasta(uint32_t transcurridoMs);
+  static void tick(void* scan);
+
+  BLEAdvertisedDeviceCallbacks* cb_ = nullptr;
+  bool wantDuplicates_ = false;
+  bool active_ = false;
+  uint16_t interval_ = 100;
+  uint16_t window_ = 100;
+  BLEScanResults results_;
+  uint32_t seed_ = 12345;
+  void (*completo_)(BLEScanResults) = nullptr;
+  std::vector<uint32_t> emitidos_;  // paquetes ya entregados por anunciante
+  uint32_t duracionMs_ = 0;
+  unsigned long inicioMs_ = 0;
+};
+
+class BLEDevice {
+public:
+  static void init(const std::string& deviceName);
+  static bool getInitialized();
+  static void setPower(esp_power_level_t powerLevel);
+  static BLEAddress getAddress();
+  static BLEScan* getScan();
+
+  // --- Solo host ---
+  struct HostAdvertiser {
+    const char* name;  // nullptr = sin nombre
+    uint8_t addr[6];
+    int rssi;
+    uint16_t advIntervalMs;
+  };
+  static void hostSetAdvertisers(const HostAdvertiser* list, size_t count);
+  static const HostAdvertiser* hostAdvertisers(size_t* count);
+};
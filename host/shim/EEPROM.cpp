@@ -0,0 +1,62 @@
+#include "EEPROM.h"
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+EEPROMClass EEPROM;
+
+static std::string eepromPath() {
+  const char* data = getenv("ESP32_HOST_DATA");
+  std::string dir = data ? data : "host_data";
+  mkdir(dir.c_str(), 0755);
+  return dir + "/eeprom.bin";
+}
+
+bool EEPROMClass::begin(size_t size) {
+  if (data_) end();
+  data_ = (uint8_t*)calloc(size, 1);
+  if (!data_) return false;
+  size_ = size;
+  FILE* f = fopen(eepromPath().c_str(), "rb");
+  if (f) {
+    size_t n = fread(data_, 1, size_, f);
+    (void)n;
+    fclose(f);
+  }
+  dirty_ = false;
+  return true;
+}
+
+void EEPROMClass::end() {
+  free(data_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+uint8_t EEPROMClass::read(int address) {
+  return address >= 0 && (size_t)address < size_ ? data_[address] : 0;
+}
+
+void EEPROMClass::write(int address, uint8_t val) {
+  if (address < 0 || (size_t)address >= size_) return;
+  if (data_[address] != val) {
+    data_[address] = val;
+    dirty_ = true;
+  }
+}
+
+bool EEPROMClass::commit() {
+  if (!data_) return false;
+  if (!dirty_) return true;
+  FILE* f = fopen(eepromPath().c_str(), "wb");
+  if (!f) return false;
+  size_t n = fwrite(data_, 1, size_, f);
+  fclose(f);
+  commits_++;
+  bytesCommitted_ += (uint32_t)n;
+  dirty_ = false;
+  return n == size_;
+}
@@ -0,0 +1,48 @@
+// Shim de host: EEPROMClass del core ESP32, persistida en <datos>/eeprom.bin
+// Igual que en el dispositivo, commit() reescribe el blob completo si hay cambios.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class EEPROMClass {
+public:
+  bool begin(size_t size);
+  void end();
+  uint8_t read(int address);
+  void write(int address, uint8_t val);
+  bool commit();
+  size_t length() const { return size_; }
+  uint8_t* getDataPtr() {
+    dirty_ = true;
+    return data_;
+  }
+  const uint8_t* getConstDataPtr() const { return data_; }
+
+  template <typename T>
+  T& get(int address, T& t) {
+    if (address >= 0 && address + sizeof(T) <= size_) memcpy(&t, data_ + address, sizeof(T));
+    return t;
+  }
+  template <typename T>
+  const T& put(int address, const T& t) {
+    if (address >= 0 && address + sizeof(T) <= size_) {
+      memcpy(data_ + address, &t, sizeof(T));
+      dirty_ = true;
+    }
+    return t;
+  }
+
+  // --- Solo host ---
+  uint32_t hostCommits() const { return commits_; }
+  uint32_t hostBytesCommitted() const { return bytesCommitted_; }
+
+private:
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  bool dirty_ = false;
+  uint32_t commits_ = 0;
+  uint32_t bytesCommitted_ = 0;
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,252 @@
+#include "FS.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "SPIFFS.h"
+
+namespace fs {
+
+struct FileImpl {
+  FS* fs = nullptr;
+  FILE* fp = nullptr;
+  bool dir = false;
+  bool writable = false;
+  std::string path;  // ruta SPIFFS ("/nombre")
+  std::string hostPath;
+  std::vector<std::string> entries;
+  size_t nextEntry = 0;
+  long readSize = -1;  // tamaño fijo en modo lectura (evita fstat por byte)
+
+  ~FileImpl() {
+    if (fp) fclose(fp);
+  }
+};
+
+std::string FS::hostPath(const char* path) const {
+  std::string p = root_;
+  if (!path || path[0] != '/') p += "/";
+  if (path) p += path;
+  while (p.size() > root_.size() + 1 && p.back() == '/') p.pop_back();
+  return p;
+}
+
+void FS::hostRescan() {
+  used_ = 0;
+  DIR* d = opendir(root_.c_str());
+  if (!d) return;
+  while (dirent* e = readdir(d)) {
+    std::string full = root_ + "/" + e->d_name;
+    struct stat st;
+    if (stat(full.c_str(), &st) == 0 && S_ISREG(st.st_mode)) used_ += st.st_size;
+  }
+  closedir(d);
+}
+
+static long fileSizeOnDisk(const std::string& p) {
+  struct stat st;
+  return stat(p.c_str(), &st) == 0 && S_ISREG(st.st_mode) ? (long)st.st_size : -1;
+}
+
+File FS::open(const char* path, const char* mode, const bool create) {
+  (void)create;
+  auto impl = std::make_shared<FileImpl>();
+  impl->fs = this;
+  impl->path = (path && path[0] == '/') ? path : std::string("/") + (path ? path : "");
+  impl->hostPath = hostPath(impl->path.c_str());
+
+  struct stat st;
+  bool isDir = stat(impl->hostPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+  if (isDir) {
+    impl->dir = true;
+    DIR* d = opendir(impl->hostPath.c_str());
+    if (!d) return File();
+    while (dirent* e = readdir(d)) {
+      if (e->d_name[0] == '.') continue;
+      impl->entries.push_back(e->d_name);
+    }
+    closedir(d);
+    return File(impl);
+  }
+
+  const char* fmode = "rb";
+  if (mode[0] == 'w') {
+    fmode = "wb";
+    long old = fileSizeOnDisk(impl->hostPath);
+    if (old > 0) hostAccount(-old);
+  } else if (mode[0] == 'a') {
+    fmode = "ab";
+  } else if (fileSizeOnDisk(impl->hostPath) < 0) {
+    return File();
+  }
+  impl->fp = fopen(impl->hostPath.c_str(), fmode);
+  if (!impl->fp) return File();
+  impl->writable = mode[0] != 'r';
+  if (!impl->writable) impl->readSize = fileSizeOnDisk(impl->hostPath);
+  return File(impl);
+}
+
+bool FS::exists(const char* path) {
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+  if (fallarBorrados_) return false;
+  std::string p = hostPath(path);
+  long size = fileSizeOnDisk(p);
+  if (::unlink(p.c_str()) != 0) return false;
+  if (size > 0) hostAccount(-size);
+  return true;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+  std::string to = hostPath(pathTo);
+  long old = fileSizeOnDisk(to);
+  if (::rename(hostPath(pathFrom).c_str(), to.c_str()) != 0) return false;
+  if (old > 0) hostAccount(-old);
+  return true;
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+  if (!impl_ || !impl_->fp || !impl_->writable) return 0;
+  FS* fs = impl_->fs;
+  if (fs->hostCapacity() && fs->hostUsed() + size > fs->hostCapacity()) {
+    size = fs->hostCapacity() > fs->hostUsed() ? fs->hostCapacity() - fs->hostUsed() : 0;
+  }
+  size_t n = fwrite(buf, 1, size, impl_->fp);
+  fs->hostAccount((long)n);
+  return n;
+}
+
+int File::available() {
+  if (!impl_ || !impl_->fp) return 0;
+  long rem = (long)size() - (long)position();
+  return rem > 0 ? (int)rem : 0;
+}
+
+int File::read() {
+  if (!impl_ || !impl_->fp) return -1;
+  int c = fgetc(impl_->fp);
+  return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+  if (!impl_ || !impl_->fp) return -1;
+  int c = fgetc(impl_->fp);
+  if (c != EOF) ungetc(c, impl_->fp);
+  return c == EOF ? -1 : c;
+}
+
+void File::flush() {
+  if (impl_ && impl_->fp) fflush(impl_->fp);
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+  if (!impl_ || !impl_->fp) return 0;
+  return fread(buf, 1, size, impl_->fp);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (!impl_ || !impl_->fp) return false;
+  int whence = mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END;
+  return fseek(impl_->fp, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+  if (!impl_ || !impl_->fp) return 0;
+  long p = ftell(impl_->fp);
+  return p < 0 ? 0 : (size_t)p;
+}
+
+size_t File::size() const {
+  if (!impl_ || !impl_->fp) return 0;
+  if (impl_->readSize >= 0) return (size_t)impl_->readSize;
+  fflush(impl_->fp);
+  struct stat st;
+  return fstat(fileno(impl_->fp), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() { impl_.reset(); }
+
+File::operator bool() const { return impl_ && (impl_->fp || impl_->dir); }
+
+time_t File::getLastWrite() {
+  if (!impl_) return 0;
+  struct stat st;
+  return stat(impl_->hostPath.c_str(), &st) == 0 ? st.st_mtime : 0;
+}
+
+const char* File::path() const { return impl_ ? impl_->path.c_str() : nullptr; }
+
+// Como en los cores 2.x/3.x, name() es el nombre sin directorio; path() la ruta completa
+const char* File::name() const {
+  if (!impl_) return nullptr;
+  const char* p = impl_->path.c_str();
+  const char* barra = strrchr(p, '/');
+  return barra && barra[1] ? barra + 1 : p;
+}
+
+bool File::isDirectory() const { return impl_ && impl_->dir; }
+
+File File::openNextFile(const char* mode) {
+  if (!impl_ || !impl_->dir) return File();
+  while (impl_->nextEntry < impl_->entries.size()) {
+    std::string child = impl_->path;
+    if (child.back() != '/') child += "/";
+    child += impl_->entries[impl_->nextEntry++];
+    File f = impl_->fs->open(child.c_str(), mode);
+    if (f) return f;
+  }
+  return File();
+}
+
+void File::rewindDirectory() {
+  if (impl_) impl_->nextEntry = 0;
+}
+
+bool SPIFFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles,
+                     const char* partitionLabel) {
+  (void)formatOnFail;
+  (void)basePath;
+  (void)maxOpenFiles;
+  (void)partitionLabel;
+  if (root_.empty()) {
+    const char* data = getenv("ESP32_HOST_DATA");
+    root_ = std::string(data ? data : "host_data") + "/spiffs";
+  }
+  std::string acc;
+  for (size_t i = 0; i <= root_.size(); i++) {
+    if (i == root_.size() || root_[i] == '/') {
+      if (!acc.empty()) mkdir(acc.c_str(), 0755);
+    }
+    if (i < root_.size()) acc += root_[i];
+  }
+  hostRescan();
+  struct stat st;
+  return stat(root_.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool SPIFFSFS::format() {
+  DIR* d = opendir(root_.c_str());
+  if (!d) return false;
+  while (dirent* e = readdir(d)) {
+    if (e->d_name[0] == '.') continue;
+    ::unlink((root_ + "/" + e->d_name).c_str());
+  }
+  closedir(d);
+  used_ = 0;
+  return true;
+}
+
+size_t SPIFFSFS::totalBytes() { return capacity_; }
+size_t SPIFFSFS::usedBytes() { return used_; }
+
+}  // namespace fs
+
+fs::SPIFFSFS SPIFFS;
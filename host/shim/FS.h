@@ -0,0 +1,88 @@
+// Shim de host: File/FS del core ESP32 respaldados por un directorio local
+#pragma once
+#include <memory>
+#include <string>
+
+#include "Arduino.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class FS;
+struct FileImpl;
+
+class File : public Stream {
+public:
+  File() {}
+  explicit File(std::shared_ptr<FileImpl> impl) : impl_(impl) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  void flush() override;
+  size_t read(uint8_t* buf, size_t size);
+  size_t readBytes(char* buffer, size_t length) { return read((uint8_t*)buffer, length); }
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  void close();
+  operator bool() const;
+  time_t getLastWrite();
+  const char* path() const;
+  const char* name() const;
+  bool isDirectory() const;
+  File openNextFile(const char* mode = FILE_READ);
+  void rewindDirectory();
+
+private:
+  std::shared_ptr<FileImpl> impl_;
+};
+
+class FS {
+public:
+  File open(const char* path, const char* mode = FILE_READ, const bool create = false);
+  File open(const String& path, const char* mode = FILE_READ, const bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* pathFrom, const char* pathTo);
+  bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+
+  // --- Solo host ---
+  std::string hostPath(const char* path) const;
+  void hostSetRoot(const char* dir) { root_ = dir; }
+  const std::string& hostRoot() const { return root_; }
+  // Contabilidad de ocupación (bytes de datos) para simular una partición llena
+  size_t hostUsed() const { return used_; }
+  size_t hostCapacity() const { return capacity_; }
+  void hostAccount(long delta) { used_ = (long)used_ + delta < 0 ? 0 : used_ + delta; }
+  void hostRescan();
+  // Hace fallar todos los remove() (una partición dañada o de solo lectura)
+  void hostFallarBorrados(bool fallar) { fallarBorrados_ = fallar; }
+
+protected:
+  std::string root_;
+  size_t capacity_ = 0;
+  size_t used_ = 0;
+  bool fallarBorrados_ = false;
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekMode;
+using fs::SeekSet;
@@ -0,0 +1,20 @@
+// Shim de host: IPAddress IPv4
+#pragma once
+#include <cstdint>
+
+#include "WString.h"
+
+class IPAddress {
+public:
+  IPAddress() : bytes_{0, 0, 0, 0} {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes_{a, b, c, d} {}
+  uint8_t operator[](int i) const { return bytes_[i]; }
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", bytes_[0], bytes_[1], bytes_[2], bytes_[3]);
+    return String(buf);
+  }
+
+private:
+  uint8_t bytes_[4];
+};
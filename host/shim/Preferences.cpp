@@ -0,0 +1,79 @@
+#include "Preferences.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+uint32_t Preferences::writes_ = 0;
+uint32_t Preferences::bytesWritten_ = 0;
+
+bool Preferences::begin(const char* name, bool readOnly, const char*) {
+  const char* data = getenv("ESP32_HOST_DATA");
+  snprintf(dir_, sizeof(dir_), "%s/nvs", data ? data : "host_data");
+  mkdir(data ? data : "host_data", 0755);
+  mkdir(dir_, 0755);
+  size_t n = strlen(dir_);
+  snprintf(dir_ + n, sizeof(dir_) - n, "/%s", name);
+  mkdir(dir_, 0755);
+  started_ = true;
+  readOnly_ = readOnly;
+  return true;
+}
+
+void Preferences::end() { started_ = false; }
+
+const char* Preferences::path(const char* key) {
+  snprintf(path_, sizeof(path_), "%s/%s", dir_, key);
+  return path_;
+}
+
+bool Preferences::clear() {
+  if (!started_ || readOnly_) return false;
+  DIR* d = opendir(dir_);
+  if (!d) return false;
+  while (struct dirent* e = readdir(d)) {
+    if (e->d_name[0] != '.') unlink(path(e->d_name));
+  }
+  closedir(d);
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  return started_ && !readOnly_ && unlink(path(key)) == 0;
+}
+
+bool Preferences::isKey(const char* key) {
+  struct stat st;
+  return started_ && stat(path(key), &st) == 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (!started_ || readOnly_ || !key || !value || !len) return 0;
+  FILE* f = fopen(path(key), "wb");
+  if (!f) return 0;
+  size_t n = fwrite(value, 1, len, f);
+  fclose(f);
+  writes_++;
+  bytesWritten_ += (uint32_t)n;
+  return n == len ? len : 0;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  struct stat st;
+  if (!started_ || stat(path(key), &st) != 0) return 0;
+  return (size_t)st.st_size;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  size_t len = getBytesLength(key);
+  if (!len || !buf || len > maxLen) return 0;  // como en el core: no trunca
+  FILE* f = fopen(path(key), "rb");
+  if (!f) return 0;
+  size_t n = fread(buf, 1, len, f);
+  fclose(f);
+  return n == len ? len : 0;
+}
@@ -0,0 +1,32 @@
+// Shim de host: Preferences (NVS) del core ESP32, una clave por archivo en
+// <datos>/nvs/<espacio>/<clave>. Como en el dispositivo, cada put escribe y confirma.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false, const char* partition_label = nullptr);
+  void end();
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+  size_t putBytes(const char* key, const void* value, size_t len);
+  size_t getBytesLength(const char* key);
+  size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+  // --- Solo host ---
+  static uint32_t hostWrites() { return writes_; }
+  static uint32_t hostBytesWritten() { return bytesWritten_; }
+
+private:
+  // Sin std::string: las rutas no cuentan como asignaciones del sketch
+  const char* path(const char* key);
+
+  char dir_[200] = "";
+  char path_[480];
+  bool started_ = false;
+  bool readOnly_ = false;
+  static uint32_t writes_;
+  static uint32_t bytesWritten_;
+};
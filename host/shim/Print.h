@@ -0,0 +1,63 @@
+// Shim de host: jerarquía Print/Stream del core Arduino
+#pragma once
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+#include "WString.h"
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+  size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+  size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  // Como en el core: los números se formatean en la pila, sin pasar por String
+  size_t print(unsigned char n, int base = 10) { return printNumber(n, base); }
+  size_t print(int n, int base = 10) { return print((long long)n, base); }
+  size_t print(unsigned int n, int base = 10) { return printNumber(n, base); }
+  size_t print(long n, int base = 10) { return print((long long)n, base); }
+  size_t print(unsigned long n, int base = 10) { return printNumber(n, base); }
+  size_t print(long long n, int base = 10) {
+    if (base == 10 && n < 0) return print('-') + printNumber(0ULL - (unsigned long long)n, 10);
+    return printNumber((unsigned long long)n, base);
+  }
+  size_t print(unsigned long long n, int base = 10) { return printNumber(n, base); }
+  size_t print(double n, int digits = 2);
+
+  size_t println() { return write((const uint8_t*)"\r\n", 2); }
+  template <typename T>
+  size_t println(const T& v) { return print(v) + println(); }
+  template <typename T>
+  size_t println(const T& v, int fmt) { return print(v, fmt) + println(); }
+
+private:
+  size_t printNumber(unsigned long long n, int base);
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() {}
+
+  void setTimeout(unsigned long timeout) { timeout_ = timeout; }
+  size_t readBytes(char* buffer, size_t length);
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+  size_t readBytesUntil(char terminator, char* buffer, size_t length);
+  String readString();
+  String readStringUntil(char terminator);
+
+protected:
+  // Lectura con espera: en el host reintenta hasta agotar timeout_
+  int timedRead();
+  unsigned long timeout_ = 1000;
+};
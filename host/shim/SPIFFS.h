@@ -0,0 +1,24 @@
+// Shim de host: SPIFFS sobre el directorio <datos>/spiffs
+// La capacidad es fija (como la partición) y las escrituras fallan al llenarse.
+#pragma once
+#include "FS.h"
+
+namespace fs {
+
+class SPIFFSFS : public FS {
+public:
+  SPIFFSFS() { capacity_ = 1318001; }
+  bool begin(bool formatOnFail = false, const char* basePath = "/spiffs", uint8_t maxOpenFiles = 10,
+             const char* partitionLabel = nullptr);
+  bool format();
+  size_t totalBytes();
+  size_t usedBytes();
+  void end() {}
+
+  // --- Solo host ---
+  void hostSetTotalBytes(size_t total) { capacity_ = total; }
+};
+
+}  // namespace fs
+
+extern fs::SPIFFSFS SPIFFS;
@@ -0,0 +1,226 @@
+#include "WString.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+String::String(const char* cstr) { copy(cstr ? cstr : "", cstr ? strlen(cstr) : 0); }
+String::String(const String& str) { copy(str.c_str(), str.len_); }
+String::String(String&& rval) noexcept : buf_(rval.buf_), len_(rval.len_), cap_(rval.cap_) {
+  rval.buf_ = nullptr;
+  rval.len_ = rval.cap_ = 0;
+}
+String::String(char c) { copy(&c, 1); }
+
+static void formatInteger(char* out, size_t outLen, unsigned long long magnitude, bool negative,
+                          unsigned char base) {
+  char tmp[72];
+  int pos = 0;
+  if (base < 2 || base > 36) base = 10;
+  do {
+    int digit = magnitude % base;
+    tmp[pos++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    magnitude /= base;
+  } while (magnitude && pos < (int)sizeof(tmp) - 1);
+  size_t o = 0;
+  if (negative && o + 1 < outLen) out[o++] = '-';
+  while (pos > 0 && o + 1 < outLen) out[o++] = tmp[--pos];
+  out[o] = '\0';
+}
+
+#define STRING_SIGNED_CTOR(T)                                                           \
+  String::String(T value, unsigned char base) {                                        \
+    char tmp[72];                                                                      \
+    bool neg = value < 0 && base == 10;                                                \
+    unsigned long long mag = neg ? 0ULL - (unsigned long long)value                    \
+                                 : (unsigned long long)(value);                        \
+    if (!neg && value < 0) mag = (unsigned long long)(unsigned T)value;                \
+    formatInteger(tmp, sizeof(tmp), mag, neg, base);                                   \
+    copy(tmp, strlen(tmp));                                                            \
+  }
+#define STRING_UNSIGNED_CTOR(T)                                                         \
+  String::String(T value, unsigned char base) {                                        \
+    char tmp[72];                                                                      \
+    formatInteger(tmp, sizeof(tmp), (unsigned long long)value, false, base);           \
+    copy(tmp, strlen(tmp));                                                            \
+  }
+
+STRING_UNSIGNED_CTOR(unsigned char)
+STRING_SIGNED_CTOR(int)
+STRING_UNSIGNED_CTOR(unsigned int)
+STRING_SIGNED_CTOR(long)
+STRING_UNSIGNED_CTOR(unsigned long)
+STRING_SIGNED_CTOR(long long)
+STRING_UNSIGNED_CTOR(unsigned long long)
+
+String::String(float value, unsigned int decimalPlaces) : String((double)value, decimalPlaces) {}
+String::String(double value, unsigned int decimalPlaces) {
+  char tmp[64];
+  snprintf(tmp, sizeof(tmp), "%.*f", (int)decimalPlaces, value);
+  copy(tmp, strlen(tmp));
+}
+
+String::~String() { free(buf_); }
+
+String& String::operator=(const String& rhs) {
+  if (this != &rhs) copy(rhs.c_str(), rhs.len_);
+  return *this;
+}
+String& String::operator=(String&& rval) noexcept {
+  if (this != &rval) {
+    free(buf_);
+    buf_ = rval.buf_;
+    len_ = rval.len_;
+    cap_ = rval.cap_;
+    rval.buf_ = nullptr;
+    rval.len_ = rval.cap_ = 0;
+  }
+  return *this;
+}
+String& String::operator=(const char* cstr) {
+  copy(cstr ? cstr : "", cstr ? strlen(cstr) : 0);
+  return *this;
+}
+
+bool String::changeBuffer(unsigned int maxStrLen) {
+  char* nb = (char*)realloc(buf_, maxStrLen + 1);
+  if (!nb) return false;
+  buf_ = nb;
+  cap_ = maxStrLen;
+  return true;
+}
+
+bool String::reserve(unsigned int size) {
+  if (buf_ && cap_ >= size) return true;
+  if (!changeBuffer(size)) return false;
+  if (len_ == 0) buf_[0] = '\0';
+  return true;
+}
+
+void String::copy(const char* cstr, unsigned int length) {
+  if (!reserve(length)) {
+    len_ = 0;
+    return;
+  }
+  len_ = length;
+  memmove(buf_, cstr, length);
+  buf_[len_] = '\0';
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+  if (!cstr) return false;
+  if (length == 0) return true;
+  unsigned int newlen = len_ + length;
+  // Mismo crecimiento que el core: exacto, sin reserva geométrica
+  if (!reserve(newlen)) return false;
+  memcpy(buf_ + len_, cstr, length);
+  len_ = newlen;
+  buf_[len_] = '\0';
+  return true;
+}
+bool String::concat(const String& s) { return concat(s.c_str(), s.len_); }
+bool String::concat(const char* cstr) { return cstr ? concat(cstr, strlen(cstr)) : false; }
+bool String::concat(char c) { return concat(&c, 1); }
+
+bool String::equals(const String& s) const {
+  return len_ == s.len_ && memcmp(c_str(), s.c_str(), len_) == 0;
+}
+bool String::equals(const char* cstr) const { return strcmp(c_str(), cstr ? cstr : "") == 0; }
+bool String::equalsIgnoreCase(const String& s) const {
+  if (len_ != s.len_) return false;
+  for (unsigned int i = 0; i < len_; i++) {
+    if (tolower((unsigned char)buf_[i]) != tolower((unsigned char)s.buf_[i])) return false;
+  }
+  return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+  return prefix.len_ <= len_ && memcmp(c_str(), prefix.c_str(), prefix.len_) == 0;
+}
+bool String::endsWith(const String& suffix) const {
+  return suffix.len_ <= len_ && memcmp(c_str() + len_ - suffix.len_, suffix.c_str(), suffix.len_) == 0;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+  if (fromIndex >= len_) return -1;
+  const char* p = (const char*)memchr(buf_ + fromIndex, ch, len_ - fromIndex);
+  return p ? (int)(p - buf_) : -1;
+}
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+  if (fromIndex > len_) return -1;
+  const char* p = strstr(c_str() + fromIndex, str.c_str());
+  return p ? (int)(p - c_str()) : -1;
+}
+int String::lastIndexOf(char ch) const {
+  const char* p = len_ ? strrchr(buf_, ch) : nullptr;
+  return p ? (int)(p - buf_) : -1;
+}
+
+String String::substring(unsigned int left, unsigned int right) const {
+  if (left > right) {
+    unsigned int t = left;
+    left = right;
+    right = t;
+  }
+  String out;
+  if (left >= len_) return out;
+  if (right > len_) right = len_;
+  out.copy(buf_ + left, right - left);
+  return out;
+}
+
+void String::trim() {
+  if (!buf_ || len_ == 0) return;
+  char* begin = buf_;
+  while (isspace((unsigned char)*begin)) begin++;
+  char* end = buf_ + len_ - 1;
+  while (end >= begin && isspace((unsigned char)*end)) end--;
+  len_ = end + 1 - begin;
+  if (begin > buf_) memmove(buf_, begin, len_);
+  buf_[len_] = '\0';
+}
+
+void String::toLowerCase() {
+  for (unsigned int i = 0; i < len_; i++) buf_[i] = tolower((unsigned char)buf_[i]);
+}
+void String::toUpperCase() {
+  for (unsigned int i = 0; i < len_; i++) buf_[i] = toupper((unsigned char)buf_[i]);
+}
+
+long String::toInt() const { return atol(c_str()); }
+float String::toFloat() const { return (float)atof(c_str()); }
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+  if (!bufsize || !buf) return;
+  if (index >= len_) {
+    buf[0] = 0;
+    return;
+  }
+  unsigned int n = bufsize - 1;
+  if (n > len_ - index) n = len_ - index;
+  memcpy(buf, buf_ + index, n);
+  buf[n] = 0;
+}
+
+String operator+(const String& lhs, const String& rhs) {
+  String out;
+  out.reserve(lhs.length() + rhs.length());
+  out.concat(lhs);
+  out.concat(rhs);
+  return out;
+}
+String operator+(const String& lhs, const char* rhs) {
+  String out(lhs);
+  out.concat(rhs);
+  return out;
+}
+String operator+(const char* lhs, const String& rhs) {
+  String out(lhs);
+  out.concat(rhs);
+  return out;
+}
+String operator+(const String& lhs, char rhs) {
+  String out(lhs);
+  out.concat(rhs);
+  return out;
+}
@@ -0,0 +1,85 @@
+// Shim de host: String compatible con el core Arduino-ESP32
+// Solo implementa la parte de la API que usa el explorador.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class String {
+public:
+  String(const char* cstr = "");
+  String(const String& str);
+  String(String&& rval) noexcept;
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimalPlaces = 2);
+  explicit String(double value, unsigned int decimalPlaces = 2);
+  ~String();
+
+  String& operator=(const String& rhs);
+  String& operator=(String&& rval) noexcept;
+  String& operator=(const char* cstr);
+
+  bool reserve(unsigned int size);
+  unsigned int length() const { return len_; }
+  const char* c_str() const { return buf_ ? buf_ : ""; }
+
+  bool concat(const String& str);
+  bool concat(const char* cstr);
+  bool concat(const char* cstr, unsigned int length);
+  bool concat(char c);
+  String& operator+=(const String& rhs) { concat(rhs); return *this; }
+  String& operator+=(const char* cstr) { concat(cstr); return *this; }
+  String& operator+=(char c) { concat(c); return *this; }
+  String& operator+=(int num) { concat(String(num)); return *this; }
+  String& operator+=(unsigned int num) { concat(String(num)); return *this; }
+  String& operator+=(long num) { concat(String(num)); return *this; }
+  String& operator+=(unsigned long num) { concat(String(num)); return *this; }
+
+  bool equals(const String& s) const;
+  bool equals(const char* cstr) const;
+  bool equalsIgnoreCase(const String& s) const;
+  bool operator==(const String& rhs) const { return equals(rhs); }
+  bool operator==(const char* cstr) const { return equals(cstr); }
+  bool operator!=(const String& rhs) const { return !equals(rhs); }
+  bool operator!=(const char* cstr) const { return !equals(cstr); }
+  bool operator<(const String& rhs) const { return strcmp(c_str(), rhs.c_str()) < 0; }
+
+  bool startsWith(const String& prefix) const;
+  bool endsWith(const String& suffix) const;
+  char charAt(unsigned int index) const { return index < len_ ? buf_[index] : 0; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  int indexOf(char ch, unsigned int fromIndex = 0) const;
+  int indexOf(const String& str, unsigned int fromIndex = 0) const;
+  int lastIndexOf(char ch) const;
+  String substring(unsigned int beginIndex) const { return substring(beginIndex, len_); }
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+  void trim();
+  void toLowerCase();
+  void toUpperCase();
+  long toInt() const;
+  float toFloat() const;
+  void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const;
+  void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+    getBytes((unsigned char*)buf, bufsize, index);
+  }
+
+private:
+  bool changeBuffer(unsigned int maxStrLen);
+  void copy(const char* cstr, unsigned int length);
+
+  char* buf_ = nullptr;
+  unsigned int len_ = 0;
+  unsigned int cap_ = 0;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
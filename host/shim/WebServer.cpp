@@ -0,0 +1,543 @@
+#include "WebServer.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cctype>
+
+static const char* responseCodeText(int code) {
+  switch (code) {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 206: return "Partial Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 411: return "Length Required";
+    case 412: return "Precondition Failed";
+    case 413: return "Request Entity Too Large";
+    case 416: return "Range Not Satisfiable";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    case 507: return "Insufficient Storage";
+    default: return "";
+  }
+}
+
+static String urlDecode(const char* s, size_t len) {
+  String out;
+  out.reserve(len);
+  for (size_t i = 0; i < len; i++) {
+    char c = s[i];
+    if (c == '+') {
+      out += ' ';
+    } else if (c == '%' && i + 2 < len + 0 && isxdigit((unsigned char)s[i + 1]) &&
+               isxdigit((unsigned char)s[i + 2])) {
+      char hex[3] = {s[i + 1], s[i + 2], 0};
+      out += (char)strtol(hex, nullptr, 16);
+      i += 2;
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
+
+// Lector del cuerpo de la petición con buffer propio y tope de Content-Length
+class BodyReader {
+public:
+  BodyReader(int fd, size_t length) : fd_(fd), remaining_(length) {}
+
+  int read() {
+    if (pos_ == len_ && !fill()) return -1;
+    return buf_[pos_++];
+  }
+
+  size_t read(uint8_t* dst, size_t n) {
+    size_t got = 0;
+    while (got < n) {
+      if (pos_ == len_ && !fill()) break;
+      size_t k = std::min(n - got, len_ - pos_);
+      memcpy(dst + got, buf_ + pos_, k);
+      pos_ += k;
+      got += k;
+    }
+    return got;
+  }
+
+  // Lee una línea terminada en \r\n (sin incluirla); false si se acaba el cuerpo
+  bool readLine(String& line) {
+    line = "";
+    for (;;) {
+      int c = read();
+      if (c < 0) return false;
+      if (c == '\n') {
+        if (line.endsWith("\r")) line = line.substring(0, line.length() - 1);
+        return true;
+      }
+      line += (char)c;
+    }
+  }
+
+  bool finished() const { return remaining_ == 0 && pos_ == len_; }
+
+private:
+  bool fill() {
+    if (remaining_ == 0) return false;
+    pollfd p = {fd_, POLLIN, 0};
+    if (::poll(&p, 1, 5000) <= 0) return false;
+    ssize_t n = ::recv(fd_, buf_, std::min(sizeof(buf_), remaining_), 0);
+    if (n <= 0) return false;
+    remaining_ -= n;
+    pos_ = 0;
+    len_ = n;
+    return true;
+  }
+
+  int fd_;
+  size_t remaining_;
+  uint8_t buf_[1460];
+  size_t pos_ = 0;
+  size_t len_ = 0;
+};
+
+// Valor de un parámetro de cabecera (name="x"; filename="y")
+static String headerParam(const String& header, const char* param) {
+  String key = String(param) + "=";
+  int i = header.indexOf(key);
+  if (i < 0) return String();
+  i += key.length();
+  if (header[i] == '"') {
+    int end = header.indexOf('"', i + 1);
+    return header.substring(i + 1, end < 0 ? header.length() : end);
+  }
+  int end = header.indexOf(';', i);
+  String v = header.substring(i, end < 0 ? header.length() : end);
+  v.trim();
+  return v;
+}
+
+WebServer::WebServer(int port) : port_(port) {}
+
+WebServer::~WebServer() { close(); }
+
+void WebServer::begin() {
+  if (listenFd_ >= 0) return;
+  int port = port_;
+  if (port < 1024) {
+    const char* env = getenv("ESP32_HOST_HTTP_PORT");
+    port = env ? atoi(env) : 0;
+  }
+  listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  int one = 1;
+  setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (::bind(listenFd_, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(listenFd_, 16) != 0) {
+    ::close(listenFd_);
+    listenFd_ = -1;
+    return;
+  }
+  socklen_t alen = sizeof(addr);
+  getsockname(listenFd_, (sockaddr*)&addr, &alen);
+  boundPort_ = ntohs(addr.sin_port);
+}
+
+void WebServer::close() {
+  if (listenFd_ >= 0) ::close(listenFd_);
+  listenFd_ = -1;
+  client_ = WiFiClient();
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn) {
+  routes_.push_back({uri, method, fn, nullptr});
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn) {
+  routes_.push_back({uri, method, fn, ufn});
+}
+
+void WebServer::handleClient() {
+  if (listenFd_ < 0) return;
+  int fd = ::accept4(listenFd_, nullptr, nullptr, 0);
+  if (fd < 0) return;
+  client_ = WiFiClient(fd);
+  client_.setNoDelay(true);
+  requests_++;
+
+  if (readRequest()) {
+    const Route* route = nullptr;
+    for (auto& r : routes_) {
+      if (r.uri == uri_ && (r.method == HTTP_ANY || r.method == method_)) {
+        route = &r;
+        break;
+      }
+    }
+    // Si el cuerpo no llega completo, el core cierra sin responder
+    if (readBody(route)) {
+      if (route) route->fn();
+      else if (notFound_) notFound_();
+      else send(404, "text/plain", String("Not found: ") + uri_);
+    }
+  } else {
+    send(400, "text/plain", "Bad Request");
+  }
+
+  // Las copias hechas por el handler (server.client()) mantienen vivo el socket
+  client_ = WiFiClient();
+  responseHeaders_ = "";
+  contentLength_ = CONTENT_LENGTH_NOT_SET;
+  chunked_ = false;
+}
+
+bool WebServer::readRequest() {
+  args_.clear();
+  headers_.clear();
+  responseHeaders_ = "";
+  contentLength_ = CONTENT_LENGTH_NOT_SET;
+  chunked_ = false;
+
+  // Cabecera completa (hasta \r\n\r\n) con un tope como HTTP_MAX_DATA_WAIT del core
+  std::vector<char> head;
+  int fd = client_.fd();
+  char buf[1024];
+  size_t headerEnd = 0;
+  while (headerEnd == 0) {
+    pollfd p = {fd, POLLIN, 0};
+    if (::poll(&p, 1, 5000) <= 0) return false;
+    ssize_t n = ::recv(fd, buf, sizeof(buf), MSG_PEEK);
+    if (n <= 0) return false;
+    size_t scanFrom = head.size() >= 3 ? head.size() - 3 : 0;
+    head.insert(head.end(), buf, buf + n);
+    for (size_t i = scanFrom; i + 3 < head.size(); i++) {
+      if (head[i] == '\r' && head[i + 1] == '\n' && head[i + 2] == '\r' && head[i + 3] == '\n') {
+        headerEnd = i + 4;
+        break;
+      }
+    }
+    // Consumir solo la parte de cabecera; el cuerpo queda en el socket
+    size_t consume = headerEnd ? n - (head.size() - headerEnd) : (size_t)n;
+    ::recv(fd, buf, consume, 0);
+    if (headerEnd) head.resize(headerEnd);
+    if (head.size() > 16384) return false;
+  }
+
+  String text;
+  text.concat(head.data(), head.size());
+  int lineEnd = text.indexOf("\r\n");
+  String requestLine = text.substring(0, lineEnd);
+  int sp1 = requestLine.indexOf(' ');
+  int sp2 = requestLine.indexOf(' ', sp1 + 1);
+  if (sp1 < 0 || sp2 < 0) return false;
+  String methodStr = requestLine.substring(0, sp1);
+  String url = requestLine.substring(sp1 + 1, sp2);
+
+  method_ = HTTP_ANY;
+  if (methodStr == "GET") method_ = HTTP_GET;
+  else if (methodStr == "HEAD") method_ = HTTP_HEAD;
+  else if (methodStr == "POST") method_ = HTTP_POST;
+  else if (methodStr == "PUT") method_ = HTTP_PUT;
+  else if (methodStr == "PATCH") method_ = HTTP_PATCH;
+  else if (methodStr == "DELETE") method_ = HTTP_DELETE;
+  else if (methodStr == "OPTIONS") method_ = HTTP_OPTIONS;
+
+  int q = url.indexOf('?');
+  if (q >= 0) {
+    uri_ = url.substring(0, q);
+    parseArgs(url.substring(q + 1));
+  } else {
+    uri_ = url;
+  }
+
+  int pos = lineEnd + 2;
+  while (pos < (int)text.length()) {
+    int end = text.indexOf("\r\n", pos);
+    if (end <= pos) break;
+    String line = text.substring(pos, end);
+    pos = end + 2;
+    int colon = line.indexOf(':');
+    if (colon < 0) continue;
+    String name = line.substring(0, colon);
+    String value = line.substring(colon + 1);
+    value.trim();
+    for (auto& key : headerKeys_) {
+      if (key.equalsIgnoreCase(name)) {
+        headers_.push_back({key, value});
+        break;
+      }
+    }
+    if (name.equalsIgnoreCase("Content-Length")) contentLength_ = value.toInt();
+  }
+
+  clientContentLength_ = contentLength_ == CONTENT_LENGTH_NOT_SET ? 0 : contentLength_;
+  contentLength_ = CONTENT_LENGTH_NOT_SET;
+  return true;
+}
+
+bool WebServer::readBody(const Route* route) {
+  if (clientContentLength_ == 0) return true;
+  bool multipart = header("Content-Type").startsWith("multipart/form-data");
+
+  // Con handler de subida el cuerpo se entrega por bloques, sin guardarlo entero
+  if (route && route->ufn) return multipart ? parseMultipart(*route) : readRaw(*route);
+
+  // Cuerpo de formulario: como el core, sus campos pasan a args
+  if (clientContentLength_ >= 65536) return true;
+  BodyReader reader(client_.fd(), clientContentLength_);
+  String body;
+  body.reserve(clientContentLength_);
+  uint8_t buf[1024];
+  size_t n;
+  while ((n = reader.read(buf, sizeof(buf))) > 0) body.concat((const char*)buf, n);
+  if (header("Content-Type").startsWith("application/x-www-form-urlencoded")) {
+    parseArgs(body);
+  } else {
+    args_.push_back({"plain", body});
+  }
+  return true;
+}
+
+bool WebServer::readRaw(const Route& route) {
+  raw_.reset(new HTTPRaw());
+  raw_->status = RAW_START;
+  raw_->totalSize = 0;
+  raw_->currentSize = 0;
+  route.ufn();
+
+  BodyReader reader(client_.fd(), clientContentLength_);
+  raw_->status = RAW_WRITE;
+  while (raw_->totalSize < clientContentLength_) {
+    size_t n = reader.read(raw_->buf, HTTP_RAW_BUFLEN);
+    if (n == 0) {
+      raw_->status = RAW_ABORTED;
+      raw_->currentSize = 0;
+      route.ufn();
+      return false;
+    }
+    raw_->currentSize = n;
+    raw_->totalSize += n;
+    route.ufn();
+  }
+  raw_->status = RAW_END;
+  raw_->currentSize = 0;
+  route.ufn();
+  return true;
+}
+
+// multipart/form-data en streaming: los campos de texto van a args y cada
+// archivo se entrega al handler en bloques de HTTP_UPLOAD_BUFLEN
+bool WebServer::parseMultipart(const Route& route) {
+  String boundary = headerParam(header("Content-Type"), "boundary");
+  if (!boundary.length()) return false;
+  String delimiter = "\r\n--" + boundary;
+  const char* delim = delimiter.c_str();
+  size_t delimLen = delimiter.length();
+
+  BodyReader reader(client_.fd(), clientContentLength_);
+  String line;
+  // Preámbulo hasta la primera frontera
+  do {
+    if (!reader.readLine(line)) return false;
+  } while (line != "--" + boundary);
+
+  for (;;) {
+    String name, filename, type = "text/plain";
+    for (;;) {
+      if (!reader.readLine(line)) return false;
+      if (!line.length()) break;
+      if (line.startsWith("Content-Disposition") || line.startsWith("content-disposition")) {
+        name = headerParam(line, "name");
+        filename = headerParam(line, "filename");
+      } else if (line.startsWith("Content-Type") || line.startsWith("content-type")) {
+        type = line.substring(line.indexOf(':') + 1);
+        type.trim();
+      }
+    }
+
+    bool isFile = filename.length() > 0;
+    String value;
+    if (isFile) {
+      upload_.reset(new HTTPUpload());
+      upload_->status = UPLOAD_FILE_START;
+      upload_->name = name;
+      upload_->filename = filename;
+      upload_->type = type;
+      upload_->totalSize = 0;
+      upload_->currentSize = 0;
+      route.ufn();
+      upload_->status = UPLOAD_FILE_WRITE;
+    }
+
+    // Datos hasta el delimitador. El único '\r' del delimitador es el primero,
+    // así que ante un fallo basta con devolver lo ya comparado como datos.
+    size_t matched = 0;
+    auto emit = [&](uint8_t c) {
+      if (!isFile) {
+        value += (char)c;
+        return;
+      }
+      upload_->buf[upload_->currentSize++] = c;
+      if (upload_->currentSize == HTTP_UPLOAD_BUFLEN) {
+        upload_->totalSize += upload_->currentSize;
+        route.ufn();
+        upload_->currentSize = 0;
+      }
+    };
+    for (;;) {
+      int c = reader.read();
+      if (c < 0) {
+        if (isFile) {
+          upload_->status = UPLOAD_FILE_ABORTED;
+          route.ufn();
+        }
+        return false;
+      }
+      if ((char)c == delim[matched]) {
+        if (++matched == delimLen) break;
+        continue;
+      }
+      for (size_t i = 0; i < matched; i++) emit((uint8_t)delim[i]);
+      matched = 0;
+      if ((char)c == delim[0]) matched = 1;
+      else emit((uint8_t)c);
+    }
+
+    if (isFile) {
+      if (upload_->currentSize) {
+        upload_->totalSize += upload_->currentSize;
+        route.ufn();
+        upload_->currentSize = 0;
+      }
+      upload_->status = UPLOAD_FILE_END;
+      route.ufn();
+    } else if (name.length()) {
+      args_.push_back({name, value});
+    }
+
+    // "--" cierra el cuerpo; "\r\n" abre la siguiente parte
+    int a = reader.read(), b = reader.read();
+    if (a == '-' && b == '-') break;
+    if (a != '\r' || b != '\n') return false;
+  }
+  // Epílogo
+  uint8_t sink[64];
+  while (reader.read(sink, sizeof(sink)) > 0) {
+  }
+  return true;
+}
+
+void WebServer::parseArgs(const String& query) {
+  const char* s = query.c_str();
+  size_t len = query.length();
+  size_t start = 0;
+  while (start < len) {
+    size_t end = start;
+    while (end < len && s[end] != '&') end++;
+    size_t eq = start;
+    while (eq < end && s[eq] != '=') eq++;
+    KV kv;
+    kv.key = urlDecode(s + start, eq - start);
+    kv.value = eq < end ? urlDecode(s + eq + 1, end - eq - 1) : String();
+    if (kv.key.length()) args_.push_back(kv);
+    start = end + 1;
+  }
+}
+
+String WebServer::arg(const String& name) const {
+  for (auto& kv : args_) {
+    if (kv.key == name) return kv.value;
+  }
+  return String();
+}
+String WebServer::arg(int i) const { return i < (int)args_.size() ? args_[i].value : String(); }
+String WebServer::argName(int i) const { return i < (int)args_.size() ? args_[i].key : String(); }
+bool WebServer::hasArg(const String& name) const {
+  for (auto& kv : args_) {
+    if (kv.key == name) return true;
+  }
+  return false;
+}
+
+void WebServer::collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {
+  headerKeys_.clear();
+  headerKeys_.push_back("Authorization");
+  headerKeys_.push_back("Content-Type");
+  for (size_t i = 0; i < headerKeysCount; i++) headerKeys_.push_back(headerKeys[i]);
+}
+
+String WebServer::header(const String& name) const {
+  for (auto& kv : headers_) {
+    if (kv.key.equalsIgnoreCase(name)) return kv.value;
+  }
+  return String();
+}
+String WebServer::header(int i) const { return i < (int)headers_.size() ? headers_[i].value : String(); }
+String WebServer::headerName(int i) const { return i < (int)headers_.size() ? headers_[i].key : String(); }
+bool WebServer::hasHeader(const String& name) const {
+  for (auto& kv : headers_) {
+    if (kv.key.equalsIgnoreCase(name)) return true;
+  }
+  return false;
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+  String line = name + ": " + value + "\r\n";
+  if (first) responseHeaders_ = line + responseHeaders_;
+  else responseHeaders_ += line;
+}
+
+void WebServer::prepareHeader(String& response, int code, const char* content_type,
+                              size_t contentLength) {
+  response = String("HTTP/1.1 ") + String(code) + " " + responseCodeText(code) + "\r\n";
+  if (!content_type) content_type = "text/html";
+  response += String("Content-Type: ") + content_type + "\r\n";
+  if (contentLength_ == CONTENT_LENGTH_NOT_SET) {
+    response += String("Content-Length: ") + String((unsigned long)contentLength) + "\r\n";
+  } else if (contentLength_ != CONTENT_LENGTH_UNKNOWN) {
+    response += String("Content-Length: ") + String((unsigned long)contentLength_) + "\r\n";
+  } else {
+    response += "Transfer-Encoding: chunked\r\n";
+    chunked_ = true;
+  }
+  response += "Connection: close\r\n";
+  response += responseHeaders_;
+  response += "\r\n";
+  responseHeaders_ = "";
+}
+
+void WebServer::send(int code, const char* content_type, const String& content) {
+  String header;
+  prepareHeader(header, code, content_type, content.length());
+  client_.write((const uint8_t*)header.c_str(), header.length());
+  if (content.length()) sendContent(content);
+}
+
+void WebServer::send_P(int code, const char* content_type, const char* content, size_t contentLength) {
+  String header;
+  prepareHeader(header, code, content_type, contentLength);
+  client_.write((const uint8_t*)header.c_str(), header.length());
+  sendContent(content, contentLength);
+}
+
+void WebServer::sendContent(const char* content, size_t contentLength) {
+  if (chunked_) {
+    char len[16];
+    int n = snprintf(len, sizeof(len), "%zx\r\n", contentLength);
+    client_.write((const uint8_t*)len, n);
+  }
+  if (contentLength) client_.write((const uint8_t*)content, contentLength);
+  if (chunked_) {
+    client_.write((const uint8_t*)"\r\n", 2);
+    if (contentLength == 0) chunked_ = false;
+  }
+}
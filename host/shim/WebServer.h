@@ -0,0 +1,137 @@
+// Shim de host: WebServer del core ESP32 sobre sockets de loopback
+// Un puerto < 1024 se mapea a ESP32_HOST_HTTP_PORT o a uno efímero (ver hostPort()).
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Arduino.h"
+#include "FS.h"
+#include "WiFiClient.h"
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+// Subidas: mismo contrato que el core (el cuerpo llega al handler por bloques)
+#define HTTP_UPLOAD_BUFLEN 1436
+#define HTTP_RAW_BUFLEN 1436
+
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+enum HTTPRawStatus { RAW_START, RAW_WRITE, RAW_END, RAW_ABORTED };
+
+struct HTTPUpload {
+  HTTPUploadStatus status;
+  String filename;
+  String name;
+  String type;
+  size_t totalSize;
+  size_t currentSize;
+  uint8_t buf[HTTP_UPLOAD_BUFLEN];
+};
+
+struct HTTPRaw {
+  HTTPRawStatus status;
+  size_t totalSize;
+  size_t currentSize;
+  uint8_t buf[HTTP_RAW_BUFLEN];
+};
+
+class WebServer {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  explicit WebServer(int port = 80);
+  ~WebServer();
+
+  void begin();
+  void close();
+  void stop() { close(); }
+  void handleClient();
+
+  void on(const String& uri, THandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+  void on(const String& uri, HTTPMethod method, THandlerFunction fn);
+  void on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
+  void onNotFound(THandlerFunction fn) { notFound_ = fn; }
+
+  String uri() const { return uri_; }
+  HTTPMethod method() const { return method_; }
+  WiFiClient client() { return client_; }
+  HTTPUpload& upload() { return *upload_; }
+  HTTPRaw& raw() { return *raw_; }
+  size_t clientContentLength() const { return clientContentLength_; }
+
+  String arg(const String& name) const;
+  String arg(int i) const;
+  String argName(int i) const;
+  int args() const { return (int)args_.size(); }
+  bool hasArg(const String& name) const;
+
+  void collectHeaders(const char* headerKeys[], const size_t headerKeysCount);
+  String header(const String& name) const;
+  String header(int i) const;
+  String headerName(int i) const;
+  int headers() const { return (int)headers_.size(); }
+  bool hasHeader(const String& name) const;
+
+  void send(int code, const char* content_type = nullptr, const String& content = String(""));
+  void send(int code, const String& content_type, const String& content) {
+    send(code, content_type.c_str(), content);
+  }
+  void send_P(int code, const char* content_type, const char* content, size_t contentLength);
+  void setContentLength(const size_t contentLength) { contentLength_ = contentLength; }
+  void sendHeader(const String& name, const String& value, bool first = false);
+  void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+  void sendContent(const char* content, size_t contentLength);
+  void sendContent_P(const char* content, size_t size) { sendContent(content, size); }
+
+  template <typename T>
+  size_t streamFile(T& file, const String& contentType, const int code = 200) {
+    setContentLength(file.size());
+    send(code, contentType.c_str(), String(""));
+    return client_.write(file);
+  }
+
+  // --- Solo host ---
+  int hostPort() const { return boundPort_; }
+  uint32_t hostRequests() const { return requests_; }
+
+private:
+  struct Route {
+    String uri;
+    HTTPMethod method;
+    THandlerFunction fn;
+    THandlerFunction ufn;
+  };
+  struct KV {
+    String key;
+    String value;
+  };
+
+  bool readRequest();
+  bool readBody(const Route* route);
+  bool parseMultipart(const Route& route);
+  bool readRaw(const Route& route);
+  void parseArgs(const String& query);
+  void prepareHeader(String& response, int code, const char* content_type, size_t contentLength);
+
+  int port_;
+  int boundPort_ = 0;
+  int listenFd_ = -1;
+  std::vector<Route> routes_;
+  THandlerFunction notFound_;
+  WiFiClient client_;
+  String uri_;
+  HTTPMethod method_ = HTTP_ANY;
+  std::vector<KV> args_;
+  std::vector<KV> headers_;
+  std::vector<String> headerKeys_;
+  String responseHeaders_;
+  size_t contentLength_ = CONTENT_LENGTH_NOT_SET;
+  size_t clientContentLength_ = 0;
+  std::unique_ptr<HTTPUpload> upload_;
+  std::unique_ptr<HTTPRaw> raw_;
+  bool chunked_ = false;
+  uint32_t requests_ = 0;
+};
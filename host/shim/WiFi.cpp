@@ -0,0 +1,207 @@
+#include "WiFi.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+// --- WiFiClient ---
+
+struct WiFiClient::Socket {
+  int fd;
+  int peeked = -1;
+  explicit Socket(int f) : fd(f) {}
+  ~Socket() {
+    if (fd >= 0) ::close(fd);
+  }
+};
+
+WiFiClient::WiFiClient(int fd) : sock_(std::make_shared<Socket>(fd)) {}
+
+int WiFiClient::fd() const { return sock_ ? sock_->fd : -1; }
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+  if (!sock_ || sock_->fd < 0) return 0;
+  size_t sent = 0;
+  while (sent < size) {
+    ssize_t n = ::send(sock_->fd, buf + sent, size - sent, MSG_NOSIGNAL);
+    if (n > 0) {
+      sent += n;
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+      pollfd p = {sock_->fd, POLLOUT, 0};
+      if (::poll(&p, 1, 5000) <= 0) break;
+      continue;
+    }
+    break;
+  }
+  return sent;
+}
+
+// Igual que WiFiClient::write(Stream&) del core: bloques de 1360 bytes en heap
+size_t WiFiClient::write(Stream& stream) {
+  uint8_t* buf = (uint8_t*)malloc(1360);
+  if (!buf) return 0;
+  size_t total = 0;
+  while (stream.available()) {
+    size_t toRead = 0;
+    for (; toRead < 1360 && stream.available(); toRead++) {
+      int c = stream.read();
+      if (c < 0) break;
+      buf[toRead] = (uint8_t)c;
+    }
+    size_t w = write(buf, toRead);
+    total += w;
+    if (w != toRead) break;
+  }
+  free(buf);
+  return total;
+}
+
+int WiFiClient::available() {
+  if (!sock_ || sock_->fd < 0) return 0;
+  if (sock_->peeked >= 0) return 1;
+  uint8_t c;
+  ssize_t n = ::recv(sock_->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  return n > 0 ? 1 : 0;
+}
+
+int WiFiClient::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+  if (!sock_ || sock_->fd < 0 || size == 0) return -1;
+  size_t off = 0;
+  if (sock_->peeked >= 0) {
+    buf[off++] = (uint8_t)sock_->peeked;
+    sock_->peeked = -1;
+    if (off == size) return (int)off;
+  }
+  ssize_t n = ::recv(sock_->fd, buf + off, size - off, MSG_DONTWAIT);
+  if (n > 0) return (int)(off + n);
+  return off ? (int)off : -1;
+}
+
+int WiFiClient::peek() {
+  if (!sock_ || sock_->fd < 0) return -1;
+  if (sock_->peeked < 0) {
+    uint8_t c;
+    if (::recv(sock_->fd, &c, 1, MSG_DONTWAIT) == 1) sock_->peeked = c;
+  }
+  return sock_->peeked;
+}
+
+uint8_t WiFiClient::connected() {
+  if (!sock_ || sock_->fd < 0) return 0;
+  pollfd p = {sock_->fd, POLLIN, 0};
+  if (::poll(&p, 1, 0) < 0) return 0;
+  if (p.revents & (POLLERR | POLLHUP | POLLNVAL)) return 0;
+  if (p.revents & POLLIN) {
+    uint8_t c;
+    if (::recv(sock_->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0) return 0;
+  }
+  return 1;
+}
+
+void WiFiClient::stop() {
+  if (sock_ && sock_->fd >= 0) {
+    ::close(sock_->fd);
+    sock_->fd = -1;
+  }
+  sock_.reset();
+}
+
+void WiFiClient::setNoDelay(bool nodelay) {
+  if (!sock_ || sock_->fd < 0) return;
+  int v = nodelay ? 1 : 0;
+  setsockopt(sock_->fd, IPPROTO_TCP, TCP_NODELAY, &v, sizeof(v));
+}
+
+// --- WiFiClass ---
+
+bool WiFiClass::mode(wifi_mode_t m) {
+  mode_ = m;
+  // Como en el dispositivo: salir de AP tumba el punto de acceso
+  if (m != WIFI_MODE_AP && m != WIFI_MODE_APSTA) apActive_ = false;
+  return true;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* passphrase, int channel, int ssid_hidden,
+                       int max_connection) {
+  (void)ssid;
+  (void)passphrase;
+  (void)channel;
+  (void)ssid_hidden;
+  (void)max_connection;
+  if (mode_ == WIFI_MODE_STA) mode_ = WIFI_MODE_APSTA;
+  else if (mode_ == WIFI_MODE_NULL) mode_ = WIFI_MODE_AP;
+  apActive_ = true;
+  return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool wifioff) {
+  apActive_ = false;
+  if (wifioff) mode_ = WIFI_MODE_NULL;
+  return true;
+}
+
+// Duración simulada: 13 canales x max_ms_per_chan, como un escaneo activo real
+int16_t WiFiClass::scanNetworks(bool async, bool show_hidden, bool passive, uint32_t max_ms_per_chan,
+                                uint8_t channel, const char* ssid, const uint8_t* bssid) {
+  (void)show_hidden;
+  (void)passive;
+  (void)ssid;
+  (void)bssid;
+  if (mode_ == WIFI_MODE_NULL || mode_ == WIFI_MODE_AP) return WIFI_SCAN_FAILED;
+  if (scanning_) return WIFI_SCAN_RUNNING;
+  scans_++;
+  uint32_t duration = (channel ? 1 : 13) * max_ms_per_chan;
+  found_ = 0;
+  if (async) {
+    scanning_ = true;
+    scanDoneAt_ = millis() + duration;
+    return WIFI_SCAN_RUNNING;
+  }
+  delay(duration);
+  found_ = (int16_t)hostNetCount_;
+  return found_;
+}
+
+int16_t WiFiClass::scanComplete() {
+  if (scanning_) {
+    if ((long)(millis() - scanDoneAt_) < 0) return WIFI_SCAN_RUNNING;
+    scanning_ = false;
+    found_ = (int16_t)hostNetCount_;
+  }
+  return found_;
+}
+
+void WiFiClass::scanDelete() {
+  found_ = 0;
+  scanning_ = false;
+}
+
+void* WiFiClass::getScanInfoByIndex(int i) {
+  if (i < 0 || i >= found_) return nullptr;
+  const HostNetwork& n = hostNets_[i];
+  memset(&registro_, 0, sizeof(registro_));
+  strncpy((char*)registro_.ssid, n.ssid, sizeof(registro_.ssid) - 1);
+  registro_.primary = (uint8_t)n.channel;
+  registro_.rssi = (int8_t)n.rssi;
+  registro_.authmode = n.auth;
+  return &registro_;
+}
+
+String WiFiClass::SSID(uint8_t i) { return i < found_ ? String(hostNets_[i].ssid) : String(); }
+int32_t WiFiClass::RSSI(uint8_t i) { return i < found_ ? hostNets_[i].rssi : 0; }
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t i) {
+  return i < found_ ? hostNets_[i].auth : WIFI_AUTH_OPEN;
+}
+int32_t WiFiClass::channel(uint8_t i) { return i < found_ ? hostNets_[i].channel : 0; }
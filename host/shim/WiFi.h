@@ -0,0 +1,94 @@
+// Shim de host: WiFiClass del core ESP32 con resultados de escaneo programables
+#pragma once
+#include <cstdint>
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+
+typedef enum {
+  WIFI_AUTH_OPEN = 0,
+  WIFI_AUTH_WEP,
+  WIFI_AUTH_WPA_PSK,
+  WIFI_AUTH_WPA2_PSK,
+  WIFI_AUTH_WPA_WPA2_PSK,
+  WIFI_AUTH_WPA2_ENTERPRISE,
+  WIFI_AUTH_WPA3_PSK,
+  WIFI_AUTH_WPA2_WPA3_PSK,
+  WIFI_AUTH_MAX
+} wifi_auth_mode_t;
+
+// Subconjunto de wifi_ap_record_t de ESP-IDF (los campos que usa el sketch)
+typedef struct {
+  uint8_t bssid[6];
+  uint8_t ssid[33];
+  uint8_t primary;
+  int8_t rssi;
+  wifi_auth_mode_t authmode;
+} wifi_ap_record_t;
+
+typedef enum { WIFI_MODE_NULL = 0, WIFI_MODE_STA, WIFI_MODE_AP, WIFI_MODE_APSTA } wifi_mode_t;
+
+#define WIFI_OFF WIFI_MODE_NULL
+#define WIFI_STA WIFI_MODE_STA
+#define WIFI_AP WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+class WiFiClass {
+public:
+  bool mode(wifi_mode_t m);
+  wifi_mode_t getMode() const { return mode_; }
+  bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1, int ssid_hidden = 0,
+              int max_connection = 4);
+  bool softAPdisconnect(bool wifioff = false);
+  IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+  String macAddress() { return String("A1:B2:C3:D4:E5:F6"); }
+  uint8_t* macAddress(uint8_t* mac) {
+    static const uint8_t fija[6] = {0xA1, 0xB2, 0xC3, 0xD4, 0xE5, 0xF6};
+    memcpy(mac, fija, sizeof(fija));
+    return mac;
+  }
+  int32_t RSSI() { return 0; }
+
+  int16_t scanNetworks(bool async = false, bool show_hidden = false, bool passive = false,
+                       uint32_t max_ms_per_chan = 300, uint8_t channel = 0, const char* ssid = nullptr,
+                       const uint8_t* bssid = nullptr);
+  int16_t scanComplete();
+  void scanDelete();
+  String SSID(uint8_t i);
+  int32_t RSSI(uint8_t i);
+  wifi_auth_mode_t encryptionType(uint8_t i);
+  int32_t channel(uint8_t i);
+  // Registro crudo del escaneo (ssid sin pasar por String); nullptr fuera de rango
+  void* getScanInfoByIndex(int i);
+
+  // --- Solo host ---
+  struct HostNetwork {
+    const char* ssid;
+    int32_t rssi;
+    int32_t channel;
+    wifi_auth_mode_t auth;
+  };
+  void hostSetScanResults(const HostNetwork* nets, size_t count) {
+    hostNets_ = nets;
+    hostNetCount_ = count;
+  }
+  bool hostApActive() const { return apActive_; }
+  uint32_t hostScans() const { return scans_; }
+
+private:
+  wifi_mode_t mode_ = WIFI_MODE_NULL;
+  bool apActive_ = false;
+  const HostNetwork* hostNets_ = nullptr;
+  size_t hostNetCount_ = 0;
+  int16_t found_ = 0;
+  bool scanning_ = false;
+  unsigned long scanDoneAt_ = 0;
+  uint32_t scans_ = 0;
+  wifi_ap_record_t registro_ = {};
+};
+
+extern WiFiClass WiFi;
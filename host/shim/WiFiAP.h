@@ -0,0 +1,3 @@
+// Shim de host: la API de punto de acceso vive en WiFiClass
+#pragma once
+#include "WiFi.h"
@@ -0,0 +1,32 @@
+// Shim de host: WiFiClient sobre un socket TCP de loopback
+// Como en el core, las copias comparten el socket: se cierra al soltar la última.
+#pragma once
+#include <memory>
+
+#include "Arduino.h"
+
+class WiFiClient : public Stream {
+public:
+  WiFiClient() {}
+  explicit WiFiClient(int fd);
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+  size_t write(Stream& stream);
+  int available() override;
+  int read() override;
+  int read(uint8_t* buf, size_t size);
+  int peek() override;
+  void flush() override {}
+  uint8_t connected();
+  void stop();
+  void setNoDelay(bool nodelay);
+  int fd() const;
+  operator bool() { return connected(); }
+  bool operator==(const WiFiClient& rhs) const { return sock_ == rhs.sock_; }
+
+private:
+  struct Socket;
+  std::shared_ptr<Socket> sock_;
+};
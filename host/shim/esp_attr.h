@@ -0,0 +1,7 @@
+// Shim de host: atributos de sección del linker ESP-IDF (sin efecto en Linux)
+#pragma once
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define PROGMEM
@@ -0,0 +1,9 @@
+// Shim de host: contador de ciclos de la CPU
+#pragma once
+#include <cstdint>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+// Tiempo real del host convertido a ciclos de un C3 a 160 MHz (no el reloj
+// virtual de delay(): los kernels de microbench queman CPU de verdad)
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count();
@@ -0,0 +1,33 @@
+// Shim de host: lo mínimo de FreeRTOS que usa el explorador
+#pragma once
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+
+int xPortGetCoreID();
+TickType_t xTaskGetTickCount();
+void vTaskDelay(TickType_t ticks);
+
+// Secciones críticas: en el host, un spinlock entre hilos
+#include <atomic>
+struct portMUX_TYPE {
+  std::atomic<int> owner;
+};
+#define portMUX_INITIALIZER_UNLOCKED {0}
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+#define portENTER_CRITICAL(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) vPortExitCritical(mux)
+
+// Enmascarar interrupciones no tiene equivalente en el host: no hace nada
+#define portSET_INTERRUPT_MASK_FROM_ISR() ((UBaseType_t)0)
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(mascara) ((void)(mascara))
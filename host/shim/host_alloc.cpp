@@ -0,0 +1,136 @@
+#include "host_alloc.h"
+
+#include <malloc.h>
+
+#include <atomic>
+
+#include "esp_heap_caps.h"
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+static std::atomic<uint64_t> allocCount{0};
+static std::atomic<uint64_t> freeCount{0};
+static std::atomic<uint64_t> allocBytes{0};
+static std::atomic<int64_t> liveBytes{0};
+static std::atomic<int64_t> peakLive{0};
+static std::atomic<uint64_t> delayUs{0};
+
+static void accountAlloc(void* p, size_t requested) {
+  if (!p) return;
+  allocCount.fetch_add(1, std::memory_order_relaxed);
+  allocBytes.fetch_add(requested, std::memory_order_relaxed);
+  int64_t live = liveBytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed) + malloc_usable_size(p);
+  int64_t peak = peakLive.load(std::memory_order_relaxed);
+  while (live > peak && !peakLive.compare_exchange_weak(peak, live)) {
+  }
+}
+
+static void accountFree(void* p) {
+  if (!p) return;
+  freeCount.fetch_add(1, std::memory_order_relaxed);
+  liveBytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+}
+
+extern "C" {
+
+void* malloc(size_t size) {
+  void* p = __libc_malloc(size);
+  accountAlloc(p, size);
+  return p;
+}
+
+void* calloc(size_t n, size_t size) {
+  void* p = __libc_calloc(n, size);
+  accountAlloc(p, n * size);
+  return p;
+}
+
+void* realloc(void* ptr, size_t size) {
+  if (ptr) liveBytes.fetch_sub(malloc_usable_size(ptr), std::memory_order_relaxed);
+  void* p = __libc_realloc(ptr, size);
+  if (!p) {
+    if (ptr) liveBytes.fetch_add(malloc_usable_size(ptr), std::memory_order_relaxed);
+    return p;
+  }
+  if (ptr) {
+    // Un realloc cuenta como una asignación más (en el dispositivo suele mover el bloque)
+    freeCount.fetch_add(1, std::memory_order_relaxed);
+  }
+  accountAlloc(p, size);
+  return p;
+}
+
+void free(void* ptr) {
+  accountFree(ptr);
+  __libc_free(ptr);
+}
+
+}  // extern "C"
+
+HostAllocStats hostAllocSnapshot() {
+  HostAllocStats s;
+  s.allocs = allocCount.load();
+  s.frees = freeCount.load();
+  s.bytes = allocBytes.load();
+  int64_t live = liveBytes.load();
+  s.liveBytes = live > 0 ? (uint64_t)live : 0;
+  s.peakLive = (uint64_t)peakLive.load();
+  s.delayUs = delayUs.load();
+  return s;
+}
+
+void hostAllocResetPeak() { peakLive.store(liveBytes.load()); }
+
+void hostDelayAccount(uint64_t us) { delayUs.fetch_add(us, std::memory_order_relaxed); }
+
+// El heap del dispositivo se modela como hostHeapSize() menos lo vivo en el host
+// (un solo bloque libre: en Linux no hay fragmentación comparable que medir).
+static size_t modelFree() {
+  int64_t live = liveBytes.load();
+  int64_t total = hostHeapSize();
+  return live < total ? (size_t)(total - (live > 0 ? live : 0)) : 0;
+}
+
+void heap_caps_get_info(multi_heap_info_t* info, uint32_t caps) {
+  (void)caps;
+  size_t freeBytes = modelFree();
+  info->total_free_bytes = freeBytes;
+  info->total_allocated_bytes = hostHeapSize() - freeBytes;
+  info->largest_free_block = freeBytes;
+  int64_t peak = peakLive.load();
+  info->minimum_free_bytes = peak < (int64_t)hostHeapSize() ? hostHeapSize() - peak : 0;
+  uint64_t live = allocCount.load() - freeCount.load();
+  info->allocated_blocks = (size_t)live;
+  info->free_blocks = 1;
+  info->total_blocks = (size_t)live + 1;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+  (void)caps;
+  return modelFree();
+}
+size_t heap_caps_get_total_size(uint32_t caps) {
+  (void)caps;
+  return hostHeapSize();
+}
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  (void)caps;
+  return modelFree();
+}
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, caps);
+  return info.minimum_free_bytes;
+}
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+  (void)caps;
+  // Como en el dispositivo, lo que no cabe en el mayor bloque libre falla
+  if (size > modelFree()) return nullptr;
+  return malloc(size);
+}
+void heap_caps_free(void* ptr) { free(ptr); }
@@ -0,0 +1,18 @@
+// Solo host: contadores de asignación dinámica (malloc interpuesto) y de delay()
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+struct HostAllocStats {
+  uint64_t allocs;      // malloc/calloc/realloc que devolvieron memoria nueva
+  uint64_t frees;
+  uint64_t bytes;       // bytes pedidos en total
+  uint64_t liveBytes;   // bytes vivos ahora
+  uint64_t peakLive;    // máximo de bytes vivos desde el último reset
+  uint64_t delayUs;     // tiempo pedido a delay()/delayMicroseconds()
+};
+
+HostAllocStats hostAllocSnapshot();
+void hostAllocResetPeak();
+void hostDelayAccount(uint64_t us);
+uint32_t hostHeapSize();
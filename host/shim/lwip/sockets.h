@@ -0,0 +1,4 @@
+// Shim de host: en el core los sockets son los de lwIP; aquí los de POSIX
+#pragma once
+#include <errno.h>
+#include <sys/socket.h>
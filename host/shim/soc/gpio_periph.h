@@ -0,0 +1,5 @@
+// Shim de host: registro IO MUX de cada GPIO
+#pragma once
+#include <Arduino.h>
+
+extern const uint32_t GPIO_PIN_MUX_REG[SOC_GPIO_PIN_COUNT];
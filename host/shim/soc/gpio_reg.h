@@ -0,0 +1,11 @@
+// Shim de host: registros GPIO del ESP32-C3 (mismas direcciones que el chip)
+#pragma once
+
+#define DR_REG_GPIO_BASE 0x60004000
+#define GPIO_OUT_REG (DR_REG_GPIO_BASE + 0x0004)
+#define GPIO_OUT_W1TS_REG (DR_REG_GPIO_BASE + 0x0008)
+#define GPIO_OUT_W1TC_REG (DR_REG_GPIO_BASE + 0x000C)
+#define GPIO_ENABLE_REG (DR_REG_GPIO_BASE + 0x0020)
+#define GPIO_ENABLE_W1TS_REG (DR_REG_GPIO_BASE + 0x0024)
+#define GPIO_ENABLE_W1TC_REG (DR_REG_GPIO_BASE + 0x0028)
+#define GPIO_IN_REG (DR_REG_GPIO_BASE + 0x003C)
@@ -0,0 +1,6 @@
+// Shim de host: registros IO MUX del ESP32-C3 (pull-up / pull-down internos)
+#pragma once
+
+#define DR_REG_IO_MUX_BASE 0x60009000
+#define FUN_PU (1UL << 8)
+#define FUN_PD (1UL << 7)
@@ -0,0 +1,6 @@
+// Shim de host: frecuencias de reloj RTC
+#pragma once
+#include <cstdint>
+
+uint32_t rtc_clk_apb_freq_get();
+uint32_t rtc_clk_xtal_freq_get();
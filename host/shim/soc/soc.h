@@ -0,0 +1,11 @@
+// Shim de host: acceso a registros periféricos
+// No hay memoria mapeada: las lecturas y escrituras van a un despachador que
+// emula los registros que conoce (GPIO e IO MUX) y descarta el resto
+#pragma once
+#include <cstdint>
+
+uint32_t hostLeerRegistro(uint32_t reg);
+void hostEscribirRegistro(uint32_t reg, uint32_t valor);
+
+#define REG_READ(reg) hostLeerRegistro((uint32_t)(reg))
+#define REG_WRITE(reg, valor) hostEscribirRegistro((uint32_t)(reg), (uint32_t)(valor))
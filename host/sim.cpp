@@ -0,0 +1,27 @@
+// Simulador interactivo de host: setup() + loop() con el Monitor Serie en stdin/stdout
+// Datos persistentes en ESP32_HOST_DATA (por defecto ./host_data); el servidor web
+// escucha en 127.0.0.1:ESP32_HOST_HTTP_PORT (o un puerto efímero que se imprime).
+// A diferencia del benchmark, aquí delay() duerme de verdad (ESP32_HOST_REALTIME=1).
+#include <stdexcept>
+
+#include "ESP32-Specs.h"
+
+int main() {
+  setenv("ESP32_HOST_REALTIME", "1", 0);
+  setvbuf(stdout, nullptr, _IONBF, 0);
+  Serial.hostSetStdin(true);
+  try {
+    setup();
+    int puertoAnunciado = 0;
+    for (;;) {
+      loop();
+      if (servidorWebActivo && server.hostPort() != puertoAnunciado) {
+        puertoAnunciado = server.hostPort();
+        fprintf(stderr, "[host] servidor web en http://127.0.0.1:%d\n", puertoAnunciado);
+      }
+    }
+  } catch (const std::runtime_error& e) {
+    fprintf(stderr, "\n[host] %s: fin de la simulación\n", e.what());
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "indice_archivos.h"
+#include <SPIFFS.h>
+#include <algorithm>
+#include "resultados.h"
+
+const char* nombreOrdenIndice(OrdenIndice orden) {
+  switch (orden) {
+    case ORDEN_TAMANO: return "size";
+    case ORDEN_FECHA: return "mtime";
+    default: return "name";
+  }
+}
+
+bool IndiceArchivos::actualizar() {
+  if (valido_) return true;
+
+  File root = SPIFFS.open("/");
+  if (!root) return false;
+
+  n_ = 0;
+  vistos_ = 0;
+  for (File file = root.openNextFile(); file; file = root.openNextFile()) {
+    if (file.isDirectory()) continue;
+    vistos_++;
+    if (n_ == INDICE_MAX_ARCHIVOS) continue;
+    EntradaArchivo& e = entradas_[n_++];
+    strlcpy(e.nombre, file.path(), sizeof(e.nombre));
+    e.tamano = file.size();
+    e.fecha = (uint32_t)file.getLastWrite();
+  }
+  root.close();
+
+  usados_ = SPIFFS.usedBytes();
+  totales_ = SPIFFS.totalBytes();
+
+  // Un orden por criterio, calculado una sola vez por reconstrucción
+  for (int o = 0; o < ORDEN_TOTAL; o++) {
+    uint16_t* idx = orden_[o];
+    for (size_t i = 0; i < n_; i++) idx[i] = (uint16_t)i;
+  }
+  const EntradaArchivo* e = entradas_;
+  std::sort(orden_[ORDEN_NOMBRE], orden_[ORDEN_NOMBRE] + n_,
+            [e](uint16_t a, uint16_t b) { return strcmp(e[a].nombre, e[b].nombre) < 0; });
+  std::stable_sort(orden_[ORDEN_TAMANO], orden_[ORDEN_TAMANO] + n_,
+                   [e](uint16_t a, uint16_t b) { return e[a].tamano < e[b].tamano; });
+  std::stable_sort(orden_[ORDEN_FECHA], orden_[ORDEN_FECHA] + n_,
+                   [e](uint16_t a, uint16_t b) { return e[a].fecha < e[b].fecha; });
+
+  reconstrucciones_++;
+  valido_ = true;
+  return true;
+}
+
+void IndiceArchivos::imprimirJSON(Print& out, size_t desde, size_t limite, OrdenIndice orden, bool descendente,
+                                  void (*extra)(Print& out, const EntradaArchivo& e)) const {
+  out.print("{\"files\":[");
+  size_t hasta = desde < n_ ? min(n_, desde + limite) : desde;
+  for (size_t i = desde; i < hasta; i++) {
+    const EntradaArchivo& e = entrada(orden, i, descendente);
+    out.print(i == desde ? "{\"name\":" : ",{\"name\":");
+    imprimirTextoJSON(out, (const uint8_t*)e.nombre, strlen(e.nombre));
+    out.print(",\"size\":");
+    out.print((unsigned long)e.tamano);
+    out.print(",\"mtime\":");
+    out.print((unsigned long)e.fecha);
+    if (extra) extra(out, e);
+    out.print('}');
+  }
+  out.print("],\"count\":");
+  out.print((unsigned long)n_);
+  out.print(",\"offset\":");
+  out.print((unsigned long)desde);
+  out.print(",\"limit\":");
+  out.print((unsigned long)limite);
+  out.print(",\"sort\":\"");
+  out.print(nombreOrdenIndice(orden));
+  out.print(descendente ? "\",\"order\":\"desc\"" : "\",\"order\":\"asc\"");
+  if (truncado()) {
+    out.print(",\"truncated\":");
+    out.print((unsigned long)vistos_);
+  }
+  out.print(",\"used\":");
+  out.print((unsigned long)usados_);
+  out.print(",\"total\":");
+  out.print((unsigned long)totales_);
+  out.print('}');
+}
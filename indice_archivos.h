@@ -0,0 +1,66 @@
+// Índice en RAM del directorio raíz de SPIFFS
+// Guarda nombre, tamaño y fecha de cada archivo, más un orden precalculado por
+// cada criterio. Solo se reconstruye tras una escritura/borrado (invalidar()),
+// así /list no recorre el sistema de archivos en cada consulta y el coste de
+// una página depende de su tamaño, no del número de archivos.
+#pragma once
+#include <Arduino.h>
+
+#ifndef INDICE_MAX_ARCHIVOS
+#define INDICE_MAX_ARCHIVOS 256
+#endif
+
+enum OrdenIndice : uint8_t { ORDEN_NOMBRE, ORDEN_TAMANO, ORDEN_FECHA, ORDEN_TOTAL };
+
+struct EntradaArchivo {
+  char nombre[32];  // SPIFFS limita la ruta a 31 caracteres
+  uint32_t tamano;
+  uint32_t fecha;   // getLastWrite(), segundos
+};
+
+class IndiceArchivos {
+public:
+  // Marca el índice como obsoleto; se reconstruye en el siguiente acceso
+  void invalidar() {
+    valido_ = false;
+    generacion_++;
+  }
+  bool valido() const { return valido_; }
+  // Cambia con cada invalidar(): quien la guardó sabe si SPIFFS cambió desde entonces
+  uint32_t generacion() const { return generacion_; }
+
+  // Reconstruye si hace falta. false si no se pudo abrir la raíz
+  bool actualizar();
+
+  size_t cantidad() const { return n_; }
+  // Archivos vistos en la raíz, incluidos los que no cupieron en el índice
+  uint32_t archivosTotales() const { return vistos_; }
+  bool truncado() const { return vistos_ > n_; }
+  uint32_t bytesUsados() const { return usados_; }
+  uint32_t bytesTotales() const { return totales_; }
+  uint32_t reconstrucciones() const { return reconstrucciones_; }
+
+  // i-ésima entrada según el criterio pedido
+  const EntradaArchivo& entrada(OrdenIndice orden, size_t i, bool descendente) const {
+    size_t p = descendente ? n_ - 1 - i : i;
+    return entradas_[orden_[orden][p]];
+  }
+
+  // Escribe una página del índice como JSON (sin construir el documento en RAM).
+  // extra puede añadir campos a cada archivo (",\"clave\":valor...")
+  void imprimirJSON(Print& out, size_t desde, size_t limite, OrdenIndice orden, bool descendente,
+                    void (*extra)(Print& out, const EntradaArchivo& e) = nullptr) const;
+
+private:
+  EntradaArchivo entradas_[INDICE_MAX_ARCHIVOS];
+  uint16_t orden_[ORDEN_TOTAL][INDICE_MAX_ARCHIVOS];
+  size_t n_ = 0;
+  uint32_t vistos_ = 0;
+  uint32_t usados_ = 0;
+  uint32_t totales_ = 0;
+  uint32_t reconstrucciones_ = 0;
+  uint32_t generacion_ = 0;
+  bool valido_ = false;
+};
+
+const char* nombreOrdenIndice(OrdenIndice orden);
@@ -0,0 +1,214 @@
+#include "interprete.h"
+
+static bool esEspacio(char c) { return c == ' ' || c == '\t'; }
+
+bool LectorLineas::leer(Stream& in) {
+  if (lista_) {
+    n_ = 0;
+    lista_ = false;
+    cortada_ = false;
+  }
+  while (in.available()) {
+    char c = (char)in.read();
+    if (c != '\n' && c != '\r') {
+      if (n_ < sizeof(buf_) - 1) buf_[n_++] = c;
+      else desborde_ = true;
+      continue;
+    }
+    while (n_ > 0 && esEspacio(buf_[n_ - 1])) n_--;
+    size_t ini = 0;
+    while (ini < n_ && esEspacio(buf_[ini])) ini++;
+    memmove(buf_, buf_ + ini, n_ - ini);
+    n_ -= ini;
+    buf_[n_] = '\0';
+    cortada_ = desborde_;
+    desborde_ = false;
+    if (n_ == 0) continue;  // "\r\n" o línea en blanco
+    lista_ = true;
+    return true;
+  }
+  return false;
+}
+
+// "  8*20 " -> cmd "8", veces 20. false si no queda comando (vacío o "*0")
+static bool separarToken(const char* token, size_t len, char* cmd, uint16_t& veces) {
+  while (len > 0 && esEspacio(*token)) {
+    token++;
+    len--;
+  }
+  while (len > 0 && esEspacio(token[len - 1])) len--;
+
+  veces = 1;
+  for (size_t i = len; i > 0; i--) {
+    char c = token[i - 1];
+    if (c == '*') {
+      if (i == len) break;  // "8*" sin número: el '*' es parte del comando
+      // Satura al pasar del máximo: con muchas cifras el acumulador daría la vuelta
+      uint32_t n = 0;
+      for (size_t k = i; k < len && n <= INTERPRETE_REPETICIONES_MAX; k++) n = n * 10 + (token[k] - '0');
+      veces = n > INTERPRETE_REPETICIONES_MAX ? INTERPRETE_REPETICIONES_MAX : (uint16_t)n;
+      len = i - 1;
+      while (len > 0 && esEspacio(token[len - 1])) len--;
+      break;
+    }
+    if (c < '0' || c > '9') break;
+  }
+
+  if (len == 0 || veces == 0) return false;
+  if (len > INTERPRETE_LINEA_MAX - 1) len = INTERPRETE_LINEA_MAX - 1;
+  memcpy(cmd, token, len);
+  cmd[len] = '\0';
+  return true;
+}
+
+const DefComando* Interprete::buscar(const char* nombre, size_t len) const {
+  for (size_t i = 0; i < n_; i++) {
+    const DefComando& d = tabla_[i];
+    if (strlen(d.nombre) == len && strncasecmp(d.nombre, nombre, len) == 0) return &d;
+    if (d.alias && strlen(d.alias) == len && strncasecmp(d.alias, nombre, len) == 0) return &d;
+  }
+  return nullptr;
+}
+
+ResultadoComando Interprete::ejecutar(const char* cmd) {
+  out_.println();
+  const char* espacio = strchr(cmd, ' ');
+  size_t len = espacio ? (size_t)(espacio - cmd) : strlen(cmd);
+  const char* arg = espacio ? espacio + 1 : "";
+  while (esEspacio(*arg)) arg++;
+
+  ResultadoComando r;
+  const DefComando* d = buscar(cmd, len);
+  if (d) {
+    r = d->accion(arg);
+  } else {
+    out_.print(" Comando no reconocido: '");
+    out_.print(cmd);
+    out_.println("'");
+    out_.println(" Escriba 'help' para ver opciones");
+    r = CMD_DESCONOCIDO;
+  }
+  if (despues_) despues_(cmd, r);
+  return r;
+}
+
+bool Interprete::encolar(const char* texto, size_t len) {
+  size_t sep = guionLen_ > 0 ? 1 : 0;
+  if (guionLen_ + sep + len > sizeof(guion_)) return false;
+  if (sep) guion_[guionLen_++] = ';';
+  memcpy(guion_ + guionLen_, texto, len);
+  guionLen_ += len;
+  return true;
+}
+
+bool Interprete::siguiente() {
+  while (guionLen_ > 0) {
+    const char* fin = (const char*)memchr(guion_, ';', guionLen_);
+    size_t len = fin ? (size_t)(fin - guion_) : guionLen_;
+    uint16_t veces;
+    bool hay = separarToken(guion_, len, actual_, veces);
+    size_t consumido = fin ? len + 1 : len;
+    memmove(guion_, guion_ + consumido, guionLen_ - consumido);
+    guionLen_ -= consumido;
+    if (hay) {
+      repeticiones_ = veces;
+      return true;
+    }
+  }
+  return false;
+}
+
+void Interprete::ejecutarLinea(const char* linea) {
+  // Con un diagnóstico en curso la línea no se encola: 'stop' tiene que llegar ya
+  if (!guionPendiente() && !(ocupado_ && ocupado_())) {
+    if (!encolar(linea, strlen(linea))) {
+      out_.println("\n❌ Guion demasiado largo");
+      return;
+    }
+    avanzar();
+    return;
+  }
+
+  char cmd[INTERPRETE_LINEA_MAX];
+  for (const char* p = linea; *p;) {
+    const char* fin = strchr(p, ';');
+    size_t len = fin ? (size_t)(fin - p) : strlen(p);
+    uint16_t veces;
+    if (separarToken(p, len, cmd, veces)) {
+      for (uint16_t k = 0; k < veces; k++) {
+        bool quedaAlgo = k + 1 < veces || fin;
+        if (ejecutar(cmd) == CMD_EN_CURSO && quedaAlgo) {
+          out_.println("⏳ Hay un guion en curso: el resto de la línea se descarta");
+          return;
+        }
+      }
+    }
+    if (!fin) break;
+    p = fin + 1;
+  }
+}
+
+void Interprete::avanzar() {
+  if (ocupado_ && ocupado_()) return;
+  if (repeticiones_ == 0 && !siguiente()) return;
+  repeticiones_--;
+  ejecutar(actual_);
+}
+
+void Interprete::cancelarGuion() {
+  guionLen_ = 0;
+  repeticiones_ = 0;
+}
+
+bool Interprete::cargarGuion(Stream& in) {
+  char linea[INTERPRETE_LINEA_MAX];
+  while (in.available()) {
+    size_t n = in.readBytesUntil('\n', linea, sizeof(linea) - 1);
+    if (n == sizeof(linea) - 1) {
+      while (in.available() && in.read() != '\n') {
+      }
+    }
+    while (n > 0 && (linea[n - 1] == '\r' || esEspacio(linea[n - 1]))) n--;
+    size_t ini = 0;
+    while (ini < n && esEspacio(linea[ini])) ini++;
+    if (ini == n || linea[ini] == '#') continue;
+    if (!encolar(linea + ini, n - ini)) return false;
+  }
+  return true;
+}
+
+// Caracteres visibles de un texto UTF-8 (sin contar bytes de continuación)
+static size_t anchoTexto(const char* s) {
+  size_t n = 0;
+  for (; *s; s++) {
+    if (((uint8_t)*s & 0xC0) != 0x80) n++;
+  }
+  return n;
+}
+
+static void filaMenu(Print& out, const char* nombre, const char* ayuda) {
+  out.print("│ ");
+  out.print(nombre);
+  out.print(" - ");
+  out.print(ayuda);
+  size_t usado = 1 + anchoTexto(nombre) + 3 + anchoTexto(ayuda);
+  for (size_t i = usado; i < INTERPRETE_MENU_ANCHO; i++) out.print(' ');
+  out.println("│");
+}
+
+static void bordeMenu(Print& out, const char* izquierda, const char* derecha) {
+  out.print(izquierda);
+  for (int i = 0; i < INTERPRETE_MENU_ANCHO; i++) out.print("─");
+  out.println(derecha);
+}
+
+void Interprete::imprimirMenu(Print& out) const {
+  bordeMenu(out, "┌", "┐");
+  for (size_t i = 0; i < n_; i++) {
+    if (tabla_[i].ayuda) filaMenu(out, tabla_[i].nombre, tabla_[i].ayuda);
+  }
+  bordeMenu(out, "├", "┤");
+  filaMenu(out, "1;2;5", "varios comandos en orden");
+  filaMenu(out, "8*20", "repetir un comando N veces");
+  bordeMenu(out, "└", "┘");
+}
@@ -0,0 +1,96 @@
+// Intérprete de comandos
+// Los comandos viven en una tabla estática (nombre, alias, acción, ayuda) que
+// sirve a la vez para despacharlos y para dibujar el menú. Una línea admite
+// guiones: "1;2;5" ejecuta en orden y "8*20" repite. Si un comando lanza un
+// diagnóstico, el resto del guion espera a que termine; loop() lo retoma con
+// avanzar(), un comando por vuelta. LectorLineas junta la entrada sin bloquear
+// en un buffer fijo (ni timeout de readStringUntil ni un String por línea).
+#pragma once
+#include <Arduino.h>
+
+#ifndef INTERPRETE_LINEA_MAX
+#define INTERPRETE_LINEA_MAX 128
+#endif
+// Comandos pendientes de un guion (texto separado por ';')
+#ifndef INTERPRETE_GUION_MAX
+#define INTERPRETE_GUION_MAX 512
+#endif
+#define INTERPRETE_REPETICIONES_MAX 9999
+// Ancho interior del recuadro del menú, en caracteres
+#define INTERPRETE_MENU_ANCHO 43
+
+enum ResultadoComando : uint8_t {
+  CMD_HECHO,       // terminó
+  CMD_EN_CURSO,    // lanzó un diagnóstico: el guion espera a que acabe
+  CMD_SILENCIOSO,  // terminó y no quiere el cierre habitual (p. ej. help, que ya deja el prompt)
+  CMD_DESCONOCIDO
+};
+
+// arg es lo que sigue al nombre tras un espacio ("" si nada)
+typedef ResultadoComando (*AccionComando)(const char* arg);
+
+struct DefComando {
+  const char* nombre;  // sin distinguir mayúsculas, como el alias
+  const char* alias;   // nullptr si no tiene
+  AccionComando accion;
+  const char* ayuda;   // texto del menú; nullptr = no sale en el menú
+};
+
+class LectorLineas {
+public:
+  // Consume lo disponible sin esperar; true cuando linea() tiene una línea completa
+  // (sin '\r'/'\n' ni espacios en los extremos; las vacías se saltan)
+  bool leer(Stream& in);
+  const char* linea() const { return buf_; }
+  // La última línea no cabía y se cortó a INTERPRETE_LINEA_MAX - 1
+  bool cortada() const { return cortada_; }
+
+private:
+  char buf_[INTERPRETE_LINEA_MAX];
+  size_t n_ = 0;
+  bool lista_ = false;
+  bool cortada_ = false;
+  bool desborde_ = false;
+};
+
+class Interprete {
+public:
+  // ocupado(): hay un diagnóstico en curso. despues(): tras cada comando
+  // ejecutado, con su nombre y resultado
+  Interprete(const DefComando* tabla, size_t n, Print& out, bool (*ocupado)(),
+             void (*despues)(const char* cmd, ResultadoComando r))
+      : tabla_(tabla), n_(n), out_(out), ocupado_(ocupado), despues_(despues) {}
+
+  // Sin guion a medias ni diagnóstico en curso, la línea pasa a ser el guion y
+  // arranca ya. Si no, se ejecuta directamente (para 'stop', 'T'...) y lo que
+  // tuviera que esperar a un diagnóstico se descarta
+  void ejecutarLinea(const char* linea);
+  // Añade al guion las líneas de un archivo ('#' comenta); false si no cupo entero
+  bool cargarGuion(Stream& in);
+  // Desde loop(): un comando del guion si no hay nada en curso
+  void avanzar();
+  void cancelarGuion();
+  bool guionPendiente() const { return repeticiones_ > 0 || guionLen_ > 0; }
+  size_t bytesPendientes() const { return guionLen_; }
+
+  void imprimirMenu(Print& out) const;
+  const DefComando* buscar(const char* nombre, size_t len) const;
+
+private:
+  bool encolar(const char* texto, size_t len);
+  // Saca el siguiente comando del guion a actual_ / repeticiones_
+  bool siguiente();
+  // Un comando sin ';' ni '*': "nombre" o "nombre argumento"
+  ResultadoComando ejecutar(const char* cmd);
+
+  const DefComando* tabla_;
+  size_t n_;
+  Print& out_;
+  bool (*ocupado_)();
+  void (*despues_)(const char* cmd, ResultadoComando r);
+
+  char guion_[INTERPRETE_GUION_MAX];
+  size_t guionLen_ = 0;
+  char actual_[INTERPRETE_LINEA_MAX];
+  uint16_t repeticiones_ = 0;
+};
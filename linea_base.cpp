@@ -0,0 +1,358 @@
+#include "linea_base.h"
+#include <SPIFFS.h>
+#include <math.h>
+#include <time.h>
+#include "crc32.h"
+#include "formato.h"
+
+#define BASE_MAGIA 0x45534142u  // "BASE"
+#define BASE_VERSION 1
+
+struct CabeceraBase {
+  uint32_t magia;
+  uint8_t version;
+  uint8_t n;
+  uint16_t tamMetrica;
+  uint32_t fecha;
+  uint32_t uptime;
+  uint32_t crc;  // de la cabecera (con crc = 0) y las métricas
+};
+
+// Métricas de un solo valor: la clave de la bitácora da el id y cómo se juzga
+struct DefMetrica {
+  uint8_t clave;
+  const char* id;
+  uint8_t sentido;
+  bool relativa;
+  float tolerancia;
+};
+
+static const DefMetrica fijas[] = {
+  {K_HEAP_LIBRE, "heap.libre", PEOR_SI_BAJA, true, LINEA_BASE_TOL_HEAP},
+  {K_HEAP_MAYOR_BLOQUE, "heap.mayor_bloque", PEOR_SI_BAJA, true, LINEA_BASE_TOL_BLOQUE},
+  {K_HEAP_MAX_ASIGNABLE, "heap.max_asignable", PEOR_SI_BAJA, true, LINEA_BASE_TOL_BLOQUE},
+  {K_HEAP_FRAGMENTACION, "heap.fragmentacion", PEOR_SI_SUBE, false, LINEA_BASE_TOL_FRAG},
+  {K_TEMPERATURA, "temperatura", PEOR_SI_SUBE, false, LINEA_BASE_TOL_TEMP},
+  {K_GPIO_FUNCIONALES, "gpio.funcionales", PEOR_SI_FALTAN, false, 0},
+};
+
+static uint32_t leerU32LE(const uint8_t* p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static const char* unidad(const MetricaBase& m) {
+  if (!strncmp(m.id, "bench.", 6)) return "ciclos/op";
+  if (!strncmp(m.id, "toggle.", 7)) return "Hz";
+  if (!strcmp(m.id, "heap.fragmentacion")) return "%";
+  if (!strncmp(m.id, "heap.", 5)) return "B";
+  if (!strcmp(m.id, "temperatura")) return "°C";
+  return "";
+}
+
+static int buscarId(const MetricaBase* m, size_t n, const char* id) {
+  for (size_t i = 0; i < n; i++) {
+    if (!strcmp(m[i].id, id)) return (int)i;
+  }
+  return -1;
+}
+
+// Id con prefijo + nombre del registro (el nombre no acaba en '\0')
+static void componerId(char* id, const char* prefijo, const uint8_t* nombre, size_t len) {
+  size_t p = strlen(prefijo);
+  if (len > sizeof(MetricaBase::id) - 1 - p) len = sizeof(MetricaBase::id) - 1 - p;
+  memcpy(id, prefijo, p);
+  memcpy(id + p, nombre, len);
+  id[p + len] = '\0';
+}
+
+size_t LineaBase::extraer(const BitacoraResultados& b, MetricaBase* out, size_t max) {
+  size_t n = 0;
+  BitacoraResultados::Registro r;
+  for (uint32_t pos = b.primero(); b.leer(pos, r);) {
+    MetricaBase m = {};
+    if (r.clave == K_BENCH_KERNEL && r.len >= BENCH_KERNEL_CABECERA) {
+      uint32_t ops = leerU32LE(r.datos + 20);
+      if (!ops) continue;
+      componerId(m.id, "bench.", r.datos + BENCH_KERNEL_CABECERA, r.len - BENCH_KERNEL_CABECERA);
+      m.valor = (double)leerU32LE(r.datos + 4) / ops;
+      m.sentido = PEOR_SI_SUBE;
+      m.relativa = 1;
+      m.tolerancia = r.datos[24] & 1 ? LINEA_BASE_TOL_BENCH : LINEA_BASE_TOL_BENCH_IRQ;
+    } else if (r.clave == K_BENCH_TOGGLE && r.len >= BENCH_TOGGLE_CABECERA) {
+      componerId(m.id, "toggle.", r.datos + BENCH_TOGGLE_CABECERA, r.len - BENCH_TOGGLE_CABECERA);
+      m.valor = leerU32LE(r.datos);
+      m.sentido = PEOR_SI_BAJA;
+      m.relativa = 1;
+      m.tolerancia = LINEA_BASE_TOL_TOGGLE;
+    } else {
+      const DefMetrica* d = nullptr;
+      for (const DefMetrica& f : fijas) {
+        if (f.clave == r.clave) d = &f;
+      }
+      if (!d || (r.tipo != TV_U32 && r.tipo != TV_F32)) continue;
+      strlcpy(m.id, d->id, sizeof(m.id));
+      m.valor = r.tipo == TV_F32 ? (double)r.f32() : (double)r.u32();
+      m.sentido = d->sentido;
+      m.relativa = d->relativa;
+      m.tolerancia = d->tolerancia;
+    }
+    // Se queda el valor más reciente de cada métrica
+    int i = buscarId(out, n, m.id);
+    if (i >= 0) {
+      out[i].valor = m.valor;
+    } else if (n < max) {
+      out[n++] = m;
+    }
+  }
+  return n;
+}
+
+bool LineaBase::iniciar() {
+  n_ = 0;
+  comparada_ = false;
+  File f = SPIFFS.open(LINEA_BASE_ARCHIVO, "r");
+  if (!f) return false;
+  CabeceraBase c;
+  bool ok = f.read((uint8_t*)&c, sizeof(c)) == sizeof(c) && c.magia == BASE_MAGIA && c.version == BASE_VERSION &&
+            c.tamMetrica == sizeof(MetricaBase) && c.n <= LINEA_BASE_MAX &&
+            f.read((uint8_t*)base_, c.n * sizeof(MetricaBase)) == c.n * sizeof(MetricaBase);
+  f.close();
+  if (!ok) return false;
+  uint32_t crc = c.crc;
+  c.crc = 0;
+  if (crc32(base_, c.n * sizeof(MetricaBase), crc32(&c, sizeof(c))) != crc) return false;
+  n_ = c.n;
+  fecha_ = c.fecha;
+  uptime_ = c.uptime;
+  return true;
+}
+
+bool LineaBase::guardarArchivo() {
+  CabeceraBase c = {BASE_MAGIA, BASE_VERSION, (uint8_t)n_, sizeof(MetricaBase), fecha_, uptime_, 0};
+  c.crc = crc32(base_, n_ * sizeof(MetricaBase), crc32(&c, sizeof(c)));
+  File f = SPIFFS.open(LINEA_BASE_ARCHIVO, "w");
+  if (!f) return false;
+  bool ok = f.write((const uint8_t*)&c, sizeof(c)) == sizeof(c) &&
+            f.write((const uint8_t*)base_, n_ * sizeof(MetricaBase)) == n_ * sizeof(MetricaBase);
+  f.close();
+  return ok;
+}
+
+size_t LineaBase::guardar(const BitacoraResultados& b) {
+  // Sin métricas, extraer() no toca base_: se queda la base anterior
+  size_t n = extraer(b, base_, LINEA_BASE_MAX);
+  if (n == 0) return 0;
+  n_ = n;
+  fecha_ = (uint32_t)time(nullptr);
+  uptime_ = millis() / 1000;
+  comparada_ = false;
+  return guardarArchivo() ? n_ : 0;
+}
+
+void LineaBase::borrar() {
+  n_ = 0;
+  comparada_ = false;
+  SPIFFS.remove(LINEA_BASE_ARCHIVO);
+  SPIFFS.remove(LINEA_BASE_VEREDICTO);
+}
+
+size_t LineaBase::tolerancia(const char* prefijo, float valor) {
+  size_t len = strlen(prefijo), cambiadas = 0;
+  for (size_t i = 0; i < n_; i++) {
+    if (strncmp(base_[i].id, prefijo, len) != 0 || base_[i].sentido == PEOR_SI_FALTAN) continue;
+    base_[i].tolerancia = valor;
+    cambiadas++;
+  }
+  if (cambiadas) guardarArchivo();
+  return cambiadas;
+}
+
+double LineaBase::cambio(size_t i) const {
+  const MetricaBase& m = base_[i];
+  if (m.sentido == PEOR_SI_FALTAN) {
+    return __builtin_popcount((uint32_t)m.valor & ~(uint32_t)actual_[i]);
+  }
+  double d = actual_[i] - m.valor;
+  if (m.relativa && m.valor != 0) return d * 100.0 / fabs(m.valor);
+  return d;
+}
+
+bool LineaBase::comparar(const BitacoraResultados& b) {
+  // Fuera de la pila: son casi 2 KB
+  static MetricaBase ahora[LINEA_BASE_MAX];
+  if (n_ == 0) return false;
+  size_t n = extraer(b, ahora, LINEA_BASE_MAX);
+  size_t encontradas = 0;
+  for (size_t i = 0; i < n_; i++) {
+    int j = buscarId(ahora, n, base_[i].id);
+    if (j < 0) {
+      estado_[i] = EM_SIN_DATO;
+      actual_[i] = 0;
+      continue;
+    }
+    encontradas++;
+    actual_[i] = ahora[j].valor;
+    const MetricaBase& m = base_[i];
+    if (m.sentido == PEOR_SI_FALTAN) {
+      uint32_t antes = (uint32_t)m.valor, despues = (uint32_t)actual_[i];
+      estado_[i] = antes & ~despues ? EM_REGRESION : despues & ~antes ? EM_MEJORA : EM_OK;
+      continue;
+    }
+    // Positivo cuando va a peor
+    double peor = m.sentido == PEOR_SI_SUBE ? cambio(i) : -cambio(i);
+    estado_[i] = peor > m.tolerancia ? EM_REGRESION : peor < -m.tolerancia ? EM_MEJORA : EM_OK;
+  }
+  nuevas_ = 0;
+  for (size_t j = 0; j < n; j++) {
+    if (buscarId(base_, n_, ahora[j].id) < 0) nuevas_++;
+  }
+  comparada_ = encontradas > 0;
+  if (!comparada_) return false;
+  comparadaUptime_ = millis() / 1000;
+  comparaciones_++;
+  if (regresiones()) conRegresion_++;
+  return true;
+}
+
+size_t LineaBase::cuenta(EstadoMetrica e) const {
+  if (!comparada_) return 0;
+  size_t c = 0;
+  for (size_t i = 0; i < n_; i++) {
+    if (estado_[i] == e) c++;
+  }
+  return c;
+}
+
+const char* LineaBase::nombreEstado(EstadoMetrica e) {
+  switch (e) {
+    case EM_REGRESION: return "regresion";
+    case EM_MEJORA: return "mejora";
+    case EM_SIN_DATO: return "sin_dato";
+    default: return "ok";
+  }
+}
+
+void LineaBase::imprimirValor(Print& out, const MetricaBase& m, double v) const {
+  if (m.sentido == PEOR_SI_FALTAN) {
+    out.print((unsigned long)(uint32_t)v);
+  } else if (!strncmp(m.id, "bench.", 6)) {
+    // Los kernels de memoria bajan de 0.01 ciclos/op: cifras significativas
+    imprimirf(out, "%.4g", v);
+  } else if (!strcmp(m.id, "temperatura")) {
+    out.print(v, 1);
+  } else {
+    out.print((long)lround(v));
+  }
+}
+
+void LineaBase::imprimirTexto(Print& out) const {
+  if (!comparada_) {
+    out.println(n_ ? "📏 Sin métricas que comparar con la línea base" : "📏 No hay línea base guardada");
+    return;
+  }
+  imprimirlnf(out, "📏 COMPARACIÓN CON LA LÍNEA BASE (%u métricas)", (unsigned)n_);
+  for (size_t i = 0; i < n_; i++) {
+    if (estado_[i] != EM_REGRESION && estado_[i] != EM_MEJORA) continue;
+    const MetricaBase& m = base_[i];
+    out.print(estado_[i] == EM_REGRESION ? "  ❌ " : "  ✅ ");
+    out.print(m.id);
+    if (m.sentido == PEOR_SI_FALTAN) {
+      uint32_t antes = (uint32_t)m.valor, despues = (uint32_t)actual_[i];
+      out.print(antes & ~despues ? ": perdidos GPIO " : ": nuevos GPIO ");
+      imprimirMascara(out, antes & ~despues ? antes & ~despues : despues & ~antes, " ");
+      out.println();
+      continue;
+    }
+    out.print(": ");
+    imprimirValor(out, m, m.valor);
+    out.print(" → ");
+    imprimirValor(out, m, actual_[i]);
+    imprimirf(out, " %s (%+.1f%s, tolerancia %g%s)", unidad(m), cambio(i), m.relativa ? "%" : "", m.tolerancia,
+              m.relativa ? "%" : "");
+    out.println();
+  }
+  size_t r = regresiones(), mej = mejoras(), sin = sinDato();
+  if (r) {
+    imprimirf(out, "❌ %u regresiones", (unsigned)r);
+  } else {
+    imprimirf(out, "✅ Sin regresiones: %u métricas dentro de tolerancia", (unsigned)(n_ - sin - mej));
+  }
+  if (mej) imprimirf(out, ", %u mejoras", (unsigned)mej);
+  if (sin) imprimirf(out, " (%u sin dato en esta ejecución)", (unsigned)sin);
+  out.println();
+}
+
+void LineaBase::imprimirJSON(Print& out) const {
+  out.print("{\"estado\":\"");
+  out.print(!n_ ? "sin_base" : !comparada_ ? "sin_comparar" : regresiones() ? "regresion" : "ok");
+  out.print("\",\"base\":{\"fecha\":");
+  out.print((unsigned long)fecha_);
+  out.print(",\"uptime\":");
+  out.print((unsigned long)uptime_);
+  out.print(",\"metricas\":");
+  out.print((unsigned)n_);
+  out.print('}');
+  if (comparada_) {
+    imprimirf(out, ",\"uptime\":%lu,\"regresiones\":%u,\"mejoras\":%u,\"sin_dato\":%u,\"nuevas\":%u",
+              (unsigned long)comparadaUptime_, (unsigned)regresiones(), (unsigned)mejoras(), (unsigned)sinDato(),
+              (unsigned)nuevas_);
+  }
+  out.print(",\"metricas\":[");
+  for (size_t i = 0; i < n_; i++) {
+    const MetricaBase& m = base_[i];
+    if (i) out.print(',');
+    out.print("{\"id\":");
+    imprimirTextoJSON(out, (const uint8_t*)m.id, strlen(m.id));
+    imprimirf(out, ",\"unidad\":\"%s\",\"base\":", unidad(m));
+    imprimirValor(out, m, m.valor);
+    out.print(",\"actual\":");
+    bool hay = comparada_ && estado_[i] != EM_SIN_DATO;
+    if (hay) {
+      imprimirValor(out, m, actual_[i]);
+    } else {
+      out.print("null");
+    }
+    out.print(",\"cambio\":");
+    if (hay) {
+      out.print(cambio(i), m.sentido == PEOR_SI_FALTAN ? 0 : 2);
+    } else {
+      out.print("null");
+    }
+    imprimirf(out, ",\"tolerancia\":%g,\"relativa\":%s,\"sentido\":\"%s\",\"estado\":\"%s\"}", m.tolerancia,
+              m.relativa ? "true" : "false",
+              m.sentido == PEOR_SI_SUBE ? "sube" : m.sentido == PEOR_SI_BAJA ? "baja" : "faltan",
+              comparada_ ? nombreEstado((EstadoMetrica)estado_[i]) : "sin_comparar");
+  }
+  out.print("]}");
+}
+
+bool LineaBase::escribirVeredicto() const {
+  File f = SPIFFS.open(LINEA_BASE_VEREDICTO, "w");
+  if (!f) return false;
+  imprimirJSON(f);
+  f.close();
+  return true;
+}
+
+void LineaBase::imprimirBase(Print& out) const {
+  if (!n_) {
+    out.println("📏 No hay línea base guardada (base guardar)");
+    return;
+  }
+  imprimirlnf(out, "📏 LÍNEA BASE: %u métricas, guardada con %lu s de uptime", (unsigned)n_,
+              (unsigned long)uptime_);
+  for (size_t i = 0; i < n_; i++) {
+    const MetricaBase& m = base_[i];
+    out.print("  ");
+    out.print(m.id);
+    for (size_t k = strlen(m.id); k < 26; k++) out.print(' ');
+    if (m.sentido == PEOR_SI_FALTAN) {
+      imprimirMascara(out, (uint32_t)m.valor, " ");
+      out.println("  (sin perder ninguno)");
+      continue;
+    }
+    imprimirValor(out, m, m.valor);
+    imprimirlnf(out, " %s  (tolerancia %g%s, peor si %s)", unidad(m), m.tolerancia, m.relativa ? "%" : "",
+                m.sentido == PEOR_SI_SUBE ? "sube" : "baja");
+  }
+}
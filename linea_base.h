@@ -0,0 +1,133 @@
+// Línea base de resultados y comparación entre ejecuciones
+// Cada benchmark o diagnóstico completo se quedaba solo: una placa degradada o
+// un firmware más lento se veían comparando exportaciones TXT a mano.
+//
+// guardar() toma de la bitácora las métricas numéricas (el último valor de cada
+// una) y las escribe en LINEA_BASE_ARCHIVO:
+//   bench.<kernel>    ciclos/op de la mediana         peor si sube (%)
+//   toggle.<método>   frecuencia de conmutación (Hz)  peor si baja (%)
+//   heap.*            libre, mayor bloque, mayor asignable: peor si baja (%);
+//                     fragmentación: peor si sube (puntos)
+//   temperatura       °C                              peor si sube (grados)
+//   gpio.funcionales  máscara de pines                peor si falta alguno
+// Cada métrica lleva su tolerancia (las de LINEA_BASE_TOL_* al guardarla; se
+// pueden cambiar una a una con tolerancia()). comparar() enfrenta la bitácora
+// actual con la base y marca cada métrica como ok, regresión, mejora o sin dato.
+//
+//   Archivo: [cabecera con CRC-32][MetricaBase x n]
+#pragma once
+#include <Arduino.h>
+#include "resultados.h"
+
+#define LINEA_BASE_ARCHIVO "/linea_base.bin"
+// Veredicto de la última comparación en JSON (lo sirve /veredicto)
+#define LINEA_BASE_VEREDICTO "/veredicto.json"
+
+// 19 kernels, 4 métodos de conmutación, 4 del heap, temperatura y GPIO, con margen
+#ifndef LINEA_BASE_MAX
+#define LINEA_BASE_MAX 40
+#endif
+
+// Tolerancias por defecto: % del valor base, salvo fragmentación y temperatura
+// (unidades). Los kernels que corren con interrupciones oscilan más
+#ifndef LINEA_BASE_TOL_BENCH
+#define LINEA_BASE_TOL_BENCH 10
+#endif
+#ifndef LINEA_BASE_TOL_BENCH_IRQ
+#define LINEA_BASE_TOL_BENCH_IRQ 25
+#endif
+#ifndef LINEA_BASE_TOL_TOGGLE
+#define LINEA_BASE_TOL_TOGGLE 10
+#endif
+#ifndef LINEA_BASE_TOL_HEAP
+#define LINEA_BASE_TOL_HEAP 10
+#endif
+#ifndef LINEA_BASE_TOL_BLOQUE
+#define LINEA_BASE_TOL_BLOQUE 15
+#endif
+#ifndef LINEA_BASE_TOL_FRAG
+#define LINEA_BASE_TOL_FRAG 10
+#endif
+#ifndef LINEA_BASE_TOL_TEMP
+#define LINEA_BASE_TOL_TEMP 8
+#endif
+
+enum SentidoMetrica : uint8_t {
+  PEOR_SI_SUBE,
+  PEOR_SI_BAJA,
+  PEOR_SI_FALTAN,  // máscara: regresión si se pierde algún bit de la base
+};
+
+enum EstadoMetrica : uint8_t { EM_OK, EM_REGRESION, EM_MEJORA, EM_SIN_DATO };
+
+struct MetricaBase {
+  char id[32];
+  double valor;      // double: una máscara de 32 bits cabe sin redondeo
+  float tolerancia;  // % si relativa, unidades si no; en máscaras no se usa
+  uint8_t sentido;   // SentidoMetrica
+  uint8_t relativa;
+  uint16_t reservado;
+};
+static_assert(sizeof(MetricaBase) == 48, "MetricaBase cambia el formato de LINEA_BASE_ARCHIVO");
+
+class LineaBase {
+public:
+  // Métricas de b, la última de cada una, con las tolerancias por defecto
+  static size_t extraer(const BitacoraResultados& b, MetricaBase* out, size_t max);
+
+  // Carga la base de SPIFFS; false si no hay o está dañada. Llamar tras SPIFFS.begin()
+  bool iniciar();
+  // Toma las métricas de b como nueva base; cantidad guardada (0 si no había ninguna)
+  size_t guardar(const BitacoraResultados& b);
+  void borrar();
+  // Cambia la tolerancia de las métricas cuyo id empieza por prefijo; cuántas cambiaron
+  size_t tolerancia(const char* prefijo, float valor);
+
+  // Compara b con la base; false si no hay base o b no tiene ninguna de sus métricas
+  bool comparar(const BitacoraResultados& b);
+  // Escribe el veredicto de la última comparación en LINEA_BASE_VEREDICTO
+  bool escribirVeredicto() const;
+
+  // Informe de la última comparación: regresiones y mejoras, y el resumen
+  void imprimirTexto(Print& out) const;
+  // Veredicto en JSON: estado global y cada métrica con base, actual y cambio
+  void imprimirJSON(Print& out) const;
+  // La base guardada, una métrica por línea
+  void imprimirBase(Print& out) const;
+
+  bool existe() const { return n_ > 0; }
+  size_t cantidad() const { return n_; }
+  const MetricaBase& metrica(size_t i) const { return base_[i]; }
+  uint32_t fecha() const { return fecha_; }
+  // De la última comparación
+  bool comparada() const { return comparada_; }
+  size_t regresiones() const { return cuenta(EM_REGRESION); }
+  size_t mejoras() const { return cuenta(EM_MEJORA); }
+  size_t sinDato() const { return cuenta(EM_SIN_DATO); }
+  EstadoMetrica estado(size_t i) const { return (EstadoMetrica)estado_[i]; }
+  double actual(size_t i) const { return actual_[i]; }
+  // Acumulados
+  uint32_t comparaciones() const { return comparaciones_; }
+  uint32_t conRegresion() const { return conRegresion_; }
+
+  static const char* nombreEstado(EstadoMetrica e);
+
+private:
+  bool guardarArchivo();
+  size_t cuenta(EstadoMetrica e) const;
+  // Cambio respecto a la base en las unidades de la tolerancia (pines perdidos en máscaras)
+  double cambio(size_t i) const;
+  void imprimirValor(Print& out, const MetricaBase& m, double v) const;
+
+  MetricaBase base_[LINEA_BASE_MAX];
+  size_t n_ = 0;
+  uint32_t fecha_ = 0;   // time() al guardar
+  uint32_t uptime_ = 0;  // s desde el arranque al guardar
+  double actual_[LINEA_BASE_MAX];
+  uint8_t estado_[LINEA_BASE_MAX];
+  bool comparada_ = false;
+  uint32_t comparadaUptime_ = 0;
+  size_t nuevas_ = 0;  // métricas de la bitácora que la base no tiene
+  uint32_t comparaciones_ = 0;
+  uint32_t conRegresion_ = 0;
+};
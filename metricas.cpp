@@ -0,0 +1,112 @@
+#include "metricas.h"
+#include "formato.h"
+
+static const uint32_t CUBETAS_US[METRICAS_N_CUBETAS] = METRICAS_CUBETAS;
+
+int MetricasHTTP::registrar(const char* uri, const char* metodo) {
+  // Volver a iniciar el servidor no duplica las rutas
+  for (size_t i = 0; i < n_; i++) {
+    if (!strcmp(rutas_[i].uri, uri) && !strcmp(rutas_[i].metodo, metodo)) return (int)i;
+  }
+  if (n_ == METRICAS_RUTAS_MAX) return -1;
+  EstadisticaRuta& r = rutas_[n_];
+  memset(&r, 0, sizeof(r));
+  r.uri = uri;
+  r.metodo = metodo;
+  return (int)n_++;
+}
+
+void MetricasHTTP::anotarParcial(int ruta, uint32_t us) {
+  if (ruta >= 0) rutas_[ruta].enCursoUs += us;
+}
+
+void MetricasHTTP::anotar(int ruta, uint32_t us) {
+  if (ruta < 0) return;
+  EstadisticaRuta& r = rutas_[ruta];
+  us += r.enCursoUs;
+  r.enCursoUs = 0;
+  r.peticiones++;
+  r.sumaUs += us;
+  if (us > r.maxUs) r.maxUs = us;
+  for (uint8_t i = 0; i < METRICAS_N_CUBETAS; i++) {
+    if (us <= CUBETAS_US[i]) {
+      r.cubetas[i]++;
+      break;
+    }
+  }
+}
+
+static void etiquetasRuta(Print& out, const EstadisticaRuta& r) {
+  out.print("{ruta=");
+  metricaEtiqueta(out, r.uri);
+  out.print(",metodo=\"");
+  out.print(r.metodo);
+  out.print('"');
+}
+
+void MetricasHTTP::imprimir(Print& out) const {
+  metricaCabecera(out, "esp32_http_peticiones_total", "counter", "Peticiones atendidas por ruta");
+  for (size_t i = 0; i < n_; i++) {
+    out.print("esp32_http_peticiones_total");
+    etiquetasRuta(out, rutas_[i]);
+    imprimirf(out, "} %lu\n", (unsigned long)rutas_[i].peticiones);
+  }
+
+  metricaCabecera(out, "esp32_http_segundos", "histogram", "Tiempo de respuesta por ruta, subida incluida");
+  for (size_t i = 0; i < n_; i++) {
+    const EstadisticaRuta& r = rutas_[i];
+    uint32_t acumulado = 0;
+    for (uint8_t c = 0; c < METRICAS_N_CUBETAS; c++) {
+      acumulado += r.cubetas[c];
+      out.print("esp32_http_segundos_bucket");
+      etiquetasRuta(out, r);
+      imprimirf(out, ",le=\"%g\"} %lu\n", CUBETAS_US[c] / 1e6, (unsigned long)acumulado);
+    }
+    out.print("esp32_http_segundos_bucket");
+    etiquetasRuta(out, r);
+    imprimirf(out, ",le=\"+Inf\"} %lu\n", (unsigned long)r.peticiones);
+    out.print("esp32_http_segundos_sum");
+    etiquetasRuta(out, r);
+    imprimirf(out, "} %.6f\n", r.sumaUs / 1e6);
+    out.print("esp32_http_segundos_count");
+    etiquetasRuta(out, r);
+    imprimirf(out, "} %lu\n", (unsigned long)r.peticiones);
+  }
+
+  metricaCabecera(out, "esp32_http_max_segundos", "gauge", "Respuesta más lenta por ruta desde el arranque");
+  for (size_t i = 0; i < n_; i++) {
+    out.print("esp32_http_max_segundos");
+    etiquetasRuta(out, rutas_[i]);
+    imprimirf(out, "} %.6f\n", rutas_[i].maxUs / 1e6);
+  }
+}
+
+void metricaCabecera(Print& out, const char* nombre, const char* tipo, const char* ayuda) {
+  imprimirf(out, "# HELP %s %s\n# TYPE %s %s\n", nombre, ayuda, nombre, tipo);
+}
+
+void metricaValor(Print& out, const char* nombre, uint32_t v) {
+  imprimirf(out, "%s %lu\n", nombre, (unsigned long)v);
+}
+
+void metricaValor(Print& out, const char* nombre, float v, int decimales) {
+  imprimirf(out, "%s %.*f\n", nombre, decimales, (double)v);
+}
+
+void metrica(Print& out, const char* nombre, const char* tipo, const char* ayuda, uint32_t v) {
+  metricaCabecera(out, nombre, tipo, ayuda);
+  metricaValor(out, nombre, v);
+}
+
+void metricaEtiqueta(Print& out, const char* valor) {
+  out.print('"');
+  for (const char* p = valor; *p; p++) {
+    if (*p == '\\' || *p == '"') out.print('\\');
+    if (*p == '\n') {
+      out.print("\\n");
+      continue;
+    }
+    out.print(*p);
+  }
+  out.print('"');
+}
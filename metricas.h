@@ -0,0 +1,54 @@
+// Métricas en formato de texto de Prometheus (/metrics)
+// MetricasHTTP lleva, por ruta registrada, peticiones, tiempo total y máximo y un
+// histograma de latencias con cubetas fijas; registrarRuta() la alimenta. Las
+// funciones metrica*() escriben una línea "nombre{etiquetas} valor\n" (el
+// formato exige '\n', no el "\r\n" de println) sin pasar por String.
+// El handler escribe a través del buffer fijo de SalidaHTTP, que se vacía en
+// trozos y se reutiliza: ni heap por raspado ni un tamaño máximo de respuesta.
+#pragma once
+#include <Arduino.h>
+
+#ifndef METRICAS_RUTAS_MAX
+#define METRICAS_RUTAS_MAX 16
+#endif
+// Límites superiores de las cubetas del histograma, en µs (+Inf va aparte)
+#define METRICAS_CUBETAS {1000, 10000, 100000, 1000000}
+#define METRICAS_N_CUBETAS 4
+
+struct EstadisticaRuta {
+  const char* uri;
+  const char* metodo;
+  uint32_t peticiones;
+  uint64_t sumaUs;
+  uint32_t maxUs;
+  uint32_t enCursoUs;  // lo que ya llevan los callbacks de subida de la petición en curso
+  uint32_t cubetas[METRICAS_N_CUBETAS];  // no acumuladas; se suman al imprimir
+};
+
+class MetricasHTTP {
+public:
+  // Índice de la ruta (o -1 si la tabla está llena)
+  int registrar(const char* uri, const char* metodo);
+  // Tiempo de un callback de subida: se suma a la petición en curso de la ruta
+  void anotarParcial(int ruta, uint32_t us);
+  // Fin de una petición: handler final más lo acumulado por la subida
+  void anotar(int ruta, uint32_t us);
+
+  size_t rutas() const { return n_; }
+  const EstadisticaRuta& ruta(size_t i) const { return rutas_[i]; }
+  void imprimir(Print& out) const;
+
+private:
+  EstadisticaRuta rutas_[METRICAS_RUTAS_MAX];
+  size_t n_ = 0;
+};
+
+// Cabecera # HELP / # TYPE de una familia
+void metricaCabecera(Print& out, const char* nombre, const char* tipo, const char* ayuda);
+// Una muestra sin etiquetas
+void metricaValor(Print& out, const char* nombre, uint32_t v);
+void metricaValor(Print& out, const char* nombre, float v, int decimales);
+// Cabecera y muestra, para las familias de un solo valor
+void metrica(Print& out, const char* nombre, const char* tipo, const char* ayuda, uint32_t v);
+// Valor de etiqueta con los escapes del formato (\\, \" y \n)
+void metricaEtiqueta(Print& out, const char* valor);
@@ -0,0 +1,322 @@
+#include "microbench.h"
+#include <esp_cpu.h>
+#include "crc32.h"
+#include "gpio_rapido.h"
+
+bool MicroBench::registrar(const DefKernel& k) {
+  if (n_ >= MICROBENCH_MAX_KERNELS) return false;
+  kernels_[n_++] = k;
+  return true;
+}
+
+void MicroBench::setMuestras(uint8_t n) {
+  if (n < 1) n = 1;
+  if (n > MICROBENCH_MAX_MUESTRAS) n = MICROBENCH_MAX_MUESTRAS;
+  muestras_ = n;
+}
+
+uint32_t MicroBench::muestra(const DefKernel& k, bool sinIRQ) {
+  UBaseType_t mascara = 0;
+  if (sinIRQ) mascara = portSET_INTERRUPT_MASK_FROM_ISR();
+  uint32_t inicio = esp_cpu_get_cycle_count();
+  uint32_t r = k.fn(k.ctx);
+  uint32_t ciclos = esp_cpu_get_cycle_count() - inicio;
+  if (sinIRQ) portCLEAR_INTERRUPT_MASK_FROM_ISR(mascara);
+  sumidero_ += r;
+  return ciclos;
+}
+
+// Flancos alternos de dos en dos: el nivel es constante en cada llamada y no añade saltos
+template <typename Escribir>
+static void cronometrarFlancos(Escribir escribir, uint32_t* marcas) {
+  marcas[0] = esp_cpu_get_cycle_count();
+  for (size_t i = 1; i <= MICROBENCH_FLANCOS; i += 2) {
+    escribir(true);
+    marcas[i] = esp_cpu_get_cycle_count();
+    escribir(false);
+    marcas[i + 1] = esp_cpu_get_cycle_count();
+  }
+}
+
+const char* nombreMetodoToggle(MetodoToggle m) {
+  switch (m) {
+    case TOGGLE_HAL: return "HAL digitalWrite";
+    case TOGGLE_REGISTRO: return "registro W1TS/W1TC";
+    case TOGGLE_PLANTILLA: return "PinRapido<N>";
+    case TOGGLE_RMW: return "RMW GPIO_OUT";
+    default: return "?";
+  }
+}
+
+void MicroBench::medirToggle(MetodoToggle m, MedidaToggle& r) {
+  static_assert(MICROBENCH_FLANCOS % 2 == 0, "MICROBENCH_FLANCOS debe ser par");
+  const uint8_t pin = MICROBENCH_PIN_GPIO;
+  const uint32_t mascara = 1UL << pin;
+  uint32_t marcas[MICROBENCH_FLANCOS + 1];
+
+  pinMode(pin, OUTPUT);
+  UBaseType_t irq = 0;
+  if (sinIRQ_) irq = portSET_INTERRUPT_MASK_FROM_ISR();
+  switch (m) {
+    case TOGGLE_HAL:
+      cronometrarFlancos([](bool v) { digitalWrite(MICROBENCH_PIN_GPIO, v); }, marcas);
+      break;
+    case TOGGLE_REGISTRO:
+      cronometrarFlancos([mascara](bool v) { v ? gpioAlto(mascara) : gpioBajo(mascara); }, marcas);
+      break;
+    case TOGGLE_PLANTILLA:
+      cronometrarFlancos([](bool v) { PinRapido<MICROBENCH_PIN_GPIO>::escribir(v); }, marcas);
+      break;
+    default:
+      cronometrarFlancos([mascara](bool v) { gpioEscribirRMW(mascara, v ? mascara : 0); }, marcas);
+      break;
+  }
+  if (sinIRQ_) portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+  pinMode(pin, INPUT);
+
+  uint32_t total = marcas[MICROBENCH_FLANCOS] - marcas[0];
+  r.media = (float)total / MICROBENCH_FLANCOS;
+  r.min = UINT32_MAX;
+  r.max = 0;
+  float var = 0;
+  for (size_t i = 1; i <= MICROBENCH_FLANCOS; i++) {
+    uint32_t d = marcas[i] - marcas[i - 1];
+    if (d < r.min) r.min = d;
+    if (d > r.max) r.max = d;
+    var += (d - r.media) * (d - r.media);
+  }
+  r.desviacion = sqrtf(var / (MICROBENCH_FLANCOS - 1));
+}
+
+static uint32_t kernelVacio(void*) { return 0; }
+
+// El mínimo, no la media: cualquier interrupción colada solo puede alargarlo
+void MicroBench::calibrar() {
+  const DefKernel vacio = {"vacio", kernelVacio, 1, nullptr, nullptr, false};
+  uint32_t minimo = UINT32_MAX;
+  for (int i = 0; i < 16; i++) {
+    uint32_t c = muestra(vacio, sinIRQ_);
+    if (c < minimo) minimo = c;
+  }
+  sobrecoste_ = minimo;
+  calibrado_ = true;
+}
+
+bool MicroBench::medir(size_t i, EstadisticaBench& est) {
+  if (i >= n_) return false;
+  if (!calibrado_) calibrar();
+  const DefKernel& k = kernels_[i];
+  if (k.preparar && !k.preparar(k.ctx, true)) return false;
+
+  bool sinIRQ = sinIRQ_ && !k.conIRQ;
+  for (uint8_t c = 0; c < calentamiento_; c++) sumidero_ += k.fn(k.ctx);
+  for (uint8_t m = 0; m < muestras_; m++) {
+    uint32_t ciclos = muestra(k, sinIRQ);
+    tiempos_[m] = ciclos > sobrecoste_ ? ciclos - sobrecoste_ : 0;
+  }
+
+  if (k.preparar) k.preparar(k.ctx, false);
+  est.ops = k.ops;
+  est.sinIRQ = sinIRQ;
+  resumir(tiempos_, muestras_, est);
+  return true;
+}
+
+void MicroBench::resumir(uint32_t* m, size_t n, EstadisticaBench& est) {
+  // Inserción: con n <= MICROBENCH_MAX_MUESTRAS no compensa nada más elaborado
+  for (size_t i = 1; i < n; i++) {
+    uint32_t v = m[i];
+    size_t j = i;
+    for (; j > 0 && m[j - 1] > v; j--) m[j] = m[j - 1];
+    m[j] = v;
+  }
+
+  uint64_t suma = 0;
+  for (size_t i = 0; i < n; i++) suma += m[i];
+  float media = (float)suma / n;
+  float var = 0;
+  for (size_t i = 0; i < n; i++) var += (m[i] - media) * (m[i] - media);
+
+  est.muestras = (uint8_t)n;
+  est.min = m[0];
+  est.max = m[n - 1];
+  est.mediana = n % 2 ? m[n / 2] : (uint32_t)(((uint64_t)m[n / 2 - 1] + m[n / 2]) / 2);
+  est.p95 = m[(95 * n + 99) / 100 - 1];  // rango más cercano
+  est.media = (uint32_t)(media + 0.5f);
+  est.desviacion = n > 1 ? (uint32_t)(sqrtf(var / (n - 1)) + 0.5f) : 0;
+}
+
+// === KERNELS DE FÁBRICA ===
+
+// Punto de partida que el compilador no conoce: impide plegar los bucles en constantes
+static volatile uint32_t semilla = 7;
+
+static uint32_t kernelALU(void*) {
+  uint32_t x = semilla, y = 0x9E3779B9u;
+  for (int i = 0; i < 256; i++) {
+    x = (x ^ y) + (x << 3);
+    y = y * 33 + (x >> 5);
+  }
+  return x ^ y;
+}
+
+// El antiguo test matemático: sqrt y producto en coma flotante
+static uint32_t kernelSqrt(void*) {
+  float r = 0;
+  float base = (float)semilla;
+  for (int i = 0; i < 64; i++) r += sqrtf(base + i) * 3.14159f;
+  return (uint32_t)r;
+}
+
+static uint32_t kernelFloatMAC(void*) {
+  float a = (float)semilla;
+  for (int i = 0; i < 256; i++) a = a * 1.0001f + 0.5f;
+  return (uint32_t)a;
+}
+
+// La misma cuenta en Q16.16: 65543 / 65536 ≈ 1.0001, 32768 = 0.5
+static uint32_t kernelFijoMAC(void*) {
+  int32_t a = (int32_t)(semilla << 16);
+  for (int i = 0; i < 256; i++) a = (int32_t)(((int64_t)a * 65543) >> 16) + 32768;
+  return (uint32_t)a;
+}
+
+// Buffers de memcpy/memset/CRC: se piden al preparar y se devuelven al terminar
+static const size_t BENCH_BUF = 4096;
+static uint8_t* bufA = nullptr;
+static uint8_t* bufB = nullptr;
+
+static bool prepararBuffers(void*, bool activar) {
+  if (activar) {
+    bufA = (uint8_t*)malloc(BENCH_BUF);
+    bufB = (uint8_t*)malloc(BENCH_BUF);
+    if (bufA && bufB) {
+      for (size_t i = 0; i < BENCH_BUF; i++) bufA[i] = (uint8_t)(i * 31);
+      return true;
+    }
+  }
+  free(bufA);
+  free(bufB);
+  bufA = bufB = nullptr;
+  return false;
+}
+
+static uint32_t kernelMemcpy(void* ctx) {
+  size_t n = (size_t)(uintptr_t)ctx;
+  memcpy(bufB, bufA, n);
+  return bufB[n - 1];
+}
+
+static uint32_t kernelMemset(void* ctx) {
+  size_t n = (size_t)(uintptr_t)ctx;
+  memset(bufB, (int)semilla, n);
+  return bufB[n / 2];
+}
+
+static uint32_t kernelCRC32(void*) { return crc32(bufA, 1024); }
+
+// 16 pares; escribir en el bloque evita que el compilador elimine el par entero
+static uint32_t kernelMalloc(void* ctx) {
+  size_t n = (size_t)(uintptr_t)ctx;
+  uint32_t r = 0;
+  for (int i = 0; i < 16; i++) {
+    volatile uint8_t* p = (volatile uint8_t*)malloc(n);
+    if (!p) continue;
+    p[0] = (uint8_t)i;
+    r += p[0];
+    free((void*)p);
+  }
+  return r;
+}
+
+// El antiguo test de memoria: crecimiento de un String a base de concatenar
+static uint32_t kernelString(void*) {
+  String s;
+  for (int i = 0; i < 20; i++) s += String(i);
+  return s.length();
+}
+
+// Los kernels GPIO hacen 256 flancos (128 periodos) cada uno
+static bool prepararPin(void*, bool activar) {
+  pinMode(MICROBENCH_PIN_GPIO, activar ? OUTPUT : INPUT);
+  return true;
+}
+
+static bool prepararMascara(void*, bool activar) {
+  for (uint8_t pin = 0; pin < 32; pin++) {
+    if (MICROBENCH_PINES_MASCARA & (1UL << pin)) pinMode(pin, activar ? OUTPUT : INPUT);
+  }
+  return true;
+}
+
+static uint32_t kernelDigitalWrite(void*) {
+  for (int i = 0; i < 128; i++) {
+    digitalWrite(MICROBENCH_PIN_GPIO, HIGH);
+    digitalWrite(MICROBENCH_PIN_GPIO, LOW);
+  }
+  return 0;
+}
+
+// Máscara calculada en ejecución, como haría un driver con el pin en una variable
+static uint32_t kernelW1TS(void* ctx) {
+  uint32_t mascara = 1UL << (uintptr_t)ctx;
+  for (int i = 0; i < 128; i++) {
+    gpioAlto(mascara);
+    gpioBajo(mascara);
+  }
+  return 0;
+}
+
+static uint32_t kernelPlantilla(void*) {
+  typedef PinRapido<MICROBENCH_PIN_GPIO> Pin;
+  for (int i = 0; i < 128; i++) {
+    Pin::alto();
+    Pin::bajo();
+  }
+  return 0;
+}
+
+static uint32_t kernelRMW(void* ctx) {
+  uint32_t mascara = 1UL << (uintptr_t)ctx;
+  for (int i = 0; i < 128; i++) {
+    gpioEscribirRMW(mascara, mascara);
+    gpioEscribirRMW(mascara, 0);
+  }
+  return 0;
+}
+
+// Un patrón distinto por escritura sobre los 4 pines de la máscara
+static uint32_t kernelMascara(void*) {
+  for (uint32_t i = 0; i < 256; i++) gpioEscribir(MICROBENCH_PINES_MASCARA, i * 0x9E3779B9u);
+  return 0;
+}
+
+#define TAM(n) ((void*)(uintptr_t)(n))
+
+static const DefKernel kernelsBase[] = {
+  {"alu.u32", kernelALU, 256, nullptr, nullptr, false},
+  {"float.sqrt", kernelSqrt, 64, nullptr, nullptr, false},
+  {"float.mac", kernelFloatMAC, 256, nullptr, nullptr, false},
+  {"fijo.mac", kernelFijoMAC, 256, nullptr, nullptr, false},
+  {"memcpy.16", kernelMemcpy, 16, TAM(16), prepararBuffers, false},
+  {"memcpy.256", kernelMemcpy, 256, TAM(256), prepararBuffers, false},
+  {"memcpy.4096", kernelMemcpy, 4096, TAM(4096), prepararBuffers, false},
+  {"memset.16", kernelMemset, 16, TAM(16), prepararBuffers, false},
+  {"memset.256", kernelMemset, 256, TAM(256), prepararBuffers, false},
+  {"memset.4096", kernelMemset, 4096, TAM(4096), prepararBuffers, false},
+  {"crc32.1k", kernelCRC32, 1024, nullptr, prepararBuffers, false},
+  {"malloc.32", kernelMalloc, 16, TAM(32), nullptr, true},
+  {"malloc.1k", kernelMalloc, 16, TAM(1024), nullptr, true},
+  {"string.concat", kernelString, 20, nullptr, nullptr, true},
+  {"gpio.digitalWrite", kernelDigitalWrite, 256, nullptr, prepararPin, false},
+  {"gpio.w1ts", kernelW1TS, 256, TAM(MICROBENCH_PIN_GPIO), prepararPin, false},
+  {"gpio.plantilla", kernelPlantilla, 256, nullptr, prepararPin, false},
+  {"gpio.rmw", kernelRMW, 256, TAM(MICROBENCH_PIN_GPIO), prepararPin, false},
+  {"gpio.mascara4", kernelMascara, 256, nullptr, prepararMascara, false},
+};
+
+#undef TAM
+
+void registrarKernelsBase(MicroBench& mb) {
+  for (const DefKernel& k : kernelsBase) mb.registrar(k);
+}
@@ -0,0 +1,133 @@
+// Motor de micro-benchmarks
+// Los kernels se registran en una tabla fija con la función a medir y cuántas
+// operaciones hace por llamada. Cada medida corre unas llamadas de calentamiento
+// y luego N muestras cronometradas con el contador de ciclos de la CPU
+// (esp_cpu_get_cycle_count), con las interrupciones enmascaradas alrededor de
+// cada muestra si se pide. Al tiempo de cada muestra se le resta el sobrecoste
+// de la propia medida (calibrado con un kernel vacío) y el resultado se resume
+// en mín/mediana/p95/máx/media/desviación típica y ciclos por operación.
+#pragma once
+#include <Arduino.h>
+
+#ifndef MICROBENCH_MAX_KERNELS
+#define MICROBENCH_MAX_KERNELS 24
+#endif
+#ifndef MICROBENCH_MAX_MUESTRAS
+#define MICROBENCH_MAX_MUESTRAS 64
+#endif
+// Muestras y llamadas de calentamiento por defecto; ajustables con setMuestras()
+#ifndef MICROBENCH_MUESTRAS
+#define MICROBENCH_MUESTRAS 31
+#endif
+#ifndef MICROBENCH_CALENTAMIENTO
+#define MICROBENCH_CALENTAMIENTO 3
+#endif
+// 1 = enmascarar interrupciones durante cada muestra (salvo kernels marcados conIRQ)
+#ifndef MICROBENCH_SIN_INTERRUPCIONES
+#define MICROBENCH_SIN_INTERRUPCIONES 1
+#endif
+// Pin que conmutan los kernels GPIO y medirToggle, y pines del kernel con máscara
+#ifndef MICROBENCH_PIN_GPIO
+#define MICROBENCH_PIN_GPIO 2
+#endif
+#ifndef MICROBENCH_PINES_MASCARA
+#define MICROBENCH_PINES_MASCARA ((1UL << 2) | (1UL << 3) | (1UL << 4) | (1UL << 5))
+#endif
+// Flancos cronometrados uno a uno por medirToggle (par)
+#ifndef MICROBENCH_FLANCOS
+#define MICROBENCH_FLANCOS 64
+#endif
+
+// Hace el trabajo de una llamada; lo que devuelve se acumula en un sumidero
+// volátil para que el compilador no pueda descartar el cálculo
+typedef uint32_t (*KernelBench)(void* ctx);
+// Opcional: true antes de las muestras, false después (pines, buffers...).
+// Si al activar devuelve false, el kernel no se mide
+typedef bool (*PrepararBench)(void* ctx, bool activar);
+
+struct DefKernel {
+  const char* nombre;
+  KernelBench fn;
+  uint32_t ops;            // operaciones por llamada (ciclos/op = ciclos / ops)
+  void* ctx;
+  PrepararBench preparar;
+  bool conIRQ;             // nunca enmascarar: usa el asignador u otros servicios con bloqueo
+};
+
+struct EstadisticaBench {
+  uint32_t min;            // ciclos por llamada, ya sin el sobrecoste de medida
+  uint32_t mediana;
+  uint32_t p95;
+  uint32_t max;
+  uint32_t media;
+  uint32_t desviacion;     // desviación típica muestral
+  uint32_t ops;
+  uint8_t muestras;
+  bool sinIRQ;
+
+  float ciclosPorOp() const { return ops ? (float)mediana / ops : 0.0f; }
+};
+
+// Formas de conmutar un pin que compara medirToggle
+enum MetodoToggle : uint8_t { TOGGLE_HAL, TOGGLE_REGISTRO, TOGGLE_PLANTILLA, TOGGLE_RMW, TOGGLE_TOTAL };
+
+// Ciclos entre flancos consecutivos (incluye leer el contador en cada flanco)
+struct MedidaToggle {
+  uint32_t min;
+  uint32_t max;
+  float media;
+  float desviacion;
+
+  uint32_t jitter() const { return max - min; }
+  // Onda cuadrada: dos flancos por periodo
+  uint32_t frecuenciaHz(uint32_t mhz) const { return media > 0 ? (uint32_t)(mhz * 1e6f / (2 * media)) : 0; }
+};
+
+const char* nombreMetodoToggle(MetodoToggle m);
+
+class MicroBench {
+public:
+  // false si la tabla está llena
+  bool registrar(const DefKernel& k);
+  size_t cantidad() const { return n_; }
+  const DefKernel& kernel(size_t i) const { return kernels_[i]; }
+
+  // Mide el sobrecoste de leer el contador dos veces alrededor de una llamada
+  void calibrar();
+  uint32_t sobrecoste() const { return sobrecoste_; }
+
+  // Calentamiento + muestras del kernel i (calibra antes si hace falta).
+  // false si i no existe o su preparación falla
+  bool medir(size_t i, EstadisticaBench& est);
+
+  // Conmuta MICROBENCH_PIN_GPIO MICROBENCH_FLANCOS veces con el método dado,
+  // anotando el contador de ciclos tras cada flanco
+  void medirToggle(MetodoToggle m, MedidaToggle& r);
+
+  void setMuestras(uint8_t n);
+  uint8_t muestras() const { return muestras_; }
+  void setCalentamiento(uint8_t n) { calentamiento_ = n; }
+  uint8_t calentamiento() const { return calentamiento_; }
+  void setSinInterrupciones(bool s) { sinIRQ_ = s; }
+  bool sinInterrupciones() const { return sinIRQ_; }
+
+private:
+  uint32_t muestra(const DefKernel& k, bool sinIRQ);
+  static void resumir(uint32_t* m, size_t n, EstadisticaBench& est);
+
+  DefKernel kernels_[MICROBENCH_MAX_KERNELS];
+  uint32_t tiempos_[MICROBENCH_MAX_MUESTRAS];
+  size_t n_ = 0;
+  uint32_t sobrecoste_ = 0;
+  bool calibrado_ = false;
+  uint8_t muestras_ = MICROBENCH_MUESTRAS;
+  uint8_t calentamiento_ = MICROBENCH_CALENTAMIENTO;
+  bool sinIRQ_ = MICROBENCH_SIN_INTERRUPCIONES;
+  volatile uint32_t sumidero_ = 0;
+};
+
+// Kernels de fábrica: ALU entera, sqrt y multiplicación-suma en float (por
+// software en el C3) frente a punto fijo Q16.16, memcpy/memset a 16/256/4096 B,
+// CRC32, pares malloc/free, concatenación de String y escritura de GPIO por la
+// HAL, por registro (máscara variable y PinRapido), con máscara de 4 pines y RMW
+void registrarKernelsBase(MicroBench& mb);
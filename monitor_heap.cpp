@@ -0,0 +1,163 @@
+#include "monitor_heap.h"
+#include "resultados.h"
+
+const CapacidadHeap CAPACIDADES_HEAP[] = {
+  {"interna", MALLOC_CAP_INTERNAL},
+  {"dma", MALLOC_CAP_DMA},
+  {"iram", MALLOC_CAP_EXEC},
+};
+const size_t N_CAPACIDADES_HEAP = sizeof(CAPACIDADES_HEAP) / sizeof(CAPACIDADES_HEAP[0]);
+
+void fotoHeap(uint32_t caps, FotoHeap& f) {
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, caps);
+  f.total = heap_caps_get_total_size(caps);
+  f.libre = info.total_free_bytes;
+  f.mayorBloque = info.largest_free_block;
+  f.minimoLibre = info.minimum_free_bytes;
+  f.bloquesLibres = info.free_blocks;
+}
+
+const char* nombreMotivoBarrido(uint8_t m) {
+  static const char* const nombres[] = {"reserva", "fallo", "tope"};
+  return m <= BARRIDO_TOPE ? nombres[m] : "?";
+}
+
+void barrerClase(uint32_t tam, ClaseHeap& c) {
+  if (tam < sizeof(void*)) tam = sizeof(void*);
+  c.tam = tam;
+  c.bloques = 0;
+  c.libreAntes = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+  c.motivo = BARRIDO_TOPE;
+
+  void* lista = nullptr;
+  while (c.bloques < HEAP_BARRIDO_MAX_BLOQUES) {
+    if (heap_caps_get_free_size(MALLOC_CAP_DEFAULT) < HEAP_RESERVA_BARRIDO + tam) {
+      c.motivo = BARRIDO_RESERVA;
+      break;
+    }
+    void** p = (void**)heap_caps_malloc(tam, MALLOC_CAP_DEFAULT);
+    if (!p) {
+      c.motivo = BARRIDO_FALLO;
+      break;
+    }
+    *p = lista;
+    lista = p;
+    c.bloques++;
+  }
+  while (lista) {
+    void* anterior = *(void**)lista;
+    heap_caps_free(lista);
+    lista = anterior;
+  }
+}
+
+uint32_t mayorAsignable() {
+  uint32_t lo = 0, hi = heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT);
+  // Invariante: lo se pudo asignar (o es 0); por encima de hi no se intenta
+  while (lo < hi) {
+    uint32_t medio = lo + (hi - lo + 1) / 2;
+    void* p = heap_caps_malloc(medio, MALLOC_CAP_DEFAULT);
+    if (p) {
+      heap_caps_free(p);
+      lo = medio;
+    } else {
+      hi = medio - 1;
+    }
+  }
+  return lo;
+}
+
+// === SERIE TEMPORAL ===
+
+void SerieHeap::muestrear(const char* origen) {
+  FotoHeap f;
+  fotoHeap(MALLOC_CAP_DEFAULT, f);
+  if (n_) {
+    const MuestraHeap& u = muestra(n_ - 1);
+    if (u.libre == f.libre && u.mayorBloque == f.mayorBloque && u.bloquesLibres == f.bloquesLibres) return;
+  }
+
+  MuestraHeap* m;
+  if (n_ < HEAP_SERIE_LEN) {
+    m = &anillo_[(inicio_ + n_++) % HEAP_SERIE_LEN];
+  } else {
+    m = &anillo_[inicio_];
+    inicio_ = (inicio_ + 1) % HEAP_SERIE_LEN;
+    descartadas_++;
+  }
+  m->ms = millis();
+  m->libre = f.libre;
+  m->mayorBloque = f.mayorBloque;
+  m->bloquesLibres = f.bloquesLibres > 0xFFFF ? 0xFFFF : (uint16_t)f.bloquesLibres;
+  m->fragmentacion = f.fragmentacion();
+  strncpy(m->origen, origen, HEAP_ORIGEN_LEN - 1);
+  m->origen[HEAP_ORIGEN_LEN - 1] = '\0';
+}
+
+void SerieHeap::imprimirTexto(Print& out) const {
+  out.print("\n🧩 SERIE DEL HEAP: ");
+  out.print((unsigned)n_);
+  out.print("/");
+  out.print((unsigned)HEAP_SERIE_LEN);
+  out.print(" muestras, ");
+  out.print((unsigned long)descartadas_);
+  out.println(" descartadas");
+  if (n_ == 0) {
+    out.println("• Sin muestras");
+    return;
+  }
+  out.println("  ms            Libre   Mayor bloque  Bloq. libres  Frag.  Origen");
+  for (size_t i = 0; i < n_; i++) {
+    const MuestraHeap& m = muestra(i);
+    char linea[72];
+    snprintf(linea, sizeof(linea), "  %-10lu %9lu %14lu %13u %5u%%  ", (unsigned long)m.ms,
+             (unsigned long)m.libre, (unsigned long)m.mayorBloque, (unsigned)m.bloquesLibres,
+             (unsigned)m.fragmentacion);
+    out.print(linea);
+    out.println(m.origen);
+  }
+}
+
+void SerieHeap::imprimirJSON(Print& out) const {
+  out.print("{\"capacidad\":");
+  out.print((unsigned)HEAP_SERIE_LEN);
+  out.print(",\"descartadas\":");
+  out.print((unsigned long)descartadas_);
+  out.print(",\"muestras\":[");
+  for (size_t i = 0; i < n_; i++) {
+    const MuestraHeap& m = muestra(i);
+    out.print(i ? ",\n{\"ms\":" : "\n{\"ms\":");
+    out.print((unsigned long)m.ms);
+    out.print(",\"libre\":");
+    out.print((unsigned long)m.libre);
+    out.print(",\"mayor_bloque\":");
+    out.print((unsigned long)m.mayorBloque);
+    out.print(",\"bloques_libres\":");
+    out.print((unsigned)m.bloquesLibres);
+    out.print(",\"fragmentacion\":");
+    out.print((unsigned)m.fragmentacion);
+    out.print(",\"origen\":");
+    imprimirTextoJSON(out, (const uint8_t*)m.origen, strlen(m.origen));
+    out.print('}');
+  }
+  out.print("\n]}");
+}
+
+void SerieHeap::imprimirCSV(Print& out) const {
+  out.println("ms,libre,mayor_bloque,bloques_libres,fragmentacion,origen");
+  for (size_t i = 0; i < n_; i++) {
+    const MuestraHeap& m = muestra(i);
+    out.print((unsigned long)m.ms);
+    out.print(',');
+    out.print((unsigned long)m.libre);
+    out.print(',');
+    out.print((unsigned long)m.mayorBloque);
+    out.print(',');
+    out.print((unsigned)m.bloquesLibres);
+    out.print(',');
+    out.print((unsigned)m.fragmentacion);
+    out.print(',');
+    out.println(m.origen);
+  }
+}
@@ -0,0 +1,95 @@
+// Perfil y seguimiento de la fragmentación del heap
+// - fotoHeap(): estado de un heap por capacidad (interna, DMA, IRAM) con el
+//   índice de fragmentación 100 * (1 - mayor bloque libre / bytes libres).
+// - barrerClase(): cuántos bloques de un tamaño se pueden pedir de verdad a la
+//   vez, hasta que falla la asignación o se llega a la reserva que se deja al
+//   resto del sistema. Los bloques se encadenan entre sí (el primer puntero de
+//   cada uno apunta al anterior), así el barrido no necesita memoria propia.
+// - SerieHeap: anillo de muestras (libre, mayor bloque, bloques libres) que se
+//   toman periódicamente y tras cada comando y cada handler HTTP, solo si el heap
+//   cambió; cada muestra lleva su origen para relacionar la fragmentación con
+//   quien la provocó. Se exporta en JSON o CSV (/heap) y en texto (comando F).
+#pragma once
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+// Bytes que el barrido deja siempre libres para WiFi, BLE y el servidor web
+#ifndef HEAP_RESERVA_BARRIDO
+#define HEAP_RESERVA_BARRIDO 24576
+#endif
+// Tope de bloques por clase (acota el tiempo de un paso con bloques de 16 B)
+#ifndef HEAP_BARRIDO_MAX_BLOQUES
+#define HEAP_BARRIDO_MAX_BLOQUES 16384
+#endif
+#ifndef HEAP_SERIE_LEN
+#define HEAP_SERIE_LEN 64
+#endif
+#ifndef HEAP_MUESTREO_MS
+#define HEAP_MUESTREO_MS 10000
+#endif
+#define HEAP_ORIGEN_LEN 12  // cabe "/resultados"
+
+struct FotoHeap {
+  uint32_t total;
+  uint32_t libre;
+  uint32_t mayorBloque;
+  uint32_t minimoLibre;
+  uint32_t bloquesLibres;
+
+  uint8_t fragmentacion() const { return libre ? (uint8_t)(100 - (uint64_t)mayorBloque * 100 / libre) : 0; }
+};
+
+void fotoHeap(uint32_t caps, FotoHeap& f);
+
+struct CapacidadHeap {
+  const char* nombre;
+  uint32_t caps;
+};
+extern const CapacidadHeap CAPACIDADES_HEAP[];
+extern const size_t N_CAPACIDADES_HEAP;
+
+enum MotivoBarrido : uint8_t { BARRIDO_RESERVA, BARRIDO_FALLO, BARRIDO_TOPE };
+const char* nombreMotivoBarrido(uint8_t m);
+
+struct ClaseHeap {
+  uint32_t tam;
+  uint32_t bloques;     // asignados a la vez
+  uint32_t libreAntes;
+  MotivoBarrido motivo;
+};
+
+void barrerClase(uint32_t tam, ClaseHeap& c);
+// Mayor bloque que malloc entrega de verdad (búsqueda binaria bajo el mayor bloque libre)
+uint32_t mayorAsignable();
+
+struct MuestraHeap {
+  uint32_t ms;
+  uint32_t libre;
+  uint32_t mayorBloque;
+  uint16_t bloquesLibres;
+  uint8_t fragmentacion;
+  char origen[HEAP_ORIGEN_LEN];  // con terminador
+};
+
+class SerieHeap {
+public:
+  // Anota el estado del heap por defecto si cambió desde la última muestra
+  void muestrear(const char* origen);
+  void limpiar() { n_ = inicio_ = 0; }
+
+  size_t cantidad() const { return n_; }
+  static constexpr size_t capacidad() { return HEAP_SERIE_LEN; }
+  // 0 = la más antigua
+  const MuestraHeap& muestra(size_t i) const { return anillo_[(inicio_ + i) % HEAP_SERIE_LEN]; }
+  uint32_t descartadas() const { return descartadas_; }
+
+  void imprimirTexto(Print& out) const;
+  void imprimirJSON(Print& out) const;
+  void imprimirCSV(Print& out) const;
+
+private:
+  MuestraHeap anillo_[HEAP_SERIE_LEN];
+  size_t inicio_ = 0;
+  size_t n_ = 0;
+  uint32_t descartadas_ = 0;
+};
@@ -0,0 +1,277 @@
+#include "muestreo.h"
+#include "formato.h"
+
+const char* nombreCanalMuestra(uint8_t c) {
+  static const char* const nombres[] = {"heap_libre", "mayor_bloque", "temperatura_dc", "rssi"};
+  return c < CM_TOTAL ? nombres[c] : "?";
+}
+
+// === CODIFICACIÓN ===
+
+#define MASCARA_INTERVALO 0x80
+
+static uint8_t varintZigzag(uint8_t* out, int32_t v) {
+  uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+  uint8_t n = 0;
+  while (z >= 0x80) {
+    out[n++] = (uint8_t)(z | 0x80);
+    z >>= 7;
+  }
+  out[n++] = (uint8_t)z;
+  return n;
+}
+
+static int32_t leerVarintZigzag(const uint8_t* datos, uint16_t& off) {
+  uint32_t z = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    uint8_t b = datos[off++];
+    z |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) break;
+  }
+  return (int32_t)((z >> 1) ^ (~(z & 1) + 1));
+}
+
+void SerieMuestras::limpiar() {
+  primero_ = nBloques_ = 0;
+  dtUltimo_ = 0;
+  tomadas_ = descartadas_ = 0;
+  costeUs_ = 0;
+}
+
+void SerieMuestras::anotarCoste(uint32_t us) { costeUs_ += us; }
+
+void SerieMuestras::agregar(const Muestra& m) {
+  tomadas_++;
+  if (nBloques_) {
+    uint8_t cod[MUESTRA_MAX];
+    uint8_t n = 1;
+    cod[0] = 0;  // máscara
+    uint32_t dt = m.ms - ultima_.ms;
+    if (dt != dtUltimo_) {
+      cod[0] |= MASCARA_INTERVALO;
+      n += varintZigzag(cod + n, (int32_t)(dt - dtUltimo_));
+    }
+    for (uint8_t c = 0; c < CM_TOTAL; c++) {
+      if (m.valor[c] == ultima_.valor[c]) continue;
+      cod[0] |= 1 << c;
+      n += varintZigzag(cod + n, m.valor[c] - ultima_.valor[c]);
+    }
+    Bloque& b = bloques_[(primero_ + nBloques_ - 1) % MUESTREO_BLOQUES];
+    if (b.usados + n <= MUESTREO_BLOQUE_BYTES) {
+      memcpy(b.datos + b.usados, cod, n);
+      b.usados += n;
+      b.n++;
+      dtUltimo_ = dt;
+      ultima_ = m;
+      return;
+    }
+  }
+
+  // Bloque nuevo (o el primero): la muestra va entera en la cabecera
+  if (nBloques_ == MUESTREO_BLOQUES) {
+    descartadas_ += bloques_[primero_].n;
+    primero_ = (primero_ + 1) % MUESTREO_BLOQUES;
+    nBloques_--;
+  }
+  Bloque& b = bloques_[(primero_ + nBloques_++) % MUESTREO_BLOQUES];
+  b.ms0 = m.ms;
+  memcpy(b.base, m.valor, sizeof(b.base));
+  b.n = 1;
+  b.usados = 0;
+  dtUltimo_ = 0;
+  ultima_ = m;
+}
+
+uint32_t SerieMuestras::cantidad() const {
+  uint32_t n = 0;
+  for (uint8_t i = 0; i < nBloques_; i++) n += bloque(i).n;
+  return n;
+}
+
+size_t SerieMuestras::bytesUsados() const {
+  size_t n = 0;
+  for (uint8_t i = 0; i < nBloques_; i++) n += sizeof(Bloque) - MUESTREO_BLOQUE_BYTES + bloque(i).usados;
+  return n;
+}
+
+// === LECTURA ===
+
+SerieMuestras::Lector::Lector(const SerieMuestras& s) : s_(s), bloque_(0), muestra_(0), off_(0), dt_(0) {}
+
+bool SerieMuestras::Lector::siguiente(Muestra& m) {
+  while (bloque_ < s_.nBloques_) {
+    const Bloque& b = s_.bloque(bloque_);
+    if (muestra_ == b.n) {
+      bloque_++;
+      muestra_ = off_ = 0;
+      continue;
+    }
+    if (muestra_ == 0) {
+      previa_.ms = b.ms0;
+      memcpy(previa_.valor, b.base, sizeof(previa_.valor));
+      dt_ = 0;
+    } else {
+      uint8_t mascara = b.datos[off_++];
+      if (mascara & MASCARA_INTERVALO) dt_ += leerVarintZigzag(b.datos, off_);
+      previa_.ms += dt_;
+      for (uint8_t c = 0; c < CM_TOTAL; c++) {
+        if (mascara & (1 << c)) previa_.valor[c] += leerVarintZigzag(b.datos, off_);
+      }
+    }
+    muestra_++;
+    m = previa_;
+    return true;
+  }
+  return false;
+}
+
+void SerieMuestras::reducir(uint32_t ventanaMs, uint32_t desdeMs, void (*fn)(const VentanaMuestras&, void*),
+                            void* ctx) const {
+  VentanaMuestras v;
+  v.n = 0;
+  Lector lector(*this);
+  Muestra m;
+  while (lector.siguiente(m)) {
+    if ((int32_t)(m.ms - desdeMs) < 0) continue;
+    uint32_t inicio = ventanaMs ? m.ms - m.ms % ventanaMs : m.ms;
+    if (v.n && (ventanaMs == 0 || inicio != v.inicioMs)) {
+      fn(v, ctx);
+      v.n = 0;
+    }
+    if (v.n == 0) {
+      v.inicioMs = inicio;
+      for (uint8_t c = 0; c < CM_TOTAL; c++) {
+        v.min[c] = v.max[c] = m.valor[c];
+        v.suma[c] = 0;
+      }
+    }
+    v.n++;
+    for (uint8_t c = 0; c < CM_TOTAL; c++) {
+      if (m.valor[c] < v.min[c]) v.min[c] = m.valor[c];
+      if (m.valor[c] > v.max[c]) v.max[c] = m.valor[c];
+      v.suma[c] += m.valor[c];
+    }
+  }
+  if (v.n) fn(v, ctx);
+}
+
+// === RENDER ===
+
+static void imprimirResumenTexto(Print& out, const SerieMuestras& s, uint32_t ventanaMs) {
+  char linea[112];
+  snprintf(linea, sizeof(linea), "\n📈 MUESTREO: %lu muestras en %u/%u B, cada %lu ms, %lu descartadas",
+           (unsigned long)s.cantidad(), (unsigned)s.bytesUsados(), (unsigned)s.capacidad(),
+           (unsigned long)s.periodo(), (unsigned long)s.descartadas());
+  out.println(linea);
+  snprintf(linea, sizeof(linea), "   Coste: %lu us por muestra (%.3f%% de CPU)", (unsigned long)s.costeMedioUs(),
+           s.usoCPU());
+  out.print(linea);
+  if (ventanaMs) imprimirlnf(out, "; ventanas de %lu s", (unsigned long)(ventanaMs / 1000));
+  else out.println("; muestras sueltas");
+}
+
+static void ventanaTexto(const VentanaMuestras& v, void* ctx) {
+  char linea[112];
+  snprintf(linea, sizeof(linea), "  %8lus %4lu %7ld %7ld %7ld %7ld %5.1f %5.1f %5.1f %4ld %4ld",
+           (unsigned long)(v.inicioMs / 1000), (unsigned long)v.n, (long)v.min[CM_HEAP_LIBRE],
+           (long)(v.media(CM_HEAP_LIBRE) + 0.5f), (long)v.max[CM_HEAP_LIBRE], (long)v.min[CM_MAYOR_BLOQUE],
+           v.min[CM_TEMPERATURA] / 10.0, v.media(CM_TEMPERATURA) / 10.0, v.max[CM_TEMPERATURA] / 10.0,
+           (long)v.min[CM_RSSI], (long)v.max[CM_RSSI]);
+  ((Print*)ctx)->println(linea);
+}
+
+void SerieMuestras::imprimirTexto(Print& out, uint32_t ventanaMs) const {
+  imprimirResumenTexto(out, *this, ventanaMs);
+  if (tomadas_ == 0) {
+    out.println("• Sin muestras");
+    return;
+  }
+  out.println("  Desde         n  Heap mín   media    máx  Bloque mín  T mín media  máx  RSSI mín/máx");
+  reducir(ventanaMs, 0, ventanaTexto, &out);
+}
+
+static void ventanaJSON(const VentanaMuestras& v, void* ctx) {
+  Print& out = *(Print*)ctx;
+  out.print("\n{\"ms\":");
+  out.print((unsigned long)v.inicioMs);
+  out.print(",\"n\":");
+  out.print((unsigned long)v.n);
+  for (uint8_t c = 0; c < CM_TOTAL; c++) {
+    out.print(",\"");
+    out.print(nombreCanalMuestra(c));
+    out.print("\":[");
+    out.print((long)v.min[c]);
+    out.print(',');
+    out.print(v.media(c), 1);
+    out.print(',');
+    out.print((long)v.max[c]);
+    out.print(']');
+  }
+  out.print('}');
+}
+
+void SerieMuestras::imprimirJSON(Print& out, uint32_t ventanaMs) const {
+  out.print("{\"periodo_ms\":");
+  out.print((unsigned long)periodo_);
+  out.print(",\"ventana_ms\":");
+  out.print((unsigned long)ventanaMs);
+  out.print(",\"muestras\":");
+  out.print((unsigned long)cantidad());
+  out.print(",\"descartadas\":");
+  out.print((unsigned long)descartadas_);
+  out.print(",\"bytes\":");
+  out.print((unsigned)bytesUsados());
+  out.print(",\"capacidad\":");
+  out.print((unsigned)capacidad());
+  out.print(",\"coste_us\":");
+  out.print((unsigned long)costeMedioUs());
+  out.print(",\"cpu_pct\":");
+  out.print(usoCPU(), 4);
+  out.print(",\"ahora_ms\":");
+  out.print((unsigned long)millis());
+  // Cada canal es [mín, media, máx] dentro de la ventana
+  out.print(",\"ventanas\":[");
+  struct Ctx {
+    Print* out;
+    bool primera;
+  } ctx = {&out, true};
+  reducir(ventanaMs, 0, [](const VentanaMuestras& v, void* p) {
+    Ctx& c = *(Ctx*)p;
+    if (!c.primera) c.out->print(',');
+    c.primera = false;
+    ventanaJSON(v, c.out);
+  }, &ctx);
+  out.print("\n]}");
+}
+
+static void ventanaCSV(const VentanaMuestras& v, void* ctx) {
+  Print& out = *(Print*)ctx;
+  out.print((unsigned long)v.inicioMs);
+  out.print(',');
+  out.print((unsigned long)v.n);
+  for (uint8_t c = 0; c < CM_TOTAL; c++) {
+    out.print(',');
+    out.print((long)v.min[c]);
+    out.print(',');
+    out.print(v.media(c), 1);
+    out.print(',');
+    out.print((long)v.max[c]);
+  }
+  out.println();
+}
+
+void SerieMuestras::imprimirCSV(Print& out, uint32_t ventanaMs) const {
+  out.print("ms,n");
+  for (uint8_t c = 0; c < CM_TOTAL; c++) {
+    const char* nombre = nombreCanalMuestra(c);
+    out.print(",");
+    out.print(nombre);
+    out.print("_min,");
+    out.print(nombre);
+    out.print("_media,");
+    out.print(nombre);
+    out.print("_max");
+  }
+  out.println();
+  reducir(ventanaMs, 0, ventanaCSV, &out);
+}
@@ -0,0 +1,124 @@
+// Muestreo periódico en segundo plano
+// Una tarea permanente del planificador toma cada periodo() ms el heap libre, el
+// mayor bloque, la temperatura del chip y el RSSI de la estación, sin que nadie
+// escriba un comando. Las muestras se guardan comprimidas en un anillo de bloques
+// de tamaño fijo, así unas horas de historia caben en unos pocos KB:
+//
+//   Bloque: cabecera con la primera muestra en absoluto, luego una muestra tras
+//   otra como diferencias con la anterior:
+//     [máscara u8][Δintervalo varint zigzag][Δcanal varint zigzag]...
+//   El bit c de la máscara indica que el canal c cambió (solo esos llevan Δ) y el
+//   bit 7 que el intervalo entre muestras no es el de la anterior. Una muestra sin
+//   cambios a ritmo constante ocupa 1 byte.
+//
+// Al llenarse el anillo se descarta el bloque más antiguo entero. Las consultas
+// agregan por ventanas de tiempo (mín/máx/media por canal) para no devolver cada
+// muestra; ventana 0 = muestras sueltas.
+#pragma once
+#include <Arduino.h>
+
+// Bloques del anillo y bytes de muestras por bloque (MUESTREO_BLOQUES * ~280 B de RAM)
+#ifndef MUESTREO_BLOQUES
+#define MUESTREO_BLOQUES 12
+#endif
+#ifndef MUESTREO_BLOQUE_BYTES
+#define MUESTREO_BLOQUE_BYTES 256
+#endif
+// Periodo inicial; se cambia en marcha con "S periodo <ms>"
+#ifndef MUESTREO_PERIODO_MS
+#define MUESTREO_PERIODO_MS 10000
+#endif
+#define MUESTREO_PERIODO_MIN_MS 100
+
+enum CanalMuestra : uint8_t {
+  CM_HEAP_LIBRE,    // bytes
+  CM_MAYOR_BLOQUE,  // bytes
+  CM_TEMPERATURA,   // décimas de °C
+  CM_RSSI,          // dBm; 0 sin enlace
+  CM_TOTAL
+};
+
+struct Muestra {
+  uint32_t ms;  // millis(): también da el tiempo encendido
+  int32_t valor[CM_TOTAL];
+};
+
+// Agregado de las muestras de una ventana [inicioMs, inicioMs + ventana)
+struct VentanaMuestras {
+  uint32_t inicioMs;
+  uint32_t n;
+  int32_t min[CM_TOTAL];
+  int32_t max[CM_TOTAL];
+  int64_t suma[CM_TOTAL];
+
+  float media(uint8_t c) const { return n ? (float)suma[c] / n : 0.0f; }
+};
+
+const char* nombreCanalMuestra(uint8_t c);
+
+class SerieMuestras {
+public:
+  void agregar(const Muestra& m);
+  void limpiar();
+
+  // Coste de tomar la muestra (lo anota la tarea que muestrea)
+  void anotarCoste(uint32_t us);
+  uint32_t costeMedioUs() const { return tomadas_ ? (uint32_t)(costeUs_ / tomadas_) : 0; }
+  // Fracción del tiempo de CPU que se lleva el muestreo, en %
+  float usoCPU() const { return periodo_ ? 100.0f * costeMedioUs() / (periodo_ * 1000.0f) : 0.0f; }
+
+  void setPeriodo(uint32_t ms) { periodo_ = ms < MUESTREO_PERIODO_MIN_MS ? MUESTREO_PERIODO_MIN_MS : ms; }
+  uint32_t periodo() const { return periodo_; }
+
+  uint32_t cantidad() const;
+  uint32_t tomadas() const { return tomadas_; }
+  uint32_t descartadas() const { return descartadas_; }
+  size_t bytesUsados() const;
+  static constexpr size_t capacidad() { return sizeof(bloques_); }
+
+  // Recorre las muestras retenidas de la más antigua a la más nueva
+  class Lector {
+  public:
+    explicit Lector(const SerieMuestras& s);
+    bool siguiente(Muestra& m);
+
+  private:
+    const SerieMuestras& s_;
+    uint8_t bloque_;    // bloques leídos desde el más antiguo
+    uint16_t muestra_;  // dentro del bloque
+    uint16_t off_;
+    uint32_t dt_;
+    Muestra previa_;
+  };
+
+  // Agrega por ventanas de ventanaMs (0 = cada muestra sola) desde desdeMs y
+  // llama a fn con cada ventana cerrada
+  void reducir(uint32_t ventanaMs, uint32_t desdeMs, void (*fn)(const VentanaMuestras&, void*), void* ctx) const;
+
+  void imprimirTexto(Print& out, uint32_t ventanaMs) const;
+  void imprimirJSON(Print& out, uint32_t ventanaMs) const;
+  void imprimirCSV(Print& out, uint32_t ventanaMs) const;
+
+private:
+  struct Bloque {
+    uint32_t ms0;
+    int32_t base[CM_TOTAL];
+    uint16_t n;
+    uint16_t usados;
+    uint8_t datos[MUESTREO_BLOQUE_BYTES];
+  };
+  // Máscara + Δintervalo + Δ por canal, cada varint de hasta 5 bytes
+  static constexpr size_t MUESTRA_MAX = 1 + 5 * (1 + CM_TOTAL);
+
+  const Bloque& bloque(uint8_t i) const { return bloques_[(primero_ + i) % MUESTREO_BLOQUES]; }
+
+  Bloque bloques_[MUESTREO_BLOQUES];
+  uint8_t primero_ = 0;
+  uint8_t nBloques_ = 0;
+  Muestra ultima_;  // para codificar la siguiente
+  uint32_t dtUltimo_ = 0;
+  uint32_t periodo_ = MUESTREO_PERIODO_MS;
+  uint32_t tomadas_ = 0;
+  uint32_t descartadas_ = 0;
+  uint64_t costeUs_ = 0;
+};
@@ -0,0 +1,84 @@
+#include "planificador.h"
+
+Tarea* Planificador::lanzar(const char* nombre, PasoTarea paso, FinTarea alTerminar) {
+  for (Tarea& t : tareas_) {
+    if (t.activa) continue;
+    t.reiniciar();
+    t.nombre = nombre;
+    t.paso = paso;
+    t.alTerminar = alTerminar;
+    t.proximo = millis();
+    t.activa = true;
+    return &t;
+  }
+  return nullptr;
+}
+
+size_t Planificador::ejecutar() {
+  size_t ejecutados = 0;
+  for (Tarea& t : tareas_) {
+    if (!t.activa || (int32_t)(millis() - t.proximo) < 0) continue;
+
+    uint32_t inicio = micros();
+    int32_t espera = t.paso(t);
+    uint32_t duracion = micros() - inicio;
+    pasos_++;
+    ejecutados++;
+    if (duracion > pasoMaxUs_) {
+      pasoMaxUs_ = duracion;
+      pasoMaxNombre_ = t.nombre;
+    }
+
+    // El paso pudo cancelar su propia tarea
+    if (!t.activa) continue;
+    if (espera == TAREA_FIN) {
+      t.activa = false;
+      if (t.alTerminar) t.alTerminar(t);
+    } else {
+      t.proximo = millis() + (uint32_t)espera;
+    }
+  }
+  return ejecutados;
+}
+
+uint32_t Planificador::msHastaProximo() const {
+  uint32_t minimo = UINT32_MAX;
+  uint32_t ahora = millis();
+  for (const Tarea& t : tareas_) {
+    if (!t.activa) continue;
+    int32_t falta = (int32_t)(t.proximo - ahora);
+    if (falta <= 0) return 0;
+    if ((uint32_t)falta < minimo) minimo = falta;
+  }
+  return minimo;
+}
+
+size_t Planificador::activas() const {
+  size_t n = 0;
+  for (const Tarea& t : tareas_) n += t.activa;
+  return n;
+}
+
+const Tarea* Planificador::buscar(PasoTarea paso) const {
+  for (const Tarea& t : tareas_) {
+    if (t.activa && t.paso == paso) return &t;
+  }
+  return nullptr;
+}
+
+bool Planificador::cancelar(PasoTarea paso) {
+  Tarea* t = const_cast<Tarea*>(buscar(paso));
+  if (!t) return false;
+  t->activa = false;
+  return true;
+}
+
+void Planificador::cancelarTodas() {
+  for (Tarea& t : tareas_) t.activa = false;
+}
+
+void Planificador::reiniciarEstadisticas() {
+  pasoMaxUs_ = 0;
+  pasoMaxNombre_ = "";
+  pasos_ = 0;
+}
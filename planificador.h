@@ -0,0 +1,77 @@
+// Planificador cooperativo de tareas
+// Cada diagnóstico es una máquina de estados: un paso hace un trozo corto de
+// trabajo y devuelve cuántos ms esperar hasta el siguiente, en lugar de llamar
+// a delay(). loop() ejecuta los pasos vencidos y entre uno y otro sigue
+// atendiendo el servidor web, Serial y la cola BLE.
+#pragma once
+#include <Arduino.h>
+
+#ifndef PLANIFICADOR_MAX_TAREAS
+#define PLANIFICADOR_MAX_TAREAS 6
+#endif
+
+// Retorno de un paso: la tarea terminó
+constexpr int32_t TAREA_FIN = -1;
+
+struct Tarea;
+// Ejecuta un paso; devuelve ms hasta el siguiente (0 = próxima vuelta de loop) o TAREA_FIN
+typedef int32_t (*PasoTarea)(Tarea& t);
+// Se llama una vez cuando la tarea termina (no al cancelarla)
+typedef void (*FinTarea)(Tarea& t);
+
+struct Tarea {
+  const char* nombre = nullptr;
+  PasoTarea paso = nullptr;
+  FinTarea alTerminar = nullptr;
+  uint32_t proximo = 0;  // millis() a partir del cual toca el siguiente paso
+  bool activa = false;
+
+  // Estado que el paso conserva entre llamadas
+  uint16_t estado = 0;
+  uint16_t i = 0;
+  uint16_t j = 0;
+  uint32_t marca = 0;
+  uint32_t a = 0;
+  uint32_t b = 0;
+
+  // Pasa a la etapa e y pide esperar esperaMs antes de ejecutarla
+  int32_t siguiente(uint16_t e, int32_t esperaMs = 0) {
+    estado = e;
+    return esperaMs;
+  }
+  // Deja la tarea lista para empezar desde la etapa 0
+  void reiniciar() {
+    estado = i = j = 0;
+    marca = a = b = 0;
+  }
+};
+
+class Planificador {
+public:
+  // Registra una tarea que empieza en la próxima vuelta; nullptr si no hay hueco
+  Tarea* lanzar(const char* nombre, PasoTarea paso, FinTarea alTerminar = nullptr);
+  // Ejecuta un paso de cada tarea vencida; devuelve cuántos pasos corrió
+  size_t ejecutar();
+  // ms hasta el próximo paso pendiente: 0 si ya hay trabajo, UINT32_MAX si no hay tareas
+  uint32_t msHastaProximo() const;
+
+  bool activa(PasoTarea paso) const { return buscar(paso) != nullptr; }
+  size_t activas() const;
+  // Quita la tarea sin llamar a alTerminar; false si no estaba activa
+  bool cancelar(PasoTarea paso);
+  void cancelarTodas();
+
+  // Paso más largo observado: mide lo que loop() tarda en volver a atender la web
+  uint32_t pasoMaxUs() const { return pasoMaxUs_; }
+  const char* pasoMaxNombre() const { return pasoMaxNombre_; }
+  uint32_t pasosEjecutados() const { return pasos_; }
+  void reiniciarEstadisticas();
+
+private:
+  const Tarea* buscar(PasoTarea paso) const;
+
+  Tarea tareas_[PLANIFICADOR_MAX_TAREAS];
+  uint32_t pasoMaxUs_ = 0;
+  const char* pasoMaxNombre_ = "";
+  uint32_t pasos_ = 0;
+};
@@ -0,0 +1,68 @@
+#include "rangos_http.h"
+
+static const char* saltarEspacios(const char* p) {
+  while (*p == ' ' || *p == '\t') p++;
+  return p;
+}
+
+// Lee un entero decimal; false si no hay dígitos o desborda 32 bits
+static bool leerNumero(const char*& p, uint32_t& valor) {
+  if (*p < '0' || *p > '9') return false;
+  uint64_t v = 0;
+  while (*p >= '0' && *p <= '9') {
+    v = v * 10 + (*p++ - '0');
+    if (v > 0xFFFFFFFFULL) return false;
+  }
+  valor = (uint32_t)v;
+  return true;
+}
+
+int parsearRangos(const char* cabecera, uint32_t tamano, RangoBytes* rangos, int max) {
+  if (!cabecera || strncmp(cabecera, "bytes=", 6) != 0) return RANGO_IGNORAR;
+  const char* p = cabecera + 6;
+  int n = 0;
+  bool alguno = false;
+
+  for (;;) {
+    p = saltarEspacios(p);
+    uint32_t inicio = 0, fin = 0;
+    bool valido = true;
+
+    if (*p == '-') {
+      // Sufijo: los últimos N bytes
+      p++;
+      uint32_t sufijo;
+      if (!leerNumero(p, sufijo)) return RANGO_IGNORAR;
+      if (sufijo == 0 || tamano == 0) {
+        valido = false;
+      } else {
+        inicio = sufijo >= tamano ? 0 : tamano - sufijo;
+        fin = tamano - 1;
+      }
+    } else {
+      if (!leerNumero(p, inicio) || *p++ != '-') return RANGO_IGNORAR;
+      if (*p >= '0' && *p <= '9') {
+        if (!leerNumero(p, fin) || fin < inicio) return RANGO_IGNORAR;
+        if (fin >= tamano) fin = tamano - 1;
+      } else {
+        fin = tamano - 1;
+      }
+      valido = inicio < tamano;
+    }
+
+    alguno = true;
+    if (valido) {
+      if (n == max) return RANGO_IGNORAR;  // demasiados rangos: se sirve completo
+      rangos[n].inicio = inicio;
+      rangos[n].fin = fin;
+      n++;
+    }
+
+    p = saltarEspacios(p);
+    if (*p == '\0') break;
+    if (*p++ != ',') return RANGO_IGNORAR;
+  }
+
+  if (!alguno) return RANGO_IGNORAR;
+  return n > 0 ? n : RANGO_NO_SATISFACIBLE;
+}
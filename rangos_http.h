@@ -0,0 +1,24 @@
+// Peticiones HTTP Range (RFC 7233) para descargas reanudables
+// Solo unidades "bytes". Los rangos se devuelven ya resueltos contra el
+// tamaño del archivo (sufijos "-N" y finales abiertos "N-" incluidos).
+#pragma once
+#include <Arduino.h>
+
+#ifndef RANGOS_MAX
+#define RANGOS_MAX 8
+#endif
+
+struct RangoBytes {
+  uint32_t inicio;
+  uint32_t fin;  // inclusivo
+
+  uint32_t longitud() const { return fin - inicio + 1; }
+};
+
+enum ResultadoRango : int8_t {
+  RANGO_IGNORAR = 0,        // sin cabecera o con sintaxis no soportada: enviar todo (200)
+  RANGO_NO_SATISFACIBLE = -1 // ningún rango cae dentro del archivo: 416
+};
+
+// Devuelve cuántos rangos válidos se escribieron en rangos (1..max) o un ResultadoRango
+int parsearRangos(const char* cabecera, uint32_t tamano, RangoBytes* rangos, int max);
@@ -0,0 +1,259 @@
+#include "respaldo.h"
+#include "crc32.h"
+
+// Offsets dentro de la cabecera de un registro
+#define R_LEN 1
+#define R_SALTO 2
+#define R_SEQ 3
+#define R_POS 7
+#define R_CRC 11
+
+static uint32_t leerU32(const uint8_t* p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void ponerU32(uint8_t* p, uint32_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+void DiarioRespaldo::clave(uint8_t n, char* out) { snprintf(out, 6, "p%u", n); }
+
+#define CLAVE_ESQUEMA "esquema"
+
+// Los ids de texto identifican cada Clave: insertar, quitar o renombrar una cambia la huella
+uint32_t DiarioRespaldo::esquema() {
+  const uint8_t fijo[] = {RESPALDO_VERSION, K_TOTAL, TV_BYTES};
+  uint32_t crc = crc32(fijo, sizeof(fijo));
+  for (uint8_t k = 0; k < K_TOTAL; k++) {
+    const char* id = nombreClave(k);
+    crc = crc32(id, strlen(id) + 1, crc);
+  }
+  return crc;
+}
+
+void DiarioRespaldo::escribirEsquema() {
+  uint8_t v[4];
+  ponerU32(v, esquema());
+  prefs_.putBytes(CLAVE_ESQUEMA, v, sizeof(v));
+}
+
+bool DiarioRespaldo::leerPagina(uint8_t n, uint8_t* buf) {
+  char k[6];
+  clave(n, k);
+  size_t len = prefs_.isKey(k) ? prefs_.getBytes(k, buf, RESPALDO_PAGINA) : 0;
+  memset(buf + len, 0xFF, RESPALDO_PAGINA - len);
+  return len > 0;
+}
+
+// Solo los bytes usados: una página a medias ocupa menos entradas de NVS
+bool DiarioRespaldo::escribirPagina(uint8_t n) {
+  char k[6];
+  clave(n, k);
+  paginasEscritas_++;
+  entradas_ += entradasNVS(usado_);
+  return prefs_.putBytes(k, pagina_, usado_) == usado_;
+}
+
+bool DiarioRespaldo::registroValido(const uint8_t* p, uint16_t resto) {
+  if (resto < CABECERA || p[0] != MAGIA) return false;
+  uint8_t len = p[R_LEN];
+  if (len == 0 || CABECERA + len > resto) return false;
+  uint32_t crc = crc32(p, R_CRC);
+  return crc32(p + CABECERA, len, crc) == leerU32(p + R_CRC);
+}
+
+bool DiarioRespaldo::analizar(const uint8_t* buf, Pagina& pg) {
+  uint16_t off = 0;
+  bool alguno = false;
+  while (registroValido(buf + off, RESPALDO_PAGINA - off)) {
+    uint32_t seq = leerU32(buf + off + R_SEQ);
+    uint32_t pos = leerU32(buf + off + R_POS);
+    // Lo anterior a un salto de secuencia o de posición no encadena con esto
+    if (!alguno || seq != pg.ultimoSeq + 1 || pos != pg.finPos) {
+      pg.ini = off;
+      pg.primerSeq = seq;
+      pg.primerPos = pos;
+    }
+    pg.ultimoSeq = seq;
+    pg.finPos = pos + buf[off + R_LEN];
+    alguno = true;
+    off += CABECERA + buf[off + R_LEN];
+  }
+  pg.fin = off;
+  return alguno;
+}
+
+bool DiarioRespaldo::abrir() {
+  if (abierto_) return true;
+  abierto_ = prefs_.begin(RESPALDO_ESPACIO);
+  if (!abierto_) return false;
+  uint8_t v[4];
+  if (prefs_.getBytes(CLAVE_ESQUEMA, v, sizeof(v)) == sizeof(v) && leerU32(v) == esquema()) return true;
+  // Sin esquema (diario anterior a él) o de otro firmware: sus claves no significan lo mismo
+  char k[6];
+  for (uint8_t n = 0; n < RESPALDO_PAGINAS && !descartado_; n++) {
+    clave(n, k);
+    descartado_ = prefs_.isKey(k);
+  }
+  prefs_.clear();
+  escribirEsquema();
+  return true;
+}
+
+int DiarioRespaldo::buscarCabeza(Pagina* pg, bool* valida) {
+  int cabeza = -1;
+  for (uint8_t n = 0; n < RESPALDO_PAGINAS; n++) {
+    valida[n] = leerPagina(n, pagina_) && analizar(pagina_, pg[n]);
+    if (valida[n] && (cabeza < 0 || (int32_t)(pg[n].ultimoSeq - pg[cabeza].ultimoSeq) > 0)) cabeza = n;
+  }
+  if (cabeza < 0) {
+    actual_ = 0;
+    usado_ = 0;
+    memset(pagina_, 0xFF, sizeof(pagina_));
+    return -1;
+  }
+  // Se sigue escribiendo tras el último registro válido de la cabeza
+  leerPagina(cabeza, pagina_);
+  actual_ = cabeza;
+  usado_ = pg[cabeza].fin;
+  memset(pagina_ + usado_, 0xFF, RESPALDO_PAGINA - usado_);
+  seq_ = pg[cabeza].ultimoSeq + 1;
+  flujo_ = pg[cabeza].finPos;
+  return cabeza;
+}
+
+size_t DiarioRespaldo::recuperar(BitacoraResultados& b) {
+  uint32_t t0 = micros();
+  if (!abrir()) return 0;
+  Pagina pg[RESPALDO_PAGINAS];
+  bool valida[RESPALDO_PAGINAS];
+  int cabeza = buscarCabeza(pg, valida);
+  hasta_ = b.fin();
+  enBitacora_ = true;
+  if (cabeza < 0) {
+    recuperadoUs_ = micros() - t0;
+    return 0;
+  }
+
+  // Hacia atrás mientras cada página continúe donde acabó la anterior
+  uint8_t inicio = cabeza;
+  for (uint8_t k = 1; k < RESPALDO_PAGINAS; k++) {
+    uint8_t previa = (inicio + RESPALDO_PAGINAS - 1) % RESPALDO_PAGINAS;
+    if (!valida[previa] || pg[inicio].ini != 0 || pg[previa].ultimoSeq + 1 != pg[inicio].primerSeq ||
+        pg[previa].finPos != pg[inicio].primerPos) {
+      break;
+    }
+    inicio = previa;
+  }
+
+  // Hacia delante, desde el primer registro de la bitácora que empiece entero
+  static uint8_t reg[3 + 255];
+  uint16_t nReg = 0;
+  bool alineado = false;
+  size_t restaurados = 0;
+  for (uint8_t n = inicio;; n = (n + 1) % RESPALDO_PAGINAS) {
+    leerPagina(n, pagina_);
+    for (uint16_t off = pg[n].ini; off < pg[n].fin; off += CABECERA + pagina_[off + R_LEN]) {
+      const uint8_t* datos = pagina_ + off + CABECERA;
+      uint8_t len = pagina_[off + R_LEN];
+      uint16_t i = 0;
+      if (!alineado) {
+        if (pagina_[off + R_SALTO] == SIN_SALTO) continue;
+        i = pagina_[off + R_SALTO];
+        alineado = true;
+      }
+      for (; i < len; i++) {
+        reg[nReg++] = datos[i];
+        if (nReg >= 3 && nReg == 3 + reg[2]) {
+          if (b.importar(reg)) restaurados += nReg;
+          nReg = 0;
+        }
+      }
+    }
+    if (n == cabeza) break;
+  }
+  // pagina_ vuelve a tener la cabeza, que es donde se sigue escribiendo
+  memset(pagina_ + usado_, 0xFF, RESPALDO_PAGINA - usado_);
+  hasta_ = b.fin();
+  recuperadoUs_ = micros() - t0;
+  return restaurados;
+}
+
+size_t DiarioRespaldo::guardar(const BitacoraResultados& b) {
+  uint32_t t0 = micros();
+  if (!abierto_) {
+    if (!abrir()) return 0;
+    Pagina pg[RESPALDO_PAGINAS];
+    bool valida[RESPALDO_PAGINAS];
+    buscarCabeza(pg, valida);
+  }
+  if (!enBitacora_) {
+    // Lo del diario no es de esta bitácora: que no encadene con lo nuevo
+    hasta_ = b.primero();
+    flujo_++;
+    enBitacora_ = true;
+  }
+
+  BitacoraResultados::Registro r;
+  uint32_t desde = hasta_;
+  uint32_t fin = b.fin();
+  // Lo que la bitácora ya descartó, o lo que no cabría en el diario, es un hueco
+  uint32_t saltar = (int32_t)(b.primero() - desde) > 0 ? b.primero() : desde;
+  while (fin - saltar > capacidad() && b.leer(saltar, r)) {}
+  flujo_ += saltar - desde;
+  desde = saltar;
+
+  ultimasPaginas_ = 0;
+  size_t nuevos = fin - desde;
+  if (nuevos == 0) {
+    ultimoUs_ = micros() - t0;
+    return 0;
+  }
+
+  uint32_t frontera = desde;  // desde siempre empieza un registro
+  while (desde != fin) {
+    if (RESPALDO_PAGINA - usado_ <= CABECERA) {
+      escribirPagina(actual_);
+      ultimasPaginas_++;
+      actual_ = (actual_ + 1) % RESPALDO_PAGINAS;
+      usado_ = 0;
+      memset(pagina_, 0xFF, sizeof(pagina_));
+    }
+    uint8_t n = (uint8_t)min(fin - desde, (uint32_t)(RESPALDO_PAGINA - usado_ - CABECERA));
+    while ((int32_t)(frontera - desde) < 0 && b.leer(frontera, r)) {}
+    uint32_t salto = frontera - desde;
+
+    uint8_t* p = pagina_ + usado_;
+    p[0] = MAGIA;
+    p[R_LEN] = n;
+    p[R_SALTO] = (int32_t)salto >= 0 && salto < n ? (uint8_t)salto : SIN_SALTO;
+    ponerU32(p + R_SEQ, seq_);
+    ponerU32(p + R_POS, flujo_);
+    b.almacen().leer(desde, p + CABECERA, n);
+    ponerU32(p + R_CRC, crc32(p + CABECERA, n, crc32(p, R_CRC)));
+
+    usado_ += CABECERA + n;
+    seq_++;
+    flujo_ += n;
+    desde += n;
+  }
+  escribirPagina(actual_);
+  ultimasPaginas_++;
+  hasta_ = fin;
+  guardados_++;
+  ultimoUs_ = micros() - t0;
+  return nuevos;
+}
+
+void DiarioRespaldo::borrar() {
+  if (!abrir()) return;
+  prefs_.clear();
+  escribirEsquema();
+  actual_ = 0;
+  usado_ = 0;
+  memset(pagina_, 0xFF, sizeof(pagina_));
+  enBitacora_ = false;
+}
@@ -0,0 +1,123 @@
+// Respaldo de la bitácora en flash como diario de páginas
+// Antes cada exportación copiaba hasta 4 KB de historial a la EEPROM emulada
+// byte a byte y hacía commit(): el core guarda la EEPROM como un único blob de
+// NVS, así que cada copia reescribía los 4 KB enteros aunque casi todo fuera igual.
+//
+// Ahora el respaldo es un diario de solo añadir sobre RESPALDO_PAGINAS páginas de
+// RESPALDO_PAGINA bytes, cada una su propia clave de NVS (Preferences). Cada
+// guardar() añade solo lo escrito en la bitácora desde el anterior y reescribe
+// solo las páginas que tocó (la página en curso y las que llenó); el resto no se
+// vuelve a escribir. Al llenarse la última página se reutiliza la más antigua.
+//
+//   Registro del diario (nunca cruza una página):
+//     [magia u8][len u8][salto u8][secuencia u32][posición u32][CRC-32 u32][len bytes]
+//   posición: offset en el flujo de bytes respaldados (un hueco en la bitácora lo
+//   hace saltar); salto: offset en los datos del primer registro de la bitácora
+//   que empieza en este trozo (0xFF si ninguno); el CRC cubre cabecera y datos.
+//
+// NVS escribe cada clave de forma atómica, así que un corte de corriente deja la
+// página anterior o la nueva. Al arrancar, recuperar() lee cada página una vez,
+// busca la secuencia más alta y sigue hacia atrás mientras secuencia y posición
+// encadenen: devuelve a la bitácora la copia válida más reciente.
+//
+// Los registros guardan los números de Clave tal cual, y un firmware nuevo puede
+// renumerarlas. La clave "esquema" del espacio lleva una huella de la tabla de
+// claves y de RESPALDO_VERSION; si no coincide, las páginas se borran sin recuperar.
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include "resultados.h"
+
+// 16 x 256 B: lo mismo que ocupaba el blob de EEPROM
+#ifndef RESPALDO_PAGINAS
+#define RESPALDO_PAGINAS 16
+#endif
+#ifndef RESPALDO_PAGINA
+#define RESPALDO_PAGINA 256
+#endif
+static_assert(RESPALDO_PAGINA >= 64 && RESPALDO_PAGINA <= 256, "RESPALDO_PAGINA debe estar entre 64 y 256");
+static_assert(RESPALDO_PAGINAS >= 2 && RESPALDO_PAGINAS <= 100, "RESPALDO_PAGINAS fuera de rango");
+#define RESPALDO_ESPACIO "respaldo"
+// Cambiarla si cambia el formato del registro del diario
+#define RESPALDO_VERSION 1
+
+// Coste aproximado en NVS: entradas de 32 B, 126 por sector de 4 KB; un blob
+// ocupa sus datos más dos entradas (índice y cabecera). Un sector se borra cada
+// vez que se llena, así que los borrados crecen con las entradas escritas.
+#define NVS_ENTRADA 32
+#define NVS_ENTRADAS_SECTOR 126
+inline uint32_t entradasNVS(size_t bytesBlob) { return 2 + (uint32_t)((bytesBlob + NVS_ENTRADA - 1) / NVS_ENTRADA); }
+
+class DiarioRespaldo {
+public:
+  // Abre el espacio de NVS y devuelve a b la copia más reciente; bytes restaurados
+  size_t recuperar(BitacoraResultados& b);
+  // Añade al diario lo que b escribió desde el último guardar(); bytes nuevos
+  size_t guardar(const BitacoraResultados& b);
+  // Borra todas las páginas; el siguiente guardar() empieza de cero
+  void borrar();
+
+  uint32_t secuencia() const { return seq_; }
+  // Huella de RESPALDO_VERSION y de los ids de Clave y TipoValor de este firmware
+  static uint32_t esquema();
+  // Al abrir había páginas de otro esquema y se borraron
+  bool descartado() const { return descartado_; }
+  // Bytes de bitácora que el diario puede conservar
+  static constexpr size_t capacidad() { return (RESPALDO_PAGINAS - 1) * (RESPALDO_PAGINA - CABECERA); }
+
+  // Del último guardar()
+  uint32_t ultimoUs() const { return ultimoUs_; }
+  uint8_t ultimasPaginas() const { return ultimasPaginas_; }
+  // Acumulados
+  uint32_t guardados() const { return guardados_; }
+  uint32_t paginasEscritas() const { return paginasEscritas_; }
+  uint32_t entradasEscritas() const { return entradas_; }
+  // Lo que habría costado reescribir el blob entero en cada guardar()
+  uint32_t entradasSinDiario() const { return guardados_ * entradasNVS(RESPALDO_PAGINAS * RESPALDO_PAGINA); }
+  uint32_t recuperadoUs() const { return recuperadoUs_; }
+
+private:
+  static constexpr uint8_t MAGIA = 0xD1;
+  static constexpr uint8_t CABECERA = 15;
+  static constexpr uint8_t SIN_SALTO = 0xFF;
+
+  // Resumen de una página tras validarla: los registros [ini, fin) encadenan
+  // entre sí y terminan en el último válido
+  struct Pagina {
+    uint16_t ini;
+    uint16_t fin;
+    uint32_t primerSeq;
+    uint32_t ultimoSeq;
+    uint32_t primerPos;
+    uint32_t finPos;
+  };
+
+  // Abre el espacio; si el esquema guardado no es el de este firmware, lo vacía
+  bool abrir();
+  // Valida todas las páginas y deja listo el punto de escritura; -1 si no hay nada
+  int buscarCabeza(Pagina* pg, bool* valida);
+  bool leerPagina(uint8_t n, uint8_t* buf);
+  bool escribirPagina(uint8_t n);
+  static bool registroValido(const uint8_t* p, uint16_t resto);
+  static bool analizar(const uint8_t* buf, Pagina& pg);
+  static void clave(uint8_t n, char* out);
+  void escribirEsquema();
+
+  Preferences prefs_;
+  bool abierto_ = false;
+  bool descartado_ = false;
+  uint8_t pagina_[RESPALDO_PAGINA];  // página en curso
+  uint8_t actual_ = 0;
+  uint16_t usado_ = 0;
+  uint32_t seq_ = 0;        // secuencia del siguiente registro
+  uint32_t flujo_ = 0;      // posición en el diario del siguiente byte
+  uint32_t hasta_ = 0;      // posición de la bitácora ya respaldada
+  bool enBitacora_ = false; // hasta_ tiene sentido para la bitácora actual
+
+  uint32_t ultimoUs_ = 0;
+  uint8_t ultimasPaginas_ = 0;
+  uint32_t guardados_ = 0;
+  uint32_t paginasEscritas_ = 0;
+  uint32_t entradas_ = 0;
+  uint32_t recuperadoUs_ = 0;
+};
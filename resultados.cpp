@@ -0,0 +1,945 @@
+#include "resultados.h"
+#include "monitor_heap.h"
+#include <WiFi.h>
+#include <esp_system.h>
+
+// === CATÁLOGO DE SECCIONES Y CLAVES ===
+
+struct DefSeccion {
+  const char* id;
+  const char* titulo;
+  const char* subrayado;
+  const char* pie;
+};
+
+static const DefSeccion secciones[SEC_TOTAL] = {
+  {"chip", "🔍 ANÁLISIS DEL CHIP ESP32-C3 ", "============================================", "✅ Análisis del chip completado (modo seguro)"},
+  {"memoria", "🧠 ANÁLISIS DE MEMORIA", "=======================", "✅ Análisis de memoria completado"},
+  {"wifi", "📶 ANÁLISIS DE WIFI", "====================", "✅ Análisis WiFi completado"},
+  {"gpio", "🔌 ANÁLISIS DE GPIOS", "=====================", "✅ Análisis de GPIOs completado"},
+  {"sistema", "⚙️ ANÁLISIS DEL SISTEMA", "========================", "✅ Análisis del sistema completado"},
+  {"sensores", "🌡️ ANÁLISIS DE SENSORES", "=========================", "✅ Análisis de sensores completado"},
+  {"leds", "💡 TEST DE LEDS", "================", "💡 Test de LEDs completado\nℹ️ Si no viste LEDs, pueden estar en otros pines o no existir"},
+  {"benchmark", "🏃 BENCHMARK DE RENDIMIENTO", "============================", "✅ Benchmark completado"},
+  {"ble", "📡 ANÁLISIS DE BLUETOOTH", "=========================", "✅ Análisis de Bluetooth completado"},
+  {"heap", "🧩 PERFIL DEL HEAP", "==================", "✅ Perfil del heap completado"},
+};
+
+// Subtítulos: se imprimen al cambiar de grupo dentro de una sección
+static const char* const grupos[] = {
+  "📋 IDENTIFICACIÓN BÁSICA:",
+  "\n💾 INFORMACIÓN DE FLASH:",
+  "📊 HEAP PRINCIPAL:",
+  "\n🔍 DETALLES DEL HEAP:",
+  "\n🧪 TEST DE FRAGMENTACIÓN:",
+  "📡 INFORMACIÓN BÁSICA:",
+  "🔍 PINES DISPONIBLES:",
+  "\n🧪 EJECUTANDO TESTS:",
+  "\n📊 RESUMEN:",
+  "🔄 INFORMACIÓN DE ARRANQUE:",
+  "\n🕐 FRECUENCIAS DE RELOJ:",
+  "\n🔋 GESTIÓN DE ENERGÍA:",
+  "\n🌐 SERVIDOR WEB:",
+  "🌡️ SENSOR DE TEMPERATURA:",
+  "\n⏱️ SISTEMA DE TIMING:",
+  "\n📊 KERNELS (ciclos por llamada):",
+  "\n📊 RESUMEN DE ESCANEO BLE:",
+  "⚙️ CONFIGURACIÓN DE MEDIDA:",
+  "\n🔁 CONMUTACIÓN DE UN PIN (flancos cronometrados):",
+  "🧩 HEAPS POR CAPACIDAD:",
+  "\n📦 BARRIDO POR TAMAÑO (bloques a la vez):",
+};
+
+enum : int8_t {
+  G_NINGUNO = -1, G_ID, G_FLASH, G_HEAP, G_HEAP_DET, G_FRAG, G_WIFI_INFO, G_PINES, G_TESTS,
+  G_RESUMEN, G_ARRANQUE, G_RELOJ, G_ENERGIA, G_WEB, G_TEMP, G_TIMING, G_KERNELS, G_BLE_RESUMEN,
+  G_BENCH_CONF, G_TOGGLE, G_HEAP_CAPS, G_HEAP_CLASES
+};
+
+enum FormatoClave : uint8_t {
+  F_OCULTO,   // no aparece en el texto
+  F_NUM,      // "• Etiqueta: v<unidad>"
+  F_KB,       // bytes mostrados en KB
+  F_MB,       // bytes mostrados en MB (0 = no determinado)
+  F_MHZ,      // Hz mostrados en MHz
+  F_SINO,     // ✅ SÍ / ❌ NO
+  F_EXITO,    // ✅ Exitosa / ❌ Falló
+  F_TEXTO,
+  F_F1,       // float con 1 decimal
+  F_PINES,    // máscara de GPIOs como lista de números
+  F_ESPECIAL  // render propio en renderTexto()
+};
+
+struct DefClave {
+  const char* id;        // nombre para JSON/CSV
+  const char* etiqueta;
+  int8_t grupo;
+  uint8_t formato;
+  const char* unidad;
+};
+
+static const DefClave claves[K_TOTAL] = {
+  {"nota", "", G_NINGUNO, F_OCULTO, ""},
+  {"seccion", "", G_NINGUNO, F_OCULTO, ""},
+  {"fin_seccion", "", G_NINGUNO, F_OCULTO, ""},
+  {"ms", "", G_NINGUNO, F_OCULTO, ""},
+
+  {"chip.familia", "Familia", G_ID, F_TEXTO, ""},
+  {"chip.arquitectura", "Arquitectura", G_ID, F_TEXTO, ""},
+  {"chip.nucleos", "Núcleos", G_ID, F_NUM, ""},
+  {"chip.wifi", "WiFi", G_ID, F_SINO, ""},
+  {"chip.bluetooth", "Bluetooth", G_ID, F_SINO, ""},
+  {"chip.revision", "Revisión", G_ID, F_NUM, ""},
+  {"chip.id", "Chip ID", G_ID, F_TEXTO, ""},
+  {"flash.bytes", "Tamaño", G_FLASH, F_MB, ""},
+  {"flash.hz", "Velocidad", G_FLASH, F_MHZ, ""},
+  {"sketch.bytes", "Tamaño sketch", G_FLASH, F_KB, ""},
+  {"sketch.libre_bytes", "Espacio libre", G_FLASH, F_KB, ""},
+  {"sdk.version", "SDK Version", G_FLASH, F_TEXTO, ""},
+
+  {"heap.total_bytes", "Total", G_HEAP, F_KB, ""},
+  {"heap.libre_bytes", "Libre", G_HEAP, F_KB, ""},
+  {"heap.usado_bytes", "Usado", G_HEAP, F_KB, ""},
+  {"heap.utilizacion_pct", "Utilización", G_HEAP, F_NUM, "%"},
+  {"heap.bloques", "Bloques totales", G_HEAP_DET, F_NUM, ""},
+  {"heap.bloques_libres", "Bloques libres", G_HEAP_DET, F_NUM, ""},
+  {"heap.mayor_bloque_bytes", "Bloque más grande", G_HEAP_DET, F_NUM, " bytes"},
+  {"heap.bytes_libres", "Bytes libres", G_HEAP_DET, F_NUM, ""},
+  {"heap.fragmentacion_pct", "Fragmentación", G_HEAP_DET, F_NUM, "%"},
+  {"heap.test_malloc_1k", "Asignación de 1KB", G_FRAG, F_EXITO, ""},
+  {"heap.test_free", "Liberación", G_FRAG, F_EXITO, ""},
+
+  {"wifi.mac", "MAC Address", G_WIFI_INFO, F_TEXTO, ""},
+  {"wifi.modo", "Modo", G_WIFI_INFO, F_TEXTO, ""},
+  {"wifi.cache_edad_s", "Caché de hace", G_WIFI_INFO, F_NUM, " s"},
+  {"wifi.redes", "", G_NINGUNO, F_ESPECIAL, ""},
+  {"wifi.red.ssid", "", G_NINGUNO, F_ESPECIAL, ""},
+  {"wifi.red.seguridad", "", G_NINGUNO, F_ESPECIAL, ""},
+  {"wifi.red.rssi", "", G_NINGUNO, F_ESPECIAL, ""},
+  {"wifi.red.canal", "", G_NINGUNO, F_ESPECIAL, ""},
+  {"wifi.redes_extra", "", G_NINGUNO, F_ESPECIAL, ""},
+
+  {"gpio.perfil", "Perfil de placa", G_PINES, F_TEXTO, ""},
+  {"gpio.pines", "", G_PINES, F_ESPECIAL, ""},
+  {"gpio.reservados", "Reservados", G_PINES, F_TEXTO, ""},
+  {"gpio.pin", "", G_TESTS, F_ESPECIAL, ""},
+  {"gpio.corto", "", G_TESTS, F_ESPECIAL, ""},
+  {"gpio.flotantes", "Sin conexión externa (flotantes)", G_RESUMEN, F_PINES, ""},
+  {"gpio.fijos_alto", "Fijados a VCC desde fuera", G_RESUMEN, F_PINES, ""},
+  {"gpio.fijos_bajo", "Fijados a GND desde fuera", G_RESUMEN, F_PINES, ""},
+  {"gpio.funcionales", "", G_RESUMEN, F_ESPECIAL, ""},
+  {"gpio.problematicos", "", G_RESUMEN, F_ESPECIAL, ""},
+  {"gpio.duracion_us", "Duración del test", G_RESUMEN, F_NUM, " μs"},
+
+  {"sistema.reset", "Razón del reset", G_ARRANQUE, F_ESPECIAL, ""},
+  {"sistema.uptime_s", "Tiempo activo", G_ARRANQUE, F_NUM, " segundos"},
+  {"sistema.nucleo", "Núcleo actual", G_ARRANQUE, F_NUM, ""},
+  {"sistema.cpu_mhz", "CPU", G_RELOJ, F_NUM, " MHz"},
+  {"sistema.apb_hz", "APB", G_RELOJ, F_MHZ, ""},
+  {"sistema.xtal_mhz", "XTAL", G_RELOJ, F_NUM, " MHz"},
+  {"sistema.wakeup", "Wake-up causa", G_ENERGIA, F_NUM, ""},
+  {"sistema.modo_energia", "Modo actual", G_ENERGIA, F_TEXTO, ""},
+  {"web.activo", "Estado", G_WEB, F_ESPECIAL, ""},
+  {"web.red", "Red", G_WEB, F_TEXTO, ""},
+  {"web.ip", "IP", G_WEB, F_TEXTO, ""},
+
+  {"sensores.temperatura_c", "Temperatura del chip", G_TEMP, F_ESPECIAL, "°C"},
+  {"sensores.millis", "Millis()", G_TIMING, F_NUM, " ms"},
+  {"sensores.micros", "Micros()", G_TIMING, F_NUM, " μs"},
+  {"sensores.delay_100ms", "", G_TIMING, F_ESPECIAL, ""},
+
+  {"leds.candidatos", "", G_NINGUNO, F_ESPECIAL, ""},
+  {"leds.pin", "", G_NINGUNO, F_ESPECIAL, ""},
+  {"leds.parpadeos", "", G_NINGUNO, F_ESPECIAL, ""},
+
+  {"bench.cpu_mhz", "CPU", G_BENCH_CONF, F_ESPECIAL, " MHz"},
+  {"bench.muestras", "Muestras por kernel", G_BENCH_CONF, F_NUM, ""},
+  {"bench.sin_irq", "Interrupciones enmascaradas", G_BENCH_CONF, F_SINO, ""},
+  {"bench.sobrecoste", "Sobrecoste de medida", G_BENCH_CONF, F_NUM, " ciclos"},
+  {"bench.kernel", "", G_KERNELS, F_ESPECIAL, ""},
+  {"bench.toggle", "", G_TOGGLE, F_ESPECIAL, ""},
+
+  {"ble.iniciado", "", G_NINGUNO, F_ESPECIAL, ""},
+  {"ble.mac", "MAC Address", G_NINGUNO, F_TEXTO, ""},
+  {"ble.dispositivo", "", G_NINGUNO, F_ESPECIAL, ""},
+  {"ble.encontrados", "Dispositivos encontrados", G_BLE_RESUMEN, F_ESPECIAL, ""},
+  {"ble.paquetes", "Anuncios recibidos", G_BLE_RESUMEN, F_NUM, ""},
+  {"ble.tasa", "Tasa de anuncios", G_BLE_RESUMEN, F_F1, " paq/s"},
+  {"ble.expulsados", "Expulsados de la tabla (LRU)", G_BLE_RESUMEN, F_NUM, ""},
+  {"ble.descartados", "Anuncios descartados (cola llena)", G_BLE_RESUMEN, F_NUM, ""},
+  {"ble.cola_max", "Ocupación máxima de la cola", G_BLE_RESUMEN, F_NUM, " registros"},
+
+  {"heap.capacidad", "", G_HEAP_CAPS, F_ESPECIAL, ""},
+  {"heap.reserva_bytes", "Reserva que no se toca", G_HEAP_CLASES, F_NUM, " bytes"},
+  {"heap.clase", "", G_HEAP_CLASES, F_ESPECIAL, ""},
+  {"heap.max_asignable_bytes", "Mayor bloque asignable de verdad", G_RESUMEN, F_NUM, " bytes"},
+};
+
+const char* nombreSeccion(uint8_t s) { return s < SEC_TOTAL ? secciones[s].id : "general"; }
+const char* nombreClave(uint8_t k) { return k < K_TOTAL ? claves[k].id : "desconocida"; }
+
+// === TEXTOS AUXILIARES ===
+
+const char* textoRazonReset(uint32_t razon) {
+  switch (razon) {
+    case ESP_RST_POWERON: return "Power-On";
+    case ESP_RST_EXT: return "Reset externo";
+    case ESP_RST_SW: return "Software";
+    case ESP_RST_PANIC: return "Excepción/Pánico";
+    case ESP_RST_INT_WDT: return "Interrupt WDT";
+    case ESP_RST_TASK_WDT: return "Task WDT";
+    case ESP_RST_WDT: return "Other WDT";
+    case ESP_RST_DEEPSLEEP: return "Deep Sleep";
+    case ESP_RST_BROWNOUT: return "Brownout";
+    default: return "Desconocido";
+  }
+}
+
+const char* textoSeguridad(uint32_t tipo) {
+  switch (tipo) {
+    case WIFI_AUTH_OPEN: return "Abierta";
+    case WIFI_AUTH_WEP: return "WEP";
+    case WIFI_AUTH_WPA_PSK: return "WPA-PSK";
+    case WIFI_AUTH_WPA2_PSK: return "WPA2-PSK";
+    case WIFI_AUTH_WPA_WPA2_PSK: return "WPA/WPA2";
+    case WIFI_AUTH_WPA2_ENTERPRISE: return "WPA2-Enterprise";
+    case WIFI_AUTH_WPA3_PSK: return "WPA3-PSK";
+    default: return "Desconocida";
+  }
+}
+
+const char* textoCalidadRSSI(int32_t rssi) {
+  if (rssi > -30) return "Excelente";
+  else if (rssi > -50) return "Muy buena";
+  else if (rssi > -60) return "Buena";
+  else if (rssi > -70) return "Regular";
+  else return "Débil";
+}
+
+// === CODIFICACIÓN ===
+
+static uint8_t varint(uint8_t* out, uint32_t v) {
+  uint8_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+uint32_t BitacoraResultados::Registro::u32() const {
+  uint32_t v = 0;
+  for (uint8_t i = 0, shift = 0; i < len && shift < 35; i++, shift += 7) {
+    v |= (uint32_t)(datos[i] & 0x7F) << shift;
+    if (!(datos[i] & 0x80)) break;
+  }
+  return v;
+}
+
+int32_t BitacoraResultados::Registro::i32() const {
+  uint32_t z = u32();
+  return (int32_t)((z >> 1) ^ (~(z & 1) + 1));
+}
+
+float BitacoraResultados::Registro::f32() const {
+  float f = 0;
+  if (len == sizeof(f)) memcpy(&f, datos, sizeof(f));
+  return f;
+}
+
+void BitacoraResultados::escribir(uint8_t clave, uint8_t tipo, const void* datos, uint8_t len) {
+  uint8_t reg[3 + 255];
+  reg[0] = clave;
+  reg[1] = tipo;
+  reg[2] = len;
+  memcpy(reg + 3, datos, len);
+  size_t total = 3 + (size_t)len;
+
+  // Desalojar registros completos del principio hasta que quepa el nuevo
+  while (buf_.fin() + total - primero_ > HISTORY_MAX_LEN) {
+    uint8_t cab[3];
+    buf_.leer(primero_, cab, sizeof(cab));
+    primero_ += 3 + cab[2];
+  }
+  buf_.append((const char*)reg, total);
+}
+
+void BitacoraResultados::seccion(Seccion s) {
+  u32(K_SECCION, s);
+  u32(K_MARCA_TIEMPO, millis());
+}
+
+void BitacoraResultados::finSeccion(Seccion s) { u32(K_FIN_SECCION, s); }
+
+void BitacoraResultados::u32(Clave k, uint32_t v) {
+  uint8_t b[5];
+  escribir(k, TV_U32, b, varint(b, v));
+}
+
+void BitacoraResultados::i32(Clave k, int32_t v) {
+  uint8_t b[5];
+  uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+  escribir(k, TV_I32, b, varint(b, z));
+}
+
+void BitacoraResultados::f32(Clave k, float v) { escribir(k, TV_F32, &v, sizeof(v)); }
+
+void BitacoraResultados::booleano(Clave k, bool v) {
+  uint8_t b = v ? 1 : 0;
+  escribir(k, TV_BOOL, &b, 1);
+}
+
+void BitacoraResultados::texto(Clave k, const char* s) { texto(k, s, strlen(s)); }
+
+void BitacoraResultados::texto(Clave k, const char* s, size_t len) {
+  escribir(k, TV_TEXTO, s, (uint8_t)min(len, (size_t)255));
+}
+
+void BitacoraResultados::bytes(Clave k, const void* datos, uint8_t len) { escribir(k, TV_BYTES, datos, len); }
+
+void BitacoraResultados::nota(const char* s, size_t len) {
+  while (len > 0) {
+    uint8_t trozo = (uint8_t)min(len, (size_t)255);
+    escribir(K_NOTA, TV_TEXTO, s, trozo);
+    s += trozo;
+    len -= trozo;
+  }
+}
+
+bool BitacoraResultados::importar(const uint8_t* registro) {
+  if (registro[0] >= K_TOTAL || registro[1] > TV_BYTES) return false;
+  escribir(registro[0], registro[1], registro + 3, registro[2]);
+  return true;
+}
+
+void BitacoraResultados::limpiar() {
+  buf_.limpiar();
+  primero_ = buf_.fin();
+}
+
+bool BitacoraResultados::leer(uint32_t& pos, Registro& r) const {
+  for (;;) {
+    if ((int32_t)(pos - primero_) < 0) pos = primero_;
+    uint32_t fin = buf_.fin();
+    if (pos == fin) return false;
+    uint8_t cab[3];
+    buf_.leer(pos, cab, sizeof(cab));
+    r.clave = cab[0];
+    r.tipo = cab[1];
+    r.len = cab[2];
+    buf_.leer(pos + 3, r.datos, r.len);
+    // Si un escritor pisó el registro mientras se leía, reanudar desde el más antiguo
+    if (buf_.fin() - pos > HISTORY_MAX_LEN) {
+      pos = primero_;
+      continue;
+    }
+    pos += 3 + r.len;
+    return true;
+  }
+}
+
+// === RENDER DE TEXTO ===
+
+static uint32_t leerU32LE(const uint8_t* p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+void imprimirMascara(Print& out, uint32_t mascara, const char* separador) {
+  bool primero = true;
+  for (uint8_t pin = 0; pin < 32; pin++) {
+    if (!(mascara & (1UL << pin))) continue;
+    if (!primero) out.print(separador);
+    out.print((unsigned)pin);
+    primero = false;
+  }
+}
+
+void imprimirMac(Print& out, const uint8_t* m) {
+  static const char hex[] = "0123456789abcdef";
+  char txt[18];
+  for (int i = 0; i < 6; i++) {
+    txt[i * 3] = hex[m[i] >> 4];
+    txt[i * 3 + 1] = hex[m[i] & 0xF];
+    txt[i * 3 + 2] = i < 5 ? ':' : '\0';
+  }
+  out.print(txt);
+}
+
+void BitacoraResultados::renderTexto(Print& out, const Registro& r, CursorRender& c, bool incluirNotas) const {
+  if (r.clave == K_NOTA) {
+    if (incluirNotas) out.write(r.datos, r.len);
+    return;
+  }
+  if (r.clave == K_SECCION) {
+    c.seccion = (uint8_t)r.u32();
+    c.grupo = G_NINGUNO;
+    c.item = 0;
+    if (c.seccion < SEC_TOTAL) {
+      out.print("\n");
+      out.print(secciones[c.seccion].titulo);
+      out.print("\n");
+      out.print(secciones[c.seccion].subrayado);
+      out.print("\n");
+    }
+    return;
+  }
+  if (r.clave == K_FIN_SECCION) {
+    uint32_t s = r.u32();
+    if (s < SEC_TOTAL) {
+      out.print("\n");
+      out.print(secciones[s].pie);
+      out.print("\n");
+    }
+    c.seccion = SEC_TOTAL;
+    return;
+  }
+  if (r.clave >= K_TOTAL) return;
+
+  const DefClave& d = claves[r.clave];
+  if (d.formato == F_OCULTO) return;
+  if (d.grupo != G_NINGUNO && d.grupo != c.grupo) {
+    out.println(grupos[d.grupo]);
+    c.grupo = d.grupo;
+  }
+
+  if (d.formato != F_ESPECIAL) {
+    out.print("• ");
+    out.print(d.etiqueta);
+    out.print(": ");
+  }
+
+  switch (d.formato) {
+    case F_NUM:
+      if (r.tipo == TV_I32) out.print((long)r.i32());
+      else out.print((unsigned long)r.u32());
+      out.println(d.unidad);
+      return;
+    case F_KB:
+      out.print((unsigned long)(r.u32() / 1024));
+      out.println(" KB");
+      return;
+    case F_MB:
+      if (r.u32() == 0) {
+        out.println("No determinado");
+      } else {
+        out.print((unsigned long)(r.u32() / (1024 * 1024)));
+        out.println(" MB");
+      }
+      return;
+    case F_MHZ:
+      out.print((unsigned long)(r.u32() / 1000000));
+      out.println(" MHz");
+      return;
+    case F_SINO:
+      out.println(r.booleano() ? "✅ SÍ" : "❌ NO");
+      return;
+    case F_EXITO:
+      out.println(r.booleano() ? "✅ Exitosa" : "❌ Falló");
+      return;
+    case F_TEXTO:
+      out.write(r.datos, r.len);
+      out.println();
+      return;
+    case F_F1:
+      out.print(r.f32(), 1);
+      out.println(d.unidad);
+      return;
+    case F_PINES:
+      imprimirMascara(out, r.u32(), " ");
+      out.println();
+      return;
+    default:
+      break;
+  }
+
+  // Formatos especiales
+  switch (r.clave) {
+    case K_WIFI_REDES:
+      if (r.u32() > 0) {
+        out.print("\n📋 REDES ENCONTRADAS (");
+        out.print((unsigned long)r.u32());
+        out.println("):");
+      } else {
+        out.println("\n❌ No se encontraron redes WiFi");
+      }
+      break;
+    case K_RED_SSID:
+      c.item++;
+      out.print("  ");
+      out.print((unsigned)c.item);
+      out.print(". ");
+      out.write(r.datos, r.len);
+      out.println();
+      break;
+    case K_RED_SEGURIDAD:
+      c.aux1 = (int32_t)r.u32();
+      break;
+    case K_RED_RSSI:
+      c.aux2 = r.i32();
+      break;
+    case K_RED_CANAL:
+      out.print("     🔒 ");
+      out.print(textoSeguridad(c.aux1));
+      out.print(" | 📶 ");
+      out.print(textoCalidadRSSI(c.aux2));
+      out.print(" (");
+      out.print((long)c.aux2);
+      out.print("dBm) | 📺 Ch");
+      out.println((unsigned long)r.u32());
+      break;
+    case K_WIFI_REDES_EXTRA:
+      out.print("  ... y ");
+      out.print((unsigned long)r.u32());
+      out.println(" redes más");
+      break;
+    case K_GPIO_PINES:
+      out.print("• Testeando: ");
+      imprimirMascara(out, r.u32(), ", ");
+      out.println();
+      break;
+    case K_GPIO_PIN:
+      out.print("  GPIO ");
+      out.print((unsigned)r.datos[0]);
+      out.println(r.len > 1 && r.datos[1] ? ": ✅ Funcional" : ": ⚠️ Problemático");
+      break;
+    case K_GPIO_CORTO:
+      if (r.len < 3) break;
+      out.print("  ⚡ Corto GPIO ");
+      out.print((unsigned)r.datos[0]);
+      out.print(" ↔ GPIO ");
+      out.print((unsigned)r.datos[1]);
+      out.println(r.datos[2] ? " (pines vecinos)" : "");
+      break;
+    case K_GPIO_FUNCIONALES:
+      out.print("• Funcionales (");
+      out.print((unsigned)__builtin_popcount(r.u32()));
+      out.print("): ");
+      imprimirMascara(out, r.u32(), " ");
+      out.println();
+      break;
+    case K_GPIO_PROBLEMATICOS:
+      out.print("• Problemáticos: ");
+      imprimirMascara(out, r.u32(), " ");
+      out.println();
+      break;
+    case K_RESET_RAZON:
+      out.print("• Razón del reset: ");
+      out.println(textoRazonReset(r.u32()));
+      break;
+    case K_WEB_ACTIVO:
+      out.println(r.booleano() ? "• Estado: ✅ Activo" : "• Estado: ❌ Inactivo");
+      break;
+    case K_TEMPERATURA: {
+      float t = r.f32();
+      out.print("• Temperatura del chip: ");
+      out.print(t, 1);
+      out.print("°C");
+      if (t > 80) out.println(" 🔥 ADVERTENCIA: Temperatura muy alta!");
+      else if (t > 60) out.println(" ⚠️ Temperatura elevada");
+      else out.println(" ✅ Temperatura normal");
+      break;
+    }
+    case K_DELAY_100MS: {
+      uint32_t ms = r.u32();
+      out.print("🎯 Test de precisión delay(100ms): ");
+      out.print((unsigned long)ms);
+      out.println("ms");
+      if (ms >= 98 && ms <= 102) {
+        out.println("✅ Excelente precisión");
+      } else {
+        out.print("⚠️ Desviación: ");
+        out.print((long)abs((int)(ms - 100)));
+        out.println("ms");
+      }
+      break;
+    }
+    case K_LEDS_CANDIDATOS:
+      out.print("\n🔍 Probando ");
+      out.print((unsigned long)r.u32());
+      out.println(" posibles ubicaciones de LEDs");
+      out.println("👀 Observa la placa durante cada test...\n");
+      break;
+    case K_LED_PIN:
+      out.print("🧪 Testeando GPIO");
+      out.print((unsigned long)r.u32());
+      out.print(":\n   Parpadeando: ");
+      break;
+    case K_LED_PARPADEOS:
+      for (uint32_t i = 0; i < r.u32(); i++) out.print("●");
+      out.println(" [Completado]");
+      break;
+    case K_BENCH_CPU_MHZ:
+      c.aux1 = (int32_t)r.u32();  // para pasar ciclos/op a Mops/s en los kernels
+      out.print("• CPU: ");
+      out.print((unsigned long)r.u32());
+      out.println(" MHz");
+      break;
+    case K_BENCH_KERNEL: {
+      if (r.len < BENCH_KERNEL_CABECERA) break;
+      uint32_t ops = leerU32LE(r.datos + 20);
+      float cpo = ops ? (float)leerU32LE(r.datos + 4) / ops : 0.0f;
+      char linea[96];
+      snprintf(linea, sizeof(linea), " mediana %8lu | mín %8lu | p95 %8lu | σ %6lu | %8.2f ciclos/op",
+               (unsigned long)leerU32LE(r.datos + 4), (unsigned long)leerU32LE(r.datos),
+               (unsigned long)leerU32LE(r.datos + 8), (unsigned long)leerU32LE(r.datos + 16), cpo);
+      out.print("  ⏱️ ");
+      uint8_t longNombre = r.len - BENCH_KERNEL_CABECERA;
+      out.write(r.datos + BENCH_KERNEL_CABECERA, longNombre);
+      for (uint8_t i = longNombre; i < 18; i++) out.print(' ');
+      out.print(linea);
+      if (c.aux1 > 0 && cpo > 0) {
+        out.print(" (");
+        out.print(c.aux1 / cpo, 1);
+        out.print(" Mops/s)");
+      }
+      out.println(r.datos[24] & 1 ? "" : " [con IRQ]");
+      break;
+    }
+    case K_BENCH_TOGGLE: {
+      if (r.len < BENCH_TOGGLE_CABECERA) break;
+      uint32_t hz = leerU32LE(r.datos);
+      uint32_t minimo = leerU32LE(r.datos + 4), maximo = leerU32LE(r.datos + 8);
+      char linea[112];
+      snprintf(linea, sizeof(linea), " %9.1f kHz | flanco %7.2f ciclos (mín %lu, máx %lu) | jitter %lu ciclos p-p, σ ",
+               hz / 1000.0f, leerU32LE(r.datos + 12) / 100.0f, (unsigned long)minimo, (unsigned long)maximo,
+               (unsigned long)(maximo - minimo));
+      out.print("  🔁 ");
+      uint8_t longNombre = r.len - BENCH_TOGGLE_CABECERA;
+      out.write(r.datos + BENCH_TOGGLE_CABECERA, longNombre);
+      for (uint8_t i = longNombre; i < 18; i++) out.print(' ');
+      out.print(linea);
+      out.println(leerU32LE(r.datos + 16) / 100.0f, 2);
+      break;
+    }
+    case K_HEAP_CAPACIDAD: {
+      if (r.len < HEAP_CAPACIDAD_CABECERA) break;
+      char linea[112];
+      snprintf(linea, sizeof(linea), " total %7.1f KB | libre %7.1f KB | mayor bloque %7lu B | %4lu bloques libres | frag %3u%%",
+               leerU32LE(r.datos) / 1024.0f, leerU32LE(r.datos + 4) / 1024.0f, (unsigned long)leerU32LE(r.datos + 8),
+               (unsigned long)leerU32LE(r.datos + 16), (unsigned)r.datos[20]);
+      out.print("  🧩 ");
+      uint8_t longNombre = r.len - HEAP_CAPACIDAD_CABECERA;
+      out.write(r.datos + HEAP_CAPACIDAD_CABECERA, longNombre);
+      for (uint8_t i = longNombre; i < 8; i++) out.print(' ');
+      out.println(linea);
+      break;
+    }
+    case K_HEAP_CLASE: {
+      if (r.len < HEAP_CLASE_CABECERA) break;
+      uint32_t tam = leerU32LE(r.datos), bloques = leerU32LE(r.datos + 4);
+      char linea[96];
+      snprintf(linea, sizeof(linea), "  📦 %6lu B x %6lu bloques = %7.1f KB de %7.1f KB libres (%s)", (unsigned long)tam,
+               (unsigned long)bloques, (float)tam * bloques / 1024.0f, leerU32LE(r.datos + 8) / 1024.0f,
+               nombreMotivoBarrido(r.datos[12]));
+      out.println(linea);
+      break;
+    }
+    case K_BLE_INICIADO:
+      out.println(r.booleano() ? "• BLE Initialized: ✅" : "• BLE Already Initialized: ✅");
+      break;
+    case K_BLE_DISPOSITIVO:
+      if (r.len < BLE_DISPOSITIVO_CABECERA) break;
+      out.print("  📱 ");
+      if (r.len > BLE_DISPOSITIVO_CABECERA) out.write(r.datos + BLE_DISPOSITIVO_CABECERA, r.len - BLE_DISPOSITIVO_CABECERA);
+      else out.print("[Sin nombre]");
+      out.print(" | ");
+      imprimirMac(out, r.datos);
+      out.print(" | ");
+      out.print((long)(int8_t)r.datos[6]);
+      out.print("dBm (");
+      out.print((long)(int8_t)r.datos[7]);
+      out.print("/");
+      out.print((long)(int8_t)r.datos[8]);
+      out.print(") | ");
+      out.print((unsigned)(r.datos[9] | r.datos[10] << 8));
+      out.println(" paq");
+      break;
+    case K_BLE_ENCONTRADOS:
+      out.print("• Dispositivos encontrados: ");
+      out.println((unsigned long)r.u32());
+      if (r.u32() == 0) out.println("• No se encontraron dispositivos BLE.");
+      break;
+    default:
+      break;
+  }
+}
+
+void BitacoraResultados::mostrar(Print& out, CursorRender& cursor) const {
+  Registro r;
+  while (leer(cursor.pos, r)) renderTexto(out, r, cursor, false);
+}
+
+bool BitacoraResultados::mostrarSiguiente(Print& out, CursorRender& cursor) const {
+  Registro r;
+  if (!leer(cursor.pos, r)) return false;
+  renderTexto(out, r, cursor, false);
+  return true;
+}
+
+// === EXPORTACIÓN JSON / CSV ===
+
+void imprimirTextoJSON(Print& out, const uint8_t* s, size_t len) {
+  out.print('"');
+  size_t tramo = 0;  // inicio de la racha de bytes que no necesitan escape
+  for (size_t i = 0; i < len; i++) {
+    uint8_t ch = s[i];
+    if (ch != '"' && ch != '\\' && ch >= 0x20) continue;
+    out.write(s + tramo, i - tramo);
+    if (ch < 0x20) {
+      char esc[7];
+      snprintf(esc, sizeof(esc), "\\u%04x", ch);
+      out.print(esc);
+    } else {
+      out.print('\\');
+      out.print((char)ch);
+    }
+    tramo = i + 1;
+  }
+  out.write(s + tramo, len - tramo);
+  out.print('"');
+}
+
+static void imprimirTextoCSV(Print& out, const uint8_t* s, size_t len) {
+  out.print('"');
+  for (size_t i = 0; i < len; i++) {
+    if (s[i] == '"') out.print('"');
+    out.print((char)s[i]);
+  }
+  out.print('"');
+}
+
+static void imprimirValorMaquina(Print& out, const BitacoraResultados::Registro& r, bool json) {
+  switch (r.tipo) {
+    case TV_U32: out.print((unsigned long)r.u32()); return;
+    case TV_I32: out.print((long)r.i32()); return;
+    case TV_F32: {
+      float f = r.f32();
+      if (isnan(f) || isinf(f)) out.print(json ? "null" : "");
+      else out.print(f, 3);
+      return;
+    }
+    case TV_BOOL: out.print(r.booleano() ? "true" : "false"); return;
+    case TV_TEXTO:
+      if (json) imprimirTextoJSON(out, r.datos, r.len);
+      else imprimirTextoCSV(out, r.datos, r.len);
+      return;
+    default: break;
+  }
+  // TV_BYTES con estructura conocida
+  if (r.clave == K_BLE_DISPOSITIVO && r.len >= BLE_DISPOSITIVO_CABECERA) {
+    const uint8_t* nombre = r.datos + BLE_DISPOSITIVO_CABECERA;
+    uint8_t longNombre = r.len - BLE_DISPOSITIVO_CABECERA;
+    unsigned paquetes = r.datos[9] | r.datos[10] << 8;
+    if (json) {
+      out.print("{\"mac\":\"");
+      imprimirMac(out, r.datos);
+      out.print("\",\"rssi\":");
+      out.print((long)(int8_t)r.datos[6]);
+      out.print(",\"rssi_min\":");
+      out.print((long)(int8_t)r.datos[7]);
+      out.print(",\"rssi_max\":");
+      out.print((long)(int8_t)r.datos[8]);
+      out.print(",\"paquetes\":");
+      out.print(paquetes);
+      out.print(",\"nombre\":");
+      imprimirTextoJSON(out, nombre, longNombre);
+      out.print('}');
+    } else {
+      out.print('"');
+      imprimirMac(out, r.datos);
+      out.print(' ');
+      out.print((long)(int8_t)r.datos[6]);
+      out.print(' ');
+      out.print(paquetes);
+      out.print(' ');
+      for (uint8_t i = 0; i < longNombre; i++) out.print(nombre[i] == '"' ? '\'' : (char)nombre[i]);
+      out.print('"');
+    }
+  } else if (r.clave == K_BENCH_KERNEL && r.len >= BENCH_KERNEL_CABECERA) {
+    const uint8_t* nombre = r.datos + BENCH_KERNEL_CABECERA;
+    uint8_t longNombre = r.len - BENCH_KERNEL_CABECERA;
+    uint32_t ops = leerU32LE(r.datos + 20);
+    float cpo = ops ? (float)leerU32LE(r.datos + 4) / ops : 0.0f;
+    if (json) {
+      static const char* const campos[] = {"min", "mediana", "p95", "max", "desviacion", "ops"};
+      out.print("{\"kernel\":");
+      imprimirTextoJSON(out, nombre, longNombre);
+      for (int i = 0; i < 6; i++) {
+        out.print(",\"");
+        out.print(campos[i]);
+        out.print("\":");
+        out.print((unsigned long)leerU32LE(r.datos + 4 * i));
+      }
+      out.print(",\"ciclos_op\":");
+      out.print(cpo, 3);
+      out.print(",\"sin_irq\":");
+      out.print(r.datos[24] & 1 ? "true}" : "false}");
+    } else {
+      out.print('"');
+      out.write(nombre, longNombre);
+      out.print(' ');
+      out.print((unsigned long)leerU32LE(r.datos + 4));
+      out.print(' ');
+      out.print((unsigned long)leerU32LE(r.datos + 8));
+      out.print(' ');
+      out.print(cpo, 3);
+      out.print('"');
+    }
+  } else if (r.clave == K_BENCH_TOGGLE && r.len >= BENCH_TOGGLE_CABECERA) {
+    const uint8_t* nombre = r.datos + BENCH_TOGGLE_CABECERA;
+    uint8_t longNombre = r.len - BENCH_TOGGLE_CABECERA;
+    if (json) {
+      out.print("{\"metodo\":");
+      imprimirTextoJSON(out, nombre, longNombre);
+      out.print(",\"frecuencia_hz\":");
+      out.print((unsigned long)leerU32LE(r.datos));
+      out.print(",\"ciclos_min\":");
+      out.print((unsigned long)leerU32LE(r.datos + 4));
+      out.print(",\"ciclos_max\":");
+      out.print((unsigned long)leerU32LE(r.datos + 8));
+      out.print(",\"ciclos_media\":");
+      out.print(leerU32LE(r.datos + 12) / 100.0f, 2);
+      out.print(",\"desviacion\":");
+      out.print(leerU32LE(r.datos + 16) / 100.0f, 2);
+      out.print('}');
+    } else {
+      out.print('"');
+      out.write(nombre, longNombre);
+      out.print(' ');
+      out.print((unsigned long)leerU32LE(r.datos));
+      out.print("Hz jitter ");
+      out.print((unsigned long)(leerU32LE(r.datos + 8) - leerU32LE(r.datos + 4)));
+      out.print('"');
+    }
+  } else if (r.clave == K_HEAP_CAPACIDAD && r.len >= HEAP_CAPACIDAD_CABECERA) {
+    const uint8_t* nombre = r.datos + HEAP_CAPACIDAD_CABECERA;
+    uint8_t longNombre = r.len - HEAP_CAPACIDAD_CABECERA;
+    if (json) {
+      static const char* const campos[] = {"total", "libre", "mayor_bloque", "minimo_libre", "bloques_libres"};
+      out.print("{\"capacidad\":");
+      imprimirTextoJSON(out, nombre, longNombre);
+      for (int i = 0; i < 5; i++) {
+        out.print(",\"");
+        out.print(campos[i]);
+        out.print("\":");
+        out.print((unsigned long)leerU32LE(r.datos + 4 * i));
+      }
+      out.print(",\"fragmentacion\":");
+      out.print((unsigned)r.datos[20]);
+      out.print('}');
+    } else {
+      out.print('"');
+      out.write(nombre, longNombre);
+      out.print(' ');
+      out.print((unsigned long)leerU32LE(r.datos + 4));
+      out.print(' ');
+      out.print((unsigned long)leerU32LE(r.datos + 8));
+      out.print(' ');
+      out.print((unsigned)r.datos[20]);
+      out.print("%\"");
+    }
+  } else if (r.clave == K_HEAP_CLASE && r.len >= HEAP_CLASE_CABECERA) {
+    if (json) {
+      out.print("{\"tam\":");
+      out.print((unsigned long)leerU32LE(r.datos));
+      out.print(",\"bloques\":");
+      out.print((unsigned long)leerU32LE(r.datos + 4));
+      out.print(",\"libre_antes\":");
+      out.print((unsigned long)leerU32LE(r.datos + 8));
+      out.print(",\"motivo\":\"");
+      out.print(nombreMotivoBarrido(r.datos[12]));
+      out.print("\"}");
+    } else {
+      out.print((unsigned long)leerU32LE(r.datos));
+      out.print('x');
+      out.print((unsigned long)leerU32LE(r.datos + 4));
+    }
+  } else if (r.clave == K_GPIO_CORTO && r.len >= 3) {
+    if (json) {
+      out.print("{\"a\":");
+      out.print((unsigned)r.datos[0]);
+      out.print(",\"b\":");
+      out.print((unsigned)r.datos[1]);
+      out.print(",\"vecinos\":");
+      out.print(r.datos[2] ? "true}" : "false}");
+    } else {
+      out.print((unsigned)r.datos[0]);
+      out.print('-');
+      out.print((unsigned)r.datos[1]);
+    }
+  } else if (r.clave == K_GPIO_PIN && r.len >= 2) {
+    if (json) {
+      out.print("{\"pin\":");
+      out.print((unsigned)r.datos[0]);
+      out.print(",\"ok\":");
+      out.print(r.datos[1] ? "true}" : "false}");
+    } else {
+      out.print((unsigned)r.datos[0]);
+      out.print(r.datos[1] ? ":ok" : ":fallo");
+    }
+  } else {
+    static const char hex[] = "0123456789abcdef";
+    out.print('"');
+    for (uint8_t i = 0; i < r.len; i++) {
+      out.print(hex[r.datos[i] >> 4]);
+      out.print(hex[r.datos[i] & 0xF]);
+    }
+    out.print('"');
+  }
+}
+
+void BitacoraResultados::exportar(Print& out, FormatoSalida formato) const {
+  uint32_t pos = primero_;
+  Registro r;
+
+  if (formato == FMT_TXT) {
+    CursorRender c;
+    while (leer(pos, r)) renderTexto(out, r, c, true);
+    return;
+  }
+
+  bool json = formato == FMT_JSON;
+  if (json) out.print("{\"dispositivo\":\"ESP32-C3\",\"registros\":[");
+  else out.println("ms,seccion,clave,valor");
+
+  uint8_t seccionActual = SEC_TOTAL;
+  uint32_t msActual = 0;
+  bool primero = true;
+  while (leer(pos, r)) {
+    if (r.clave == K_SECCION) {
+      seccionActual = (uint8_t)r.u32();
+      continue;
+    }
+    if (r.clave == K_MARCA_TIEMPO) {
+      msActual = r.u32();
+      continue;
+    }
+    if (r.clave == K_FIN_SECCION) {
+      seccionActual = SEC_TOTAL;
+      continue;
+    }
+    if (json) {
+      out.print(primero ? "\n{\"ms\":" : ",\n{\"ms\":");
+      out.print((unsigned long)msActual);
+      out.print(",\"seccion\":\"");
+      out.print(nombreSeccion(seccionActual));
+      out.print("\",\"clave\":\"");
+      out.print(nombreClave(r.clave));
+      out.print("\",\"valor\":");
+      imprimirValorMaquina(out, r, true);
+      out.print('}');
+    } else {
+      out.print((unsigned long)msActual);
+      out.print(',');
+      out.print(nombreSeccion(seccionActual));
+      out.print(',');
+      out.print(nombreClave(r.clave));
+      out.print(',');
+      imprimirValorMaquina(out, r, false);
+      out.println();
+    }
+    primero = false;
+  }
+  if (json) out.print("\n]}\n");
+}
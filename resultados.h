@@ -0,0 +1,227 @@
+// Resultados estructurados del explorador
+// Cada sección emite registros tipados (clave, tipo, valor) a una bitácora binaria
+// compacta sobre el historial circular. El texto para Serial/TXT y las
+// exportaciones JSON/CSV se generan al vuelo desde los registros, solo cuando se piden.
+//
+// Formato de un registro: [clave u8][tipo u8][len u8][len bytes de valor]
+//   U32/I32 -> varint (I32 en zigzag), F32 -> 4 bytes, BOOL -> 1 byte,
+//   TEXTO/BYTES -> bytes tal cual (máx. 255)
+#pragma once
+#include <Arduino.h>
+#include "historial.h"
+
+// Tamaño del historial circular en RAM; se puede cambiar con -DHISTORY_MAX_LEN=...
+#ifndef HISTORY_MAX_LEN
+#define HISTORY_MAX_LEN 4000
+#endif
+
+enum TipoValor : uint8_t { TV_U32, TV_I32, TV_F32, TV_BOOL, TV_TEXTO, TV_BYTES };
+
+enum Seccion : uint8_t {
+  SEC_CHIP,
+  SEC_MEMORIA,
+  SEC_WIFI,
+  SEC_GPIO,
+  SEC_SISTEMA,
+  SEC_SENSORES,
+  SEC_LEDS,
+  SEC_BENCHMARK,
+  SEC_BLE,
+  SEC_HEAP,
+  SEC_TOTAL
+};
+
+// El orden debe coincidir con la tabla de claves en resultados.cpp
+enum Clave : uint8_t {
+  K_NOTA,           // texto libre de addToHistory (no se muestra por Serial)
+  K_SECCION,        // inicio de sección: u32 = Seccion
+  K_FIN_SECCION,    // fin de sección: u32 = Seccion
+  K_MARCA_TIEMPO,   // u32 millis() al iniciar la sección
+
+  K_CHIP_FAMILIA,
+  K_CHIP_ARQUITECTURA,
+  K_CHIP_NUCLEOS,
+  K_CHIP_WIFI,
+  K_CHIP_BT,
+  K_CHIP_REVISION,
+  K_CHIP_ID,
+  K_FLASH_TAMANO,
+  K_FLASH_VELOCIDAD,
+  K_SKETCH_TAMANO,
+  K_SKETCH_LIBRE,
+  K_SDK_VERSION,
+
+  K_HEAP_TOTAL,
+  K_HEAP_LIBRE,
+  K_HEAP_USADO,
+  K_HEAP_UTILIZACION,
+  K_HEAP_BLOQUES,
+  K_HEAP_BLOQUES_LIBRES,
+  K_HEAP_MAYOR_BLOQUE,
+  K_HEAP_BYTES_LIBRES,
+  K_HEAP_FRAGMENTACION,  // u32 % = 100 * (1 - mayor bloque / libre)
+  K_HEAP_TEST_ASIGNACION,
+  K_HEAP_TEST_LIBERACION,
+
+  K_WIFI_MAC,
+  K_WIFI_MODO,
+  K_WIFI_CACHE_EDAD,  // u32 s: resultados servidos desde la caché
+  K_WIFI_REDES,
+  K_RED_SSID,
+  K_RED_SEGURIDAD,
+  K_RED_RSSI,
+  K_RED_CANAL,
+  K_WIFI_REDES_EXTRA,
+
+  K_GPIO_PERFIL,
+  K_GPIO_PINES,
+  K_GPIO_RESERVADOS,
+  K_GPIO_PIN,
+  K_GPIO_CORTO,        // bytes: gpio a, gpio b, vecinos en el conector (0/1)
+  K_GPIO_FLOTANTES,    // máscaras de pines
+  K_GPIO_FIJOS_ALTO,
+  K_GPIO_FIJOS_BAJO,
+  K_GPIO_FUNCIONALES,
+  K_GPIO_PROBLEMATICOS,
+  K_GPIO_DURACION_US,
+
+  K_RESET_RAZON,
+  K_UPTIME,
+  K_NUCLEO_ACTUAL,
+  K_CPU_FREQ,
+  K_APB_FREQ,
+  K_XTAL_FREQ,
+  K_WAKEUP_CAUSA,
+  K_MODO_ENERGIA,
+  K_WEB_ACTIVO,
+  K_WEB_RED,
+  K_WEB_IP,
+
+  K_TEMPERATURA,
+  K_MILLIS,
+  K_MICROS,
+  K_DELAY_100MS,
+
+  K_LEDS_CANDIDATOS,
+  K_LED_PIN,
+  K_LED_PARPADEOS,
+
+  K_BENCH_CPU_MHZ,
+  K_BENCH_MUESTRAS,
+  K_BENCH_SIN_IRQ,
+  K_BENCH_SOBRECOSTE,  // u32 ciclos restados a cada muestra
+  K_BENCH_KERNEL,      // bytes: ver BENCH_KERNEL_CABECERA
+  K_BENCH_TOGGLE,      // bytes: ver BENCH_TOGGLE_CABECERA
+
+  K_BLE_INICIADO,
+  K_BLE_MAC,
+  K_BLE_DISPOSITIVO,  // bytes: ver BLE_DISPOSITIVO_CABECERA
+  K_BLE_ENCONTRADOS,
+  K_BLE_PAQUETES,
+  K_BLE_TASA,         // f32 anuncios/s
+  K_BLE_EXPULSADOS,   // entradas expulsadas de la tabla por LRU
+  K_BLE_DESCARTADOS,
+  K_BLE_COLA_MAX,
+
+  K_HEAP_CAPACIDAD,     // bytes: ver HEAP_CAPACIDAD_CABECERA
+  K_HEAP_RESERVA,       // u32 bytes que el barrido deja libres
+  K_HEAP_CLASE,         // bytes: ver HEAP_CLASE_CABECERA
+  K_HEAP_MAX_ASIGNABLE,
+
+  K_TOTAL
+};
+
+// K_BLE_DISPOSITIVO: mac[6], rssi media, mín, máx (int8), paquetes (u16 LE), nombre
+#define BLE_DISPOSITIVO_CABECERA 11
+// K_BENCH_KERNEL: ciclos mín, mediana, p95, máx, desviación, ops por llamada (u32 LE),
+// flags (bit 0: interrupciones enmascaradas), nombre
+#define BENCH_KERNEL_CABECERA 25
+// K_BENCH_TOGGLE: frecuencia Hz, ciclos entre flancos mín, máx, media y σ en centésimas (u32 LE), método
+#define BENCH_TOGGLE_CABECERA 20
+// K_HEAP_CAPACIDAD: total, libre, mayor bloque, mínimo libre, bloques libres (u32 LE),
+// fragmentación %, nombre
+#define HEAP_CAPACIDAD_CABECERA 21
+// K_HEAP_CLASE: tamaño, bloques asignados a la vez, libre antes (u32 LE), MotivoBarrido
+#define HEAP_CLASE_CABECERA 13
+
+enum FormatoSalida : uint8_t { FMT_TXT, FMT_JSON, FMT_CSV };
+
+// Estado de un render incremental (p. ej. el que alimenta Serial)
+struct CursorRender {
+  uint32_t pos = 0;
+  uint8_t seccion = SEC_TOTAL;
+  int8_t grupo = -1;
+  uint8_t item = 0;    // contador de elementos en listas (redes WiFi)
+  int32_t aux1 = 0;    // valores previos de un grupo (seguridad y RSSI de una red)
+  int32_t aux2 = 0;
+};
+
+class BitacoraResultados {
+public:
+  struct Registro {
+    uint8_t clave;
+    uint8_t tipo;
+    uint8_t len;
+    uint8_t datos[255];
+
+    uint32_t u32() const;
+    int32_t i32() const;
+    float f32() const;
+    bool booleano() const { return len && datos[0]; }
+  };
+
+  void seccion(Seccion s);
+  void finSeccion(Seccion s);
+  void u32(Clave k, uint32_t v);
+  void i32(Clave k, int32_t v);
+  void f32(Clave k, float v);
+  void booleano(Clave k, bool v);
+  void texto(Clave k, const char* s);
+  void texto(Clave k, const char* s, size_t len);
+  void bytes(Clave k, const void* datos, uint8_t len);
+  void nota(const char* s, size_t len);
+  // Añade un registro ya codificado ([clave][tipo][len][valor]), p. ej. al
+  // recuperar un respaldo; false si la clave o el tipo no existen
+  bool importar(const uint8_t* registro);
+
+  // Lee el registro en pos y avanza; false al llegar al final.
+  // Si pos quedó atrás (sobrescrito por el giro del buffer) salta al más antiguo.
+  bool leer(uint32_t& pos, Registro& r) const;
+
+  // Render incremental: emite lo nuevo desde el cursor (sin notas) y lo avanza
+  void mostrar(Print& out, CursorRender& cursor) const;
+  // Lo mismo de un registro en uno, para quien reparte la salida; false si no quedaban
+  bool mostrarSiguiente(Print& out, CursorRender& cursor) const;
+  // Render completo de todo lo retenido
+  void exportar(Print& out, FormatoSalida formato) const;
+
+  uint32_t primero() const { return primero_; }
+  uint32_t fin() const { return buf_.fin(); }
+  size_t bytesUsados() const { return buf_.fin() - primero_; }
+  uint32_t descartados() const { return buf_.descartados(); }
+  bool vacio() const { return buf_.fin() == primero_; }
+  static constexpr size_t capacidad() { return HISTORY_MAX_LEN; }
+  void limpiar();
+
+  const HistorialCircular<HISTORY_MAX_LEN>& almacen() const { return buf_; }
+
+private:
+  void escribir(uint8_t clave, uint8_t tipo, const void* datos, uint8_t len);
+  void renderTexto(Print& out, const Registro& r, CursorRender& c, bool incluirNotas) const;
+
+  HistorialCircular<HISTORY_MAX_LEN> buf_;
+  uint32_t primero_ = 0;  // posición lógica del registro completo más antiguo
+};
+
+const char* nombreSeccion(uint8_t s);
+const char* nombreClave(uint8_t k);
+
+// Textos compartidos con los diagnósticos
+const char* textoRazonReset(uint32_t razon);
+const char* textoSeguridad(uint32_t tipo);
+const char* textoCalidadRSSI(int32_t rssi);
+void imprimirMac(Print& out, const uint8_t* mac);
+// Números de los bits a 1 (pines de una máscara GPIO)
+void imprimirMascara(Print& out, uint32_t mascara, const char* separador);
+// Cadena JSON entre comillas con los escapes necesarios
+void imprimirTextoJSON(Print& out, const uint8_t* s, size_t len);
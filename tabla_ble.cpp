@@ -0,0 +1,186 @@
+#include "tabla_ble.h"
+#include "resultados.h"
+
+float DispositivoBLE::tasa() const {
+  uint32_t lapso = ultimoMs - primeroMs;
+  return lapso ? (paquetes - 1) * 1000.0f / lapso : 0.0f;
+}
+
+size_t TablaBLE::hash(const uint8_t* mac) {
+  // Los 3 últimos bytes de la MAC son los más variables; se mezclan todos
+  uint32_t h = (uint32_t)mac[0] | (uint32_t)mac[1] << 8 | (uint32_t)mac[2] << 16 | (uint32_t)mac[3] << 24;
+  h ^= ((uint32_t)mac[4] | (uint32_t)mac[5] << 8) * 0x9E3779B1u;
+  h *= 0x85EBCA6Bu;
+  return (h ^ (h >> 16)) & (HUECOS - 1);
+}
+
+size_t TablaBLE::huecoDe(const uint8_t* mac) const {
+  size_t i = hash(mac);
+  while (indice_[i] != NINGUNO && memcmp(entradas_[indice_[i]].mac, mac, 6) != 0) {
+    i = (i + 1) & (HUECOS - 1);
+  }
+  return i;
+}
+
+// Borrado con desplazamiento hacia atrás: sin lápidas, el sondeo sigue siendo corto
+void TablaBLE::quitarDelIndice(uint8_t e) {
+  size_t i = huecoDe(entradas_[e].mac);
+  size_t j = i;
+  for (;;) {
+    j = (j + 1) & (HUECOS - 1);
+    if (indice_[j] == NINGUNO) break;
+    size_t k = hash(entradas_[indice_[j]].mac);
+    // j puede ocupar el hueco i si su posición ideal k no está en (i, j]
+    bool enMedio = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+    if (!enMedio) {
+      indice_[i] = indice_[j];
+      i = j;
+    }
+  }
+  indice_[i] = NINGUNO;
+}
+
+void TablaBLE::desenlazar(uint8_t e) {
+  DispositivoBLE& d = entradas_[e];
+  if (d.anterior != NINGUNO) entradas_[d.anterior].siguiente = d.siguiente;
+  else cabeza_ = d.siguiente;
+  if (d.siguiente != NINGUNO) entradas_[d.siguiente].anterior = d.anterior;
+  else cola_ = d.anterior;
+}
+
+void TablaBLE::enlazarAlFrente(uint8_t e) {
+  DispositivoBLE& d = entradas_[e];
+  d.anterior = NINGUNO;
+  d.siguiente = cabeza_;
+  if (cabeza_ != NINGUNO) entradas_[cabeza_].anterior = e;
+  cabeza_ = e;
+  if (cola_ == NINGUNO) cola_ = e;
+}
+
+void TablaBLE::registrar(const RegistroEscaneoBLE& reg) {
+  paquetes_++;
+  size_t h = huecoDe(reg.mac);
+  uint8_t e = indice_[h];
+
+  if (e != NINGUNO) {
+    DispositivoBLE& d = entradas_[e];
+    d.ultimoMs = reg.ms;
+    d.paquetes++;
+    if (reg.rssi < d.rssiMin) d.rssiMin = reg.rssi;
+    if (reg.rssi > d.rssiMax) d.rssiMax = reg.rssi;
+    d.rssiMedia16 += (int16_t)((reg.rssi * 16 - d.rssiMedia16) / 8);
+    // El nombre suele llegar en la respuesta de escaneo, no en el primer anuncio
+    if (d.longNombre == 0 && reg.longNombre) {
+      d.longNombre = reg.longNombre;
+      memcpy(d.nombre, reg.nombre, reg.longNombre);
+    }
+    if (cabeza_ != e) {
+      desenlazar(e);
+      enlazarAlFrente(e);
+    }
+    return;
+  }
+
+  // Alta: hueco libre o, con la tabla llena, el menos reciente
+  if (n_ < BLE_TABLA_MAX) {
+    e = n_++;
+  } else {
+    e = cola_;
+    quitarDelIndice(e);
+    desenlazar(e);
+    expulsados_++;
+    h = huecoDe(reg.mac);  // el desplazamiento pudo mover el hueco libre
+  }
+  altas_++;
+
+  DispositivoBLE& d = entradas_[e];
+  memcpy(d.mac, reg.mac, 6);
+  d.longNombre = reg.longNombre;
+  memcpy(d.nombre, reg.nombre, reg.longNombre);
+  d.primeroMs = d.ultimoMs = reg.ms;
+  d.paquetes = 1;
+  d.rssiMin = d.rssiMax = reg.rssi;
+  d.rssiMedia16 = (int16_t)(reg.rssi * 16);
+  indice_[h] = e;
+  enlazarAlFrente(e);
+}
+
+const DispositivoBLE* TablaBLE::buscar(const uint8_t* mac) const {
+  uint8_t e = indice_[huecoDe(mac)];
+  return e == NINGUNO ? nullptr : &entradas_[e];
+}
+
+void TablaBLE::limpiar() {
+  memset(indice_, NINGUNO, sizeof(indice_));
+  n_ = 0;
+  cabeza_ = cola_ = NINGUNO;
+  paquetes_ = altas_ = expulsados_ = 0;
+}
+
+void TablaBLE::imprimirTexto(Print& out) const {
+  out.print("\n📡 TABLA BLE: ");
+  out.print((unsigned)n_);
+  out.print("/");
+  out.print((unsigned)BLE_TABLA_MAX);
+  out.print(" dispositivos, ");
+  out.print((unsigned long)paquetes_);
+  out.print(" anuncios, ");
+  out.print((unsigned long)expulsados_);
+  out.println(" expulsados");
+  if (n_ == 0) {
+    out.println("• Sin dispositivos registrados");
+    return;
+  }
+  out.println("  MAC                RSSI media (mín/máx)  Paquetes  Paq/s  Visto hace  Nombre");
+  uint32_t ahora = millis();
+  for (const DispositivoBLE* d = masReciente(); d; d = masAntiguoQue(d)) {
+    char linea[80];
+    snprintf(linea, sizeof(linea), "  %4d dBm (%4d/%4d)  %8lu  %5.1f  %8lus  ", d->rssiMedia(), d->rssiMin,
+             d->rssiMax, (unsigned long)d->paquetes, d->tasa(), (unsigned long)((ahora - d->ultimoMs) / 1000));
+    out.print("  ");
+    imprimirMac(out, d->mac);
+    out.print(linea);
+    if (d->longNombre) out.write((const uint8_t*)d->nombre, d->longNombre);
+    else out.print("-");
+    out.println();
+  }
+}
+
+void TablaBLE::imprimirJSON(Print& out) const {
+  out.print("{\"capacidad\":");
+  out.print((unsigned)BLE_TABLA_MAX);
+  out.print(",\"dispositivos\":");
+  out.print((unsigned)n_);
+  out.print(",\"paquetes\":");
+  out.print((unsigned long)paquetes_);
+  out.print(",\"altas\":");
+  out.print((unsigned long)altas_);
+  out.print(",\"expulsados\":");
+  out.print((unsigned long)expulsados_);
+  out.print(",\"ahora_ms\":");
+  out.print((unsigned long)millis());
+  out.print(",\"lista\":[");
+  for (const DispositivoBLE* d = masReciente(); d; d = masAntiguoQue(d)) {
+    if (d != masReciente()) out.print(',');
+    out.print("\n{\"mac\":\"");
+    imprimirMac(out, d->mac);
+    out.print("\",\"nombre\":");
+    imprimirTextoJSON(out, (const uint8_t*)d->nombre, d->longNombre);
+    out.print(",\"rssi\":");
+    out.print((int)d->rssiMedia());
+    out.print(",\"rssi_min\":");
+    out.print((int)d->rssiMin);
+    out.print(",\"rssi_max\":");
+    out.print((int)d->rssiMax);
+    out.print(",\"paquetes\":");
+    out.print((unsigned long)d->paquetes);
+    out.print(",\"tasa\":");
+    out.print(d->tasa(), 2);
+    out.print(",\"primero_ms\":");
+    out.print((unsigned long)d->primeroMs);
+    out.print(",\"ultimo_ms\":");
+    out.print((unsigned long)d->ultimoMs);
+    out.print('}');
+  }
+  out.print("\n]}");
+}
@@ -0,0 +1,77 @@
+// Tabla de dispositivos BLE
+// Un anuncio repetido no crea un registro nuevo: actualiza la entrada de su
+// dirección (paquetes, primera/última vez visto, RSSI mín/máx/media móvil).
+// Las entradas viven en un arreglo fijo, encadenadas en orden LRU; un índice
+// de direccionamiento abierto (sondeo lineal, 2x huecos) las localiza por MAC.
+// Con la tabla llena se expulsa el dispositivo que lleva más tiempo callado.
+#pragma once
+#include <Arduino.h>
+#include "ble_cola.h"
+
+#ifndef BLE_TABLA_MAX
+#define BLE_TABLA_MAX 64
+#endif
+
+struct DispositivoBLE {
+  uint8_t mac[6];
+  uint8_t longNombre;
+  char nombre[20];      // sin terminador, como en RegistroEscaneoBLE
+  uint32_t primeroMs;
+  uint32_t ultimoMs;
+  uint32_t paquetes;
+  int8_t rssiMin;
+  int8_t rssiMax;
+  int16_t rssiMedia16;  // media móvil exponencial (alfa 1/8) en 1/16 dBm
+  uint8_t anterior;     // lista LRU: hacia el más reciente
+  uint8_t siguiente;    // hacia el más antiguo
+
+  int8_t rssiMedia() const { return (int8_t)((rssiMedia16 + (rssiMedia16 < 0 ? -8 : 8)) / 16); }
+  // Anuncios por segundo entre el primero y el último (0 con un solo paquete)
+  float tasa() const;
+};
+
+class TablaBLE {
+public:
+  static_assert(BLE_TABLA_MAX >= 2 && BLE_TABLA_MAX <= 127 && (BLE_TABLA_MAX & (BLE_TABLA_MAX - 1)) == 0,
+                "BLE_TABLA_MAX debe ser potencia de 2 y menor que 128");
+  static constexpr uint8_t NINGUNO = 0xFF;
+
+  TablaBLE() { limpiar(); }
+
+  // Solo desde loop(): suma el anuncio a su dispositivo (o lo da de alta)
+  void registrar(const RegistroEscaneoBLE& reg);
+  const DispositivoBLE* buscar(const uint8_t* mac) const;
+  void limpiar();
+
+  // Recorrido del más reciente al más antiguo: for (p = masReciente(); p; p = masAntiguoQue(p))
+  const DispositivoBLE* masReciente() const { return cabeza_ == NINGUNO ? nullptr : &entradas_[cabeza_]; }
+  const DispositivoBLE* masAntiguoQue(const DispositivoBLE* d) const {
+    return d->siguiente == NINGUNO ? nullptr : &entradas_[d->siguiente];
+  }
+
+  size_t cantidad() const { return n_; }
+  static constexpr size_t capacidad() { return BLE_TABLA_MAX; }
+  uint32_t paquetes() const { return paquetes_; }
+  uint32_t altas() const { return altas_; }
+  uint32_t expulsados() const { return expulsados_; }
+
+  void imprimirTexto(Print& out) const;
+  void imprimirJSON(Print& out) const;
+
+private:
+  static constexpr size_t HUECOS = BLE_TABLA_MAX * 2;
+  static size_t hash(const uint8_t* mac);
+  size_t huecoDe(const uint8_t* mac) const;  // hueco con esa MAC o el vacío donde iría
+  void quitarDelIndice(uint8_t e);
+  void desenlazar(uint8_t e);
+  void enlazarAlFrente(uint8_t e);
+
+  DispositivoBLE entradas_[BLE_TABLA_MAX];
+  uint8_t indice_[HUECOS];
+  uint8_t n_ = 0;
+  uint8_t cabeza_ = NINGUNO;  // más reciente
+  uint8_t cola_ = NINGUNO;    // más antiguo (próximo a expulsar)
+  uint32_t paquetes_ = 0;
+  uint32_t altas_ = 0;
+  uint32_t expulsados_ = 0;
+};
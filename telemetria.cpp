@@ -0,0 +1,96 @@
+#include "telemetria.h"
+#include "crc32.h"
+
+void CodificadorCOBS::emitirBloque() {
+  out_.write((uint8_t)(n_ + 1));
+  out_.write(bloque_, n_);
+  n_ = 0;
+}
+
+void CodificadorCOBS::escribir(const uint8_t* datos, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (datos[i] == 0) {
+      emitirBloque();
+      continue;
+    }
+    bloque_[n_++] = datos[i];
+    // Código 0xFF: 254 bytes sin cero implícito detrás
+    if (n_ == sizeof(bloque_)) emitirBloque();
+  }
+}
+
+void CodificadorCOBS::terminar() {
+  emitirBloque();
+  out_.write((uint8_t)0);
+}
+
+void EmisorTrama::abrir(uint8_t tipo, uint8_t secuencia) {
+  out_.write((uint8_t)0);
+  uint8_t cab[2] = {tipo, secuencia};
+  cobs_.escribir(cab, sizeof(cab));
+  crc_ = crc32(cab, sizeof(cab));
+  carga_ = 0;
+  abierta_ = true;
+}
+
+void EmisorTrama::escribir(const void* datos, size_t len) {
+  cobs_.escribir((const uint8_t*)datos, len);
+  crc_ = crc32(datos, len, crc_);
+  carga_ += len;
+}
+
+void EmisorTrama::cerrar() {
+  uint8_t crc[4] = {(uint8_t)crc_, (uint8_t)(crc_ >> 8), (uint8_t)(crc_ >> 16), (uint8_t)(crc_ >> 24)};
+  cobs_.escribir(crc, sizeof(crc));
+  cobs_.terminar();
+  abierta_ = false;
+}
+
+static void ponerU32LE(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+void Telemetria::activar(Print& out, uint32_t baudios) {
+  activa_ = true;
+  baudios_ = baudios;
+  uint8_t hola[7] = {TELEMETRIA_VERSION, K_TOTAL, SEC_TOTAL};
+  ponerU32LE(hola + 3, baudios);
+  EmisorTrama t(out);
+  t.abrir(TRAMA_HOLA, secuencia_++);
+  t.escribir(hola, sizeof(hola));
+  t.cerrar();
+  tramas_++;
+}
+
+void Telemetria::enviarRegistros(Print& out, const BitacoraResultados& b, uint32_t& pos) {
+  // La trama se abre con el primer registro que no sea nota: sin tramas vacías
+  EmisorTrama t(out);
+  BitacoraResultados::Registro r;
+  while (b.leer(pos, r)) {
+    if (r.clave == K_NOTA) continue;
+    size_t tam = 3 + r.len;
+    if (t.abierta() && t.carga() + tam > TELEMETRIA_CARGA_MAX) t.cerrar();
+    if (!t.abierta()) {
+      t.abrir(TRAMA_REGISTROS, secuencia_++);
+      tramas_++;
+      uint8_t inicio[4];
+      ponerU32LE(inicio, pos - tam);  // leer() pudo saltar registros pisados
+      t.escribir(inicio, sizeof(inicio));
+    }
+    uint8_t cab[3] = {r.clave, r.tipo, r.len};
+    t.escribir(cab, sizeof(cab));
+    t.escribir(r.datos, r.len);
+  }
+  if (t.abierta()) t.cerrar();
+}
+
+void Telemetria::enviarListo(Print& out, const char* origen) {
+  EmisorTrama t(out);
+  t.abrir(TRAMA_LISTO, secuencia_++);
+  t.escribir(origen, strlen(origen));
+  t.cerrar();
+  tramas_++;
+}
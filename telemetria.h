@@ -0,0 +1,91 @@
+// Telemetría binaria por Serial
+// Para bancos de prueba: en vez del texto del menú, los mismos registros de la
+// bitácora (resultados.h) viajan tal cual en tramas COBS con CRC-32. El formato
+// del registro es el esquema fijo; no depende de la redacción de los mensajes.
+// Se activa y desactiva en caliente con el comando "bin"; la entrada de comandos
+// sigue siendo texto y los mensajes sueltos del sketch siguen saliendo en claro.
+//
+// Trama en el cable: 0x00 COBS([tipo u8][secuencia u8][carga][crc32 LE]) 0x00
+//   El CRC cubre tipo, secuencia y carga. El 0x00 inicial cierra el texto que se
+//   colara antes; el receptor descarta todo lo que no sea una trama válida.
+// Tipos:
+//   TRAMA_HOLA      [versión u8][K_TOTAL u8][SEC_TOTAL u8][baudios u32 LE]
+//   TRAMA_REGISTROS [posición u32 LE][registros [clave][tipo][len][valor]...]
+//   TRAMA_LISTO     [nombre del comando o diagnóstico que terminó]
+// La secuencia crece en uno por trama (un salto delata tramas perdidas); la
+// posición es la lógica del historial del primer registro de la trama.
+#pragma once
+#include <Arduino.h>
+#include "resultados.h"
+
+#define TELEMETRIA_VERSION 1
+// Velocidad del puerto en modo binario si "bin on" no indica otra
+#ifndef TELEMETRIA_BAUDIOS
+#define TELEMETRIA_BAUDIOS 921600
+#endif
+// Carga máxima de una trama; los registros se agrupan hasta llenarla
+#ifndef TELEMETRIA_CARGA_MAX
+#define TELEMETRIA_CARGA_MAX 512
+#endif
+static_assert(TELEMETRIA_CARGA_MAX >= 4 + 3 + 255, "TELEMETRIA_CARGA_MAX no admite un registro máximo");
+
+// Trama sin codificar (tipo, secuencia, carga y CRC) y su peor caso en COBS
+#define TELEMETRIA_TRAMA_MAX (2 + TELEMETRIA_CARGA_MAX + 4)
+#define TELEMETRIA_COBS_MAX (TELEMETRIA_TRAMA_MAX + TELEMETRIA_TRAMA_MAX / 254 + 1)
+
+enum TipoTrama : uint8_t { TRAMA_HOLA = 1, TRAMA_REGISTROS, TRAMA_LISTO };
+
+// COBS por flujo: acumula hasta 254 bytes sin cero y los emite con su código
+class CodificadorCOBS {
+public:
+  explicit CodificadorCOBS(Print& out) : out_(out) {}
+  void escribir(const uint8_t* datos, size_t len);
+  // Emite el bloque pendiente y el delimitador 0x00
+  void terminar();
+
+private:
+  void emitirBloque();
+
+  Print& out_;
+  uint8_t bloque_[254];
+  uint8_t n_ = 0;
+};
+
+// Tramas en construcción, una tras otra: el CRC se calcula por trozos mientras se escribe
+class EmisorTrama {
+public:
+  explicit EmisorTrama(Print& out) : out_(out), cobs_(out) {}
+  void abrir(uint8_t tipo, uint8_t secuencia);
+  void escribir(const void* datos, size_t len);
+  void cerrar();
+  bool abierta() const { return abierta_; }
+  size_t carga() const { return carga_; }
+
+private:
+  Print& out_;
+  CodificadorCOBS cobs_;
+  uint32_t crc_ = 0;
+  size_t carga_ = 0;
+  bool abierta_ = false;
+};
+
+class Telemetria {
+public:
+  bool activa() const { return activa_; }
+  uint32_t baudios() const { return baudios_; }
+  // Marca el modo binario y anuncia la versión del protocolo con TRAMA_HOLA
+  void activar(Print& out, uint32_t baudios);
+  void desactivar() { activa_ = false; }
+
+  // Envía los registros desde pos hasta el final (sin notas) y avanza pos
+  void enviarRegistros(Print& out, const BitacoraResultados& b, uint32_t& pos);
+  void enviarListo(Print& out, const char* origen);
+
+  uint32_t tramas() const { return tramas_; }
+
+private:
+  uint8_t secuencia_ = 0;
+  uint32_t tramas_ = 0;
+  uint32_t baudios_ = 0;
+  bool activa_ = false;
+};
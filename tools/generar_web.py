@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Genera web_assets.h a partir de los archivos de web/.
+
+Incrusta estilo.css y app.js dentro de index.html, minifica el resultado,
+lo comprime con gzip (determinista, mtime=0) y lo emite como un array
+constexpr en flash junto con su longitud y un ETag precalculado.
+
+  python3 tools/generar_web.py          regenera web_assets.h
+  python3 tools/generar_web.py --check  falla si web_assets.h está desactualizado
+"""
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+RAIZ = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB = os.path.join(RAIZ, "web")
+SALIDA = os.path.join(RAIZ, "web_assets.h")
+
+
+def leer(nombre):
+    with open(os.path.join(WEB, nombre), encoding="utf-8") as f:
+        return f.read()
+
+
+def minificar_css(css):
+    css = re.sub(r"/\*.*?\*/", "", css, flags=re.S)
+    css = re.sub(r"\s+", " ", css)
+    css = re.sub(r"\s*([{}:;,>])\s*", r"\1", css)
+    return css.replace(";}", "}").strip()
+
+
+def quitar_comentario_js(linea):
+    """Corta un comentario // final respetando las cadenas entre comillas."""
+    comilla = None
+    i = 0
+    while i < len(linea):
+        c = linea[i]
+        if comilla:
+            if c == "\\":
+                i += 1
+            elif c == comilla:
+                comilla = None
+        elif c in "'\"`":
+            comilla = c
+        elif linea.startswith("//", i):
+            return linea[:i]
+        i += 1
+    return linea
+
+
+def minificar_js(js):
+    # Se conservan los saltos de línea para no depender de la inserción de ';'
+    lineas = (quitar_comentario_js(l).strip() for l in js.splitlines())
+    return "\n".join(l for l in lineas if l)
+
+
+def minificar_html(html):
+    html = re.sub(r"<!--.*?-->", "", html, flags=re.S)
+    html = "".join(l.strip() for l in html.splitlines())
+    return re.sub(r">\s+<", "><", html)
+
+
+def pagina():
+    html = minificar_html(leer("index.html"))
+    html = re.sub(r'<link rel="stylesheet" href="([^"]+)">',
+                  lambda m: "<style>" + minificar_css(leer(m.group(1))) + "</style>", html)
+    html = re.sub(r'<script src="([^"]+)"></script>',
+                  lambda m: "<script>" + minificar_js(leer(m.group(1))) + "</script>", html)
+    return html.encode("utf-8")
+
+
+def generar():
+    original = sum(len(leer(n).encode("utf-8")) for n in ("index.html", "estilo.css", "app.js"))
+    minificado = pagina()
+    gz = gzip.compress(minificado, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(gz).hexdigest()[:16]
+
+    filas = []
+    for i in range(0, len(gz), 16):
+        filas.append("  " + ", ".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+
+    return (
+        "// GENERADO por tools/generar_web.py a partir de web/ -- no editar a mano.\n"
+        "// index.html + estilo.css + app.js: %d B -> %d B minificado -> %d B gzip\n"
+        "#pragma once\n"
+        "#include <stddef.h>\n"
+        "#include <stdint.h>\n"
+        "\n"
+        "constexpr size_t WEB_INDEX_GZ_LEN = %d;\n"
+        "constexpr char WEB_INDEX_ETAG[] = \"\\\"%s\\\"\";\n"
+        "constexpr uint8_t WEB_INDEX_GZ[WEB_INDEX_GZ_LEN] = {\n"
+        "%s\n"
+        "};\n" % (original, len(minificado), len(gz), len(gz), etag, "\n".join(filas))
+    )
+
+
+def main():
+    contenido = generar()
+    if "--check" in sys.argv[1:]:
+        actual = open(SALIDA, encoding="utf-8").read() if os.path.exists(SALIDA) else ""
+        if actual != contenido:
+            print("web_assets.h desactualizado: ejecuta tools/generar_web.py", file=sys.stderr)
+            return 1
+        return 0
+    with open(SALIDA, "w", encoding="utf-8") as f:
+        f.write(contenido)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,169 @@
+// Lista de archivos del File Manager (paginada en el servidor; se recarga cuando /eventos avisa)
+const PAGE_SIZE = 50;
+let errorCount = 0;
+let offset = 0;
+
+function changePage(delta) {
+  offset = Math.max(0, offset + delta * PAGE_SIZE);
+  loadFiles();
+}
+
+function showError(msg) {
+  document.getElementById('files').innerHTML = '<div class="error">❌ Error: ' + msg + '</div>';
+}
+
+function loadFiles() {
+  fetch('/list?offset=' + offset + '&limit=' + PAGE_SIZE + '&sort=mtime&order=desc')
+    .then(response => {
+      if (!response.ok) throw new Error('HTTP ' + response.status);
+      return response.json();
+    })
+    .then(data => {
+      errorCount = 0;
+      if (data.offset > 0 && data.offset >= data.count) {
+        changePage(-Math.ceil(data.offset / PAGE_SIZE));
+        return;
+      }
+      let statsHtml = 'Archivos: ' + data.count + ' | ';
+      statsHtml += 'Usado: ' + (data.used/1024).toFixed(1) + ' KB | ';
+      statsHtml += 'Total: ' + (data.total/1024).toFixed(1) + ' KB';
+      if (data.count > PAGE_SIZE) {
+        let last = Math.min(data.offset + data.files.length, data.count);
+        statsHtml += '<br>Mostrando ' + (data.offset + 1) + '-' + last + ' de ' + data.count + ' ';
+        if (data.offset > 0) statsHtml += '<a href="#" class="btn" onclick="changePage(-1);return false">◀</a>';
+        if (last < data.count) statsHtml += '<a href="#" class="btn" onclick="changePage(1);return false">▶</a>';
+      }
+      document.getElementById('stats').innerHTML = statsHtml;
+      let html = '';
+      if (data.files && data.files.length > 0) {
+        data.files.forEach(file => {
+          html += '<div class="file-item">';
+          html += '<div class="file-info">';
+          html += '<div class="file-name">' + file.name + '</div>';
+          html += '<div class="file-size">' + (file.size/1024).toFixed(2) + ' KB (' + file.size + ' bytes)</div>';
+          if (file.export) {
+            let e = file.export;
+            let detalle = '#' + e.seq + ' · ' + e.format;
+            if (e.gzip && e.original) detalle += ' · ' + (e.original/1024).toFixed(1) + ' KB sin comprimir';
+            if (e.sections) detalle += ' · ' + e.records + ' registros: ' + e.sections.split(',').join(', ');
+            html += '<div class="file-export">' + detalle + '</div>';
+          }
+          html += '</div>';
+          html += '<div>';
+          html += '<a href="/download?file=' + encodeURIComponent(file.name) + '" class="btn btn-download" target="_blank">📥 Descargar</a>';
+          html += '<a href="/delete?file=' + encodeURIComponent(file.name) + '" class="btn btn-delete" onclick="return confirm(\'¿Eliminar ' + file.name + '?\')">🗑️ Eliminar</a>';
+          html += '</div>';
+          html += '</div>';
+        });
+      } else {
+        html = '<div class="file-item"><div class="file-info">📂 No hay archivos guardados</div></div>';
+      }
+      document.getElementById('files').innerHTML = html;
+    })
+    .catch(err => {
+      errorCount++;
+      console.error('Error loading files:', err);
+      if (errorCount < 3) {
+        setTimeout(loadFiles, 2000); // Reintentar en 2 segundos
+      } else {
+        showError('No se pueden cargar los archivos. Error: ' + err.message);
+      }
+    });
+}
+
+function uploadFile() {
+  let input = document.getElementById('upfile');
+  let status = document.getElementById('upstatus');
+  if (!input.files.length) return;
+  let form = new FormData();
+  form.append('file', input.files[0]);
+  status.textContent = 'Subiendo...';
+  fetch('/upload', { method: 'POST', body: form })
+    .then(response => response.json())
+    .then(data => {
+      if (data.error) {
+        status.textContent = '❌ ' + data.error;
+      } else {
+        status.textContent = '✅ ' + data.file + ' (' + data.size + ' bytes, ' + data.kbps + ' KB/s)';
+        input.value = '';
+        loadFiles();
+      }
+    })
+    .catch(err => { status.textContent = '❌ Error: ' + err.message; });
+}
+
+// Comparación con la línea base: se recarga con cada "Listo" (benchmark, diagnóstico, base)
+function escapar(texto) {
+  return String(texto).replace(/[&<>"]/g, c => ({'&': '&amp;', '<': '&lt;', '>': '&gt;', '"': '&quot;'}[c]));
+}
+
+function loadVeredicto() {
+  fetch('/veredicto')
+    .then(response => response.json())
+    .then(data => {
+      let div = document.getElementById('veredicto');
+      if (data.estado != 'ok' && data.estado != 'regresion') {
+        div.hidden = true;
+        return;
+      }
+      let html;
+      if (data.estado == 'ok') {
+        html = '✅ Sin regresiones frente a la línea base (' + data.metricas.length + ' métricas';
+        if (data.mejoras) html += ', ' + data.mejoras + ' mejoras';
+        html += ')';
+      } else {
+        html = '❌ ' + data.regresiones + ' regresiones frente a la línea base';
+        html += '<ul>';
+        data.metricas.filter(m => m.estado == 'regresion').forEach(m => {
+          html += '<li>' + escapar(m.id) + ': ' + m.base + ' → ' + m.actual + ' ' + escapar(m.unidad);
+          if (m.sentido == 'faltan') html += ' (' + m.cambio + ' pines perdidos)';
+          else html += ' (' + (m.cambio > 0 ? '+' : '') + m.cambio + (m.relativa ? '%' : '') + ', tolerancia ' + m.tolerancia + (m.relativa ? '%' : '') + ')';
+          html += '</li>';
+        });
+        html += '</ul>';
+      }
+      html += '<a href="/download?file=/veredicto.json" target="_blank">veredicto.json</a>';
+      div.className = 'veredicto veredicto-' + data.estado;
+      div.innerHTML = html;
+      div.hidden = false;
+    })
+    .catch(err => console.error('Error loading veredicto:', err));
+}
+
+// Cambios empujados por el ESP32: salida de los comandos y avisos de SPIFFS.
+// EventSource reconecta solo y manda Last-Event-ID, así no se repite salida.
+const MAX_SALIDA = 20000;
+
+function agregarSalida(texto) {
+  let pre = document.getElementById('salida');
+  let abajo = pre.scrollTop + pre.clientHeight >= pre.scrollHeight - 4;
+  let total = pre.textContent + texto;
+  if (total.length > MAX_SALIDA) total = total.slice(total.length - MAX_SALIDA);
+  pre.textContent = total;
+  if (abajo) pre.scrollTop = pre.scrollHeight;
+}
+
+function conectarEventos() {
+  let estado = document.getElementById('vivo');
+  let fuente = new EventSource('/eventos');
+  let reconexion = false;
+  fuente.onopen = function() {
+    estado.textContent = '🟢 En vivo';
+    errorCount = 0;
+    if (reconexion) loadFiles(); // pudo cambiar algo mientras no había conexión
+    reconexion = true;
+  };
+  fuente.onerror = function() { estado.textContent = '🔴 Reconectando...'; };
+  fuente.addEventListener('historial', function(e) { agregarSalida(e.data); });
+  fuente.addEventListener('listo', function(e) {
+    agregarSalida('\n─── Listo: ' + e.data + ' ───\n');
+    loadVeredicto();
+  });
+  fuente.addEventListener('desfase', function(e) { agregarSalida('\n⚠️ ' + e.data + ' bytes de historial perdidos\n'); });
+  fuente.addEventListener('archivos', function() { loadFiles(); });
+}
+
+loadFiles();
+loadVeredicto();
+if (window.EventSource) conectarEventos();
+else setInterval(function() { if (errorCount < 3) loadFiles(); }, 5000);
@@ -0,0 +1,202 @@
+// GENERADO por tools/generar_web.py a partir de web/ -- no editar a mano.
+// index.html + estilo.css + app.js: 9880 B -> 8242 B minificado -> 3062 B gzip
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+constexpr size_t WEB_INDEX_GZ_LEN = 3062;
+constexpr char WEB_INDEX_ETAG[] = "\"b3d8cda998803383\"";
+constexpr uint8_t WEB_INDEX_GZ[WEB_INDEX_GZ_LEN] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x5a, 0x5b, 0x6f, 0xdc, 0xc6,
+  0x15, 0x7e, 0xd7, 0xaf, 0x18, 0xaf, 0x51, 0x71, 0x59, 0x6b, 0xb9, 0x17, 0x49, 0x96, 0xbd, 0x37,
+  0x43, 0xb1, 0xe5, 0xda, 0x68, 0x9c, 0x08, 0x91, 0x5c, 0xb4, 0xb5, 0x0d, 0x63, 0x96, 0x1c, 0xee,
+  0x8e, 0x45, 0x72, 0x18, 0x72, 0xa8, 0x95, 0xb2, 0x5d, 0x20, 0x08, 0xd0, 0x3e, 0x15, 0x28, 0xda,
+  0x06, 0x09, 0x50, 0xb4, 0x70, 0x51, 0x34, 0x0f, 0x7d, 0xc8, 0x5b, 0xd1, 0xf6, 0xad, 0x40, 0xfc,
+  0x4f, 0xfc, 0x07, 0x9a, 0x9f, 0xd0, 0x73, 0x66, 0x86, 0xb7, 0xdd, 0x95, 0x8c, 0xba, 0x50, 0x60,
+  0x68, 0x0e, 0xcf, 0x9c, 0x73, 0xe6, 0x5c, 0xbf, 0x19, 0x65, 0x78, 0xe3, 0xc1, 0xc7, 0xf7, 0x4f,
+  0x7f, 0x76, 0x7c, 0x44, 0x66, 0x32, 0x0c, 0xc6, 0x43, 0xf3, 0x2f, 0xa3, 0xde, 0x78, 0x28, 0xb9,
+  0x0c, 0xd8, 0xf8, 0xe8, 0xe4, 0x78, 0xb7, 0x47, 0x1e, 0xf2, 0x80, 0x91, 0x27, 0x34, 0xa2, 0x53,
+  0x96, 0x0c, 0xdb, 0xfa, 0xcb, 0x30, 0x64, 0x92, 0x92, 0x88, 0x86, 0x6c, 0xd4, 0x38, 0xe7, 0x6c,
+  0x1e, 0x8b, 0x44, 0x36, 0x88, 0x2b, 0x22, 0xc9, 0x22, 0x39, 0x6a, 0xcc, 0xb9, 0x27, 0x67, 0x23,
+  0x8f, 0x9d, 0x73, 0x97, 0xb5, 0xd4, 0x62, 0x87, 0xf0, 0x88, 0x4b, 0x4e, 0x83, 0x56, 0xea, 0xd2,
+  0x80, 0x8d, 0xba, 0x0d, 0x23, 0xc3, 0x9d, 0xd1, 0x24, 0x65, 0xb0, 0xe7, 0xe9, 0xe9, 0xc3, 0xd6,
+  0x1d, 0xa0, 0xa6, 0xf2, 0x12, 0x14, 0x4c, 0x84, 0x77, 0xb9, 0xf0, 0x41, 0x5e, 0xcb, 0xa7, 0x21,
+  0x0f, 0x2e, 0xfb, 0x87, 0x09, 0x6c, 0x1e, 0x84, 0x34, 0x99, 0xf2, 0xa8, 0xdf, 0xeb, 0xc4, 0x17,
+  0x83, 0x09, 0x75, 0xcf, 0xa6, 0x89, 0xc8, 0x22, 0xaf, 0x7f, 0xd3, 0xef, 0xe0, 0xcf, 0xd2, 0x41,
+  0x0b, 0x28, 0x8f, 0x58, 0xb2, 0xa8, 0x7c, 0x9d, 0xcf, 0xb8, 0x64, 0x83, 0x98, 0x7a, 0x1e, 0x8f,
+  0xa6, 0x66, 0xaf, 0x48, 0x3c, 0x96, 0xb4, 0x12, 0xea, 0xf1, 0x2c, 0xed, 0x77, 0x35, 0xe9, 0xa2,
+  0x95, 0xce, 0xa8, 0x27, 0xe6, 0xfd, 0x0e, 0xe9, 0xc5, 0x17, 0x04, 0xa9, 0x24, 0x99, 0x4e, 0x68,
+  0xb3, 0xb3, 0xa3, 0x7e, 0x9c, 0xae, 0xbd, 0x74, 0x7c, 0xf0, 0x46, 0x0b, 0xe4, 0x85, 0x8b, 0x9a,
+  0xfe, 0x3b, 0xfe, 0x5d, 0x9f, 0xe6, 0xe6, 0xa9, 0x9d, 0x9d, 0x42, 0x63, 0x77, 0x7f, 0x4d, 0x63,
+  0x85, 0x12, 0x30, 0x5f, 0xf6, 0xf7, 0x60, 0x43, 0x2a, 0x02, 0xee, 0x91, 0x9b, 0x9d, 0xce, 0xc1,
+  0xc4, 0xf7, 0x07, 0x1e, 0x4f, 0xe3, 0x80, 0x5e, 0xf6, 0xfd, 0x80, 0x5d, 0x0c, 0x5e, 0x65, 0xa9,
+  0xe4, 0xfe, 0x65, 0xcb, 0x38, 0xb8, 0x9f, 0xc6, 0x14, 0x1c, 0x3b, 0x61, 0x72, 0xce, 0x58, 0x34,
+  0xa0, 0x01, 0x9f, 0x46, 0xca, 0xa6, 0xb4, 0xef, 0xc2, 0x67, 0x96, 0xe4, 0x66, 0x46, 0xbe, 0x58,
+  0xa0, 0x80, 0x16, 0xd8, 0x39, 0xef, 0x77, 0x0d, 0x19, 0xc3, 0xa6, 0x7d, 0x3b, 0x67, 0x7c, 0x3a,
+  0x93, 0xfd, 0x89, 0x08, 0xbc, 0x81, 0x2b, 0x02, 0x91, 0xf4, 0x6f, 0xee, 0xee, 0xee, 0x0e, 0xe6,
+  0x60, 0x59, 0x6b, 0x92, 0x30, 0x7a, 0xd6, 0x57, 0xff, 0xb6, 0x68, 0x10, 0x98, 0xbd, 0x29, 0xff,
+  0x8c, 0x2d, 0x0c, 0xeb, 0xed, 0xdb, 0xb7, 0x07, 0x4a, 0x0c, 0x12, 0xfb, 0x1d, 0xe7, 0x2e, 0x0b,
+  0x0d, 0x17, 0xbb, 0xc0, 0x84, 0xc8, 0xf9, 0x7a, 0xf4, 0xb6, 0x7f, 0xf7, 0xa0, 0xc6, 0x7a, 0x67,
+  0x1f, 0x79, 0x27, 0x32, 0x5a, 0xe4, 0x4e, 0xba, 0x83, 0x1e, 0x47, 0xb7, 0x18, 0x1f, 0x76, 0x08,
+  0x2e, 0x24, 0xbb, 0x90, 0x2d, 0x8f, 0xb9, 0x22, 0xa1, 0x92, 0x8b, 0xa8, 0x1f, 0x89, 0x88, 0xad,
+  0xb8, 0x12, 0x5c, 0xb7, 0x6a, 0x45, 0xe1, 0x3c, 0x1e, 0x05, 0x90, 0x0c, 0xad, 0x49, 0x20, 0xdc,
+  0x33, 0xa5, 0xae, 0x05, 0xe1, 0x8d, 0x02, 0x41, 0xbd, 0x5a, 0xf4, 0x7a, 0x77, 0xe8, 0xc1, 0xde,
+  0xbe, 0xf1, 0x80, 0xca, 0x16, 0xc3, 0xcc, 0x02, 0x26, 0x59, 0x8d, 0xd5, 0x73, 0x77, 0xf7, 0x37,
+  0xb0, 0xf6, 0x67, 0xe2, 0x1c, 0x92, 0x4e, 0x40, 0x5c, 0xb8, 0xbc, 0xc4, 0x03, 0x2e, 0x1d, 0xac,
+  0x24, 0xa0, 0xa9, 0x23, 0xa8, 0x10, 0x99, 0xe0, 0x98, 0x13, 0xb6, 0x26, 0x42, 0x4a, 0x11, 0xf6,
+  0x77, 0x21, 0x59, 0x72, 0x66, 0x32, 0xeb, 0x2e, 0xca, 0x38, 0x2c, 0x9d, 0x54, 0x52, 0x99, 0xd6,
+  0xf4, 0xb3, 0x5d, 0xbf, 0xe7, 0x7b, 0xef, 0x4a, 0xad, 0xba, 0x86, 0x9e, 0xd2, 0xc0, 0x92, 0x44,
+  0x24, 0x2b, 0x49, 0xeb, 0x1d, 0x78, 0x34, 0x0f, 0xfc, 0x41, 0xaf, 0xeb, 0xf6, 0xf6, 0x4a, 0xc9,
+  0x9d, 0x6b, 0x24, 0x9b, 0x0c, 0x5f, 0x3a, 0xe8, 0x4a, 0xe0, 0xde, 0x70, 0xc8, 0x5a, 0xb9, 0x95,
+  0x09, 0xb3, 0x74, 0xb2, 0x78, 0xcd, 0xff, 0xa6, 0x7a, 0xde, 0xe3, 0x50, 0x18, 0xa5, 0x0d, 0x02,
+  0x4d, 0x0d, 0xd5, 0xa2, 0x94, 0x82, 0x79, 0x1e, 0xad, 0xb1, 0x75, 0x19, 0xfe, 0xe4, 0xd6, 0x79,
+  0x7b, 0xf8, 0xf3, 0x2e, 0x07, 0xcc, 0x74, 0xc9, 0xec, 0x76, 0xf0, 0x33, 0x06, 0xdd, 0x0f, 0xc4,
+  0xbc, 0x75, 0xd9, 0xa7, 0x99, 0x14, 0x03, 0xa5, 0xaa, 0xa5, 0xaa, 0xb3, 0x1f, 0x27, 0xd0, 0xfa,
+  0x12, 0x1a, 0x6f, 0xc8, 0xfb, 0x73, 0x7e, 0x2e, 0x16, 0x55, 0xf2, 0x01, 0xe4, 0x6c, 0xb5, 0x20,
+  0x23, 0x91, 0x84, 0xd0, 0xed, 0xaa, 0x6e, 0x03, 0x4d, 0xcc, 0xe3, 0xae, 0x14, 0x8b, 0xf7, 0x70,
+  0x53, 0xb1, 0x99, 0x64, 0xc1, 0xc2, 0x84, 0xf0, 0x8e, 0x8e, 0x60, 0xf9, 0x89, 0x2e, 0x36, 0x58,
+  0x9a, 0x7f, 0x6d, 0x89, 0xb3, 0x7a, 0x1d, 0xec, 0x31, 0xaf, 0xcc, 0x9d, 0xee, 0xfe, 0xfe, 0x41,
+  0x6f, 0xaf, 0xca, 0x9e, 0xb0, 0x69, 0xc2, 0x52, 0x28, 0xd9, 0x77, 0x66, 0xdc, 0x72, 0xd8, 0xd6,
+  0x2d, 0x7f, 0xd8, 0xd6, 0xb3, 0x07, 0x5b, 0xff, 0x78, 0xe8, 0xf1, 0x73, 0xe2, 0x06, 0x34, 0x4d,
+  0x47, 0x8d, 0xa2, 0xa9, 0x37, 0x6a, 0x64, 0x5d, 0x32, 0x40, 0x9b, 0x75, 0xc7, 0xdf, 0xbf, 0xfe,
+  0xfa, 0x8b, 0xff, 0xfc, 0xeb, 0x37, 0x64, 0xd3, 0xc4, 0x82, 0xcf, 0xc3, 0x78, 0x7c, 0xe8, 0x85,
+  0x30, 0x81, 0x52, 0x99, 0x50, 0x42, 0x13, 0x77, 0x06, 0x11, 0x48, 0x09, 0xd4, 0x37, 0x49, 0x81,
+  0xc6, 0x42, 0x4a, 0x4e, 0x8e, 0x1f, 0x3f, 0x7c, 0x78, 0x32, 0x6c, 0xc7, 0x60, 0x07, 0x28, 0xd1,
+  0x9a, 0xb8, 0x37, 0x6a, 0xa8, 0x1a, 0x6c, 0xe4, 0x4a, 0xf5, 0x6a, 0x7c, 0x1f, 0x7c, 0x48, 0x23,
+  0x4f, 0x10, 0x06, 0x04, 0xef, 0xcd, 0xb7, 0xd0, 0x9e, 0x5d, 0x9a, 0x3a, 0x8e, 0xb3, 0xb2, 0xb9,
+  0x70, 0x48, 0x21, 0xa0, 0x42, 0x99, 0x71, 0xcf, 0x63, 0x51, 0x55, 0x9f, 0xe1, 0xd1, 0x19, 0x0d,
+  0x27, 0xe3, 0x51, 0x9c, 0x49, 0x22, 0x2f, 0x63, 0x18, 0xb3, 0xd8, 0x58, 0x1b, 0x4a, 0x68, 0x16,
+  0xab, 0xdf, 0xc7, 0x43, 0x4a, 0x66, 0x09, 0xf3, 0x47, 0x8d, 0x9b, 0x85, 0x74, 0xa8, 0x07, 0x52,
+  0xd6, 0x44, 0x83, 0x88, 0xc8, 0x0d, 0xb8, 0x7b, 0x96, 0x8b, 0x44, 0xc7, 0x34, 0xed, 0x41, 0xc2,
+  0x64, 0x96, 0x44, 0xc4, 0xa7, 0x41, 0x0a, 0x62, 0xbe, 0x7f, 0xfd, 0xfb, 0xbf, 0x92, 0x93, 0x6c,
+  0xc2, 0xc1, 0x57, 0x14, 0xe6, 0x6f, 0x4c, 0x23, 0xa3, 0x06, 0x0f, 0x9b, 0xc1, 0x69, 0x21, 0x42,
+  0x40, 0x5c, 0x75, 0x0c, 0x1a, 0x51, 0x3a, 0xc6, 0x74, 0x82, 0x8a, 0x6b, 0x72, 0x37, 0x97, 0x5e,
+  0x99, 0xed, 0x82, 0xb2, 0xaf, 0xbe, 0xc1, 0x40, 0x9d, 0xa8, 0x6a, 0x24, 0xa5, 0x36, 0xac, 0x89,
+  0xd2, 0x49, 0xb8, 0x18, 0xdf, 0x87, 0x66, 0xef, 0x4a, 0x94, 0xa5, 0x44, 0x18, 0x1b, 0x40, 0xc8,
+  0x10, 0x6a, 0x4b, 0xc7, 0x46, 0x49, 0x29, 0x83, 0xa3, 0x97, 0xc0, 0x04, 0x0c, 0xb9, 0xb9, 0xa9,
+  0x9b, 0xf0, 0x58, 0x8e, 0x21, 0x89, 0x52, 0x49, 0x8e, 0x0f, 0x7f, 0x74, 0xf4, 0xf2, 0xe4, 0xf1,
+  0xcf, 0x8f, 0xc8, 0x88, 0xec, 0x77, 0x06, 0x5b, 0xd0, 0xdf, 0x89, 0x6a, 0x8c, 0xf7, 0x21, 0x41,
+  0x25, 0x10, 0x0d, 0x4d, 0xf8, 0x3e, 0x80, 0x12, 0xbd, 0xf6, 0xb3, 0xc8, 0xc5, 0xe1, 0x83, 0x50,
+  0x25, 0x9a, 0xb2, 0x63, 0xc8, 0xaa, 0x26, 0x64, 0x8e, 0xa4, 0x36, 0x59, 0x6c, 0x15, 0x8c, 0x4f,
+  0xa8, 0x9c, 0x39, 0x21, 0xbd, 0x00, 0xb0, 0x90, 0xef, 0xbe, 0x45, 0x14, 0x1b, 0xf9, 0x61, 0xa9,
+  0xd6, 0x06, 0xf1, 0x26, 0x0e, 0x29, 0x04, 0x62, 0x6b, 0x59, 0x4a, 0x4f, 0x67, 0x62, 0x7e, 0x84,
+  0xa6, 0x34, 0xc3, 0x74, 0x8a, 0xa2, 0x3d, 0xe1, 0x66, 0x21, 0x34, 0x53, 0x67, 0xca, 0xe4, 0x51,
+  0xc0, 0xf0, 0xd7, 0x0f, 0x2e, 0x1f, 0x7b, 0x4d, 0x4b, 0x39, 0xde, 0xb2, 0x1d, 0x1e, 0x41, 0x4d,
+  0x3c, 0x3a, 0x7d, 0xf2, 0x21, 0xa8, 0xb7, 0xaa, 0xf9, 0xa3, 0x4e, 0xd4, 0x18, 0xbf, 0xfd, 0xd3,
+  0xaf, 0x89, 0x92, 0xd8, 0x27, 0x16, 0x18, 0x03, 0x62, 0xe1, 0x5f, 0x4b, 0xbb, 0xc5, 0xaa, 0xe9,
+  0xae, 0xd8, 0x04, 0x8a, 0x7d, 0x26, 0xdd, 0x59, 0xd3, 0x6a, 0x07, 0x50, 0x1a, 0xf7, 0xf4, 0x59,
+  0x46, 0x28, 0xa0, 0x38, 0x96, 0xb5, 0x1d, 0xf0, 0x90, 0x6b, 0x62, 0xe9, 0x51, 0xa4, 0xa7, 0x30,
+  0xf6, 0x47, 0xa1, 0xe4, 0x21, 0xdb, 0x56, 0x8d, 0x09, 0x30, 0x60, 0xea, 0x5a, 0xf6, 0x96, 0x23,
+  0x67, 0x2c, 0x6a, 0x42, 0x47, 0x88, 0x21, 0x0c, 0x8c, 0x8c, 0xc6, 0xa0, 0x86, 0xfb, 0xa4, 0x79,
+  0x23, 0x27, 0x39, 0xe2, 0xcc, 0x26, 0x72, 0x06, 0x30, 0x85, 0x44, 0x6c, 0xae, 0xcd, 0x6e, 0x5a,
+  0x8f, 0x4e, 0x4f, 0x8f, 0x95, 0xed, 0x05, 0x9b, 0x4e, 0x49, 0xf0, 0x9c, 0xc9, 0xe1, 0xe2, 0xc3,
+  0xab, 0x54, 0x44, 0xca, 0xa3, 0xb9, 0x32, 0x8f, 0x82, 0xeb, 0x95, 0xa2, 0xd5, 0x00, 0xa3, 0x62,
+  0xfc, 0xea, 0x98, 0x03, 0x8d, 0x49, 0x87, 0x6c, 0x6f, 0x93, 0x1a, 0x69, 0xa4, 0x97, 0x2e, 0xee,
+  0x42, 0x9f, 0x54, 0x62, 0xdf, 0x52, 0xa1, 0x76, 0x19, 0x0f, 0x6a, 0x52, 0xda, 0x95, 0x28, 0x17,
+  0xf6, 0xa1, 0x97, 0x31, 0x9f, 0x54, 0xdb, 0x78, 0x04, 0x00, 0x1b, 0x43, 0x75, 0x68, 0x0a, 0x43,
+  0x87, 0xa5, 0xd4, 0x83, 0x1e, 0x24, 0xbf, 0x20, 0x10, 0x9a, 0x92, 0xfd, 0x16, 0xf0, 0x3f, 0x4d,
+  0x01, 0x95, 0x6a, 0x66, 0xad, 0x31, 0x4b, 0x99, 0xd7, 0xee, 0x76, 0x7a, 0x7b, 0xb6, 0x23, 0xc5,
+  0x43, 0x7e, 0xc1, 0xbc, 0x66, 0xd7, 0x56, 0xbb, 0x7f, 0xfc, 0xc1, 0x26, 0x01, 0xa7, 0x42, 0xd2,
+  0xa0, 0x2a, 0x40, 0x22, 0xe1, 0x2a, 0x09, 0x56, 0xc5, 0x43, 0xda, 0xae, 0x71, 0xe5, 0x68, 0xe0,
+  0x0b, 0x3c, 0x10, 0x24, 0x5a, 0x99, 0xf5, 0x3c, 0xaa, 0x79, 0xc2, 0x9c, 0x49, 0xa5, 0xa9, 0x13,
+  0xb0, 0x68, 0x8a, 0xf0, 0xbf, 0xe2, 0xce, 0x55, 0xf3, 0x86, 0x93, 0x64, 0xfc, 0x44, 0x60, 0x6b,
+  0xc6, 0xb6, 0x51, 0x5a, 0x59, 0x88, 0xd3, 0xa6, 0xb5, 0xf0, 0x8b, 0xd2, 0x8b, 0x76, 0x7a, 0x6c,
+  0x93, 0xf7, 0xac, 0x8d, 0xd1, 0xb5, 0xc9, 0x8a, 0xc2, 0x8d, 0x8d, 0xb3, 0xd2, 0x2d, 0xab, 0xd1,
+  0xee, 0xae, 0xf6, 0xcb, 0xb7, 0x5f, 0x7f, 0x8e, 0x8d, 0xd2, 0xa8, 0x52, 0x06, 0x0d, 0x6b, 0xd9,
+  0xf2, 0xfe, 0xca, 0xd6, 0x75, 0x7d, 0xf5, 0x0f, 0xa3, 0x6b, 0x79, 0x75, 0x3f, 0x50, 0xfa, 0x56,
+  0xfa, 0x41, 0x61, 0x83, 0xee, 0x67, 0x33, 0x93, 0x7a, 0x55, 0xff, 0xa8, 0xf8, 0x14, 0x89, 0x5f,
+  0x8d, 0x96, 0xf6, 0x19, 0x74, 0xa0, 0xf2, 0x83, 0x2f, 0x92, 0x23, 0x0a, 0x5d, 0x01, 0x57, 0xba,
+  0xaa, 0x66, 0xc5, 0x01, 0x2b, 0x9d, 0xa7, 0xb8, 0x1d, 0x35, 0xd0, 0xe6, 0x6b, 0x58, 0xe0, 0x66,
+  0xf2, 0x0e, 0x16, 0xbc, 0xa5, 0x00, 0x0b, 0x84, 0x15, 0x97, 0x0e, 0x2e, 0x6b, 0xed, 0xeb, 0xea,
+  0x9d, 0x88, 0x60, 0xf4, 0x4e, 0x65, 0xae, 0x83, 0xeb, 0x95, 0x64, 0xef, 0x15, 0xe5, 0xd2, 0x2c,
+  0x34, 0x20, 0x9b, 0xa2, 0x4e, 0x2e, 0x25, 0x4b, 0xed, 0x42, 0x11, 0x3a, 0x4c, 0x31, 0xe8, 0x5b,
+  0x4d, 0x5e, 0x01, 0xe0, 0x06, 0x52, 0x21, 0x6b, 0x3f, 0x7b, 0x70, 0xa5, 0x0d, 0xd0, 0x43, 0xc4,
+  0xba, 0x89, 0x82, 0x41, 0x2a, 0xfb, 0x54, 0x09, 0xfd, 0xee, 0x9f, 0x44, 0x13, 0x7c, 0xc4, 0x76,
+  0x52, 0x8b, 0x65, 0xce, 0xf4, 0x33, 0x1e, 0x63, 0x0c, 0xa0, 0x01, 0x26, 0x1c, 0x60, 0x19, 0x0d,
+  0xec, 0x42, 0x08, 0x1e, 0x2e, 0xdf, 0xd7, 0x2c, 0x19, 0xae, 0xac, 0xfc, 0x94, 0xc3, 0x8c, 0x12,
+  0x61, 0x9c, 0x40, 0x73, 0x4e, 0xac, 0x5c, 0x43, 0xca, 0x54, 0x8f, 0x4f, 0x37, 0xcb, 0x65, 0x4e,
+  0x82, 0xb7, 0x2b, 0x2f, 0x55, 0x42, 0x00, 0xb5, 0x21, 0x44, 0xca, 0x5b, 0x53, 0xb9, 0xd9, 0x81,
+  0xfb, 0x14, 0x97, 0x4d, 0x6b, 0x07, 0xd2, 0xec, 0x95, 0x80, 0x7a, 0xb7, 0x76, 0x88, 0x65, 0x5f,
+  0x17, 0x04, 0xed, 0x15, 0x1d, 0x86, 0x42, 0x71, 0x6d, 0xfa, 0x94, 0x7b, 0x37, 0x86, 0xb4, 0x4e,
+  0xc8, 0x8b, 0xa8, 0x9d, 0x5f, 0xe0, 0xee, 0xa1, 0x16, 0x35, 0x81, 0x58, 0xe4, 0x0a, 0x8f, 0x3d,
+  0xfd, 0xe4, 0xf1, 0x7d, 0x38, 0x3b, 0x40, 0x86, 0x48, 0x36, 0x8b, 0x8c, 0x51, 0xbe, 0x59, 0x43,
+  0x47, 0xb9, 0x8c, 0x06, 0x91, 0x00, 0x56, 0xf0, 0xf1, 0xe1, 0xe5, 0x24, 0xa0, 0xd1, 0x99, 0xc2,
+  0x42, 0xdf, 0x90, 0x07, 0x30, 0xb3, 0x10, 0xc4, 0x24, 0xa6, 0xf4, 0x36, 0x59, 0xa1, 0x6e, 0x86,
+  0xff, 0x97, 0x0d, 0x4a, 0x42, 0xa5, 0x0d, 0x98, 0xc2, 0x07, 0x9c, 0xe2, 0xf3, 0x24, 0x6c, 0x3e,
+  0xb7, 0xbe, 0xfb, 0xf7, 0x11, 0x8e, 0xd9, 0x88, 0x26, 0x64, 0xad, 0x0a, 0xee, 0x3d, 0xb7, 0x6c,
+  0xb4, 0xf6, 0xeb, 0xdf, 0x2a, 0xd4, 0x6b, 0xf8, 0xd6, 0xec, 0x5d, 0x77, 0x6c, 0xe1, 0x7e, 0x1c,
+  0x95, 0x84, 0x41, 0x93, 0xc9, 0x4b, 0xf9, 0xea, 0x4a, 0xbe, 0xa2, 0x7a, 0xc1, 0x57, 0x5f, 0x90,
+  0x8f, 0x04, 0x99, 0xd1, 0xcb, 0x12, 0x52, 0x4f, 0x33, 0x9a, 0x78, 0x30, 0xae, 0x52, 0x83, 0xbe,
+  0xca, 0x70, 0xff, 0x4f, 0x70, 0x66, 0xa6, 0x3a, 0x17, 0xce, 0x72, 0x97, 0x22, 0x18, 0x81, 0x11,
+  0xbe, 0x3a, 0xcb, 0x6f, 0xdd, 0x1a, 0x6c, 0x21, 0xa8, 0x13, 0x58, 0x82, 0x1a, 0x2e, 0x28, 0xd4,
+  0x40, 0x0c, 0x12, 0x55, 0x0e, 0x4b, 0xfb, 0x90, 0xa8, 0xf0, 0xd5, 0x36, 0xd5, 0x50, 0x22, 0x81,
+  0x21, 0xd9, 0xc5, 0x4a, 0x86, 0x09, 0x71, 0x0a, 0x68, 0x45, 0x64, 0xb2, 0x59, 0x80, 0xa0, 0x1d,
+  0xd2, 0xeb, 0x74, 0x3a, 0x55, 0x07, 0x95, 0xd8, 0xcc, 0x82, 0x03, 0x03, 0x29, 0xce, 0x18, 0x40,
+  0x77, 0xa2, 0xd3, 0x04, 0x34, 0xa6, 0x25, 0xda, 0xad, 0x42, 0x2e, 0xd0, 0xe7, 0x84, 0x2c, 0x4d,
+  0xa1, 0xb7, 0x2b, 0xb0, 0xb7, 0xac, 0x43, 0xbe, 0x2a, 0x28, 0x37, 0x5d, 0x45, 0x23, 0x7e, 0x40,
+  0x1f, 0x57, 0x79, 0x4b, 0x83, 0x7f, 0xac, 0xbd, 0x1c, 0x57, 0x64, 0xe9, 0xf5, 0xfc, 0x9a, 0xc7,
+  0x32, 0x2e, 0xb8, 0xa1, 0x34, 0xd4, 0xda, 0xbd, 0x4d, 0x72, 0xb0, 0x82, 0x22, 0xb1, 0x3f, 0x81,
+  0x40, 0x44, 0x61, 0x0f, 0xe1, 0xd7, 0x07, 0x30, 0x03, 0x10, 0x57, 0x21, 0xd9, 0xa1, 0x71, 0xcc,
+  0x22, 0x13, 0x32, 0x6b, 0x87, 0x54, 0x44, 0x3d, 0xeb, 0xbc, 0x30, 0x73, 0x3d, 0x4b, 0x1d, 0x7c,
+  0x0d, 0xb8, 0xaf, 0x9f, 0xaa, 0x30, 0xad, 0xf0, 0x6e, 0xc1, 0x34, 0x8a, 0x87, 0x4c, 0xc8, 0xd1,
+  0xa5, 0x3e, 0x3c, 0x48, 0x59, 0x90, 0x90, 0xc9, 0x99, 0xf0, 0xc0, 0x65, 0xc7, 0x1f, 0x9f, 0x9c,
+  0x02, 0x05, 0x6f, 0x80, 0x7d, 0x6d, 0xc8, 0x72, 0x13, 0x76, 0x5c, 0x01, 0x7d, 0xeb, 0x88, 0xaf,
+  0x98, 0x71, 0x2a, 0xe0, 0x2a, 0xce, 0x1b, 0x2d, 0x43, 0x84, 0x5c, 0xa0, 0x08, 0xc5, 0x5b, 0x0d,
+  0xfa, 0xe6, 0x2d, 0x7f, 0xfc, 0x65, 0xb9, 0x45, 0x4d, 0x43, 0x6c, 0x9c, 0xcd, 0x82, 0x54, 0x9f,
+  0x22, 0x3b, 0x25, 0xef, 0xd9, 0x24, 0x4e, 0x4d, 0xa7, 0x6e, 0xa7, 0x36, 0xb6, 0x67, 0xe5, 0xbd,
+  0x73, 0x1a, 0x64, 0xcc, 0x8c, 0xe6, 0x95, 0xab, 0xc1, 0x7a, 0xfa, 0x93, 0xab, 0x8f, 0xb1, 0x39,
+  0xeb, 0x06, 0x64, 0x25, 0xe5, 0xb0, 0xb5, 0xc5, 0x34, 0x69, 0xa2, 0x04, 0x81, 0x8e, 0x31, 0x6d,
+  0xe7, 0x44, 0x26, 0x50, 0x33, 0x86, 0x0c, 0x33, 0x21, 0x0e, 0xa8, 0xcb, 0x9a, 0xed, 0x67, 0xdb,
+  0xc3, 0x71, 0xe3, 0x45, 0x7b, 0xba, 0x43, 0x5c, 0x34, 0xa0, 0xb9, 0xb0, 0xb6, 0x2d, 0x50, 0xb2,
+  0x4d, 0xc3, 0x78, 0x80, 0x23, 0x60, 0xa8, 0x56, 0x81, 0x54, 0x8b, 0xb1, 0x5a, 0x4c, 0xf5, 0xa2,
+  0xa1, 0x16, 0x9f, 0x66, 0x02, 0x96, 0xcb, 0x67, 0xee, 0x0b, 0xdb, 0x5e, 0xbb, 0x71, 0xfc, 0x24,
+  0xbf, 0x0a, 0xd7, 0x6e, 0x1d, 0xc5, 0x05, 0xd9, 0x7a, 0xaf, 0xd0, 0xab, 0x29, 0x0c, 0xfd, 0xea,
+  0x9a, 0x92, 0xa8, 0x68, 0xa8, 0xc0, 0x21, 0x75, 0x93, 0x17, 0xe4, 0x06, 0xf8, 0x53, 0x9c, 0x59,
+  0x05, 0x2e, 0xaa, 0x90, 0x8b, 0x37, 0x0d, 0x4b, 0x81, 0x23, 0x7e, 0xee, 0xe8, 0x1b, 0x3c, 0xe8,
+  0x92, 0x49, 0xc6, 0x56, 0x31, 0xbf, 0xee, 0x61, 0xab, 0xf2, 0x47, 0x5a, 0xbe, 0x5d, 0x69, 0xbb,
+  0x98, 0x52, 0x27, 0x1c, 0xef, 0x32, 0x46, 0x3e, 0xc0, 0x32, 0x3f, 0xc1, 0x67, 0x34, 0x42, 0x01,
+  0xf0, 0x92, 0xe0, 0xcd, 0xb7, 0x11, 0xa3, 0x64, 0x42, 0xc1, 0x05, 0x65, 0xa2, 0x41, 0xd1, 0x24,
+  0xea, 0xd1, 0xc1, 0x60, 0x36, 0x4c, 0xad, 0xf0, 0xcd, 0xdf, 0x34, 0xb1, 0x8a, 0xf3, 0x42, 0xf6,
+  0x4a, 0x24, 0x14, 0xe6, 0x7f, 0x31, 0x05, 0x2a, 0x59, 0x69, 0x3e, 0xea, 0xdd, 0xfa, 0xf7, 0xea,
+  0xbc, 0xc0, 0x3c, 0x5d, 0x1b, 0x13, 0xb5, 0xaa, 0xa9, 0x1a, 0x6d, 0x20, 0xc4, 0xbb, 0x0e, 0x51,
+  0x1b, 0x48, 0x59, 0x80, 0xe3, 0xa1, 0x7e, 0x22, 0x28, 0x2b, 0xc9, 0xe0, 0x1e, 0x8c, 0x11, 0x0d,
+  0xab, 0x8e, 0xab, 0x44, 0xa0, 0x40, 0xa4, 0xe1, 0x2a, 0x1c, 0x0d, 0xb8, 0x02, 0x1d, 0x79, 0xa6,
+  0x87, 0x0e, 0xf7, 0xd4, 0x08, 0x36, 0xb7, 0x60, 0x47, 0xf9, 0x11, 0x4d, 0x7d, 0xfb, 0xab, 0xdf,
+  0x19, 0x12, 0x75, 0x65, 0x46, 0x03, 0x7d, 0x83, 0xa8, 0x6d, 0xcd, 0x22, 0x0e, 0xd3, 0xcc, 0xa4,
+  0x49, 0x08, 0x70, 0x28, 0x92, 0xdc, 0xd8, 0x02, 0x08, 0x5d, 0x52, 0x4c, 0x85, 0x42, 0xb3, 0x0e,
+  0x4e, 0x08, 0x35, 0x1b, 0x4e, 0xb8, 0x50, 0xd2, 0x62, 0x8e, 0x7e, 0x88, 0x59, 0xe2, 0xc1, 0x36,
+  0x55, 0xf5, 0xca, 0x97, 0x2b, 0x5b, 0x9a, 0xc5, 0x1e, 0xbc, 0x8a, 0xde, 0x23, 0xd6, 0x2d, 0x8b,
+  0x80, 0xb5, 0x96, 0x5d, 0x17, 0x07, 0x6c, 0x09, 0x0b, 0xa8, 0xe4, 0xe7, 0x14, 0x99, 0x7e, 0x50,
+  0x32, 0x41, 0x44, 0x25, 0xcc, 0x41, 0xb8, 0x40, 0xb9, 0x9c, 0x9a, 0x33, 0x55, 0x08, 0xd7, 0x6e,
+  0xb5, 0xeb, 0xf8, 0x00, 0xbd, 0xa7, 0xe1, 0x41, 0x85, 0xa8, 0x83, 0xb4, 0x7c, 0x37, 0x1e, 0x2b,
+  0xab, 0x57, 0x15, 0xe8, 0x3a, 0xc0, 0xaa, 0x7f, 0x37, 0x80, 0x05, 0x4b, 0x49, 0xe1, 0x8b, 0x8f,
+  0x10, 0xde, 0x80, 0xf8, 0xf2, 0x51, 0xb2, 0x7c, 0x51, 0x2c, 0xfb, 0xb4, 0xca, 0x07, 0xbd, 0x6b,
+  0x1d, 0x33, 0xd4, 0xca, 0x52, 0xdd, 0xa2, 0x36, 0xe0, 0x88, 0x6b, 0x71, 0x43, 0xa1, 0x32, 0xc7,
+  0x0e, 0xaa, 0x73, 0xe9, 0xf7, 0xa3, 0x27, 0x87, 0x3f, 0x7d, 0x79, 0x72, 0xf8, 0xe1, 0xe3, 0x07,
+  0x87, 0x20, 0x1d, 0x51, 0x42, 0xf5, 0x7d, 0x88, 0x42, 0x72, 0x02, 0x1c, 0xd0, 0x4f, 0x5b, 0x65,
+  0x87, 0xc5, 0x5e, 0x80, 0x0f, 0x56, 0xd7, 0x74, 0x24, 0xfd, 0x70, 0x95, 0x0f, 0x75, 0x3a, 0xa1,
+  0xaf, 0x20, 0xc7, 0x70, 0x93, 0x93, 0xba, 0x89, 0x08, 0x82, 0x53, 0x11, 0xc3, 0xe9, 0x71, 0x0d,
+  0x60, 0x11, 0x76, 0x3d, 0x52, 0xcf, 0xc4, 0xf8, 0x4a, 0x51, 0xf2, 0x18, 0x5a, 0x8b, 0xec, 0x69,
+  0x29, 0xea, 0x8e, 0x6f, 0xa4, 0x54, 0xe7, 0xc5, 0x2d, 0xa2, 0x2c, 0xd3, 0x29, 0xad, 0x98, 0xca,
+  0x5b, 0x5f, 0x79, 0x3c, 0xbb, 0xd8, 0xaf, 0x59, 0x52, 0x00, 0xa9, 0xac, 0xce, 0xde, 0xaa, 0xb2,
+  0x0f, 0xb6, 0x56, 0xf5, 0x98, 0x9d, 0x5a, 0x8f, 0x3a, 0x92, 0xbd, 0x72, 0xa2, 0x75, 0xeb, 0x6b,
+  0x23, 0xc2, 0xd5, 0xcf, 0x7f, 0xc9, 0xd1, 0x39, 0x88, 0x13, 0x69, 0x01, 0x91, 0xf2, 0x7e, 0x70,
+  0x4d, 0x83, 0x07, 0x20, 0x96, 0x3b, 0xd3, 0xcf, 0x54, 0x0f, 0xd2, 0x80, 0x46, 0x89, 0x3a, 0x11,
+  0x59, 0x02, 0x67, 0xb1, 0xda, 0x4c, 0x0b, 0xce, 0x39, 0xf1, 0x22, 0x14, 0xb1, 0x0b, 0x54, 0x5d,
+  0x64, 0x8e, 0xde, 0xed, 0x88, 0x48, 0xc4, 0x3a, 0xa1, 0x8c, 0x71, 0xca, 0x18, 0x6d, 0xc8, 0xea,
+  0x30, 0xfe, 0xfe, 0xf5, 0xeb, 0xbf, 0x90, 0xa3, 0x88, 0x28, 0x23, 0x06, 0x1b, 0x1f, 0x9f, 0x4a,
+  0x4d, 0x36, 0xa9, 0xcd, 0xfc, 0x9a, 0x09, 0x7a, 0xa6, 0x2c, 0x2b, 0x46, 0x28, 0x59, 0x2b, 0x56,
+  0x90, 0xab, 0xac, 0xf8, 0xf2, 0xef, 0xe4, 0x13, 0xe6, 0x56, 0x9f, 0x50, 0x2d, 0x40, 0x03, 0x85,
+  0x34, 0xea, 0x79, 0xca, 0x1b, 0x1f, 0xe2, 0xfb, 0x37, 0x48, 0x6e, 0x5a, 0x33, 0xf8, 0x4d, 0xe0,
+  0x5f, 0x59, 0x21, 0xed, 0x0b, 0x0d, 0x0c, 0x55, 0xd4, 0x13, 0x9b, 0x39, 0x58, 0x86, 0xb6, 0x86,
+  0x16, 0x57, 0x4a, 0xc3, 0xc7, 0x43, 0xb1, 0x2a, 0x69, 0xab, 0x2e, 0xc9, 0x7a, 0x1e, 0xbd, 0xfd,
+  0xf2, 0x73, 0xfd, 0x1f, 0xc1, 0xad, 0x22, 0xbf, 0x77, 0xaa, 0x79, 0xae, 0x7a, 0x74, 0xfe, 0xfd,
+  0x79, 0x64, 0x99, 0xc7, 0xd3, 0x0a, 0x6c, 0xd0, 0x8d, 0xea, 0x4a, 0x1b, 0x3c, 0x96, 0xfa, 0x38,
+  0x6f, 0xae, 0x3f, 0x0f, 0x5a, 0xf1, 0x87, 0x3f, 0xe3, 0x3d, 0x6a, 0x45, 0xb7, 0x42, 0x70, 0xf8,
+  0xd0, 0x54, 0x78, 0xa6, 0xe8, 0xe4, 0xca, 0x9a, 0xeb, 0x1d, 0x90, 0x5f, 0x08, 0xaa, 0xda, 0x51,
+  0x79, 0x35, 0xe0, 0x06, 0x9d, 0xd5, 0x72, 0x60, 0xed, 0x88, 0x98, 0x31, 0x73, 0x0e, 0x21, 0x9c,
+  0x3b, 0x95, 0xfc, 0xb5, 0xd7, 0xeb, 0xc3, 0x0c, 0x17, 0xb8, 0xd2, 0x3c, 0xc6, 0x3f, 0xc1, 0x01,
+  0xb2, 0x6c, 0xd6, 0x34, 0x6f, 0xba, 0x01, 0xd5, 0xad, 0xd9, 0x21, 0xfb, 0xea, 0xe6, 0x33, 0x6c,
+  0x9b, 0x57, 0xf3, 0x61, 0x5b, 0xff, 0x35, 0xa6, 0xad, 0xfe, 0xe7, 0x80, 0xff, 0x02, 0xef, 0xa1,
+  0xec, 0x6e, 0x32, 0x20, 0x00, 0x00,
+};